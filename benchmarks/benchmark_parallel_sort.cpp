@@ -0,0 +1,90 @@
+/**
+ * @file benchmark_parallel_sort.cpp
+ * @brief 并行排序的线程扩展性基准测试
+ *
+ * 对同一份随机数据分别用 1 ~ 32 个线程排序，items_per_second 随线程数
+ * 的增长即为加速比。线程数超过机器核数时结果没有参考意义。
+ *
+ * 运行：./benchmark_parallel_sort --benchmark_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "algorithms.h"
+#include "sorting/parallel_sort.h"
+#include "sorting/quick_sort.h"
+#include "sorting/merge_sort.h"
+
+namespace
+{
+    constexpr size_t kArrayLength = 1 << 23;
+
+    int compare_int64(const void *const a, const void *const b)
+    {
+        int64_t x = *static_cast<const int64_t *>(a);
+        int64_t y = *static_cast<const int64_t *>(b);
+        return (x > y) - (x < y);
+    }
+
+    const std::vector<int64_t> &random_input()
+    {
+        static const std::vector<int64_t> input = [] {
+            std::mt19937_64 gen(20250626);
+            std::vector<int64_t> vec(kArrayLength);
+            for (auto &v : vec)
+            {
+                v = static_cast<int64_t>(gen());
+            }
+            return vec;
+        }();
+        return input;
+    }
+
+    template <sort_result_t (*Sort)(void *, size_t, size_t, compare_func_t)>
+    void BM_Sort(benchmark::State &state)
+    {
+        size_t threads = static_cast<size_t>(state.range(0));
+        if (algorithms_set_thread_count(threads) != 0)
+        {
+            state.SkipWithError("failed to create thread pool");
+            return;
+        }
+        const auto &input = random_input();
+        std::vector<int64_t> data(input.size());
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            data = input;
+            state.ResumeTiming();
+            Sort(data.data(), data.size(), sizeof(int64_t), compare_int64);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+        state.counters["threads"] = static_cast<double>(threads);
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Sort, generic_parallel_sort)
+    ->RangeMultiplier(2)->Range(1, 32)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Sort, generic_parallel_stable_sort)
+    ->RangeMultiplier(2)->Range(1, 32)->Unit(benchmark::kMillisecond)->UseRealTime();
+// 顺序算法作为 1 线程的基准
+BENCHMARK_TEMPLATE(BM_Sort, generic_quick_sort)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Sort, generic_merge_sort)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    algorithms_init();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    algorithms_cleanup();
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file benchmark_searching.cpp
+ * @brief 小数组顺序扫描与二分查找的分界点，以及插值查找的基准测试
+ *
+ * 启动时先用 linear_search_calibrate() 在本机上标定分界点并打印，
+ * 随后顺序扫描(BM_Linear)、二分查找和按分界点自动选择的 upper bound
+ * 在 4 ~ 4096 个元素上对比，前两者曲线的交点应与标定结果接近。
+ * BM_Large 在 1600 万个均匀分布和偏斜分布的键上对比插值查找与二分查找，
+ * 偏斜分布下插值退回二分查找，只应慢一两次探测。
+ *
+ * 运行：./benchmark_searching --benchmark_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "algorithms.h"
+#include "searching/binary_search.h"
+#include "searching/linear_search.h"
+#include "searching/interpolation_search.h"
+
+namespace
+{
+    constexpr size_t kQueryCount = 1024;
+    constexpr size_t kLargeLength = 1 << 24;
+
+    // 有序数组 0, 2, 4, ...，查询均匀落在数组范围内
+    void make_small_input(size_t n, std::vector<int32_t> &arr, std::vector<int32_t> &queries)
+    {
+        arr.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            arr[i] = static_cast<int32_t>(2 * i);
+        }
+        std::mt19937 gen(20250801);
+        queries.resize(kQueryCount);
+        for (auto &q : queries)
+        {
+            q = static_cast<int32_t>(gen() % (2 * n + 1));
+        }
+    }
+
+    template <size_t (*Search)(const int32_t *, size_t, int32_t)>
+    void BM_Small(benchmark::State &state)
+    {
+        std::vector<int32_t> arr;
+        std::vector<int32_t> queries;
+        make_small_input(static_cast<size_t>(state.range(0)), arr, queries);
+        for (auto _ : state)
+        {
+            for (int32_t q : queries)
+            {
+                benchmark::DoNotOptimize(Search(arr.data(), arr.size(), q));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+    }
+
+    // BM_Linear 把分界点设为无穷大，adaptive_upper_bound 总是走顺序扫描
+    size_t linear_upper_bound(const int32_t *arr, size_t n, int32_t key)
+    {
+        return adaptive_upper_bound_int32(arr, n, key);
+    }
+
+    void BM_Linear(benchmark::State &state)
+    {
+        size_t crossover = linear_search_crossover_bytes();
+        linear_search_set_crossover_bytes(SIZE_MAX);
+        BM_Small<linear_upper_bound>(state);
+        linear_search_set_crossover_bytes(crossover);
+    }
+
+    enum class Distribution
+    {
+        Uniform,
+        Skewed,
+    };
+
+    const std::vector<int64_t> &large_input(Distribution dist)
+    {
+        static const auto make = [](Distribution d) {
+            std::mt19937_64 gen(20250801);
+            std::vector<int64_t> vec(kLargeLength);
+            for (auto &v : vec)
+            {
+                double u = static_cast<double>(gen() >> 11) / 9007199254740992.0;
+                // 偏斜分布：u^4 让大部分键挤在小的一端
+                v = d == Distribution::Uniform ? static_cast<int64_t>(gen() >> 1)
+                                               : static_cast<int64_t>(u * u * u * u * 1e18);
+            }
+            radix_sort_int64(vec.data(), vec.size());
+            return vec;
+        };
+        static const std::vector<int64_t> uniform = make(Distribution::Uniform);
+        static const std::vector<int64_t> skewed = make(Distribution::Skewed);
+        return dist == Distribution::Uniform ? uniform : skewed;
+    }
+
+    template <size_t (*Search)(const int64_t *, size_t, int64_t), Distribution Dist>
+    void BM_Large(benchmark::State &state)
+    {
+        const auto &arr = large_input(Dist);
+        std::mt19937_64 gen(1);
+        std::vector<int64_t> queries(kQueryCount);
+        for (auto &q : queries)
+        {
+            q = arr[gen() % arr.size()];
+        }
+        for (auto _ : state)
+        {
+            for (int64_t q : queries)
+            {
+                benchmark::DoNotOptimize(Search(arr.data(), arr.size(), q));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+    }
+} // namespace
+
+BENCHMARK(BM_Linear)->RangeMultiplier(2)->Range(4, 4096);
+BENCHMARK_TEMPLATE(BM_Small, upper_bound_int32)->RangeMultiplier(2)->Range(4, 4096);
+// 按标定的分界点选择，应当在每个长度上都接近两者中较快的一个
+BENCHMARK_TEMPLATE(BM_Small, adaptive_upper_bound_int32)->RangeMultiplier(2)->Range(4, 4096);
+
+BENCHMARK_TEMPLATE(BM_Large, lower_bound_int64, Distribution::Uniform);
+BENCHMARK_TEMPLATE(BM_Large, interpolation_search_int64, Distribution::Uniform);
+BENCHMARK_TEMPLATE(BM_Large, lower_bound_int64, Distribution::Skewed);
+BENCHMARK_TEMPLATE(BM_Large, interpolation_search_int64, Distribution::Skewed);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    algorithms_init();
+    size_t crossover = linear_search_calibrate();
+    std::printf("linear search crossover: %zu bytes (%zu int32), simd level %d\n", crossover,
+                crossover / sizeof(int32_t), static_cast<int>(linear_search_simd_level()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    algorithms_cleanup();
+    return 0;
+}
@@ -0,0 +1,632 @@
+/**
+ * @file benchmark_sorting.cpp
+ * @brief 排序算法的性能矩阵：算法 x 元素类型 x 输入分布 x 规模 x 线程数
+ *
+ * 每个基准的名字为 sort/<算法>/<元素类型>/<分布>/<规模>/threads:<线程数>，
+ * 只统计排序本身的时间(手动计时，不含每次迭代前恢复输入的拷贝)。
+ * 默认输出 JSON，可直接存档并与其他版本比较。
+ *
+ * 运行：
+ *   ./benchmark_sorting                                    # 全部，JSON 输出到 stdout
+ *   ./benchmark_sorting --benchmark_filter='sort/quick/int64/.*'
+ *   ./benchmark_sorting --max_size=100000000 --threads=1,4,16 --benchmark_out=sort.json
+ *
+ * 额外参数(需放在 Google Benchmark 参数之前或之后均可)：
+ *   --max_size=N     最大规模，默认 1048576，上限 10^8；总数据量超过 4 GiB 的组合会跳过
+ *   --threads=a,b,c  并行排序使用的线程数，默认 1 到 CPU 核数之间的 2 的幂
+ *   --noise_pct=K    mostly_sorted 分布中被打乱的元素比例，默认 1
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms.h"
+#include "sorting/heap_sort.h"
+#include "sorting/indirect_sort.h"
+#include "sorting/inplace_merge_sort.h"
+#include "sorting/insertion_sort.h"
+#include "sorting/key_sort.h"
+#include "sorting/string_sort.h"
+#include "sorting/merge_sort.h"
+#include "sorting/parallel_sort.h"
+#include "sorting/quick_sort.h"
+#include "sorting/radix_sort.h"
+#include "sorting/selection_sort.h"
+#include "sorting/shell_sort.h"
+#include "sorting/sorting_network.h"
+#include "sorting/sort.hpp"
+#include "sorting/tim_sort.h"
+#include "util/thread_pool.h"
+
+namespace
+{
+    /* ========================================================================
+     * 配置
+     * ======================================================================== */
+
+    struct Config
+    {
+        size_t max_size = size_t(1) << 20;
+        size_t max_bytes = size_t(4) << 30;
+        std::vector<size_t> threads;
+        unsigned noise_pct = 1;
+    };
+
+    Config g_config;
+
+    const size_t kSizes[] = {16, 256, 4096, 65536, size_t(1) << 20, size_t(1) << 24, 100000000};
+
+    // O(n^2) 算法只跑到该规模
+    constexpr size_t kQuadraticMaxSize = 4096;
+
+    /* ========================================================================
+     * 元素类型
+     * ======================================================================== */
+
+    template <size_t N>
+    struct Record
+    {
+        uint64_t key;
+        char payload[N - sizeof(uint64_t)];
+
+        bool operator<(const Record &other) const { return key < other.key; }
+    };
+
+    static_assert(sizeof(Record<16>) == 16, "Record<16> must be 16 bytes");
+    static_assert(sizeof(Record<64>) == 64, "Record<64> must be 64 bytes");
+    static_assert(sizeof(Record<256>) == 256, "Record<256> must be 256 bytes");
+
+    /** 字符串按指针排序，字符串本身保存在 StringPool 中 */
+    struct StringRef
+    {
+        const char *str;
+
+        bool operator<(const StringRef &other) const { return std::strcmp(str, other.str) < 0; }
+    };
+
+    static_assert(sizeof(StringRef) == sizeof(char *), "StringRef must be a bare pointer");
+
+    template <typename T>
+    int compare_value(const void *const a, const void *const b)
+    {
+        const T &x = *static_cast<const T *>(a);
+        const T &y = *static_cast<const T *>(b);
+        return (y < x) - (x < y);
+    }
+
+    template <typename T>
+    uint64_t record_key(const void *const elem)
+    {
+        return static_cast<const T *>(elem)->key;
+    }
+
+    // 前 8 字节按大端拼成整数，与 strcmp 的顺序一致
+    uint64_t string_prefix_key(const void *const elem)
+    {
+        const unsigned char *s = reinterpret_cast<const unsigned char *>(static_cast<const StringRef *>(elem)->str);
+        uint64_t key = 0;
+        size_t i = 0;
+        for (; i < 8 && s[i] != '\0'; i++)
+        {
+            key = (key << 8) | s[i];
+        }
+        return i == 0 ? 0 : key << (8 * (8 - i));
+    }
+
+    /**
+     * 每种元素类型：名字、由有序的 64 位值生成元素的方法，以及可用的
+     * 基数排序键类型和键提取函数(不可用时为 -1 / nullptr)。
+     */
+    template <typename T>
+    struct ElementTraits;
+
+    template <>
+    struct ElementTraits<int32_t>
+    {
+        static constexpr const char *name = "int32";
+        static constexpr int radix_key = RADIX_KEY_INT32;
+        static constexpr sort_key_func_t *key = nullptr;
+        static int32_t make(uint64_t v, std::vector<std::string> &) { return static_cast<int32_t>(static_cast<uint32_t>(v)); }
+    };
+
+    template <>
+    struct ElementTraits<int64_t>
+    {
+        static constexpr const char *name = "int64";
+        static constexpr int radix_key = RADIX_KEY_INT64;
+        static constexpr sort_key_func_t *key = nullptr;
+        static int64_t make(uint64_t v, std::vector<std::string> &) { return static_cast<int64_t>(v); }
+    };
+
+    template <>
+    struct ElementTraits<double>
+    {
+        static constexpr const char *name = "double";
+        static constexpr int radix_key = RADIX_KEY_DOUBLE;
+        static constexpr sort_key_func_t *key = nullptr;
+        static double make(uint64_t v, std::vector<std::string> &) { return static_cast<double>(v); }
+    };
+
+    template <size_t N>
+    struct ElementTraits<Record<N>>
+    {
+        static constexpr const char *name = N == 16 ? "record16" : N == 64 ? "record64" : "record256";
+        static constexpr int radix_key = RADIX_KEY_UINT64;
+        static constexpr sort_key_func_t *key = record_key<Record<N>>;
+        static Record<N> make(uint64_t v, std::vector<std::string> &)
+        {
+            Record<N> r;
+            r.key = v;
+            std::memset(r.payload, static_cast<int>(v & 0xFF), sizeof(r.payload));
+            return r;
+        }
+    };
+
+    template <>
+    struct ElementTraits<StringRef>
+    {
+        static constexpr const char *name = "string";
+        static constexpr int radix_key = -1;
+        static constexpr sort_key_func_t *key = string_prefix_key;
+        static StringRef make(uint64_t v, std::vector<std::string> &pool)
+        {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "key-%020llu", static_cast<unsigned long long>(v));
+            pool.emplace_back(buf);
+            return StringRef{nullptr};
+        }
+    };
+
+    /* ========================================================================
+     * 输入分布
+     * ======================================================================== */
+
+    enum class Distribution
+    {
+        Random,
+        Sorted,
+        Reversed,
+        OrganPipe,
+        FewUnique,
+        Sawtooth,
+        MostlySorted,
+    };
+
+    const Distribution kDistributions[] = {
+        Distribution::Random, Distribution::Sorted, Distribution::Reversed, Distribution::OrganPipe,
+        Distribution::FewUnique, Distribution::Sawtooth, Distribution::MostlySorted,
+    };
+
+    std::string distribution_name(Distribution dist)
+    {
+        switch (dist)
+        {
+        case Distribution::Random:
+            return "random";
+        case Distribution::Sorted:
+            return "sorted";
+        case Distribution::Reversed:
+            return "reversed";
+        case Distribution::OrganPipe:
+            return "organ_pipe";
+        case Distribution::FewUnique:
+            return "few_unique";
+        case Distribution::Sawtooth:
+            return "sawtooth";
+        case Distribution::MostlySorted:
+            return "mostly_sorted_" + std::to_string(g_config.noise_pct) + "pct";
+        }
+        return "unknown";
+    }
+
+    std::vector<uint64_t> generate_values(Distribution dist, size_t n)
+    {
+        std::mt19937_64 gen(20250626 ^ n);
+        std::vector<uint64_t> values(n);
+        switch (dist)
+        {
+        case Distribution::Random:
+            for (auto &v : values)
+            {
+                v = gen() >> 1;
+            }
+            break;
+        case Distribution::Sorted:
+            for (size_t i = 0; i < n; i++)
+            {
+                values[i] = i;
+            }
+            break;
+        case Distribution::Reversed:
+            for (size_t i = 0; i < n; i++)
+            {
+                values[i] = n - i;
+            }
+            break;
+        case Distribution::OrganPipe:
+            for (size_t i = 0; i < n; i++)
+            {
+                values[i] = i < n / 2 ? i : n - i;
+            }
+            break;
+        case Distribution::FewUnique:
+            for (auto &v : values)
+            {
+                v = gen() % 16;
+            }
+            break;
+        case Distribution::Sawtooth:
+        {
+            size_t period = std::max<size_t>(1, n / 16);
+            for (size_t i = 0; i < n; i++)
+            {
+                values[i] = i % period;
+            }
+            break;
+        }
+        case Distribution::MostlySorted:
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                values[i] = i;
+            }
+            size_t swaps = n * g_config.noise_pct / 200;
+            for (size_t k = 0; k < swaps; k++)
+            {
+                std::swap(values[gen() % n], values[gen() % n]);
+            }
+            break;
+        }
+        }
+        return values;
+    }
+
+    /** 一组输入数据；字符串类型的 pool 保存字符串本体 */
+    template <typename T>
+    struct Input
+    {
+        Distribution dist;
+        size_t n = 0;
+        std::vector<T> data;
+        std::vector<std::string> pool;
+    };
+
+    /**
+     * 同一 (分布, 规模) 的各算法连续注册，只缓存最近一组输入，
+     * 避免同时保留所有组合的数据。
+     */
+    template <typename T>
+    const Input<T> &get_input(Distribution dist, size_t n)
+    {
+        static std::unique_ptr<Input<T>> cached;
+        if (cached && cached->dist == dist && cached->n == n)
+        {
+            return *cached;
+        }
+        cached.reset();
+        auto input = std::make_unique<Input<T>>();
+        input->dist = dist;
+        input->n = n;
+        std::vector<uint64_t> values = generate_values(dist, n);
+        input->data.reserve(n);
+        for (uint64_t v : values)
+        {
+            input->data.push_back(ElementTraits<T>::make(v, input->pool));
+        }
+        if constexpr (std::is_same<T, StringRef>::value)
+        {
+            // pool 填充完毕后地址才稳定
+            for (size_t i = 0; i < n; i++)
+            {
+                input->data[i].str = input->pool[i].c_str();
+            }
+        }
+        cached = std::move(input);
+        return *cached;
+    }
+
+    /* ========================================================================
+     * 算法
+     * ======================================================================== */
+
+    template <typename T>
+    using SortFn = std::function<sort_result_t(T *, size_t)>;
+
+    template <typename T>
+    struct Algorithm
+    {
+        std::string name;
+        SortFn<T> sort;
+        bool parallel;
+        size_t max_size;
+    };
+
+    template <typename T>
+    SortFn<T> c_sort(sort_result_t (*sort)(void *, size_t, size_t, compare_func_t))
+    {
+        return [sort](T *arr, size_t n) { return sort(arr, n, sizeof(T), compare_value<T>); };
+    }
+
+    template <typename T>
+    std::vector<Algorithm<T>> algorithms_for()
+    {
+        const size_t unlimited = SIZE_MAX;
+        std::vector<Algorithm<T>> algos = {
+            {"quick", c_sort<T>(generic_quick_sort), false, unlimited},
+            {"heap", c_sort<T>(generic_heap_sort), false, unlimited},
+            {"merge", c_sort<T>(generic_merge_sort), false, unlimited},
+            {"inplace_merge", c_sort<T>(generic_inplace_merge_sort), false, unlimited},
+            {"tim", c_sort<T>(generic_tim_sort), false, unlimited},
+            {"shell", c_sort<T>(generic_shell_sort), false, unlimited},
+            {"selection", c_sort<T>(generic_selection_sort), false, kQuadraticMaxSize},
+            {"insertion",
+             [](T *arr, size_t n) {
+                 T tmp;
+                 return generic_insertion_sort_with_buffer(arr, n, sizeof(T), compare_value<T>, &tmp);
+             },
+             false, kQuadraticMaxSize},
+            {"network", c_sort<T>(generic_network_sort), false, SORTING_NETWORK_MAX},
+            {"cpp_sort",
+             [](T *arr, size_t n) {
+                 algo::sort(arr, n);
+                 return SORT_SUCCESS;
+             },
+             false, unlimited},
+            {"cpp_stable_sort",
+             [](T *arr, size_t n) {
+                 algo::stable_sort(arr, n);
+                 return SORT_SUCCESS;
+             },
+             false, unlimited},
+            {"parallel", c_sort<T>(generic_parallel_sort), true, unlimited},
+            {"parallel_stable", c_sort<T>(generic_parallel_stable_sort), true, unlimited},
+        };
+
+        if (ElementTraits<T>::radix_key >= 0)
+        {
+            const auto key_type = static_cast<radix_key_type_t>(ElementTraits<T>::radix_key);
+            algos.push_back({"radix",
+                             [key_type](T *arr, size_t n) { return generic_radix_sort(arr, n, sizeof(T), 0, key_type); },
+                             false, unlimited});
+            algos.push_back({"radix_inplace",
+                             [key_type](T *arr, size_t n) { return generic_radix_sort_inplace(arr, n, sizeof(T), 0, key_type); },
+                             false, unlimited});
+        }
+        if (ElementTraits<T>::key != nullptr)
+        {
+            algos.push_back({"key_sort",
+                             [](T *arr, size_t n) {
+                                 return generic_key_sort(arr, n, sizeof(T), ElementTraits<T>::key, compare_value<T>, nullptr);
+                             },
+                             false, unlimited});
+            // 只排下标，最后一次性移动元素
+            algos.push_back({"argsort_apply",
+                             [](T *arr, size_t n) {
+                                 std::vector<size_t> indices(n);
+                                 sort_result_t res = generic_argsort(arr, n, sizeof(T), compare_value<T>, nullptr, indices.data());
+                                 return res != SORT_SUCCESS ? res : apply_permutation(arr, n, sizeof(T), indices.data());
+                             },
+                             false, unlimited});
+        }
+        if constexpr (std::is_same<T, int32_t>::value)
+        {
+            algos.push_back({"network_int32", network_sort_int32, false, SORTING_NETWORK_MAX_32BIT});
+        }
+        if constexpr (std::is_same<T, StringRef>::value)
+        {
+            // StringRef 只包含一个字符串指针，数组可以直接当作 char *[] 排序
+            algos.push_back({"string_multikey",
+                             [](T *arr, size_t n) { return string_multikey_sort(reinterpret_cast<char **>(arr), n); },
+                             false, unlimited});
+            algos.push_back({"string_radix",
+                             [](T *arr, size_t n) { return string_radix_sort(reinterpret_cast<char **>(arr), n); },
+                             false, unlimited});
+        }
+        return algos;
+    }
+
+    /* ========================================================================
+     * 注册
+     * ======================================================================== */
+
+    template <typename T>
+    void run_sort(benchmark::State &state, const SortFn<T> &sort, Distribution dist, size_t n, size_t threads)
+    {
+        thread_pool_t *pool = thread_pool_global();
+        if ((NULL == pool || thread_pool_size(pool) != threads) && algorithms_set_thread_count(threads) != 0)
+        {
+            state.SkipWithError("failed to create thread pool");
+            return;
+        }
+        const Input<T> &input = get_input<T>(dist, n);
+        std::vector<T> data(input.data);
+        for (auto _ : state)
+        {
+            std::copy(input.data.begin(), input.data.end(), data.begin());
+            auto start = std::chrono::steady_clock::now();
+            sort_result_t res = sort(data.data(), n);
+            auto end = std::chrono::steady_clock::now();
+            benchmark::ClobberMemory();
+            if (res != SORT_SUCCESS)
+            {
+                state.SkipWithError("sort failed");
+                return;
+            }
+            state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(n));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(n * sizeof(T)));
+        state.counters["n"] = static_cast<double>(n);
+        state.counters["element_size"] = static_cast<double>(sizeof(T));
+        state.counters["threads"] = static_cast<double>(threads);
+        state.counters["ns_per_element"] = benchmark::Counter(
+            static_cast<double>(state.iterations()) * static_cast<double>(n),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+    template <typename T>
+    void register_type()
+    {
+        const std::vector<Algorithm<T>> algos = algorithms_for<T>();
+        for (Distribution dist : kDistributions)
+        {
+            for (size_t n : kSizes)
+            {
+                if (n > g_config.max_size || n * sizeof(T) > g_config.max_bytes)
+                {
+                    continue;
+                }
+                for (const auto &algo : algos)
+                {
+                    if (n > algo.max_size)
+                    {
+                        continue;
+                    }
+                    std::vector<size_t> thread_counts = algo.parallel ? g_config.threads : std::vector<size_t>{1};
+                    for (size_t threads : thread_counts)
+                    {
+                        std::string name = "sort/" + algo.name + "/" + ElementTraits<T>::name + "/" +
+                                           distribution_name(dist) + "/" + std::to_string(n) +
+                                           "/threads:" + std::to_string(threads);
+                        SortFn<T> sort = algo.sort;
+                        benchmark::RegisterBenchmark(name.c_str(), [sort, dist, n, threads](benchmark::State &state) {
+                            run_sort<T>(state, sort, dist, n, threads);
+                        })
+                            ->UseManualTime()
+                            ->Unit(benchmark::kMicrosecond);
+                    }
+                }
+            }
+        }
+    }
+
+    /* ========================================================================
+     * 命令行
+     * ======================================================================== */
+
+    std::vector<size_t> default_threads()
+    {
+        size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<size_t> threads;
+        for (size_t t = 1; t <= hw; t *= 2)
+        {
+            threads.push_back(t);
+        }
+        if (threads.back() != hw)
+        {
+            threads.push_back(hw);
+        }
+        return threads;
+    }
+
+    std::vector<size_t> parse_list(const char *s)
+    {
+        std::vector<size_t> values;
+        while (*s != '\0')
+        {
+            char *end = nullptr;
+            unsigned long long v = std::strtoull(s, &end, 10);
+            if (end == s)
+            {
+                break;
+            }
+            if (v > 0)
+            {
+                values.push_back(static_cast<size_t>(v));
+            }
+            s = *end == ',' ? end + 1 : end;
+        }
+        return values;
+    }
+
+    /** 取走本程序自己的参数，其余交给 Google Benchmark */
+    void parse_args(int &argc, char **argv)
+    {
+        g_config.threads = default_threads();
+        int out = 1;
+        for (int i = 1; i < argc; i++)
+        {
+            const char *arg = argv[i];
+            if (std::strncmp(arg, "--max_size=", 11) == 0)
+            {
+                unsigned long long v = std::strtoull(arg + 11, nullptr, 10);
+                g_config.max_size = static_cast<size_t>(std::min<unsigned long long>(v, 100000000ull));
+            }
+            else if (std::strncmp(arg, "--threads=", 10) == 0)
+            {
+                std::vector<size_t> threads = parse_list(arg + 10);
+                if (!threads.empty())
+                {
+                    g_config.threads = threads;
+                }
+            }
+            else if (std::strncmp(arg, "--noise_pct=", 12) == 0)
+            {
+                g_config.noise_pct = static_cast<unsigned>(std::min(100ul, std::strtoul(arg + 12, nullptr, 10)));
+            }
+            else
+            {
+                argv[out++] = argv[i];
+            }
+        }
+        argc = out;
+    }
+
+    bool has_format_flag(int argc, char **argv)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            if (std::strncmp(argv[i], "--benchmark_format", 18) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    parse_args(argc, argv);
+
+    // 默认输出 JSON，显式指定 --benchmark_format 时以命令行为准
+    std::vector<char *> args(argv, argv + argc);
+    char json_flag[] = "--benchmark_format=json";
+    if (!has_format_flag(argc, argv))
+    {
+        args.push_back(json_flag);
+    }
+    int args_count = static_cast<int>(args.size());
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+    {
+        return 1;
+    }
+
+    register_type<int32_t>();
+    register_type<int64_t>();
+    register_type<double>();
+    register_type<Record<16>>();
+    register_type<Record<64>>();
+    register_type<Record<256>>();
+    register_type<StringRef>();
+
+    algorithms_init();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    algorithms_cleanup();
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file benchmark_swap.cpp
+ * @brief 元素交换基准测试
+ *
+ * 按元素大小比较 GENERIC_SAMP_SIZE_SWAP 宏与 select_swap_func 选出的交换函数。
+ * 每次迭代在一个数组中交换相邻元素对，模拟选择排序/希尔排序中的交换。
+ *
+ * 运行：./benchmark_swap --benchmark_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "sorting/sort_common.h"
+
+namespace
+{
+    constexpr size_t kElements = 256;
+
+    void BM_MacroSwap(benchmark::State &state)
+    {
+        size_t size = static_cast<size_t>(state.range(0));
+        std::vector<char> data(kElements * size, 1);
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i + 1 < kElements; i += 2)
+            {
+                GENERIC_SAMP_SIZE_SWAP(size, INDEX_OF(data.data(), size, i), INDEX_OF(data.data(), size, i + 1));
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kElements * size));
+    }
+
+    void BM_DispatchedSwap(benchmark::State &state)
+    {
+        size_t size = static_cast<size_t>(state.range(0));
+        std::vector<char> data(kElements * size, 1);
+        // 与排序中的用法一致，每次调用只选择一次
+        sized_swap_func_t *swap = select_swap_func(size);
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i + 1 < kElements; i += 2)
+            {
+                swap(INDEX_OF(data.data(), size, i), INDEX_OF(data.data(), size, i + 1), size);
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kElements * size));
+    }
+
+    void element_sizes(benchmark::internal::Benchmark *bench)
+    {
+        for (int size : {4, 8, 16, 24, 32, 48, 64, 96, 128, 256, 512, 1024})
+        {
+            bench->Arg(size);
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_MacroSwap)->Apply(element_sizes);
+BENCHMARK(BM_DispatchedSwap)->Apply(element_sizes);
+
+BENCHMARK_MAIN();
@@ -21,6 +21,8 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+
 /* ============================================================================
  * 版本信息
  * ============================================================================ */
@@ -34,9 +36,21 @@ extern "C" {
  * ============================================================================ */
 
 #include "sorting/insertion_sort.h"
-// #include "sorting/quick_sort.h"      // 将来添加
+#include "sorting/quick_sort.h"
 // #include "sorting/merge_sort.h"      // 将来添加
-// #include "sorting/heap_sort.h"       // 将来添加
+#include "sorting/heap_sort.h"
+#include "sorting/parallel_sort.h"
+#include "sorting/indirect_sort.h"
+#include "sorting/key_sort.h"
+#include "sorting/tim_sort.h"
+#include "sorting/nth_element.h"
+#include "sorting/topk.h"
+#include "sorting/external_sort.h"
+#include "sorting/string_sort.h"
+#include "sorting/sorting_network.h"
+#include "sorting/batch_sort.h"
+#include "sorting/sort_by_key.h"
+#include "sorting/inplace_merge_sort.h"
 // #include "sorting/bubble_sort.h"     // 将来添加
 // #include "sorting/selection_sort.h"  // 将来添加
 
@@ -44,8 +58,12 @@ extern "C" {
  * 搜索算法模块
  * ============================================================================ */
 
-// #include "searching/binary_search.h"    // 将来添加
-// #include "searching/linear_search.h"    // 将来添加
+#include "searching/binary_search.h"
+#include "searching/eytzinger.h"
+#include "searching/static_btree.h"
+#include "searching/learned_index.h"
+#include "searching/linear_search.h"
+#include "searching/interpolation_search.h"
 // #include "searching/ternary_search.h"   // 将来添加
 
 /* ============================================================================
@@ -55,7 +73,7 @@ extern "C" {
 // #include "data_structures/stack.h"      // 将来添加
 // #include "data_structures/queue.h"      // 将来添加
 // #include "data_structures/linked_list.h" // 将来添加
-// #include "data_structures/hash_table.h" // 将来添加
+#include "data_structures/hash_table.h"
 // #include "data_structures/binary_tree.h" // 将来添加
 
 /* ============================================================================
@@ -93,10 +111,18 @@ const char* algorithms_get_version(void);
 int algorithms_init(void);
 
 /**
- * @brief 清理算法工具包资源
+ * @brief 清理算法工具包资源：销毁全局线程池，归还暂存内存(util/scratch_arena.h)
  */
 void algorithms_cleanup(void);
 
+/**
+ * @brief 设置并行算法使用的线程数，会重建全局线程池
+ * @param num_threads 0 表示使用环境变量 ALGORITHMS_NUM_THREADS 或 CPU 核数
+ * @return 成功返回0，失败返回负数
+ * @note 不能与正在执行的并行算法同时调用
+ */
+int algorithms_set_thread_count(size_t num_threads);
+
 #ifdef __cplusplus
 }
 #endif
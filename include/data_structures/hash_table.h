@@ -0,0 +1,154 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 开放寻址哈希表(Swiss table 风格)，键和值都是定长的字节块。
+//
+// - 每个槽位对应 1 字节控制字节：空、已删除，或哈希值低 7 位(h2)。
+//   槽位按 HASH_TABLE_GROUP_WIDTH 个一组，查找时用 SSE2 一次比较整组的
+//   控制字节，只对 h2 相同的槽位调用相等比较，绝大多数不命中的槽位不读键；
+// - 哈希值高位选择起始组，依次探测下一组，直到遇到含空槽的组为止；
+// - 删除时所在组仍有空槽，说明这个组从未满过，没有探测序列越过它，
+//   可以直接标成空槽；只有整组已满时才留下删除标记(墓碑)。
+//   墓碑在插入时复用，过多时原容量重建一次清除；
+// - 容量是 HASH_TABLE_GROUP_WIDTH 的倍数而不要求是 2 的幂，按 1.5 倍扩容，
+//   元素数超过 容量 * 最大负载因子 时扩容。默认负载因子下，8 字节键 + 8 字节值
+//   的表刚扩容后占用约为原始数据的 1.8 倍(最坏情况)，预先 hash_table_reserve
+//   到最终大小时约为 1.2 倍。
+//
+// 键按字节比较和哈希(未提供回调时)，结构体键须把填充字节清零。
+// 值按其大小推断的自然对齐(最多 8 字节)存放，返回的值指针可以直接转换为
+// 对应类型的指针使用。插入、删除和扩容会使之前返回的指针失效。
+// 不是线程安全的：同一个表上的写操作须由调用者串行化，并发只读是安全的。
+
+/** 每组槽位数，即一次 SSE2 比较的控制字节数 */
+#define HASH_TABLE_GROUP_WIDTH 16
+
+/** 默认最大负载因子，可用 hash_table_set_max_load_factor 修改 */
+#ifndef HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR
+#define HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR 0.875
+#endif
+
+/** 批量接口每次预取的键数 */
+#define HASH_TABLE_BATCH_WIDTH 16
+
+/**
+ * 哈希函数：key 指向 key_size 字节的键，相等的键须返回相同的值。
+ * 返回值在表内还会再混合一次，恒等哈希这类只有低位变化的函数也能均匀分布
+ */
+typedef uint64_t hash_func_t(const void *const key, size_t key_size);
+
+/** 相等比较：相等时返回非 0 */
+typedef int hash_equal_func_t(const void *const a, const void *const b, size_t key_size);
+
+typedef struct hash_table hash_table_t;
+
+/**
+ * @brief 创建空表，此时不分配槽位
+ * @param value_size 可以为 0，此时表即集合
+ * @param hash 为 NULL 时使用内置哈希(hash_table_default_hash)
+ * @param equal 为 NULL 时按字节比较
+ * @param out 成功时写入新建的表，用 hash_table_destroy 释放
+ */
+extern sort_result_t hash_table_create(size_t key_size, size_t value_size, hash_func_t *hash,
+                                       hash_equal_func_t *equal, hash_table_t **out);
+extern void hash_table_destroy(hash_table_t *table);
+
+/** 删除全部元素，保留已分配的槽位 */
+extern void hash_table_clear(hash_table_t *table);
+
+extern size_t hash_table_size(const hash_table_t *table);
+
+/** 槽位数 */
+extern size_t hash_table_capacity(const hash_table_t *table);
+
+/** 表本身占用的字节数(控制字节与槽位) */
+extern size_t hash_table_memory_bytes(const hash_table_t *table);
+
+/** 内置哈希：4 和 8 字节的键按整数混合，其余按 8 字节分块混合 */
+extern uint64_t hash_table_default_hash(const void *const key, size_t key_size);
+
+/**
+ * @brief 扩容到至少能容纳 num_elements 个元素而不再扩容
+ * 已知最终大小时预先调用，可以避免逐次扩容的重建开销和 1.5 倍扩容带来的空闲槽位
+ */
+extern sort_result_t hash_table_reserve(hash_table_t *table, size_t num_elements);
+
+/**
+ * @brief 设置最大负载因子，取值 (0, 1)
+ * 调小时若当前元素数已超过新上限，立即扩容
+ */
+extern sort_result_t hash_table_set_max_load_factor(hash_table_t *table, double max_load_factor);
+
+/**
+ * @brief 插入键值对，键已存在时覆盖其值
+ * @param value 为 NULL 时新插入的值清零，已有的值不变
+ */
+extern sort_result_t hash_table_insert(hash_table_t *table, const void *key, const void *value);
+
+/**
+ * @brief 查找键，不存在时插入并把值清零
+ * @param value 写入值所在的地址，可就地修改(计数、聚合等)
+ * @param inserted 可以为 NULL，新插入时写入 1，已存在时写入 0
+ */
+extern sort_result_t hash_table_emplace(hash_table_t *table, const void *key, void **value, int *inserted);
+
+/** 返回值所在的地址，不存在时返回 NULL */
+extern void *hash_table_find(const hash_table_t *table, const void *key);
+
+/** 删除成功返回 1，键不存在时返回 0 */
+extern int hash_table_erase(hash_table_t *table, const void *key);
+
+/**
+ * 批量插入 / 查找：每 HASH_TABLE_BATCH_WIDTH 个键先算出哈希并预取各自的控制字节组，
+ * 再预取候选槽位，最后逐个完成操作，多个缓存未命中可以重叠。
+ * keys / values 是连续存放的 num_keys 个键 / 值，values 为 NULL 的含义同 hash_table_insert。
+ * inserted 可以为 NULL，否则写入新插入的键数。find_batch 在 out[i] 中写入值的地址或 NULL。
+ */
+extern sort_result_t hash_table_insert_batch(hash_table_t *table, const void *keys, const void *values,
+                                             size_t num_keys, size_t *inserted);
+extern void hash_table_find_batch(const hash_table_t *table, const void *keys, size_t num_keys, void **out);
+
+/**
+ * @brief 遍历全部元素，顺序与插入顺序无关
+ * @param cursor 从 0 开始，每次调用后更新
+ * @return 取到一个元素时返回 1 并写入 key / value(可以为 NULL)，遍历结束返回 0
+ * 遍历期间不能插入或删除
+ */
+extern int hash_table_next(const hash_table_t *table, size_t *cursor, const void **key, void **value);
+
+/**
+ * 整数键的快速路径：键按值传入，比较和默认哈希内联，不经过回调。
+ * 与通用接口共享同一张表，key_size 必须等于 sizeof(T)，否则插入返回
+ * SORT_ERROR_INVALID_ELEMENT_SIZE，查找返回 NULL，删除返回 0。
+ * 创建表时提供了哈希或相等回调时仍会调用它们。
+ */
+extern sort_result_t hash_table_insert_int32(hash_table_t *table, int32_t key, const void *value);
+extern void *hash_table_find_int32(const hash_table_t *table, int32_t key);
+extern int hash_table_erase_int32(hash_table_t *table, int32_t key);
+extern sort_result_t hash_table_insert_batch_int32(hash_table_t *table, const int32_t *keys, const void *values,
+                                                   size_t num_keys, size_t *inserted);
+extern void hash_table_find_batch_int32(const hash_table_t *table, const int32_t *keys, size_t num_keys, void **out);
+
+extern sort_result_t hash_table_insert_int64(hash_table_t *table, int64_t key, const void *value);
+extern void *hash_table_find_int64(const hash_table_t *table, int64_t key);
+extern int hash_table_erase_int64(hash_table_t *table, int64_t key);
+extern sort_result_t hash_table_insert_batch_int64(hash_table_t *table, const int64_t *keys, const void *values,
+                                                   size_t num_keys, size_t *inserted);
+extern void hash_table_find_batch_int64(const hash_table_t *table, const int64_t *keys, size_t num_keys, void **out);
+
+extern sort_result_t hash_table_insert_uint64(hash_table_t *table, uint64_t key, const void *value);
+extern void *hash_table_find_uint64(const hash_table_t *table, uint64_t key);
+extern int hash_table_erase_uint64(hash_table_t *table, uint64_t key);
+extern sort_result_t hash_table_insert_batch_uint64(hash_table_t *table, const uint64_t *keys, const void *values,
+                                                    size_t num_keys, size_t *inserted);
+extern void hash_table_find_batch_uint64(const hash_table_t *table, const uint64_t *keys, size_t num_keys, void **out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // HASH_TABLE_H
@@ -0,0 +1,97 @@
+#ifndef BINARY_SEARCH_H
+#define BINARY_SEARCH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 有序数组上的二分查找，面向高吞吐的批量探测。
+//
+// - 无分支形式：区间长度只取决于 n，不取决于比较结果，每一步用比较结果
+//   选择(cmov)下一段的起点，没有难以预测的分支；循环次数固定为 ceil(log2 n)；
+// - int32/int64/float/double 版本直接比较，并预取下一步两个候选位置；
+// - 批量版本把 SEARCH_BATCH_WIDTH 个查询交错执行：所有查询的区间长度
+//   序列相同，每一轮为每个查询各走一步并预取它下一步要读的位置，
+//   一个查询等待内存时 CPU 在处理其他查询，隐藏 DRAM 延迟。
+//
+// 数组须按 cmp(或 <)升序排列，浮点数组不能含 NaN。
+// arr 为 NULL 或 arr_len 为 0 时 lower/upper bound 返回 0。
+
+#ifndef SEARCH_BATCH_WIDTH
+#define SEARCH_BATCH_WIDTH 16
+#endif
+
+/** generic_binary_search 未找到时的返回值 */
+#define SEARCH_NOT_FOUND ((size_t)-1)
+
+/** 第一个不小于 key 的元素下标，不存在时返回 arr_len */
+extern size_t generic_lower_bound(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp
+);
+
+/** 第一个大于 key 的元素下标，不存在时返回 arr_len */
+extern size_t generic_upper_bound(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp
+);
+
+/** 与 key 相等的第一个元素下标，不存在时返回 SEARCH_NOT_FOUND */
+extern size_t generic_binary_search(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp
+);
+
+/**
+ * @brief 对 num_keys 个连续存放的查询分别求 lower bound，结果写入 out
+ * @param keys 每个查询 element_size 字节
+ */
+extern void generic_lower_bound_batch(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *keys,
+    size_t num_keys,
+    compare_func_t cmp,
+    size_t *out
+);
+
+/* ============================================================================
+ * 定类型版本
+ * ============================================================================
+ */
+
+extern size_t lower_bound_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern size_t upper_bound_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern void lower_bound_int32_batch(const int32_t *arr, size_t arr_len, const int32_t *keys, size_t num_keys, size_t *out);
+
+extern size_t lower_bound_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern size_t upper_bound_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern void lower_bound_int64_batch(const int64_t *arr, size_t arr_len, const int64_t *keys, size_t num_keys, size_t *out);
+
+extern size_t lower_bound_uint64(const uint64_t *arr, size_t arr_len, uint64_t key);
+extern size_t upper_bound_uint64(const uint64_t *arr, size_t arr_len, uint64_t key);
+extern void lower_bound_uint64_batch(const uint64_t *arr, size_t arr_len, const uint64_t *keys, size_t num_keys, size_t *out);
+
+extern size_t lower_bound_float(const float *arr, size_t arr_len, float key);
+extern size_t upper_bound_float(const float *arr, size_t arr_len, float key);
+extern void lower_bound_float_batch(const float *arr, size_t arr_len, const float *keys, size_t num_keys, size_t *out);
+
+extern size_t lower_bound_double(const double *arr, size_t arr_len, double key);
+extern size_t upper_bound_double(const double *arr, size_t arr_len, double key);
+extern void lower_bound_double_batch(const double *arr, size_t arr_len, const double *keys, size_t num_keys, size_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BINARY_SEARCH_H
@@ -0,0 +1,79 @@
+#ifndef EYTZINGER_H
+#define EYTZINGER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// Eytzinger(BFS 顺序)布局：把有序数组按完全二叉树的层序存放，
+// 位置 i(从 0 开始)的左右孩子在 2i+1 和 2i+2。
+//
+// 查找路径上前几层集中在数组开头，常驻缓存。按从 1 开始的节点编号 k，
+// 节点向下第 4 层的 16 个后代编号为 16k ~ 16k+15，即数组位置 16k-1 ~ 16k+14，
+// 连续存放(int32；int64 为向下第 3 层的 8 个)。查找每步预取这一段，访存几乎
+// 都是预取命中。这一段只有在 eyt - 1 落在缓存行边界时才是一整行，否则跨两行：
+// 用 eytzinger_alloc 分配布局数组即可保证对齐，其他方式分配的数组结果同样正确，
+// 只是每步要预取两行。
+// 与有序数组上的二分查找相比，n 远大于缓存时吞吐高出数倍。
+//
+// 查找返回的是布局中的位置(slot)，不是原有序数组的下标；需要原下标时
+// 在构建时取得 sorted_index 映射，或者把附带的值也按同样的布局存放。
+// 数组须按 cmp(或 <)升序排列，浮点数组不能含 NaN。
+
+/**
+ * @brief 分配能放 arr_len 个元素的布局数组，eyt - 1 对齐到缓存行边界
+ * @return 失败返回 NULL；用 eytzinger_free 释放，element_size 须与分配时相同
+ */
+extern void *eytzinger_alloc(size_t arr_len, size_t element_size);
+extern void eytzinger_free(void *eyt, size_t element_size);
+
+/**
+ * @brief 把有序数组 sorted 重排为 Eytzinger 布局写入 out
+ * @param out arr_len 个元素，不能与 sorted 重叠
+ * @param sorted_index 可以为 NULL；不为 NULL 时写入每个位置对应的原下标
+ */
+extern sort_result_t generic_eytzinger_build(
+    const void *sorted,
+    size_t arr_len,
+    size_t element_size,
+    void *out,
+    size_t *sorted_index
+);
+
+/** 第一个不小于 key 的元素在布局中的位置，不存在时返回 arr_len */
+extern size_t generic_eytzinger_lower_bound(
+    const void *eyt,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp
+);
+
+/** 对 num_keys 个查询交错求 lower bound，结果写入 out */
+extern void generic_eytzinger_lower_bound_batch(
+    const void *eyt,
+    size_t arr_len,
+    size_t element_size,
+    const void *keys,
+    size_t num_keys,
+    compare_func_t cmp,
+    size_t *out
+);
+
+extern size_t eytzinger_lower_bound_int32(const int32_t *eyt, size_t arr_len, int32_t key);
+extern void eytzinger_lower_bound_int32_batch(const int32_t *eyt, size_t arr_len, const int32_t *keys, size_t num_keys, size_t *out);
+
+extern size_t eytzinger_lower_bound_int64(const int64_t *eyt, size_t arr_len, int64_t key);
+extern void eytzinger_lower_bound_int64_batch(const int64_t *eyt, size_t arr_len, const int64_t *keys, size_t num_keys, size_t *out);
+
+extern size_t eytzinger_lower_bound_float(const float *eyt, size_t arr_len, float key);
+extern void eytzinger_lower_bound_float_batch(const float *eyt, size_t arr_len, const float *keys, size_t num_keys, size_t *out);
+
+extern size_t eytzinger_lower_bound_double(const double *eyt, size_t arr_len, double key);
+extern void eytzinger_lower_bound_double_batch(const double *eyt, size_t arr_len, const double *keys, size_t num_keys, size_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EYTZINGER_H
@@ -0,0 +1,41 @@
+#ifndef INTERPOLATION_SEARCH_H
+#define INTERPOLATION_SEARCH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 插值查找：按 key 在区间两端值之间的比例估计位置，键均匀分布时
+// 期望 O(log log n) 次探测，1 亿个元素约 5 次，而二分查找需要 27 次。
+//
+// 分布不均匀时插值可能每次只缩小一点区间，退化为 O(n)。这里做了保护：
+// - 每次插值后在估计位置旁约 sqrt(区间长度) 处再探测一次，估计准确时区间
+//   直接缩到这个宽度；一次插值没能让区间减半就认为分布不适合插值，
+//   立即在整个数组上改用二分查找(lower_bound_T)。整段二分的前几层地址固定，
+//   连续查询时常驻缓存，比在剩余的任意子区间上二分更快；
+// - 插值次数不超过 floor(log2(log2 n)) + INTERPOLATION_SEARCH_EXTRA_PROBES，
+//   区间缩小到 INTERPOLATION_SEARCH_MIN_RANGE 个元素以内时同样交给二分查找，
+//   最后几步插值的计算开销比它省下的比较更大。
+// 因此最坏情况仍是 O(log n)，只比二分查找多一两次探测。
+//
+// 返回值与 lower_bound_T 相同：第一个不小于 key 的元素下标，不存在时返回 arr_len。
+// 数组须升序排列，浮点数组不能含 NaN。
+
+#ifndef INTERPOLATION_SEARCH_MIN_RANGE
+#define INTERPOLATION_SEARCH_MIN_RANGE 32
+#endif
+
+#ifndef INTERPOLATION_SEARCH_EXTRA_PROBES
+#define INTERPOLATION_SEARCH_EXTRA_PROBES 3
+#endif
+
+extern size_t interpolation_search_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern size_t interpolation_search_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern size_t interpolation_search_float(const float *arr, size_t arr_len, float key);
+extern size_t interpolation_search_double(const double *arr, size_t arr_len, double key);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // INTERPOLATION_SEARCH_H
@@ -0,0 +1,70 @@
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 学习型索引(PGM 风格)：用分段线性函数拟合 "键 -> 在有序数组中的位置"。
+//
+// - 第 0 层的每一段是一条直线，对段内每个不同的键，预测位置与该键第一次
+//   出现的下标相差不超过 epsilon；用流式最优分段线性拟合(维护可行直线集合
+//   的上下凸包)一趟扫描得到段数最少的划分，构建为 O(n)；
+// - 各段的起始键又按 LEARNED_INDEX_EPSILON_RECURSIVE 递归拟合，直到只剩一段，
+//   查询从根开始每层在 2*eps+1 个段里定位，最后在原数组的
+//   [pred - epsilon, pred + epsilon] 窗口内用 lower_bound_T 完成查找；
+// - 索引只保存各段的 (起始键, 斜率, 截距)，每段 24 字节，不复制数据。
+//   分布越接近均匀段数越少，对均匀分布的 1 亿个键只需几 KB 到几百 KB，
+//   而树形布局需要完整复制一份数据。
+//
+// 索引引用构建时传入的数组，查询期间数组必须保持存在且不被修改，
+// 重新排序后需要重新构建。不在数组中的键同样返回 lower bound；模型预测
+// 偏出窗口时(重复键很多或键间空隙很大时可能发生)退回到窗口外的二分查找，
+// 结果总是正确的。
+
+/** 常用的第 0 层误差上限：窗口 129 个 8 字节元素，约 16 个缓存行 */
+#define LEARNED_INDEX_DEFAULT_EPSILON 64
+
+/** 内部各层的误差上限 */
+#define LEARNED_INDEX_EPSILON_RECURSIVE 4
+
+typedef struct learned_index learned_index_t;
+
+/**
+ * @brief 在有序数组上构建索引
+ * @param epsilon 第 0 层预测位置的最大误差，0 表示精确拟合
+ * @param out 成功时写入新建的索引，用 learned_index_destroy 释放
+ * @param stats _ex 版本在其中报告构建耗时(time_elapsed_ms)和索引字节数(max_mamory_used)
+ */
+extern sort_result_t learned_index_build_int64(const int64_t *sorted, size_t arr_len, size_t epsilon, learned_index_t **out);
+extern sort_result_t learned_index_build_int64_ex(const int64_t *sorted, size_t arr_len, size_t epsilon, learned_index_t **out, sort_stats_t *stats);
+extern sort_result_t learned_index_build_uint64(const uint64_t *sorted, size_t arr_len, size_t epsilon, learned_index_t **out);
+extern sort_result_t learned_index_build_uint64_ex(const uint64_t *sorted, size_t arr_len, size_t epsilon, learned_index_t **out, sort_stats_t *stats);
+
+extern void learned_index_destroy(learned_index_t *index);
+
+/** 第 0 层的段数 */
+extern size_t learned_index_segments(const learned_index_t *index);
+
+/** 层数(含第 0 层) */
+extern size_t learned_index_levels(const learned_index_t *index);
+
+/** 索引本身占用的字节数，不含数据数组 */
+extern size_t learned_index_memory_bytes(const learned_index_t *index);
+
+/**
+ * 第一个不小于 key 的元素下标，不存在时返回数组长度。
+ * 批量版本先为 SEARCH_BATCH_WIDTH 个查询求出预测位置并预取各自的窗口，
+ * 再在等长的窗口里同步二分。
+ */
+extern size_t learned_index_lower_bound_int64(const learned_index_t *index, int64_t key);
+extern void learned_index_lower_bound_int64_batch(const learned_index_t *index, const int64_t *keys, size_t num_keys, size_t *out);
+
+extern size_t learned_index_lower_bound_uint64(const learned_index_t *index, uint64_t key);
+extern void learned_index_lower_bound_uint64_batch(const learned_index_t *index, const uint64_t *keys, size_t num_keys, size_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // LEARNED_INDEX_H
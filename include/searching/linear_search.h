@@ -0,0 +1,83 @@
+#ifndef LINEAR_SEARCH_H
+#define LINEAR_SEARCH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+#include "searching/binary_search.h"
+
+// 向量化顺序查找，面向几百个元素以内的小数组(不要求有序)。
+//
+// - 每次用 AVX2(一次 8 个 int32/float 或 4 个 int64)或 SSE(一半宽度)比较两个
+//   向量，movemask 得到位图后用 ctz/popcount 取结果，没有逐元素的分支；
+// - 运行时检测 CPU 选择 AVX2、SSE(int32/float 用 SSE2，int64 需要 SSE4.2)
+//   或标量实现，也可以用 linear_search_set_simd_level 指定，便于测试和对比；
+// - 小的有序数组上，顺序扫描的访存是连续的，没有二分查找每一步之间的
+//   数据依赖，在一定规模以下比二分查找快。这个分界点与 CPU 有关，
+//   adaptive_upper_bound_T 按 linear_search_crossover_bytes() 选择两者之一，
+//   linear_search_calibrate() 在本机上实测并更新分界点。
+//
+// 浮点比较遵循 IEEE：NaN 与任何值都不相等，也不大于任何值。
+
+typedef enum
+{
+    LINEAR_SEARCH_SCALAR = 0,
+    LINEAR_SEARCH_SSE = 1,
+    LINEAR_SEARCH_AVX2 = 2,
+} linear_search_simd_t;
+
+/**
+ * 默认分界点(字节)：数组不超过这么大时 adaptive_upper_bound_T 使用顺序扫描。
+ * AVX2 上 int32 查询均匀分布时实测两者在 320 ~ 384 字节之间持平，取下端(80 个 int32)。
+ * 只有 SSE 或标量实现时分界点小得多，应调用 linear_search_calibrate
+ */
+#ifndef LINEAR_SEARCH_DEFAULT_CROSSOVER_BYTES
+#define LINEAR_SEARCH_DEFAULT_CROSSOVER_BYTES 320
+#endif
+
+/** 当前使用的指令集 */
+extern linear_search_simd_t linear_search_simd_level(void);
+
+/**
+ * @brief 指定使用的指令集，超出 CPU 支持范围时降到支持的最高一级
+ * @return 实际生效的指令集
+ */
+extern linear_search_simd_t linear_search_set_simd_level(linear_search_simd_t level);
+
+extern size_t linear_search_crossover_bytes(void);
+extern void linear_search_set_crossover_bytes(size_t bytes);
+
+/**
+ * @brief 在本机上对比有序 int32 数组上顺序扫描与二分查找的耗时，
+ *        取顺序扫描仍不慢于二分查找的最大数组字节数作为新的分界点
+ * @return 新的分界点(字节)，耗时为毫秒级
+ */
+extern size_t linear_search_calibrate(void);
+
+/**
+ * linear_find_T:               第一个等于 key 的元素下标，不存在时返回 SEARCH_NOT_FOUND
+ * linear_count_T:              等于 key 的元素个数
+ * linear_find_first_greater_T: 第一个大于 key 的元素下标，不存在时返回 arr_len；
+ *                              有序数组上即 upper bound
+ * adaptive_upper_bound_T:      有序数组上的 upper bound，按分界点选择顺序扫描或二分查找
+ */
+extern size_t linear_find_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern size_t linear_count_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern size_t linear_find_first_greater_int32(const int32_t *arr, size_t arr_len, int32_t key);
+extern size_t adaptive_upper_bound_int32(const int32_t *arr, size_t arr_len, int32_t key);
+
+extern size_t linear_find_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern size_t linear_count_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern size_t linear_find_first_greater_int64(const int64_t *arr, size_t arr_len, int64_t key);
+extern size_t adaptive_upper_bound_int64(const int64_t *arr, size_t arr_len, int64_t key);
+
+extern size_t linear_find_float(const float *arr, size_t arr_len, float key);
+extern size_t linear_count_float(const float *arr, size_t arr_len, float key);
+extern size_t linear_find_first_greater_float(const float *arr, size_t arr_len, float key);
+extern size_t adaptive_upper_bound_float(const float *arr, size_t arr_len, float key);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // LINEAR_SEARCH_H
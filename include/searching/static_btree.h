@@ -0,0 +1,80 @@
+#ifndef STATIC_BTREE_H
+#define STATIC_BTREE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 静态 B+ 树(S-tree)：有序数组上的只读索引，一次构建后反复查询。
+//
+// - 每个节点正好是一个 64 字节缓存行：int32/float 16 个键，int64/double 8 个键，
+//   内部节点有 B+1 个孩子，整棵树隐式存放(没有指针)，按层连续排列；
+// - 叶子层是原数组的副本(末尾用最大值补齐)，叶子按顺序相连，lower bound
+//   的结果就是原有序数组的下标，范围扫描直接顺序读叶子层；
+// - 节点内用 AVX2 一次比较 8 个键，两条指令比完一个节点，数出小于 key 的
+//   键的个数即下一层的孩子编号；CPU 不支持 AVX2 时退回标量计数；
+// - 每次查询的访存次数为树高 log_{B+1}(n/B)+1，1 亿个 int32 时为 7 次，
+//   而二分查找约为 27 次，其中上面几层常驻缓存。
+//
+// 内存开销：叶子层约 n 个元素，内部节点约为叶子层的 1/B。
+// 构建是一趟顺序扫描，_ex 版本在 stats 中报告耗时(time_elapsed_ms)和
+// 索引占用的字节数(max_mamory_used)，stree_memory_bytes() 也可以随时查询。
+//
+// 输入须按 < 升序排列(可以有重复)，浮点数组不能含 NaN。
+// 树只能用与构建时相同类型的函数查询。
+
+typedef struct stree stree_t;
+
+/**
+ * @brief 从有序数组构建索引，数组在构建后可以释放
+ * @param out 成功时写入新建的树，用 stree_destroy 释放
+ */
+extern sort_result_t stree_build_int32(const int32_t *sorted, size_t arr_len, stree_t **out);
+extern sort_result_t stree_build_int32_ex(const int32_t *sorted, size_t arr_len, stree_t **out, sort_stats_t *stats);
+extern sort_result_t stree_build_int64(const int64_t *sorted, size_t arr_len, stree_t **out);
+extern sort_result_t stree_build_int64_ex(const int64_t *sorted, size_t arr_len, stree_t **out, sort_stats_t *stats);
+extern sort_result_t stree_build_float(const float *sorted, size_t arr_len, stree_t **out);
+extern sort_result_t stree_build_float_ex(const float *sorted, size_t arr_len, stree_t **out, sort_stats_t *stats);
+extern sort_result_t stree_build_double(const double *sorted, size_t arr_len, stree_t **out);
+extern sort_result_t stree_build_double_ex(const double *sorted, size_t arr_len, stree_t **out, sort_stats_t *stats);
+
+extern void stree_destroy(stree_t *tree);
+
+/** 索引中的元素个数 */
+extern size_t stree_size(const stree_t *tree);
+
+/** 索引占用的字节数(叶子层加内部节点) */
+extern size_t stree_memory_bytes(const stree_t *tree);
+
+/**
+ * 第一个不小于 key 的元素在原有序数组中的下标，不存在时返回元素个数。
+ * 批量版本交错执行 SEARCH_BATCH_WIDTH 个查询，每层为每个查询预取下一个节点。
+ *
+ * 范围查询求 [lo, hi) 内的元素，结果为原数组下标区间 [*begin, *end)，
+ * 元素本身可以从 stree_keys_T() 返回的叶子层顺序读取。
+ */
+extern size_t stree_lower_bound_int32(const stree_t *tree, int32_t key);
+extern void stree_lower_bound_int32_batch(const stree_t *tree, const int32_t *keys, size_t num_keys, size_t *out);
+extern void stree_range_int32(const stree_t *tree, int32_t lo, int32_t hi, size_t *begin, size_t *end);
+extern const int32_t *stree_keys_int32(const stree_t *tree);
+
+extern size_t stree_lower_bound_int64(const stree_t *tree, int64_t key);
+extern void stree_lower_bound_int64_batch(const stree_t *tree, const int64_t *keys, size_t num_keys, size_t *out);
+extern void stree_range_int64(const stree_t *tree, int64_t lo, int64_t hi, size_t *begin, size_t *end);
+extern const int64_t *stree_keys_int64(const stree_t *tree);
+
+extern size_t stree_lower_bound_float(const stree_t *tree, float key);
+extern void stree_lower_bound_float_batch(const stree_t *tree, const float *keys, size_t num_keys, size_t *out);
+extern void stree_range_float(const stree_t *tree, float lo, float hi, size_t *begin, size_t *end);
+extern const float *stree_keys_float(const stree_t *tree);
+
+extern size_t stree_lower_bound_double(const stree_t *tree, double key);
+extern void stree_lower_bound_double_batch(const stree_t *tree, const double *keys, size_t num_keys, size_t *out);
+extern void stree_range_double(const stree_t *tree, double lo, double hi, size_t *begin, size_t *end);
+extern const double *stree_keys_double(const stree_t *tree);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // STATIC_BTREE_H
@@ -0,0 +1,53 @@
+#ifndef BATCH_SORT_H
+#define BATCH_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 批量排序：一次调用排序许多互相独立的小数组。
+//
+// 各段以 CSR 形式描述：第 i 段是 arr[offsets[i], offsets[i + 1])，offsets
+// 共 num_segments + 1 项且单调不减，offsets[0] 不必为 0。
+//
+// - 参数只检查一次，暂存空间每个任务只准备一次；
+// - 段按内存顺序划成约 256 KiB 的窗口，窗口内按长度分级(counting sort 出
+//   处理顺序)：不超过 SORTING_NETWORK_MAX 的段按确切长度分组，同一个排序
+//   网络连续执行；更长的段按 2 的幂分级，交给 pdqsort 的主循环
+//   (generic_quick_sort_with_buffer_ex)。只在窗口内分级是为了不打乱顺序访问；
+// - 总元素数达到并行排序的顺序阈值(parallel_sort_get_cutoff)且全局线程池
+//   可用时，按估计工作量 len * log2(len) 把处理顺序切成若干连续区间并行
+//   执行；单段长度达到阈值时单独用 generic_parallel_sort 排序。
+// 每段内的排序不稳定。
+
+/**
+ * @brief 排序 arr 中由 offsets 描述的每一段
+ * @param offsets num_segments + 1 个单调不减的下标
+ * @param results 可以为 NULL；不为 NULL 时写入每段的排序结果
+ * @return offsets 不单调时返回 SORT_ERROR_INVALID_ARGUMENT 且不修改任何数据；
+ *         否则返回第一个失败段的错误码，全部成功时返回 SORT_SUCCESS
+ */
+extern sort_result_t generic_sort_batch(
+    void *arr,
+    const size_t *offsets,
+    size_t num_segments,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_result_t *results
+);
+
+/** 同 generic_sort_batch，stats 不为 NULL 时记录整批的耗时和计数，array_length 为各段长度之和 */
+extern sort_result_t generic_sort_batch_ex(
+    void *arr,
+    const size_t *offsets,
+    size_t num_segments,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_result_t *results,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BATCH_SORT_H
@@ -0,0 +1,58 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 外部排序：对放不进内存的定长记录文件排序。
+//
+// 1. 生成初始 run：每次读入内存预算能容纳的记录，用并行排序(线程池
+//    未初始化时退化为顺序排序)排好后追加写入临时文件；
+// 2. 多路归并：按预算算出最少的归并趟数 p，再取满足 k^p >= run 数的
+//    最小路数 k，让每一路的读缓冲尽量大。用败者树做 k 路归并，每次
+//    pread 一整块，并用 posix_fadvise(WILLNEED) 提前让内核预读下一块；
+// 3. 最后一趟直接写到输出文件。数据能整体放进预算时不产生临时文件。
+//
+// 临时文件用 mkstemp 创建后立即 unlink，进程异常退出也不会残留。
+// 输出路径可以与输入路径相同。
+
+#ifndef EXTERNAL_SORT_DEFAULT_BUDGET
+#define EXTERNAL_SORT_DEFAULT_BUDGET ((size_t)256 << 20)
+#endif
+
+// 归并时每一路读缓冲的下限(字节)，只用来限制最大路数；确定趟数后
+// 剩余预算全部分给各路缓冲。预算不足 3 块时按预算的 1/3 缩小
+#ifndef EXTERNAL_SORT_MIN_BLOCK
+#define EXTERNAL_SORT_MIN_BLOCK ((size_t)4 << 10)
+#endif
+
+typedef struct
+{
+    size_t memory_budget; /**< 数据缓冲区总字节数，0 表示 EXTERNAL_SORT_DEFAULT_BUDGET。
+                               排序算法自身的辅助空间也计入预算，内核页缓存不计入 */
+    const char *temp_dir; /**< 临时文件目录，NULL 表示 $TMPDIR，未设置时为 /tmp */
+    int stable;           /**< 非 0 时保持相等记录的输入顺序 */
+} external_sort_options_t;
+
+/**
+ * @brief 对 input_path 中的定长记录排序并写入 output_path
+ * @param record_size 每条记录的字节数，文件长度必须是它的整数倍
+ * @param options 可以为 NULL，使用默认值
+ * @param stats 不为 NULL 时记录耗时、读写字节数和归并趟数
+ * @return 文件读写失败返回 SORT_ERROR_IO，文件长度不是记录大小的整数倍返回
+ *         SORT_ERROR_INVALID_LENGTH，预算不足 3 条记录返回 SORT_ERROR_INVALID_ARGUMENT
+ */
+extern sort_result_t generic_external_sort(
+    const char *input_path,
+    const char *output_path,
+    size_t record_size,
+    compare_func_t cmp,
+    const external_sort_options_t *options,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,31 @@
+#ifndef HEAP_SORT_H
+#define HEAP_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 堆排序：先自底向上建立大顶堆，再不断把堆顶交换到数组末尾并下沉。
+// 最坏情况 O(n log n)，不需要额外内存，但不稳定。快速排序在递归
+// 退化时以它作为兜底。
+
+extern sort_result_t generic_heap_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/** 同 generic_heap_sort，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_heap_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // HEAP_SORT_H
@@ -0,0 +1,63 @@
+#ifndef INDIRECT_SORT_H
+#define INDIRECT_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 间接排序：只排序指针或下标，不移动元素本身。元素很大(KB 级)时，
+// 排序过程中的内存访问从 O(n log n * element_size) 降到 O(n log n)
+// 个指针，最后需要时再用 apply_permutation 一次性把元素移动到位，
+// 元素总共只移动 O(n * element_size) 字节。
+//
+// 排序算法可以是任意与 generic_quick_sort 签名相同的算法，为 NULL 时
+// 使用 generic_quick_sort。使用稳定的算法(如 generic_merge_sort)时，
+// 相等元素保持原来的相对顺序。比较函数 cmp 比较的是元素本身。
+
+typedef sort_result_t generic_sort_func_t(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/**
+ * 按指针指向的元素排序指针数组，元素本身保持不动。
+ */
+extern sort_result_t generic_sort_pointers(
+    void *ptr_arr[],
+    size_t arr_len,
+    compare_func_t cmp,
+    generic_sort_func_t *sort
+);
+
+/**
+ * 计算排序后的下标序列：indices[i] 为排序后第 i 个元素在 arr 中的下标，
+ * arr 本身不被修改。
+ */
+extern sort_result_t generic_argsort(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    generic_sort_func_t *sort,
+    size_t *indices
+);
+
+/**
+ * 按下标序列原地重排元素，完成后 arr[i] 为原来的 arr[perm[i]]。
+ * 沿置换的环移动元素，每个元素只移动一次，只需一个元素和 n 位的额外空间。
+ * perm 不是 [0, arr_len) 的一个排列时返回 SORT_ERROR_INVALID_ARGUMENT，
+ * arr 保持不变。
+ */
+extern sort_result_t apply_permutation(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const size_t *perm
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // INDIRECT_SORT_H
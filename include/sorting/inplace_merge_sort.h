@@ -0,0 +1,69 @@
+#ifndef INPLACE_MERGE_SORT_H
+#define INPLACE_MERGE_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 稳定的原地归并排序，只使用 O(√n) 个元素的辅助空间，适合内存受限的调用方。
+//
+// - 长度为 INPLACE_MERGE_SORT_RUN_LENGTH 的小段先插入排序，再自底向上归并；
+// - 归并时较短的一侧放得进辅助空间就复制出来线性归并；
+// - 两侧都放不下时用 SymMerge(Kim & Kutzner)：二分找出分割点，旋转中间
+//   两块，把一次归并拆成两次更小的归并，直到能用辅助空间完成。
+//   比较次数为 O(m log(n/m + 1))，整个排序 O(n log n) 次比较；
+// - 旋转时较短的一块放得进辅助空间就借助它搬移，否则用三次反转。
+//
+// 辅助空间为 ceil(√n) 个元素，记入 sort_stats_t 的 max_mamory_used；
+// _with_buffer 版本使用调用方给出的空间，不分配任何内存。
+// 相同元素保持原来的相对顺序。
+
+#ifndef INPLACE_MERGE_SORT_RUN_LENGTH
+#define INPLACE_MERGE_SORT_RUN_LENGTH 16
+#endif
+
+extern sort_result_t generic_inplace_merge_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/** 同上，stats 不为 NULL 时记录耗时、计数和辅助空间峰值 */
+extern sort_result_t generic_inplace_merge_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+/**
+ * @brief 使用调用方提供的辅助空间排序，排序过程中不分配内存
+ * @param buffer 至少 buffer_len 个元素，不能与 arr 重叠
+ * @param buffer_len 至少为 1；越大归并越快，达到 arr_len / 2 后不再有区别
+ */
+extern sort_result_t generic_inplace_merge_sort_with_buffer(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    size_t buffer_len
+);
+
+/** 同上，把比较和移动计数累加到 stats(不计时、不清零) */
+extern sort_result_t generic_inplace_merge_sort_with_buffer_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    size_t buffer_len,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // INPLACE_MERGE_SORT_H
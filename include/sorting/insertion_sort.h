@@ -18,6 +18,65 @@ extern "C"
         size_t element_size,
         compare_func_t cmp);
 
+    /** 同上，stats 不为 NULL 时记录耗时和计数 */
+    extern sort_result_t generic_insertion_sort_ex(
+        void *ptr_arr[],
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        sort_stats_t *stats);
+
+    extern sort_result_t generic_insertion_sort_with_binary_search_ex(
+        void *ptr_arr[],
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        sort_stats_t *stats);
+
+    /**
+     * 连续数组上的插入排序，供分治排序处理小区间时使用。
+     * tmp 由调用方提供(至少 element_size 字节)，避免在热路径上 malloc。
+     * 找到插入位置后一次 memmove 整段后移，排序是稳定的。
+     */
+    extern sort_result_t generic_insertion_sort_with_buffer(
+        void *arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        void *tmp);
+
+    /** 同上，把比较和移动计数累加到 stats(不计时、不清零)，供其他排序的小区间调用 */
+    extern sort_result_t generic_insertion_sort_with_buffer_ex(
+        void *arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        void *tmp,
+        sort_stats_t *stats);
+
+    /**
+     * 连续数组上的二分插入排序，arr[0, start) 需已有序，从 start 开始逐个插入。
+     * 插入位置取相等元素之后(upper bound)，排序是稳定的。
+     * 比较次数为 O(n log n)，适合比较代价高于移动代价的场景(如 TimSort 补齐短 run)。
+     */
+    extern sort_result_t generic_binary_insertion_sort_with_buffer(
+        void *arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        size_t start,
+        void *tmp);
+
+    /** 同上，把比较和移动计数累加到 stats(不计时、不清零) */
+    extern sort_result_t generic_binary_insertion_sort_with_buffer_ex(
+        void *arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        size_t start,
+        void *tmp,
+        sort_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
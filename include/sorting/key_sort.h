@@ -0,0 +1,39 @@
+#ifndef KEY_SORT_H
+#define KEY_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 键提取排序：比较代价很高时(解析字段、长前缀的 strcmp 等)，先对每个
+// 元素调用一次 key 提取定长的 uint64_t 键，对紧凑的 (键, 下标) 对做
+// 基数排序，只在键相同时才调用完整的比较函数，最后按下标序列一次性
+// 移动元素。
+//
+// key 必须与 cmp 保序：key(a) < key(b) 时必须有 cmp(a, b) < 0。
+// 常见做法是取字符串前 8 字节按大端拼成整数，或把数值映射为保序整数。
+// 排序是稳定的。
+
+/** 键提取函数，返回元素的定长键 */
+typedef uint64_t sort_key_func_t(const void *const elem);
+
+/**
+ * 按 key 提取的键排序，键相同时用 cmp 决定顺序；cmp 为 NULL 时只按键排序。
+ * stats 不为 NULL 时记录完整比较次数 comparisons 和相对 n*log2(n) 次
+ * 比较估计省去的次数 comparisons_avoided；额外内存只在定义了
+ * PRINT_SORTING_INFO 时记录。
+ */
+extern sort_result_t generic_key_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    sort_key_func_t *key,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // KEY_SORT_H
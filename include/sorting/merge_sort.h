@@ -6,6 +6,16 @@ extern "C" {
 #endif
 #include "sort_common.h"
 
+// 自顶向下归并排序。整个排序只使用一块 n 个元素的辅助空间：
+// 先把数据复制一份到辅助空间，之后每一层递归交替使用原数组和辅助
+// 空间作为源和目的(ping-pong)，归并时不再把左右两半复制出来。
+// 长度不超过 MERGE_SORT_RUN_LENGTH 的区间直接在目的数组上插入排序。
+// 排序是稳定的。
+
+#ifndef MERGE_SORT_RUN_LENGTH
+#define MERGE_SORT_RUN_LENGTH 16
+#endif
+
     extern sort_result_t generic_merge_sort(
         void* arr,
         size_t arr_len,
@@ -13,7 +23,35 @@ extern "C" {
         compare_func_t cmp
     );
 
+    /**
+     * 使用调用方提供的辅助空间进行归并排序，排序过程中不再分配内存。
+     * buffer 至少需要 arr_len * element_size 字节，且不能与 arr 重叠。
+     */
+    extern sort_result_t generic_merge_sort_with_buffer(
+        void* arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        void* buffer
+    );
+
+    /** 同 generic_merge_sort，stats 不为 NULL 时记录耗时和计数 */
+    extern sort_result_t generic_merge_sort_ex(
+        void* arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        sort_stats_t* stats
+    );
 
+    extern sort_result_t generic_merge_sort_with_buffer_ex(
+        void* arr,
+        size_t arr_len,
+        size_t element_size,
+        compare_func_t cmp,
+        void* buffer,
+        sort_stats_t* stats
+    );
 
 #ifdef __cplusplus
 }
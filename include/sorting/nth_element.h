@@ -0,0 +1,72 @@
+#ifndef NTH_ELEMENT_H
+#define NTH_ELEMENT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 选择算法：只需要第 k 小的元素、中位数/分位数或前 k 小时，
+// 不必为整体排序付出 O(n log n)。
+//
+// - generic_nth_element 用 introselect：与快速排序相同的三数/九数取中
+//   和 Hoare 划分，但每次只进入包含 nth 的一侧，期望 O(n)；划分次数超过
+//   2·log2(n) 时改用中位数的中位数(median-of-medians)选枢轴并三路划分，
+//   保证最坏 O(n)。不需要额外内存，不稳定。
+// - generic_partial_sort 先选出第 k 小，再只对前 k - 1 个排序，
+//   总代价 O(n + k log k)。
+
+#ifndef NTH_ELEMENT_INSERTION_THRESHOLD
+#define NTH_ELEMENT_INSERTION_THRESHOLD 16
+#endif
+
+/**
+ * @brief 重排数组，使 arr[nth] 恰好是排序后位于该位置的元素，
+ *        且 [0, nth) 中的元素都不大于它，(nth, arr_len) 中的元素都不小于它
+ * @param nth 目标下标，必须小于 arr_len
+ * @return nth >= arr_len 时返回 SORT_ERROR_INVALID_ARGUMENT
+ */
+extern sort_result_t generic_nth_element(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t nth
+);
+
+/** 同 generic_nth_element，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_nth_element_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t nth,
+    sort_stats_t *stats
+);
+
+/**
+ * @brief 把最小的 k 个元素按升序放到 arr[0, k)，其余元素顺序不确定
+ * @param k 0 <= k <= arr_len，k == arr_len 时等价于完整排序
+ * @return k > arr_len 时返回 SORT_ERROR_INVALID_ARGUMENT
+ */
+extern sort_result_t generic_partial_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t k
+);
+
+/** 同 generic_partial_sort，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_partial_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t k,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // NTH_ELEMENT_H
@@ -0,0 +1,78 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 基于工具包全局线程池(见 util/thread_pool.h)的并行排序。
+// algorithms_init() 之前、线程池只有一个线程或数组长度小于顺序阈值时，
+// 直接退化为对应的顺序算法。
+//
+// generic_parallel_sort：并行样本排序(samplesort)。随机抽样并排序得到
+// 分割元素，各线程并行地把自己负责的块按分割元素分类计数，再并行分发到
+// 辅助空间的各个桶中，最后并行地用 generic_quick_sort 排序每个桶并拷回。
+// 与分割元素相等的元素单独成桶且无需再排序，大量重复键时也能均衡负载。
+// 不稳定，需要 n 个元素加 n 字节的辅助空间。
+//
+// generic_parallel_stable_sort：并行归并排序。各线程先用
+// generic_merge_sort_with_buffer 排序自己的块，然后逐层两两归并；每次
+// 归并按 merge path 切分输出，二分查找每段在两个输入中的起点，使各段
+// 可以独立地并行归并。稳定，需要 n 个元素的辅助空间。
+
+#ifndef PARALLEL_SORT_SEQUENTIAL_CUTOFF
+#define PARALLEL_SORT_SEQUENTIAL_CUTOFF 16384
+#endif
+
+/**
+ * @brief 设置顺序阈值，长度小于该值的数组不再并行，0 表示恢复默认值
+ */
+extern void parallel_sort_set_cutoff(size_t cutoff);
+
+extern size_t parallel_sort_get_cutoff(void);
+
+/**
+ * @brief 按当前全局线程池和顺序阈值排序 arr_len 个元素时，同时占用的辅助空间字节数上界
+ * @param stable 非 0 时对应 generic_parallel_stable_sort
+ * 用于在给定的内存预算内确定一次排序的元素数，见 external_sort
+ */
+extern size_t parallel_sort_scratch_bytes(size_t arr_len, size_t element_size, int stable);
+
+extern sort_result_t generic_parallel_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+extern sort_result_t generic_parallel_stable_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/**
+ * 同上，stats 不为 NULL 时记录墙上时间和计数。各任务先计入自己的局部
+ * 统计，全部完成后再汇总，计数过程中没有线程间共享写。
+ */
+extern sort_result_t generic_parallel_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+extern sort_result_t generic_parallel_stable_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // PARALLEL_SORT_H
@@ -0,0 +1,104 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 基数排序，按 8 位一个数字(256 个桶)处理 32/64 位定长键。
+//
+// LSD(低位优先)版本：
+// - 一次遍历同时统计所有数字位的直方图；
+// - 所有元素在某一位上都相同时跳过该位(例如取值范围较小的整数的高位)；
+// - 在原数组和 n 个元素的辅助空间之间来回分发(ping-pong)，最后一次
+//   若落在辅助空间再拷回；
+// - 稳定。
+//
+// MSD(高位优先) American flag 版本：按桶原地循环交换，只需要直方图
+// 大小的额外空间，小桶改用插入排序。不稳定。
+//
+// 有符号整数翻转符号位、IEEE 浮点数按符号翻转全部位或符号位，转换为
+// 保序的无符号键后再排序。浮点数的 -0.0 排在 +0.0 之前，NaN 按位模式
+// 排在两端。
+
+typedef enum
+{
+    RADIX_KEY_UINT32 = 0,
+    RADIX_KEY_INT32,
+    RADIX_KEY_FLOAT,
+    RADIX_KEY_UINT64,
+    RADIX_KEY_INT64,
+    RADIX_KEY_DOUBLE,
+} radix_key_type_t;
+
+/* 纯键数组，LSD，内部分配 n 个元素的辅助空间 */
+extern sort_result_t radix_sort_uint32(uint32_t *arr, size_t arr_len);
+extern sort_result_t radix_sort_int32(int32_t *arr, size_t arr_len);
+extern sort_result_t radix_sort_float(float *arr, size_t arr_len);
+extern sort_result_t radix_sort_uint64(uint64_t *arr, size_t arr_len);
+extern sort_result_t radix_sort_int64(int64_t *arr, size_t arr_len);
+extern sort_result_t radix_sort_double(double *arr, size_t arr_len);
+
+/**
+ * 对 element_size 大小的记录按位于 key_offset 处、类型为 key_type 的键
+ * 做 LSD 基数排序(稳定)。记录就是键本身时等价于上面的类型化接口。
+ */
+extern sort_result_t generic_radix_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type
+);
+
+/**
+ * 同 generic_radix_sort，使用调用方提供的辅助空间，
+ * buffer 至少需要 arr_len * element_size 字节，且不能与 arr 重叠。
+ */
+extern sort_result_t generic_radix_sort_with_buffer(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    void *buffer
+);
+
+/**
+ * MSD American flag 原地基数排序，不需要 O(n) 的辅助空间，不稳定。
+ */
+extern sort_result_t generic_radix_sort_inplace(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type
+);
+
+/**
+ * 同 generic_radix_sort / generic_radix_sort_inplace，stats 不为 NULL 时
+ * 记录耗时和移动次数。基数排序不做比较，comparisons 始终为 0。
+ */
+extern sort_result_t generic_radix_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    sort_stats_t *stats
+);
+
+extern sort_result_t generic_radix_sort_inplace_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // RADIX_SORT_H
@@ -18,6 +18,15 @@ extern sort_result_t generic_shell_sort(
     size_t element_size,
     compare_func_t cmp
 );
+
+/** 同 generic_shell_sort，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_shell_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
  
 
 #ifdef __cplusplus
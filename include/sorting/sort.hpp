@@ -0,0 +1,486 @@
+/**
+ * @file sort.hpp
+ * @brief 排序算法的 C++ 模板版本(header-only, C++17)
+ *
+ * 与 src/sorting 下的 C 实现使用相同的算法，但按元素类型和比较器实例化：
+ * 比较器可以被内联，元素移动是普通的赋值/移动而不是按 element_size
+ * 调用 memcpy。C 接口保持不变，供需要稳定 ABI 的调用方使用。
+ *
+ * 比较器语义与 std::sort 相同：comp(a, b) 在 a 应排在 b 之前时返回 true。
+ */
+
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace algo
+{
+
+    namespace detail
+    {
+        constexpr std::size_t quick_sort_insertion_threshold = 24;
+        constexpr std::size_t quick_sort_ninther_threshold = 128;
+        constexpr std::size_t partial_insertion_sort_limit = 8;
+        constexpr std::size_t merge_sort_run_length = 16;
+
+        template <typename T, typename Compare>
+        inline void insertion_sort(T *first, T *last, Compare &comp)
+        {
+            if (first == last)
+            {
+                return;
+            }
+            for (T *cur = first + 1; cur != last; ++cur)
+            {
+                if (!comp(*cur, *(cur - 1)))
+                {
+                    continue;
+                }
+                T tmp = std::move(*cur);
+                T *pos = cur;
+                do
+                {
+                    *pos = std::move(*(pos - 1));
+                    --pos;
+                } while (pos != first && comp(tmp, *(pos - 1)));
+                *pos = std::move(tmp);
+            }
+        }
+
+        template <typename T, typename Compare>
+        inline bool partial_insertion_sort(T *first, T *last, Compare &comp)
+        {
+            if (first == last)
+            {
+                return true;
+            }
+            std::size_t moved = 0;
+            for (T *cur = first + 1; cur != last; ++cur)
+            {
+                if (!comp(*cur, *(cur - 1)))
+                {
+                    continue;
+                }
+                T tmp = std::move(*cur);
+                T *pos = cur;
+                do
+                {
+                    *pos = std::move(*(pos - 1));
+                    --pos;
+                } while (pos != first && comp(tmp, *(pos - 1)));
+                *pos = std::move(tmp);
+                moved += static_cast<std::size_t>(cur - pos);
+                if (moved > partial_insertion_sort_limit)
+                {
+                    return cur + 1 == last;
+                }
+            }
+            return true;
+        }
+
+        template <typename T, typename Compare>
+        inline void sift_down(T *arr, std::size_t root, std::size_t heap_len, Compare &comp)
+        {
+            T value = std::move(arr[root]);
+            for (;;)
+            {
+                std::size_t child = 2 * root + 1;
+                if (child >= heap_len)
+                {
+                    break;
+                }
+                if (child + 1 < heap_len && comp(arr[child], arr[child + 1]))
+                {
+                    child++;
+                }
+                if (!comp(value, arr[child]))
+                {
+                    break;
+                }
+                arr[root] = std::move(arr[child]);
+                root = child;
+            }
+            arr[root] = std::move(value);
+        }
+
+        template <typename T, typename Compare>
+        inline void heap_sort(T *arr, std::size_t arr_len, Compare &comp)
+        {
+            if (arr_len <= 1)
+            {
+                return;
+            }
+            for (std::size_t i = arr_len / 2; i > 0; i--)
+            {
+                sift_down(arr, i - 1, arr_len, comp);
+            }
+            for (std::size_t end = arr_len - 1; end > 0; end--)
+            {
+                std::swap(arr[0], arr[end]);
+                sift_down(arr, 0, end, comp);
+            }
+        }
+
+        template <typename T, typename Compare>
+        inline void sort2(T *a, T *b, Compare &comp)
+        {
+            if (comp(*b, *a))
+            {
+                std::swap(*a, *b);
+            }
+        }
+
+        template <typename T, typename Compare>
+        inline void sort3(T *a, T *b, T *c, Compare &comp)
+        {
+            sort2(a, b, comp);
+            sort2(b, c, comp);
+            sort2(a, b, comp);
+        }
+
+        template <typename T, typename Compare>
+        inline T *partition_right(T *begin, T *end, Compare &comp, bool &already_partitioned)
+        {
+            T pivot = std::move(*begin);
+            T *first = begin;
+            T *last = end;
+
+            while (comp(*++first, pivot))
+            {
+            }
+            if (first - 1 == begin)
+            {
+                while (first < last && !comp(*--last, pivot))
+                {
+                }
+            }
+            else
+            {
+                while (!comp(*--last, pivot))
+                {
+                }
+            }
+
+            already_partitioned = first >= last;
+            while (first < last)
+            {
+                std::swap(*first, *last);
+                while (comp(*++first, pivot))
+                {
+                }
+                while (!comp(*--last, pivot))
+                {
+                }
+            }
+
+            T *pivot_pos = first - 1;
+            *begin = std::move(*pivot_pos);
+            *pivot_pos = std::move(pivot);
+            return pivot_pos;
+        }
+
+        template <typename T, typename Compare>
+        inline T *partition_left(T *begin, T *end, Compare &comp)
+        {
+            T pivot = std::move(*begin);
+            T *first = begin;
+            T *last = end;
+
+            while (comp(pivot, *--last))
+            {
+            }
+            if (last + 1 == end)
+            {
+                while (first < last && !comp(pivot, *++first))
+                {
+                }
+            }
+            else
+            {
+                while (!comp(pivot, *++first))
+                {
+                }
+            }
+
+            while (first < last)
+            {
+                std::swap(*first, *last);
+                while (comp(pivot, *--last))
+                {
+                }
+                while (!comp(pivot, *++first))
+                {
+                }
+            }
+
+            *begin = std::move(*last);
+            *last = std::move(pivot);
+            return last;
+        }
+
+        template <typename T>
+        inline void break_patterns(T *begin, T *end, std::size_t size)
+        {
+            if (size < quick_sort_insertion_threshold)
+            {
+                return;
+            }
+            std::size_t q = size / 4;
+            std::swap(begin[0], begin[q]);
+            std::swap(end[-1], *(end - q));
+            if (size > quick_sort_ninther_threshold)
+            {
+                std::swap(begin[1], begin[q + 1]);
+                std::swap(begin[2], begin[q + 2]);
+                std::swap(end[-2], *(end - (q + 1)));
+                std::swap(end[-3], *(end - (q + 2)));
+            }
+        }
+
+        template <typename T, typename Compare>
+        void pdq_sort_loop(T *begin, T *end, Compare &comp, std::size_t bad_allowed, bool leftmost)
+        {
+            for (;;)
+            {
+                std::size_t size = static_cast<std::size_t>(end - begin);
+                if (size < quick_sort_insertion_threshold)
+                {
+                    insertion_sort(begin, end, comp);
+                    return;
+                }
+
+                T *mid = begin + size / 2;
+                if (size > quick_sort_ninther_threshold)
+                {
+                    sort3(begin, mid, end - 1, comp);
+                    sort3(begin + 1, mid - 1, end - 2, comp);
+                    sort3(begin + 2, mid + 1, end - 3, comp);
+                    sort3(mid - 1, mid, mid + 1, comp);
+                    std::swap(*begin, *mid);
+                }
+                else
+                {
+                    sort3(mid, begin, end - 1, comp);
+                }
+
+                if (!leftmost && !comp(*(begin - 1), *begin))
+                {
+                    begin = partition_left(begin, end, comp) + 1;
+                    continue;
+                }
+
+                bool already_partitioned = false;
+                T *pivot_pos = partition_right(begin, end, comp, already_partitioned);
+                std::size_t l_size = static_cast<std::size_t>(pivot_pos - begin);
+                std::size_t r_size = static_cast<std::size_t>(end - pivot_pos) - 1;
+
+                if (l_size < size / 8 || r_size < size / 8)
+                {
+                    if (--bad_allowed == 0)
+                    {
+                        heap_sort(begin, size, comp);
+                        return;
+                    }
+                    break_patterns(begin, pivot_pos, l_size);
+                    break_patterns(pivot_pos + 1, end, r_size);
+                }
+                else if (already_partitioned &&
+                         partial_insertion_sort(begin, pivot_pos, comp) &&
+                         partial_insertion_sort(pivot_pos + 1, end, comp))
+                {
+                    return;
+                }
+
+                if (l_size < r_size)
+                {
+                    pdq_sort_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+                    begin = pivot_pos + 1;
+                    leftmost = false;
+                }
+                else
+                {
+                    pdq_sort_loop(pivot_pos + 1, end, comp, bad_allowed, false);
+                    end = pivot_pos;
+                }
+            }
+        }
+
+        inline std::size_t log2_floor(std::size_t n)
+        {
+            std::size_t log = 0;
+            while (n >>= 1)
+            {
+                log++;
+            }
+            return log;
+        }
+
+        template <typename T, typename Compare>
+        inline void merge(T *src, T *dst, std::size_t left, std::size_t mid, std::size_t right, Compare &comp)
+        {
+            if (!comp(src[mid], src[mid - 1]))
+            {
+                std::move(src + left, src + right, dst + left);
+                return;
+            }
+            std::size_t i = left, j = mid, k = left;
+            while (i < mid && j < right)
+            {
+                if (comp(src[j], src[i]))
+                {
+                    dst[k++] = std::move(src[j++]);
+                }
+                else
+                {
+                    dst[k++] = std::move(src[i++]);
+                }
+            }
+            std::move(src + i, src + mid, dst + k);
+            std::move(src + j, src + right, dst + k + (mid - i));
+        }
+
+        template <typename T, typename Compare>
+        void split_merge(T *src, T *dst, std::size_t left, std::size_t right, Compare &comp)
+        {
+            if (right - left <= merge_sort_run_length)
+            {
+                insertion_sort(dst + left, dst + right, comp);
+                return;
+            }
+            std::size_t mid = left + (right - left) / 2;
+            split_merge(dst, src, left, mid, comp);
+            split_merge(dst, src, mid, right, comp);
+            merge(src, dst, left, mid, right, comp);
+        }
+    } // namespace detail
+
+    /**
+     * @brief 插入排序，稳定，适合很短或基本有序的数组
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void insertion_sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        detail::insertion_sort(arr, arr + arr_len, comp);
+    }
+
+    /**
+     * @brief 选择排序，与 generic_selection_sort 相同，不稳定
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void selection_sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        for (std::size_t i = 0; i + 1 < arr_len; i++)
+        {
+            std::size_t min_index = i;
+            for (std::size_t j = i + 1; j < arr_len; j++)
+            {
+                if (comp(arr[j], arr[min_index]))
+                {
+                    min_index = j;
+                }
+            }
+            if (min_index != i)
+            {
+                std::swap(arr[i], arr[min_index]);
+            }
+        }
+    }
+
+    /**
+     * @brief 希尔排序，增量序列 1, 4, 13, 40, ... 与 generic_shell_sort 相同
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void shell_sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        std::size_t h = 1;
+        while (h < arr_len / 3)
+        {
+            h = 3 * h + 1;
+        }
+        for (; h >= 1; h /= 3)
+        {
+            for (std::size_t i = h; i < arr_len; i++)
+            {
+                T tmp = std::move(arr[i]);
+                std::size_t j = i;
+                for (; j >= h && comp(tmp, arr[j - h]); j -= h)
+                {
+                    arr[j] = std::move(arr[j - h]);
+                }
+                arr[j] = std::move(tmp);
+            }
+        }
+    }
+
+    /**
+     * @brief 堆排序，最坏 O(n log n)，不稳定
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void heap_sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        detail::heap_sort(arr, arr_len, comp);
+    }
+
+    /**
+     * @brief 通用排序(pdqsort)，对应 generic_quick_sort，不稳定
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        if (arr_len <= 1)
+        {
+            return;
+        }
+        detail::pdq_sort_loop(arr, arr + arr_len, comp, detail::log2_floor(arr_len), true);
+    }
+
+    /**
+     * @brief 使用调用方提供的辅助空间(至少 arr_len 个元素)做稳定排序，
+     *        对应 generic_merge_sort_with_buffer
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void stable_sort(T *arr, std::size_t arr_len, T *buffer, Compare comp = Compare())
+    {
+        if (arr_len <= 1)
+        {
+            return;
+        }
+        std::copy(arr, arr + arr_len, buffer);
+        detail::split_merge(buffer, arr, 0, arr_len, comp);
+    }
+
+    /**
+     * @brief 稳定排序(ping-pong 归并排序)，对应 generic_merge_sort
+     */
+    template <typename T, typename Compare = std::less<T>>
+    inline void stable_sort(T *arr, std::size_t arr_len, Compare comp = Compare())
+    {
+        if (arr_len <= 1)
+        {
+            return;
+        }
+        std::vector<T> buffer(arr, arr + arr_len);
+        detail::split_merge(buffer.data(), arr, 0, arr_len, comp);
+    }
+
+    template <typename T, typename Compare = std::less<T>>
+    inline void sort(std::vector<T> &vec, Compare comp = Compare())
+    {
+        algo::sort(vec.data(), vec.size(), comp);
+    }
+
+    template <typename T, typename Compare = std::less<T>>
+    inline void stable_sort(std::vector<T> &vec, Compare comp = Compare())
+    {
+        algo::stable_sort(vec.data(), vec.size(), comp);
+    }
+
+} // namespace algo
+
+#endif // SORT_HPP
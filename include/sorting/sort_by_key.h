@@ -0,0 +1,84 @@
+#ifndef SORT_BY_KEY_H
+#define SORT_BY_KEY_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/radix_sort.h"
+#include "sorting/sort_common.h"
+
+// 按键排序结构数组(SoA)：keys[] 与若干个等长的值数组按同一个排列重排，
+// 不需要先打包成结构体数组、排序后再拆开。
+//
+// - 排序阶段只移动紧凑的 (键, 下标) 对：32 位键与 32 位下标拼成一个
+//   uint64_t，64 位键为 16 字节的对；
+// - 排序完成后键按序写回，每个值数组按下标序列 gather 一遍到辅助空间再
+//   拷回，4/8/16 字节的值用定长循环，每个值只读写一次；
+// - radix_sort_by_key 使用 LSD 基数排序，总是稳定；
+// - generic_sort_by_key 用比较函数排序，键被复制进排序用的元组，比较时
+//   不再随机访问 keys[]。stable 为 0 时用 generic_parallel_sort，否则用
+//   generic_parallel_stable_sort，线程池未初始化时退化为顺序排序。
+//
+// 辅助空间为 n 个 (键, 下标) 对的两倍(比较排序为一倍加排序本身的辅助
+// 空间)与 n 个最大值元素中较大者。
+
+/** 一个值数组：data 指向 arr_len 个 element_size 字节的元素 */
+typedef struct
+{
+    void *data;
+    size_t element_size;
+} sort_value_array_t;
+
+/**
+ * @brief 按 key_type 类型的键数组做稳定的基数排序，并同步重排 values 中的每个数组
+ * @param values num_values 个值数组，num_values 为 0 时可以为 NULL
+ * @return key_type 无效时返回 SORT_ERROR_INVALID_ARGUMENT
+ */
+extern sort_result_t radix_sort_by_key(
+    void *keys,
+    size_t arr_len,
+    radix_key_type_t key_type,
+    const sort_value_array_t *values,
+    size_t num_values
+);
+
+/** 同上，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t radix_sort_by_key_ex(
+    void *keys,
+    size_t arr_len,
+    radix_key_type_t key_type,
+    const sort_value_array_t *values,
+    size_t num_values,
+    sort_stats_t *stats
+);
+
+/**
+ * @brief 用比较函数按键排序，并同步重排 values 中的每个数组
+ * @param key_size 每个键的字节数，cmp 比较的是两个键
+ * @param stable 非 0 时相等的键保持原来的相对顺序
+ */
+extern sort_result_t generic_sort_by_key(
+    void *keys,
+    size_t arr_len,
+    size_t key_size,
+    compare_func_t cmp,
+    const sort_value_array_t *values,
+    size_t num_values,
+    int stable
+);
+
+/** 同上，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_sort_by_key_ex(
+    void *keys,
+    size_t arr_len,
+    size_t key_size,
+    compare_func_t cmp,
+    const sort_value_array_t *values,
+    size_t num_values,
+    int stable,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SORT_BY_KEY_H
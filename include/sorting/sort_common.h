@@ -7,6 +7,7 @@ extern "C"
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/time.h>
 #include <time.h>
@@ -23,24 +24,79 @@ extern "C"
     SORT_ERROR_ALLOCATION_FAILED = -3,
     SORT_ERROR_THREAD_FAILED = -4,
     SORT_ERROR_INVALID_ELEMENT_SIZE = -5,
+    SORT_ERROR_INVALID_ARGUMENT = -6,
+    SORT_ERROR_IO = -7,
   } sort_result_t;
 
+  /** 硬件性能计数器种类 */
+  typedef enum
+  {
+    SORT_HW_CYCLES = 0,    /**< CPU 周期 */
+    SORT_HW_INSTRUCTIONS,  /**< 退役指令数 */
+    SORT_HW_L1D_MISSES,    /**< L1 数据缓存读缺失 */
+    SORT_HW_LLC_MISSES,    /**< 末级缓存缺失 */
+    SORT_HW_BRANCH_MISSES, /**< 分支预测失败 */
+    SORT_HW_COUNTER_COUNT,
+  } sort_hw_counter_t;
+
+  /**
+   * 一次排序期间的硬件计数(Linux perf_event_open，只统计用户态、只统计调用线程)。
+   * 内核禁止(perf_event_paranoid)、虚拟机未暴露 PMU 或未启用时对应位为 0，视为不可用。
+   */
+  typedef struct
+  {
+    uint32_t available_mask;                /**< 第 i 位为 1 表示 values[i] 有效 */
+    uint64_t values[SORT_HW_COUNTER_COUNT]; /**< 计数值，计数器被复用时已按运行时间比例放大 */
+    uint64_t snapshot[SORT_HW_COUNTER_COUNT + 2]; /**< 内部使用：开始时的原始读数和启用/运行时间 */
+  } sort_hw_counters_t;
+
   /** 排序统计信息 */
   typedef struct
   {
     size_t element_size;    /**< 元素大小(字节) */
     size_t array_length;    /**< 数组长度 */
-    clock_t start_time;     /**< 排序开始时间 */
-    clock_t end_time;       /**< 排序结束时间 */
-    double time_elapsed_ms; /**< 排序耗时(毫秒) */
+    uint64_t start_time;    /**< 排序开始时间(单调时钟，纳秒) */
+    uint64_t end_time;      /**< 排序结束时间(单调时钟，纳秒) */
+    double time_elapsed_ms; /**< 排序耗时(毫秒，墙上时间) */
     size_t comparisons;     /**< 比较次数 */
-    size_t movements;       /**< 元素移动次数 */
+    size_t comparisons_avoided; /**< 借助预先提取的键而省去的完整比较次数(估计值) */
+    size_t movements;       /**< 元素写入次数，一次交换计 2 次 */
     size_t memory_used;     /**< 使用的内存大小(字节) */
     size_t max_mamory_used; /**< 最大内存使用(字节) */
+    uint64_t io_bytes_read;    /**< 外部排序读取的字节数 */
+    uint64_t io_bytes_written; /**< 外部排序写出的字节数 */
+    size_t merge_passes;       /**< 外部排序的归并趟数，数据能整体放进内存时为 0 */
+    sort_hw_counters_t hw;  /**< 硬件计数，需先调用 sort_hw_counters_set_enabled(1) */
   } sort_stats_t;
 
   extern void print_stats(const sort_stats_t *stats);
 
+  /** CLOCK_MONOTONIC 当前时间(纳秒)。clock() 统计的是进程 CPU 时间，多线程排序时没有意义 */
+  extern uint64_t sort_monotonic_ns(void);
+
+  /**
+   * 把子任务的计数累加到 dst，供并行排序汇总各任务的局部统计。
+   * 子任务并发执行，峰值内存按各任务峰值之和计(上界)。不修改 dst 的计时字段。
+   * 硬件计数也不累加：dst 自己的读数已覆盖调用线程的整个排序过程，
+   * 工作线程上的计数只留在各任务的局部统计里。
+   */
+  extern void sort_stats_merge(sort_stats_t *dst, const sort_stats_t *src);
+
+  /**
+   * 打开/关闭 _ex 排序的硬件计数(进程级开关，默认关闭)。
+   * 每个线程第一次计数时打开自己的计数器组并一直保留到线程退出，
+   * 之后每次排序只在开始和结束各多一次 read 系统调用。
+   */
+  extern void sort_hw_counters_set_enabled(int enabled);
+  extern int sort_hw_counters_enabled(void);
+
+  /** 由 START_TIMMING/STOP_TIMMING 调用：记录起点读数 / 计算期间增量 */
+  extern void sort_hw_counters_begin(sort_hw_counters_t *hw);
+  extern void sort_hw_counters_end(sort_hw_counters_t *hw);
+
+  /** 计数器名称，用于打印 */
+  extern const char *sort_hw_counter_name(sort_hw_counter_t counter);
+
 #define INDEX_OF(start_ptr, element_size, index) \
   ((void *)((char *)(start_ptr) + ((index) * (element_size))))
 
@@ -53,11 +109,16 @@ extern "C"
     }                               \
     (stats)->time_elapsed_ms = 0.0; \
     (stats)->comparisons = 0;       \
+    (stats)->comparisons_avoided = 0; \
     (stats)->movements = 0;         \
     (stats)->memory_used = 0;       \
     (stats)->max_mamory_used = 0;   \
+    (stats)->io_bytes_read = 0;     \
+    (stats)->io_bytes_written = 0;  \
+    (stats)->merge_passes = 0;      \
     (stats)->end_time = 0;          \
-    (stats)->start_time = clock();  \
+    sort_hw_counters_begin(&(stats)->hw); \
+    (stats)->start_time = sort_monotonic_ns(); \
   } while (0)
 
 #define STOP_TIMMING(stats)                                                                                   \
@@ -67,8 +128,9 @@ extern "C"
     {                                                                                                         \
       break;                                                                                                  \
     }                                                                                                         \
-    (stats)->end_time = clock();                                                                              \
-    (stats)->time_elapsed_ms = ((double)((stats)->end_time - (stats)->start_time)) / CLOCKS_PER_SEC * 1000.0; \
+    (stats)->end_time = sort_monotonic_ns();                                                                  \
+    (stats)->time_elapsed_ms = (double)((stats)->end_time - (stats)->start_time) / 1e6;                       \
+    sort_hw_counters_end(&(stats)->hw);                                                                       \
   } while (0)
 
 #if defined(PRINT_SORTING_INFO)
@@ -122,6 +184,10 @@ extern "C"
     }                                  \
     (stats)->memory_used -= size;      \
   } while (0)
+
+// 表达式形式的计数比较，可以直接写在 if/while 条件里
+#define COUNTED_CMP(stats, cmp, a, b) \
+  ((NULL != (stats) ? (void)(stats)->comparisons++ : (void)0), (cmp)((a), (b)))
 #endif // PRINT_SORTING_INFO
 
 #define RECORD_ELEMENT_SIZE(stats, ele_size) \
@@ -177,6 +243,12 @@ extern "C"
 #define INCRE_COMPARISONS(stats)
 #endif
 
+// 未定义 PRINT_SORTING_INFO 时只剩比较函数调用本身；(void)(stats) 只是
+// 避免未使用参数的警告，优化后不产生任何代码
+#ifndef COUNTED_CMP
+#define COUNTED_CMP(stats, cmp, a, b) ((void)(stats), (cmp)((a), (b)))
+#endif
+
 #ifndef INCRE_MOVEMENTS
 #define INCRE_MOVEMENTS(stats)
 #endif
@@ -205,8 +277,9 @@ extern "C"
 #define PRINT_STATS(stats, sort_type)
 #endif
 
-  
-// todo: 使用汇编实现高性能swap
+
+// 单次交换用的通用宏。排序内部请使用 select_swap_func 按元素大小选出的
+// 交换函数，大元素时比这里逐字节 XOR 的实现快得多。
 #define GENERIC_SAMP_SIZE_SWAP(size, ap, bp)    \
   do                                            \
   {                                             \
@@ -243,6 +316,17 @@ extern "C"
 
   typedef int compare_func_t(const void *const a, const void *const b);
   typedef void swap_func_t(void *const a, void *const b);
+  typedef void sized_swap_func_t(void *const a, void *const b, size_t size);
+
+  /**
+   * 按元素大小选出交换函数：1/2/4/8/16 字节使用定长整数/SSE2 寄存器交换，
+   * 更大的元素按 32 字节(AVX2)或 16 字节(SSE2)分块交换，非 x86 平台按
+   * 栈缓冲区分块拷贝。选择结果在一次排序中复用，不要在每次交换时调用。
+   */
+  extern sized_swap_func_t *select_swap_func(size_t element_size);
+
+  /** 运行时检测 CPU 是否支持 AVX2，非 x86 平台恒为 0。结果会缓存 */
+  extern int sort_cpu_has_avx2(void);
 
   extern int compare_integers(const void *const a, const void *const b);
   extern void swap_integers(void *const a, void *const b);
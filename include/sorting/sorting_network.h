@@ -0,0 +1,67 @@
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sorting/sort_common.h"
+
+// 排序网络：比较-交换的位置只由元素个数决定，与数据无关，没有插入排序
+// 那种依赖比较结果的内层循环，分支预测失败只可能出现在比较函数内部。
+//
+// - 2~16 个元素使用已知最优(或接近最优)的网络，例如 16 个元素 60 次
+//   比较；13 个元素的网络由 16 元网络裁剪得到，比已知最优多 1 次；
+// - 通用版本按比较函数的结果生成全 0/全 1 掩码，4/8/16 字节元素用
+//   XOR 掩码交换，不产生分支；其他大小按结果调用交换函数；
+// - int32/float 版本最多 32 个元素：支持 AVX2 时在 1/2/4 个 ymm 寄存器
+//   内做双调排序，否则用 min/max(编译为 cmov)执行上面的网络，超过 16 个
+//   元素时用 Batcher 归并交换网络。
+//
+// 排序网络不稳定，只用作不稳定排序(快速排序、nth_element、原地基数排序)
+// 的小区间收尾。
+
+#ifndef SORTING_NETWORK_MAX
+#define SORTING_NETWORK_MAX 16
+#endif
+
+#ifndef SORTING_NETWORK_MAX_32BIT
+#define SORTING_NETWORK_MAX_32BIT 32
+#endif
+
+/**
+ * @brief 用排序网络排序不超过 SORTING_NETWORK_MAX 个元素
+ * @return arr_len 超过 SORTING_NETWORK_MAX 时返回 SORT_ERROR_INVALID_LENGTH
+ */
+extern sort_result_t generic_network_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/** 同上，把比较和移动计数累加到 stats(不计时、不清零)，供其他排序的小区间调用 */
+extern sort_result_t generic_network_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+/**
+ * @brief 排序不超过 SORTING_NETWORK_MAX_32BIT 个 int32
+ * @return arr_len 超过上限时返回 SORT_ERROR_INVALID_LENGTH
+ */
+extern sort_result_t network_sort_int32(int32_t *arr, size_t arr_len);
+
+/**
+ * @brief 排序不超过 SORTING_NETWORK_MAX_32BIT 个 float
+ * 按 IEEE 位模式的全序排序(与 radix_sort_float 一致)：-0.0 排在 +0.0 之前，
+ * 符号位为 1 的 NaN 排在最前，其余 NaN 排在最后。
+ */
+extern sort_result_t network_sort_float(float *arr, size_t arr_len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SORTING_NETWORK_H
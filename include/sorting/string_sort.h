@@ -0,0 +1,62 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 字符串专用排序。URL、路径这类键往往有很长的公共前缀，用 compare_strings
+// 做比较排序时每次比较都要从第 0 个字节重新 strcmp，并且每次都要解引用
+// 指针。这里的算法都按字节逐层推进，已经确定相等的前缀不再重复比较：
+//
+// - 先为每个字符串建立 {8 字节缓存键, 指针, 长度} 条目，缓存键是从当前
+//   深度开始的 8 个字节(大端打包，按无符号整数比较即为字典序)。排序只在
+//   条目数组上进行，每前进 8 个字节才回到字符串本身读取一次；
+// - 多键快速排序(三路基数快排)：按缓存键三路划分，小于/大于部分在同一
+//   深度继续，等于部分直接跳过这 8 个字节；
+// - MSD 基数排序：每层按一个字节计数分桶(字符串结束单独一个桶，排在最前)，
+//   桶号先记到 oracle 数组再分发，桶较小时转入多键快速排序；
+// - 不超过 STRING_SORT_INSERTION_THRESHOLD 个条目时用插入排序收尾。
+//
+// 排序按无符号字节的字典序，较短的前缀排在前面，与 strcmp / memcmp 一致。
+// 需要 n 个条目(24 字节)的辅助空间，MSD 基数排序另需 n 个条目加 2n 字节。
+// 两种算法都不稳定，但相等的字符串内容完全相同。
+
+#ifndef STRING_SORT_INSERTION_THRESHOLD
+#define STRING_SORT_INSERTION_THRESHOLD 16
+#endif
+
+// MSD 基数排序中桶小于该值时转入多键快速排序
+#ifndef STRING_SORT_RADIX_THRESHOLD
+#define STRING_SORT_RADIX_THRESHOLD 64
+#endif
+
+/** 带长度的字符串片段，内容可以包含 '\0' */
+typedef struct
+{
+    const char *ptr;
+    size_t len;
+} string_slice_t;
+
+/**
+ * @brief 用多键快速排序对 C 字符串指针数组排序
+ * @return strs 或其中任一元素为 NULL 时返回 SORT_ERROR_NULL_POINTER
+ */
+extern sort_result_t string_multikey_sort(char *strs[], size_t count);
+
+/** 用 MSD 基数排序对 C 字符串指针数组排序 */
+extern sort_result_t string_radix_sort(char *strs[], size_t count);
+
+/**
+ * @brief 用多键快速排序对字符串片段排序
+ * @return 存在 ptr 为 NULL 且 len 不为 0 的片段时返回 SORT_ERROR_NULL_POINTER
+ */
+extern sort_result_t slice_multikey_sort(string_slice_t slices[], size_t count);
+
+/** 用 MSD 基数排序对字符串片段排序 */
+extern sort_result_t slice_radix_sort(string_slice_t slices[], size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // STRING_SORT_H
@@ -0,0 +1,48 @@
+#ifndef TIM_SORT_H
+#define TIM_SORT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 自适应自然归并排序(TimSort)，适合大部分已有序的输入，
+// 例如按时间追加、只有少量乱序窗口的时间序列。
+//
+// - 从左到右识别升序 run 和严格降序 run(降序原地翻转，严格降序才能
+//   保证翻转后仍然稳定)；短于 minrun 的 run 用二分插入排序补齐；
+// - run 压栈，维持 len[i-2] > len[i-1] + len[i] 且 len[i-1] > len[i]
+//   的栈不变式，保证归并是平衡的，栈深度为 O(log n)；
+// - 归并前先用 gallop 剪掉两端已就位的部分，只把较短的一段复制到
+//   辅助空间；某一侧连续胜出 min_gallop 次后进入 galloping 模式，
+//   用指数搜索成块移动；
+// - 已有序输入只需 n - 1 次比较、不分配内存；辅助空间按需增长，最多
+//   n / 2 个元素。排序是稳定的。
+
+#ifndef TIM_SORT_MIN_MERGE
+#define TIM_SORT_MIN_MERGE 64
+#endif
+
+#ifndef TIM_SORT_MIN_GALLOP
+#define TIM_SORT_MIN_GALLOP 7
+#endif
+
+extern sort_result_t generic_tim_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp
+);
+
+/** 同 generic_tim_sort，stats 不为 NULL 时记录耗时和计数 */
+extern sort_result_t generic_tim_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TIM_SORT_H
@@ -0,0 +1,61 @@
+#ifndef TOPK_H
+#define TOPK_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sorting/sort_common.h"
+
+// 流式 top-k 累加器：数据分批到达、总量放不进内存或不想整体保存时，
+// 只用 k 个元素的空间维护目前见过的最小 k 个元素。
+//
+// 内部是按 cmp 的大顶堆，堆顶是当前第 k 小的元素(门槛)。堆满之后，
+// 新元素先与门槛比较一次，绝大部分元素在这一步就被丢弃；只有严格小于
+// 门槛的元素才替换堆顶并下沉，单个元素最坏 O(log k)。与门槛相等的元素
+// 不会挤掉已有元素。
+//
+// 需要最大的 k 个(例如按分数取前 100)时，传入反向比较函数即可。
+
+typedef struct topk topk_t;
+
+/**
+ * @brief 创建累加器
+ * @param k 保留的元素个数，可以为 0
+ * @return 参数非法或内存不足时返回 NULL
+ */
+extern topk_t *topk_create(size_t k, size_t element_size, compare_func_t cmp);
+
+extern void topk_destroy(topk_t *topk);
+
+/** 清空已收集的元素，保留容量 */
+extern void topk_clear(topk_t *topk);
+
+/** 当前保留的元素个数，不超过 k */
+extern size_t topk_size(const topk_t *topk);
+
+extern size_t topk_capacity(const topk_t *topk);
+
+/**
+ * @brief 当前门槛(保留元素中最大的一个)，未收满 k 个时返回 NULL。
+ *        之后到达的元素必须严格小于它才会被保留，可用于提前过滤。
+ */
+extern const void *topk_threshold(const topk_t *topk);
+
+extern sort_result_t topk_push(topk_t *topk, const void *elem);
+
+/**
+ * @brief 批量加入 arr_len 个连续存放的元素。
+ *        堆未满时整段拷贝后一次性 O(k) 建堆，之后逐个与门槛比较。
+ */
+extern sort_result_t topk_push_batch(topk_t *topk, const void *arr, size_t arr_len);
+
+/**
+ * @brief 把保留的元素按升序拷贝到 out，不影响累加器状态
+ * @param out 至少能容纳 topk_size() 个元素
+ * @param out_len 不为 NULL 时写入拷贝的元素个数
+ */
+extern sort_result_t topk_result(const topk_t *topk, void *out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TOPK_H
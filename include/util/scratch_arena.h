@@ -0,0 +1,101 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+
+// 暂存内存分配器，工具包内所有算法的临时空间都从这里申请。
+//
+// - 每个线程第一次申请时得到自己的 arena，之后的申请和释放不加锁；
+// - 小块从 mmap 得到的大块(chunk)中顺序切出(bump)，释放后按大小级别
+//   (每个 2 的幂再分 4 级)放入空闲链表，下次同级申请直接复用；大块单独
+//   mmap，释放后同样留在空闲链表里，但每个 arena 缓存的大块合计不超过
+//   scratch_set_cache_limit() 的上限，超出时从最大的块开始归还。稳态下
+//   (同样大小的排序反复执行)不再调用 malloc/mmap，也不会再触发缺页；
+// - 在别的线程释放的块压入所属 arena 的无锁链表，由所属线程下次申请时回收；
+// - 线程退出时 arena 连同缓存的块一起留给之后新建的线程复用；
+// - 可以限制所有 arena 映射的总字节数，超出时先归还缓存的大块，仍不够
+//   则申请失败，算法返回 SORT_ERROR_ALLOCATION_FAILED；
+// - 可以选择用透明大页(madvise(MADV_HUGEPAGE))映射 chunk 和大块。
+//
+// 调用者也可以自己创建 arena，用 scratch_arena_use() 让当前线程的后续申请
+// 改从它分配。一个 arena 同一时间只能由一个线程申请，释放可以在任意线程。
+// 并行算法在工作线程上的申请使用工作线程自己的 arena。
+
+typedef struct scratch_arena scratch_arena_t;
+
+/** 每个 arena 默认最多缓存的大块(超过 512 KiB 单独映射的块)字节数 */
+#ifndef SCRATCH_DEFAULT_CACHE_LIMIT
+#define SCRATCH_DEFAULT_CACHE_LIMIT ((size_t)64 << 20)
+#endif
+
+/**
+ * @brief 创建 arena
+ * @param limit 该 arena 最多映射的字节数，0 表示不限制(仍受全局上限约束)
+ * @return 失败返回 NULL
+ */
+extern scratch_arena_t *scratch_arena_create(size_t limit);
+
+/**
+ * @brief 销毁 arena，归还全部映射。调用前从它申请的块必须都已释放，
+ *        且不能是某个线程正在使用(scratch_arena_use)的 arena
+ */
+extern void scratch_arena_destroy(scratch_arena_t *arena);
+
+/**
+ * @brief 从 arena 申请 size 字节，按 16 字节对齐
+ * @return 超出上限或映射失败时返回 NULL
+ */
+extern void *scratch_arena_alloc(scratch_arena_t *arena, size_t size);
+
+/** arena 当前映射的字节数 */
+extern size_t scratch_arena_reserved(const scratch_arena_t *arena);
+
+/**
+ * @brief 让当前线程之后的 scratch_alloc 从 arena 分配
+ * @param arena 为 NULL 时恢复使用线程自己的 arena
+ * @return 之前使用的调用者 arena(没有时为 NULL)，便于嵌套恢复
+ */
+extern scratch_arena_t *scratch_arena_use(scratch_arena_t *arena);
+
+/**
+ * @brief 从当前线程使用的 arena 申请 size 字节，按 16 字节对齐
+ * @return 失败返回 NULL
+ */
+extern void *scratch_alloc(size_t size);
+
+/** 同 scratch_alloc，申请 count * size 字节并清零，乘法溢出时返回 NULL */
+extern void *scratch_calloc(size_t count, size_t size);
+
+/** 释放 scratch_alloc/scratch_arena_alloc 得到的块，ptr 为 NULL 时什么都不做 */
+extern void scratch_free(void *ptr);
+
+/**
+ * @brief 设置所有 arena 合计映射字节数的上限
+ * @param limit 0 表示不限制(默认)
+ */
+extern void scratch_set_limit(size_t limit);
+
+/**
+ * @brief 设置每个 arena 释放后继续缓存的大块合计字节数上限
+ * @param bytes 0 表示大块释放后立即归还；默认 SCRATCH_DEFAULT_CACHE_LIMIT
+ */
+extern void scratch_set_cache_limit(size_t bytes);
+
+/** 所有 arena 当前合计映射的字节数 */
+extern size_t scratch_total_reserved(void);
+
+/** 打开/关闭之后新映射内存的透明大页提示(默认关闭) */
+extern void scratch_set_huge_pages(int enabled);
+
+/**
+ * @brief 归还当前线程自己的 arena 以及已退出线程留下的 arena。
+ *        由 algorithms_cleanup() 调用，调用时这些 arena 上不能有未释放的块
+ */
+extern void scratch_release_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,78 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+
+// 工作窃取线程池。
+// 每个工作线程有一个双端任务队列：自己从尾部压入/弹出(LIFO，缓存友好)，
+// 空闲时从其他队列头部窃取最早的任务(通常是较大的子问题)。非工作线程
+// 提交的任务进入一个公共注入队列。
+//
+// 任务以任务组(thread_pool_group_t)为单位等待：等待线程不会阻塞，而是
+// 在组内任务完成前继续执行池中的任务，因此任务内部可以安全地继续提交
+// 子任务并等待(fork-join)。
+
+typedef void thread_pool_task_func_t(void *arg);
+
+typedef struct thread_pool thread_pool_t;
+
+/** 任务组，按值初始化为 THREAD_POOL_GROUP_INIT，pending 只能由线程池修改 */
+typedef struct
+{
+    size_t pending;
+} thread_pool_group_t;
+
+#define THREAD_POOL_GROUP_INIT {0}
+
+/**
+ * @brief 创建线程池
+ * @param num_threads 工作线程数，0 表示使用在线 CPU 核数
+ * @return 失败返回 NULL
+ */
+extern thread_pool_t *thread_pool_create(size_t num_threads);
+
+/**
+ * @brief 销毁线程池，等待所有工作线程退出。调用前应等待所有任务组完成。
+ */
+extern void thread_pool_destroy(thread_pool_t *pool);
+
+extern size_t thread_pool_size(const thread_pool_t *pool);
+
+/**
+ * @brief 向线程池提交一个任务并计入任务组
+ * @return 成功返回0，内存不足返回负数(此时任务未被执行)
+ */
+extern int thread_pool_submit(thread_pool_t *pool,
+                              thread_pool_group_t *group,
+                              thread_pool_task_func_t *func,
+                              void *arg);
+
+/**
+ * @brief 等待任务组内的任务全部完成，等待期间当前线程协助执行任务
+ */
+extern void thread_pool_wait(thread_pool_t *pool, thread_pool_group_t *group);
+
+/* ============================================================================
+ * 工具包全局线程池，由 algorithms_init() 创建、algorithms_cleanup() 销毁
+ * ============================================================================
+ */
+
+/**
+ * @brief 创建(或按新的线程数重建)全局线程池
+ * @param num_threads 0 表示使用环境变量 ALGORITHMS_NUM_THREADS，未设置时使用 CPU 核数
+ */
+extern int thread_pool_global_init(size_t num_threads);
+
+extern void thread_pool_global_shutdown(void);
+
+/**
+ * @brief 获取全局线程池，未初始化时返回 NULL
+ */
+extern thread_pool_t *thread_pool_global(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // THREAD_POOL_H
@@ -6,6 +6,8 @@
  */
 
 #include "algorithms.h"
+#include "util/thread_pool.h"
+#include "util/scratch_arena.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -27,12 +29,19 @@ const char* algorithms_get_version(void) {
  * ============================================================================ */
 
 int algorithms_init(void) {
-    // 这里可以添加全局初始化代码
-    // 例如：内存池初始化、日志系统初始化等
+    // 并行排序使用的全局线程池
+    if (thread_pool_global() == NULL && thread_pool_global_init(0) != 0) {
+        return -1;
+    }
     return 0;
 }
 
 void algorithms_cleanup(void) {
-    // 这里可以添加全局清理代码
-    // 例如：内存池清理、日志系统清理等
+    thread_pool_global_shutdown();
+    // 工作线程退出后它们的 arena 都已留给后来者，连同本线程的一起归还
+    scratch_release_all();
+}
+
+int algorithms_set_thread_count(size_t num_threads) {
+    return thread_pool_global_init(num_threads);
 }
@@ -0,0 +1,888 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "data_structures/hash_table.h"
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define HASH_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// 控制字节：最高位为 1 表示空闲(空或墓碑)，为 0 时低 7 位是哈希值的 h2
+#define CTRL_EMPTY ((int8_t)-128)
+#define CTRL_DELETED ((int8_t)-2)
+
+#define NOT_FOUND SIZE_MAX
+
+// 表达到这个大小时按大页对齐分配并建议内核使用透明大页，减少随机访问的 TLB 缺失
+#define HASH_TABLE_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+struct hash_table
+{
+    int8_t *ctrl;  /**< num_groups * HASH_TABLE_GROUP_WIDTH 个控制字节 */
+    char *slots;   /**< 槽位，与控制字节在同一块内存中 */
+    size_t num_groups;
+    size_t size;
+    size_t tombstones;
+    size_t growth_left; /**< 还能占用多少个空槽而不扩容 */
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset; /**< 值在槽位内的偏移 */
+    size_t slot_size;
+    size_t block_bytes; /**< 控制字节与槽位的总字节数 */
+    double max_load_factor;
+    hash_func_t *hash;
+    hash_equal_func_t *equal;
+};
+
+/* ============================================================================
+ * 控制字节组
+ * ============================================================================
+ */
+
+/** 组内控制字节等于 h2 的位图 */
+static ALWAYS_INLINE uint32_t group_match(const int8_t *group, int8_t h2)
+{
+#if defined(HASH_TABLE_SSE2)
+    __m128i ctrl = _mm_load_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_TABLE_GROUP_WIDTH; i++)
+    {
+        mask |= (uint32_t)(group[i] == h2) << i;
+    }
+    return mask;
+#endif
+}
+
+static ALWAYS_INLINE uint32_t group_match_empty(const int8_t *group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+/** 空槽或墓碑 */
+static ALWAYS_INLINE uint32_t group_match_free(const int8_t *group)
+{
+#if defined(HASH_TABLE_SSE2)
+    return (uint32_t)_mm_movemask_epi8(_mm_load_si128((const __m128i *)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_TABLE_GROUP_WIDTH; i++)
+    {
+        mask |= (uint32_t)(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+/* ============================================================================
+ * 哈希
+ * ============================================================================
+ */
+
+static ALWAYS_INLINE uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    return x;
+}
+
+uint64_t hash_table_default_hash(const void *const key, size_t key_size)
+{
+    const unsigned char *bytes = (const unsigned char *)key;
+    if (8 == key_size)
+    {
+        uint64_t x;
+        memcpy(&x, bytes, 8);
+        return mix64(x);
+    }
+    if (4 == key_size)
+    {
+        uint32_t x;
+        memcpy(&x, bytes, 4);
+        return mix64(x);
+    }
+    uint64_t h = mix64(key_size ^ 0x9e3779b97f4a7c15ull);
+    size_t i = 0;
+    for (; i + 8 <= key_size; i += 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, bytes + i, 8);
+        h = mix64(h ^ chunk);
+    }
+    if (i < key_size)
+    {
+        uint64_t chunk = 0;
+        memcpy(&chunk, bytes + i, key_size - i);
+        h = mix64(h ^ chunk);
+    }
+    return h;
+}
+
+// 下面的取哈希和比较函数都以常量函数指针传给 ALWAYS_INLINE 的探测函数，
+// 编译器在每个调用点内联展开，整数键的快速路径里不剩间接调用
+
+typedef uint64_t key_hash_t(const hash_table_t *table, const void *key);
+typedef int key_equal_t(const hash_table_t *table, const void *slot_key, const void *key);
+
+/**
+ * 起始组取哈希值的高位，h2 取低 7 位，用户哈希(如恒等哈希)未必在两端都均匀，
+ * 统一再混合一次；内置哈希的结果已经混合过，不重复处理
+ */
+static ALWAYS_INLINE uint64_t user_hash(const hash_table_t *table, const void *key, size_t key_size)
+{
+    return mix64(table->hash(key, key_size));
+}
+
+static ALWAYS_INLINE uint64_t hash_bytes(const hash_table_t *table, const void *key)
+{
+    return NULL != table->hash ? user_hash(table, key, table->key_size) : hash_table_default_hash(key, table->key_size);
+}
+
+static ALWAYS_INLINE uint64_t hash_32(const hash_table_t *table, const void *key)
+{
+    uint32_t x;
+    memcpy(&x, key, 4);
+    return NULL != table->hash ? user_hash(table, key, 4) : mix64(x);
+}
+
+static ALWAYS_INLINE uint64_t hash_64(const hash_table_t *table, const void *key)
+{
+    uint64_t x;
+    memcpy(&x, key, 8);
+    return NULL != table->hash ? user_hash(table, key, 8) : mix64(x);
+}
+
+static ALWAYS_INLINE int equal_bytes(const hash_table_t *table, const void *slot_key, const void *key)
+{
+    return NULL != table->equal ? table->equal(slot_key, key, table->key_size)
+                                : 0 == memcmp(slot_key, key, table->key_size);
+}
+
+static ALWAYS_INLINE int equal_32(const hash_table_t *table, const void *slot_key, const void *key)
+{
+    uint32_t a, b;
+    memcpy(&a, slot_key, 4);
+    memcpy(&b, key, 4);
+    return NULL != table->equal ? table->equal(slot_key, key, 4) : a == b;
+}
+
+static ALWAYS_INLINE int equal_64(const hash_table_t *table, const void *slot_key, const void *key)
+{
+    uint64_t a, b;
+    memcpy(&a, slot_key, 8);
+    memcpy(&b, key, 8);
+    return NULL != table->equal ? table->equal(slot_key, key, 8) : a == b;
+}
+
+/** 哈希值高位均匀映射到 [0, num_groups)，容量不必是 2 的幂 */
+static ALWAYS_INLINE size_t start_group(const hash_table_t *table, uint64_t hash)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 wide_t;
+    return (size_t)(((wide_t)hash * table->num_groups) >> 64);
+#else
+    return (size_t)(((hash >> 32) * (uint64_t)table->num_groups) >> 32);
+#endif
+}
+
+static ALWAYS_INLINE int8_t hash_h2(uint64_t hash)
+{
+    return (int8_t)(hash & 0x7f);
+}
+
+static ALWAYS_INLINE char *slot_at(const hash_table_t *table, size_t index)
+{
+    return table->slots + index * table->slot_size;
+}
+
+static ALWAYS_INLINE size_t next_group(const hash_table_t *table, size_t group)
+{
+    return group + 1 == table->num_groups ? 0 : group + 1;
+}
+
+/* ============================================================================
+ * 容量与重建
+ * ============================================================================
+ */
+
+static size_t growth_limit(const hash_table_t *table, size_t num_groups)
+{
+    size_t capacity = num_groups * HASH_TABLE_GROUP_WIDTH;
+    size_t limit = (size_t)((double)capacity * table->max_load_factor);
+    // 至少保留一个空槽，否则探测不会终止
+    return limit < capacity ? limit : capacity - 1;
+}
+
+/** 容纳 num_elements 个元素所需的最少组数 */
+static size_t groups_for(const hash_table_t *table, size_t num_elements)
+{
+    if (0 == num_elements)
+    {
+        return 0;
+    }
+    double capacity = (double)num_elements / table->max_load_factor;
+    size_t groups = (size_t)(capacity / HASH_TABLE_GROUP_WIDTH) + 1;
+    while (growth_limit(table, groups) < num_elements)
+    {
+        groups++;
+    }
+    return groups;
+}
+
+static size_t ctrl_bytes(size_t num_groups)
+{
+    // 槽位从缓存行边界开始
+    return (num_groups * HASH_TABLE_GROUP_WIDTH + 63) & ~(size_t)63;
+}
+
+/** 在新表中找第一个空槽，不比较键(重建时键互不相同) */
+static ALWAYS_INLINE size_t find_free(const hash_table_t *table, uint64_t hash)
+{
+    size_t group = start_group(table, hash);
+    for (;;)
+    {
+        uint32_t free_mask = group_match_free(table->ctrl + group * HASH_TABLE_GROUP_WIDTH);
+        if (0 != free_mask)
+        {
+            return group * HASH_TABLE_GROUP_WIDTH + (size_t)__builtin_ctz(free_mask);
+        }
+        group = next_group(table, group);
+    }
+}
+
+static ALWAYS_INLINE void set_ctrl(hash_table_t *table, size_t index, int8_t ctrl)
+{
+    table->ctrl[index] = ctrl;
+}
+
+/** 按 num_groups 重新分配并把全部元素搬过去，同时清除墓碑 */
+static sort_result_t rehash(hash_table_t *table, size_t num_groups)
+{
+    size_t capacity = num_groups * HASH_TABLE_GROUP_WIDTH;
+    if (num_groups > SIZE_MAX / HASH_TABLE_GROUP_WIDTH / (table->slot_size + 1))
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    size_t block_bytes = ctrl_bytes(num_groups) + capacity * table->slot_size;
+    size_t alignment = block_bytes >= HASH_TABLE_HUGE_PAGE_SIZE ? HASH_TABLE_HUGE_PAGE_SIZE : 64;
+    void *block = NULL;
+    if (0 != posix_memalign(&block, alignment, block_bytes))
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (block_bytes >= HASH_TABLE_HUGE_PAGE_SIZE)
+    {
+        madvise(block, block_bytes & ~(HASH_TABLE_HUGE_PAGE_SIZE - 1), MADV_HUGEPAGE);
+    }
+#endif
+
+    hash_table_t old = *table;
+    table->ctrl = (int8_t *)block;
+    table->slots = (char *)block + ctrl_bytes(num_groups);
+    table->num_groups = num_groups;
+    table->block_bytes = block_bytes;
+    memset(table->ctrl, CTRL_EMPTY, capacity);
+
+    // 旧表顺序扫描，新表随机写入：攒一批先算哈希并预取目标组
+    size_t pending[HASH_TABLE_BATCH_WIDTH];
+    uint64_t hashes[HASH_TABLE_BATCH_WIDTH];
+    size_t num_pending = 0;
+    size_t old_capacity = old.num_groups * HASH_TABLE_GROUP_WIDTH;
+    for (size_t i = 0; i <= old_capacity; i++)
+    {
+        if (i < old_capacity && old.ctrl[i] >= 0)
+        {
+            uint64_t hash = hash_bytes(table, slot_at(&old, i));
+            __builtin_prefetch(table->ctrl + start_group(table, hash) * HASH_TABLE_GROUP_WIDTH);
+            pending[num_pending] = i;
+            hashes[num_pending++] = hash;
+            if (num_pending < HASH_TABLE_BATCH_WIDTH)
+            {
+                continue;
+            }
+        }
+        for (size_t j = 0; j < num_pending; j++)
+        {
+            size_t index = find_free(table, hashes[j]);
+            set_ctrl(table, index, hash_h2(hashes[j]));
+            memcpy(slot_at(table, index), slot_at(&old, pending[j]), table->slot_size);
+        }
+        num_pending = 0;
+    }
+    free(old.ctrl);
+
+    table->tombstones = 0;
+    table->growth_left = growth_limit(table, num_groups) - table->size;
+    return SORT_SUCCESS;
+}
+
+/** 没有空槽可用时：墓碑占了一半以上就原容量重建，否则扩容 1.5 倍 */
+static sort_result_t grow(hash_table_t *table)
+{
+    if (0 != table->num_groups && table->size * 2 < growth_limit(table, table->num_groups))
+    {
+        return rehash(table, table->num_groups);
+    }
+    return rehash(table, groups_for(table, table->size + table->size / 2 + 1));
+}
+
+/**
+ * 批量插入前腾出 count 个空槽，保证这一批即使全是新键也不会在中途扩容(否则预取的地址失效)。
+ * 只在重建确实能腾出空槽时才提前做：元素数加这一批超过上限时扩容，否则空槽不足
+ * 只可能是被墓碑占用，原容量重建即可
+ */
+static sort_result_t reserve_batch(hash_table_t *table, size_t count)
+{
+    if (table->growth_left >= count)
+    {
+        return SORT_SUCCESS;
+    }
+    if (0 == table->num_groups || table->size + count > growth_limit(table, table->num_groups))
+    {
+        size_t target = table->size + table->size / 2 + 1;
+        return rehash(table, groups_for(table, target > table->size + count ? target : table->size + count));
+    }
+    return rehash(table, table->num_groups);
+}
+
+/* ============================================================================
+ * 查找与插入
+ * ============================================================================
+ */
+
+static ALWAYS_INLINE size_t find_index(const hash_table_t *table, const void *key, uint64_t hash, key_equal_t *equal)
+{
+    if (0 == table->num_groups)
+    {
+        return NOT_FOUND;
+    }
+    size_t group = start_group(table, hash);
+    int8_t h2 = hash_h2(hash);
+    for (;;)
+    {
+        const int8_t *ctrl = table->ctrl + group * HASH_TABLE_GROUP_WIDTH;
+        for (uint32_t match = group_match(ctrl, h2); 0 != match; match &= match - 1)
+        {
+            size_t index = group * HASH_TABLE_GROUP_WIDTH + (size_t)__builtin_ctz(match);
+            if (equal(table, slot_at(table, index), key))
+            {
+                return index;
+            }
+        }
+        // 含空槽的组从未满过，键若存在不会放到更后面的组
+        if (0 != group_match_empty(ctrl))
+        {
+            return NOT_FOUND;
+        }
+        group = next_group(table, group);
+    }
+}
+
+/**
+ * 找到键所在的槽位，不存在时占用探测序列上第一个空闲槽位并写入键。
+ * 返回槽位下标，失败(扩容时分配失败)返回 NOT_FOUND
+ */
+static ALWAYS_INLINE size_t find_or_insert(hash_table_t *table, const void *key, uint64_t hash, key_equal_t *equal,
+                                           int *inserted)
+{
+    *inserted = 0;
+    size_t target = NOT_FOUND;
+    if (0 != table->num_groups)
+    {
+        size_t group = start_group(table, hash);
+        int8_t h2 = hash_h2(hash);
+        for (;;)
+        {
+            const int8_t *ctrl = table->ctrl + group * HASH_TABLE_GROUP_WIDTH;
+            for (uint32_t match = group_match(ctrl, h2); 0 != match; match &= match - 1)
+            {
+                size_t index = group * HASH_TABLE_GROUP_WIDTH + (size_t)__builtin_ctz(match);
+                if (equal(table, slot_at(table, index), key))
+                {
+                    return index;
+                }
+            }
+            uint32_t free_mask = group_match_free(ctrl);
+            if (NOT_FOUND == target && 0 != free_mask)
+            {
+                target = group * HASH_TABLE_GROUP_WIDTH + (size_t)__builtin_ctz(free_mask);
+            }
+            if (0 != group_match_empty(ctrl))
+            {
+                break;
+            }
+            group = next_group(table, group);
+        }
+    }
+
+    if (NOT_FOUND != target && CTRL_DELETED == table->ctrl[target])
+    {
+        // 复用墓碑不消耗空槽
+        table->tombstones--;
+    }
+    else if (0 == table->growth_left || NOT_FOUND == target)
+    {
+        if (SORT_SUCCESS != grow(table))
+        {
+            return NOT_FOUND;
+        }
+        target = find_free(table, hash);
+        table->growth_left--;
+    }
+    else
+    {
+        table->growth_left--;
+    }
+    set_ctrl(table, target, hash_h2(hash));
+    memcpy(slot_at(table, target), key, table->key_size);
+    table->size++;
+    *inserted = 1;
+    return target;
+}
+
+static ALWAYS_INLINE void store_value(hash_table_t *table, size_t index, const void *value, int inserted)
+{
+    char *dst = slot_at(table, index) + table->value_offset;
+    if (NULL != value)
+    {
+        memcpy(dst, value, table->value_size);
+    }
+    else if (inserted)
+    {
+        memset(dst, 0, table->value_size);
+    }
+}
+
+static ALWAYS_INLINE sort_result_t insert_impl(hash_table_t *table, const void *key, const void *value,
+                                               key_hash_t *hasher, key_equal_t *equal)
+{
+    int inserted;
+    size_t index = find_or_insert(table, key, hasher(table, key), equal, &inserted);
+    if (NOT_FOUND == index)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    store_value(table, index, value, inserted);
+    return SORT_SUCCESS;
+}
+
+static ALWAYS_INLINE void *find_impl(const hash_table_t *table, const void *key, key_hash_t *hasher,
+                                     key_equal_t *equal)
+{
+    if (0 == table->size)
+    {
+        return NULL;
+    }
+    size_t index = find_index(table, key, hasher(table, key), equal);
+    return NOT_FOUND == index ? NULL : slot_at(table, index) + table->value_offset;
+}
+
+static ALWAYS_INLINE int erase_impl(hash_table_t *table, const void *key, key_hash_t *hasher, key_equal_t *equal)
+{
+    if (0 == table->size)
+    {
+        return 0;
+    }
+    size_t index = find_index(table, key, hasher(table, key), equal);
+    if (NOT_FOUND == index)
+    {
+        return 0;
+    }
+    // 所在组还有空槽说明它从未满过，没有探测序列越过这个组，可以直接标成空槽
+    if (0 != group_match_empty(table->ctrl + index / HASH_TABLE_GROUP_WIDTH * HASH_TABLE_GROUP_WIDTH))
+    {
+        set_ctrl(table, index, CTRL_EMPTY);
+        table->growth_left++;
+    }
+    else
+    {
+        set_ctrl(table, index, CTRL_DELETED);
+        table->tombstones++;
+    }
+    table->size--;
+    return 1;
+}
+
+/* ============================================================================
+ * 批量操作
+ * ============================================================================
+ */
+
+/**
+ * 三步流水：先为一批键算哈希并预取起始组的控制字节，再读控制字节预取候选槽位
+ * (h2 匹配的槽位，插入时没有匹配则取第一个空闲槽位)，最后逐个完成操作
+ */
+static ALWAYS_INLINE void prefetch_batch(const hash_table_t *table, const char *keys, size_t count, uint64_t *hashes,
+                                         key_hash_t *hasher, int for_insert)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hasher(table, keys + i * table->key_size);
+        __builtin_prefetch(table->ctrl + start_group(table, hashes[i]) * HASH_TABLE_GROUP_WIDTH);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t group = start_group(table, hashes[i]);
+        const int8_t *ctrl = table->ctrl + group * HASH_TABLE_GROUP_WIDTH;
+        uint32_t match = group_match(ctrl, hash_h2(hashes[i]));
+        if (0 == match && for_insert)
+        {
+            match = group_match_free(ctrl);
+        }
+        if (0 != match)
+        {
+            __builtin_prefetch(slot_at(table, group * HASH_TABLE_GROUP_WIDTH + (size_t)__builtin_ctz(match)));
+        }
+    }
+}
+
+static ALWAYS_INLINE sort_result_t insert_batch_impl(hash_table_t *table, const void *keys, const void *values,
+                                                     size_t num_keys, size_t *inserted, key_hash_t *hasher,
+                                                     key_equal_t *equal)
+{
+    const char *key_bytes = (const char *)keys;
+    const char *value_bytes = (const char *)values;
+    uint64_t hashes[HASH_TABLE_BATCH_WIDTH];
+    size_t total = 0;
+    sort_result_t result = SORT_SUCCESS;
+    for (size_t base = 0; base < num_keys && SORT_SUCCESS == result; base += HASH_TABLE_BATCH_WIDTH)
+    {
+        size_t count = num_keys - base < HASH_TABLE_BATCH_WIDTH ? num_keys - base : HASH_TABLE_BATCH_WIDTH;
+        const char *batch = key_bytes + base * table->key_size;
+        if (SORT_SUCCESS != (result = reserve_batch(table, count)))
+        {
+            break;
+        }
+        prefetch_batch(table, batch, count, hashes, hasher, 1);
+        for (size_t i = 0; i < count; i++)
+        {
+            int is_new;
+            size_t index = find_or_insert(table, batch + i * table->key_size, hashes[i], equal, &is_new);
+            if (NOT_FOUND == index)
+            {
+                result = SORT_ERROR_ALLOCATION_FAILED;
+                break;
+            }
+            store_value(table, index, NULL == value_bytes ? NULL : value_bytes + (base + i) * table->value_size,
+                        is_new);
+            total += (size_t)is_new;
+        }
+    }
+    if (NULL != inserted)
+    {
+        *inserted = total;
+    }
+    return result;
+}
+
+static ALWAYS_INLINE void find_batch_impl(const hash_table_t *table, const void *keys, size_t num_keys, void **out,
+                                          key_hash_t *hasher, key_equal_t *equal)
+{
+    const char *key_bytes = (const char *)keys;
+    uint64_t hashes[HASH_TABLE_BATCH_WIDTH];
+    if (0 == table->size)
+    {
+        memset(out, 0, num_keys * sizeof(void *));
+        return;
+    }
+    for (size_t base = 0; base < num_keys; base += HASH_TABLE_BATCH_WIDTH)
+    {
+        size_t count = num_keys - base < HASH_TABLE_BATCH_WIDTH ? num_keys - base : HASH_TABLE_BATCH_WIDTH;
+        const char *batch = key_bytes + base * table->key_size;
+        prefetch_batch(table, batch, count, hashes, hasher, 0);
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t index = find_index(table, batch + i * table->key_size, hashes[i], equal);
+            out[base + i] = NOT_FOUND == index ? NULL : slot_at(table, index) + table->value_offset;
+        }
+    }
+}
+
+/* ============================================================================
+ * 通用接口
+ * ============================================================================
+ */
+
+/** 不超过 8 的、能整除 size 的最大 2 的幂 */
+static size_t natural_alignment(size_t size)
+{
+    size_t lowest = size & (~size + 1);
+    return 0 == size || lowest > 8 ? 8 : lowest;
+}
+
+sort_result_t hash_table_create(size_t key_size, size_t value_size, hash_func_t *hash, hash_equal_func_t *equal,
+                                hash_table_t **out)
+{
+    if (NULL == out)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    *out = NULL;
+    if (0 == key_size)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    hash_table_t *table = (hash_table_t *)calloc(1, sizeof(hash_table_t));
+    if (NULL == table)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    size_t value_align = 0 == value_size ? 1 : natural_alignment(value_size);
+    size_t key_align = natural_alignment(key_size);
+    size_t slot_align = value_align > key_align ? value_align : key_align;
+    table->key_size = key_size;
+    table->value_size = value_size;
+    table->value_offset = (key_size + value_align - 1) & ~(value_align - 1);
+    table->slot_size = (table->value_offset + value_size + slot_align - 1) & ~(slot_align - 1);
+    table->max_load_factor = HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR;
+    table->hash = hash;
+    table->equal = equal;
+    *out = table;
+    return SORT_SUCCESS;
+}
+
+void hash_table_destroy(hash_table_t *table)
+{
+    if (NULL == table)
+    {
+        return;
+    }
+    free(table->ctrl);
+    free(table);
+}
+
+void hash_table_clear(hash_table_t *table)
+{
+    if (NULL == table || 0 == table->num_groups)
+    {
+        return;
+    }
+    memset(table->ctrl, CTRL_EMPTY, table->num_groups * HASH_TABLE_GROUP_WIDTH);
+    table->size = 0;
+    table->tombstones = 0;
+    table->growth_left = growth_limit(table, table->num_groups);
+}
+
+size_t hash_table_size(const hash_table_t *table)
+{
+    return NULL == table ? 0 : table->size;
+}
+
+size_t hash_table_capacity(const hash_table_t *table)
+{
+    return NULL == table ? 0 : table->num_groups * HASH_TABLE_GROUP_WIDTH;
+}
+
+size_t hash_table_memory_bytes(const hash_table_t *table)
+{
+    return NULL == table ? 0 : sizeof(hash_table_t) + table->block_bytes;
+}
+
+sort_result_t hash_table_reserve(hash_table_t *table, size_t num_elements)
+{
+    if (NULL == table)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    size_t groups = groups_for(table, num_elements);
+    return groups > table->num_groups ? rehash(table, groups) : SORT_SUCCESS;
+}
+
+sort_result_t hash_table_set_max_load_factor(hash_table_t *table, double max_load_factor)
+{
+    if (NULL == table)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (!(max_load_factor > 0.0 && max_load_factor < 1.0))
+    {
+        return SORT_ERROR_INVALID_ARGUMENT;
+    }
+    table->max_load_factor = max_load_factor;
+    if (0 == table->num_groups)
+    {
+        return SORT_SUCCESS;
+    }
+    size_t limit = growth_limit(table, table->num_groups);
+    if (table->size + table->tombstones > limit)
+    {
+        size_t groups = groups_for(table, table->size);
+        return rehash(table, groups > table->num_groups ? groups : table->num_groups);
+    }
+    table->growth_left = limit - table->size - table->tombstones;
+    return SORT_SUCCESS;
+}
+
+sort_result_t hash_table_insert(hash_table_t *table, const void *key, const void *value)
+{
+    if (NULL == table || NULL == key)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    return insert_impl(table, key, value, hash_bytes, equal_bytes);
+}
+
+sort_result_t hash_table_emplace(hash_table_t *table, const void *key, void **value, int *inserted)
+{
+    if (NULL == table || NULL == key || NULL == value)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    int is_new;
+    size_t index = find_or_insert(table, key, hash_bytes(table, key), equal_bytes, &is_new);
+    if (NOT_FOUND == index)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    store_value(table, index, NULL, is_new);
+    *value = slot_at(table, index) + table->value_offset;
+    if (NULL != inserted)
+    {
+        *inserted = is_new;
+    }
+    return SORT_SUCCESS;
+}
+
+void *hash_table_find(const hash_table_t *table, const void *key)
+{
+    if (NULL == table || NULL == key)
+    {
+        return NULL;
+    }
+    return find_impl(table, key, hash_bytes, equal_bytes);
+}
+
+int hash_table_erase(hash_table_t *table, const void *key)
+{
+    if (NULL == table || NULL == key)
+    {
+        return 0;
+    }
+    return erase_impl(table, key, hash_bytes, equal_bytes);
+}
+
+sort_result_t hash_table_insert_batch(hash_table_t *table, const void *keys, const void *values, size_t num_keys,
+                                      size_t *inserted)
+{
+    if (NULL == table || (NULL == keys && 0 != num_keys))
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    return insert_batch_impl(table, keys, values, num_keys, inserted, hash_bytes, equal_bytes);
+}
+
+void hash_table_find_batch(const hash_table_t *table, const void *keys, size_t num_keys, void **out)
+{
+    if (NULL == table || NULL == keys || NULL == out)
+    {
+        return;
+    }
+    find_batch_impl(table, keys, num_keys, out, hash_bytes, equal_bytes);
+}
+
+int hash_table_next(const hash_table_t *table, size_t *cursor, const void **key, void **value)
+{
+    if (NULL == table || NULL == cursor)
+    {
+        return 0;
+    }
+    size_t capacity = table->num_groups * HASH_TABLE_GROUP_WIDTH;
+    for (size_t i = *cursor; i < capacity; i++)
+    {
+        if (table->ctrl[i] >= 0)
+        {
+            *cursor = i + 1;
+            if (NULL != key)
+            {
+                *key = slot_at(table, i);
+            }
+            if (NULL != value)
+            {
+                *value = slot_at(table, i) + table->value_offset;
+            }
+            return 1;
+        }
+    }
+    *cursor = capacity;
+    return 0;
+}
+
+/* ============================================================================
+ * 整数键
+ * ============================================================================
+ */
+
+#define DEFINE_TYPED_HASH_TABLE(NAME, T, HASHER, EQUAL)                                                 \
+    sort_result_t hash_table_insert_##NAME(hash_table_t *table, T key, const void *value)              \
+    {                                                                                                   \
+        if (NULL == table)                                                                              \
+        {                                                                                               \
+            return SORT_ERROR_NULL_POINTER;                                                             \
+        }                                                                                               \
+        if (sizeof(T) != table->key_size)                                                               \
+        {                                                                                               \
+            return SORT_ERROR_INVALID_ELEMENT_SIZE;                                                     \
+        }                                                                                               \
+        return insert_impl(table, &key, value, HASHER, EQUAL);                                          \
+    }                                                                                                   \
+                                                                                                        \
+    void *hash_table_find_##NAME(const hash_table_t *table, T key)                                     \
+    {                                                                                                   \
+        if (NULL == table || sizeof(T) != table->key_size)                                              \
+        {                                                                                               \
+            return NULL;                                                                                \
+        }                                                                                               \
+        return find_impl(table, &key, HASHER, EQUAL);                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    int hash_table_erase_##NAME(hash_table_t *table, T key)                                            \
+    {                                                                                                   \
+        if (NULL == table || sizeof(T) != table->key_size)                                              \
+        {                                                                                               \
+            return 0;                                                                                   \
+        }                                                                                               \
+        return erase_impl(table, &key, HASHER, EQUAL);                                                  \
+    }                                                                                                   \
+                                                                                                        \
+    sort_result_t hash_table_insert_batch_##NAME(hash_table_t *table, const T *keys, const void *values, \
+                                                 size_t num_keys, size_t *inserted)                     \
+    {                                                                                                   \
+        if (NULL == table || (NULL == keys && 0 != num_keys))                                           \
+        {                                                                                               \
+            return SORT_ERROR_NULL_POINTER;                                                             \
+        }                                                                                               \
+        if (sizeof(T) != table->key_size)                                                               \
+        {                                                                                               \
+            return SORT_ERROR_INVALID_ELEMENT_SIZE;                                                     \
+        }                                                                                               \
+        return insert_batch_impl(table, keys, values, num_keys, inserted, HASHER, EQUAL);               \
+    }                                                                                                   \
+                                                                                                        \
+    void hash_table_find_batch_##NAME(const hash_table_t *table, const T *keys, size_t num_keys, void **out) \
+    {                                                                                                   \
+        if (NULL == table || NULL == keys || NULL == out)                                               \
+        {                                                                                               \
+            return;                                                                                     \
+        }                                                                                               \
+        if (sizeof(T) != table->key_size)                                                               \
+        {                                                                                               \
+            memset(out, 0, num_keys * sizeof(void *));                                                  \
+            return;                                                                                     \
+        }                                                                                               \
+        find_batch_impl(table, keys, num_keys, out, HASHER, EQUAL);                                     \
+    }
+
+DEFINE_TYPED_HASH_TABLE(int32, int32_t, hash_32, equal_32)
+DEFINE_TYPED_HASH_TABLE(int64, int64_t, hash_64, equal_64)
+DEFINE_TYPED_HASH_TABLE(uint64, uint64_t, hash_64, equal_64)
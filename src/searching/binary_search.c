@@ -0,0 +1,210 @@
+#include "searching/binary_search.h"
+
+/* ============================================================================
+ * 通用版本
+ * ============================================================================
+ */
+
+size_t generic_lower_bound(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp)
+{
+    if (NULL == arr || NULL == key || NULL == cmp || 0 == arr_len)
+    {
+        return 0;
+    }
+    // 答案始终在 [base, base + len] 内；len 的变化与比较结果无关
+    const char *base = (const char *)arr;
+    size_t len = arr_len;
+    while (len > 1)
+    {
+        size_t half = len / 2;
+        len -= half;
+        __builtin_prefetch(base + (len / 2) * element_size);
+        __builtin_prefetch(base + (half + len / 2) * element_size);
+        base = cmp(base + half * element_size, key) < 0 ? base + half * element_size : base;
+    }
+    return (size_t)(base - (const char *)arr) / element_size + (cmp(base, key) < 0);
+}
+
+size_t generic_upper_bound(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp)
+{
+    if (NULL == arr || NULL == key || NULL == cmp || 0 == arr_len)
+    {
+        return 0;
+    }
+    const char *base = (const char *)arr;
+    size_t len = arr_len;
+    while (len > 1)
+    {
+        size_t half = len / 2;
+        len -= half;
+        __builtin_prefetch(base + (len / 2) * element_size);
+        __builtin_prefetch(base + (half + len / 2) * element_size);
+        base = cmp(base + half * element_size, key) <= 0 ? base + half * element_size : base;
+    }
+    return (size_t)(base - (const char *)arr) / element_size + (cmp(base, key) <= 0);
+}
+
+size_t generic_binary_search(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp)
+{
+    size_t i = generic_lower_bound(arr, arr_len, element_size, key, cmp);
+    if (i < arr_len && 0 == cmp(INDEX_OF(arr, element_size, i), key))
+    {
+        return i;
+    }
+    return SEARCH_NOT_FOUND;
+}
+
+void generic_lower_bound_batch(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const void *keys,
+    size_t num_keys,
+    compare_func_t cmp,
+    size_t *out)
+{
+    if (NULL == keys || NULL == out || NULL == cmp)
+    {
+        return;
+    }
+    if (NULL == arr || 0 == arr_len)
+    {
+        memset(out, 0, num_keys * sizeof(size_t));
+        return;
+    }
+    const char *begin = (const char *)arr;
+    const char *key_bytes = (const char *)keys;
+    for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)
+    {
+        size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH;
+        const char *key = key_bytes + first * element_size;
+        const char *base[SEARCH_BATCH_WIDTH];
+        for (size_t i = 0; i < width; i++)
+        {
+            base[i] = begin;
+        }
+        size_t len = arr_len;
+        while (len > 1)
+        {
+            size_t half = len / 2;
+            len -= half;
+            for (size_t i = 0; i < width; i++)
+            {
+                const char *b = base[i];
+                b = cmp(b + half * element_size, key + i * element_size) < 0 ? b + half * element_size : b;
+                base[i] = b;
+                // 下一轮要读的位置，轮到它时其他查询已经掩盖了大部分延迟
+                __builtin_prefetch(b + (len / 2) * element_size);
+            }
+        }
+        for (size_t i = 0; i < width; i++)
+        {
+            out[first + i] = (size_t)(base[i] - begin) / element_size + (cmp(base[i], key + i * element_size) < 0);
+        }
+    }
+}
+
+/* ============================================================================
+ * 定类型版本
+ * ============================================================================
+ */
+
+// 每步预取下一步的两个候选位置，比较结果出来时对应的缓存行已在路上
+#define DEFINE_TYPED_SEARCH(NAME, T)                                                                  \
+    size_t lower_bound_##NAME(const T *arr, size_t arr_len, T key)                                   \
+    {                                                                                                 \
+        if (NULL == arr || 0 == arr_len)                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        const T *base = arr;                                                                          \
+        size_t len = arr_len;                                                                         \
+        while (len > 1)                                                                               \
+        {                                                                                             \
+            size_t half = len / 2;                                                                    \
+            len -= half;                                                                              \
+            __builtin_prefetch(base + len / 2);                                                       \
+            __builtin_prefetch(base + half + len / 2);                                                \
+            base = base[half] < key ? base + half : base;                                             \
+        }                                                                                             \
+        return (size_t)(base - arr) + (*base < key);                                                  \
+    }                                                                                                 \
+                                                                                                      \
+    size_t upper_bound_##NAME(const T *arr, size_t arr_len, T key)                                   \
+    {                                                                                                 \
+        if (NULL == arr || 0 == arr_len)                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        const T *base = arr;                                                                          \
+        size_t len = arr_len;                                                                         \
+        while (len > 1)                                                                               \
+        {                                                                                             \
+            size_t half = len / 2;                                                                    \
+            len -= half;                                                                              \
+            __builtin_prefetch(base + len / 2);                                                       \
+            __builtin_prefetch(base + half + len / 2);                                                \
+            base = base[half] <= key ? base + half : base;                                            \
+        }                                                                                             \
+        return (size_t)(base - arr) + (*base <= key);                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    void lower_bound_##NAME##_batch(const T *arr, size_t arr_len, const T *keys, size_t num_keys, size_t *out) \
+    {                                                                                                 \
+        if (NULL == keys || NULL == out)                                                              \
+        {                                                                                             \
+            return;                                                                                   \
+        }                                                                                             \
+        if (NULL == arr || 0 == arr_len)                                                              \
+        {                                                                                             \
+            memset(out, 0, num_keys * sizeof(size_t));                                                \
+            return;                                                                                   \
+        }                                                                                             \
+        for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)                         \
+        {                                                                                             \
+            size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH; \
+            const T *key = keys + first;                                                              \
+            const T *base[SEARCH_BATCH_WIDTH];                                                        \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                base[i] = arr;                                                                        \
+            }                                                                                         \
+            size_t len = arr_len;                                                                     \
+            while (len > 1)                                                                           \
+            {                                                                                         \
+                size_t half = len / 2;                                                                \
+                len -= half;                                                                          \
+                for (size_t i = 0; i < width; i++)                                                    \
+                {                                                                                     \
+                    const T *b = base[i][half] < key[i] ? base[i] + half : base[i];                   \
+                    base[i] = b;                                                                      \
+                    __builtin_prefetch(b + len / 2);                                                  \
+                }                                                                                     \
+            }                                                                                         \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                out[first + i] = (size_t)(base[i] - arr) + (*base[i] < key[i]);                       \
+            }                                                                                         \
+        }                                                                                             \
+    }
+
+DEFINE_TYPED_SEARCH(int32, int32_t)
+DEFINE_TYPED_SEARCH(int64, int64_t)
+DEFINE_TYPED_SEARCH(uint64, uint64_t)
+DEFINE_TYPED_SEARCH(float, float)
+DEFINE_TYPED_SEARCH(double, double)
@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include "searching/eytzinger.h"
+#include "searching/binary_search.h"
+
+// 下文用从 1 开始的节点编号 k(孩子为 2k、2k+1)，对应数组位置 k - 1。
+// 查找一直走到叶子之下，k 的二进制记录了路径：1 表示向右(该节点小于 key)。
+// 去掉末尾的 1 和紧接着的一个 0，得到最后一次向左转的节点，即答案；
+// 一路向右时结果为 0，表示不存在。
+
+#define CACHE_LINE_SIZE 64
+
+static inline size_t floor_log2(size_t n)
+{
+    return sizeof(unsigned long long) * 8 - 1 - (size_t)__builtin_clzll((unsigned long long)n);
+}
+
+/** 查找结束时的 k 换成数组位置 */
+static inline size_t result_slot(size_t k, size_t arr_len)
+{
+    k >>= __builtin_ffsll((long long)~k);
+    return 0 == k ? arr_len : k - 1;
+}
+
+/**
+ * 节点 k 向下 log2(ahead) 层的 ahead 个后代在数组中连续存放，起始位置 k * ahead - 1。
+ * eyt - 1 按缓存行对齐(eytzinger_alloc)时它们正好占满一行，预取首个元素即可；
+ * 否则跨两行，tail 为最后一个后代相对首个的字节偏移，再预取一次
+ */
+static inline size_t descendants_tail(const void *eyt, size_t ahead, size_t element_size)
+{
+    uintptr_t node0 = (uintptr_t)eyt - element_size;
+    return 0 == node0 % CACHE_LINE_SIZE ? 0 : (ahead - 1) * element_size;
+}
+
+static inline void prefetch_descendants(const char *base, size_t k, size_t ahead, size_t element_size, size_t tail)
+{
+    const char *first = base + (k * ahead - 1) * element_size;
+    __builtin_prefetch(first);
+    __builtin_prefetch(first + tail);
+}
+
+void *eytzinger_alloc(size_t arr_len, size_t element_size)
+{
+    if (0 == element_size || arr_len >= SIZE_MAX / element_size - 1)
+    {
+        return NULL;
+    }
+    // 多分配一个元素作为不用的 0 号节点，使 1 号节点之后的各段与缓存行对齐
+    void *block = NULL;
+    if (0 != posix_memalign(&block, CACHE_LINE_SIZE, (arr_len + 1) * element_size))
+    {
+        return NULL;
+    }
+    return (char *)block + element_size;
+}
+
+void eytzinger_free(void *eyt, size_t element_size)
+{
+    if (NULL != eyt)
+    {
+        free((char *)eyt - element_size);
+    }
+}
+
+/** 中序遍历以 k 为根的子树，依次填入 sorted[i...] */
+static size_t build(const char *sorted, char *out, size_t *sorted_index, size_t element_size, size_t arr_len, size_t i, size_t k)
+{
+    if (k <= arr_len)
+    {
+        i = build(sorted, out, sorted_index, element_size, arr_len, i, 2 * k);
+        memcpy(out + (k - 1) * element_size, sorted + i * element_size, element_size);
+        if (NULL != sorted_index)
+        {
+            sorted_index[k - 1] = i;
+        }
+        i = build(sorted, out, sorted_index, element_size, arr_len, i + 1, 2 * k + 1);
+    }
+    return i;
+}
+
+sort_result_t generic_eytzinger_build(
+    const void *sorted,
+    size_t arr_len,
+    size_t element_size,
+    void *out,
+    size_t *sorted_index)
+{
+    if (NULL == sorted || NULL == out)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (0 == element_size)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    build((const char *)sorted, (char *)out, sorted_index, element_size, arr_len, 0, 1);
+    return SORT_SUCCESS;
+}
+
+size_t generic_eytzinger_lower_bound(
+    const void *eyt,
+    size_t arr_len,
+    size_t element_size,
+    const void *key,
+    compare_func_t cmp)
+{
+    if (NULL == eyt || NULL == key || NULL == cmp || 0 == arr_len)
+    {
+        return arr_len;
+    }
+    // 一个缓存行能放下的同一层后代个数 ahead(2 的幂)，即向下 log2(ahead) 层的全部后代
+    size_t ahead = element_size < CACHE_LINE_SIZE ? (size_t)1 << floor_log2(CACHE_LINE_SIZE / element_size) : 1;
+    size_t tail = descendants_tail(eyt, ahead, element_size);
+    const char *base = (const char *)eyt;
+    size_t k = 1;
+    while (k <= arr_len)
+    {
+        prefetch_descendants(base, k, ahead, element_size, tail);
+        k = 2 * k + (cmp(base + (k - 1) * element_size, key) < 0);
+    }
+    return result_slot(k, arr_len);
+}
+
+void generic_eytzinger_lower_bound_batch(
+    const void *eyt,
+    size_t arr_len,
+    size_t element_size,
+    const void *keys,
+    size_t num_keys,
+    compare_func_t cmp,
+    size_t *out)
+{
+    if (NULL == keys || NULL == out || NULL == cmp)
+    {
+        return;
+    }
+    if (NULL == eyt || 0 == arr_len)
+    {
+        for (size_t i = 0; i < num_keys; i++)
+        {
+            out[i] = arr_len;
+        }
+        return;
+    }
+    const char *base = (const char *)eyt;
+    const char *key_bytes = (const char *)keys;
+    // 前 depth 层是满的，所有查询一起走完；最后一层只有部分节点
+    size_t depth = floor_log2(arr_len);
+    for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)
+    {
+        size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH;
+        const char *key = key_bytes + first * element_size;
+        size_t k[SEARCH_BATCH_WIDTH];
+        for (size_t i = 0; i < width; i++)
+        {
+            k[i] = 1;
+        }
+        for (size_t level = 0; level < depth; level++)
+        {
+            for (size_t i = 0; i < width; i++)
+            {
+                k[i] = 2 * k[i] + (cmp(base + (k[i] - 1) * element_size, key + i * element_size) < 0);
+                __builtin_prefetch(base + (k[i] - 1) * element_size);
+            }
+        }
+        for (size_t i = 0; i < width; i++)
+        {
+            if (k[i] <= arr_len)
+            {
+                k[i] = 2 * k[i] + (cmp(base + (k[i] - 1) * element_size, key + i * element_size) < 0);
+            }
+            out[first + i] = result_slot(k[i], arr_len);
+        }
+    }
+}
+
+#define DEFINE_TYPED_EYTZINGER(NAME, T)                                                               \
+    size_t eytzinger_lower_bound_##NAME(const T *eyt, size_t arr_len, T key)                         \
+    {                                                                                                 \
+        if (NULL == eyt || 0 == arr_len)                                                              \
+        {                                                                                             \
+            return arr_len;                                                                           \
+        }                                                                                             \
+        const size_t ahead = CACHE_LINE_SIZE / sizeof(T);                                             \
+        size_t tail = descendants_tail(eyt, ahead, sizeof(T));                                        \
+        size_t k = 1;                                                                                 \
+        /* 对齐时只预取一行：循环受访存延迟限制，多一条预取指令也有可见的开销 */                      \
+        if (0 == tail)                                                                                \
+        {                                                                                             \
+            while (k <= arr_len)                                                                      \
+            {                                                                                         \
+                __builtin_prefetch(eyt + k * ahead - 1);                                              \
+                k = 2 * k + (eyt[k - 1] < key);                                                       \
+            }                                                                                         \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            while (k <= arr_len)                                                                      \
+            {                                                                                         \
+                prefetch_descendants((const char *)eyt, k, ahead, sizeof(T), tail);                   \
+                k = 2 * k + (eyt[k - 1] < key);                                                       \
+            }                                                                                         \
+        }                                                                                             \
+        return result_slot(k, arr_len);                                                               \
+    }                                                                                                 \
+                                                                                                      \
+    void eytzinger_lower_bound_##NAME##_batch(const T *eyt, size_t arr_len, const T *keys, size_t num_keys, size_t *out) \
+    {                                                                                                 \
+        if (NULL == keys || NULL == out)                                                              \
+        {                                                                                             \
+            return;                                                                                   \
+        }                                                                                             \
+        if (NULL == eyt || 0 == arr_len)                                                              \
+        {                                                                                             \
+            for (size_t i = 0; i < num_keys; i++)                                                     \
+            {                                                                                         \
+                out[i] = arr_len;                                                                     \
+            }                                                                                         \
+            return;                                                                                   \
+        }                                                                                             \
+        size_t depth = floor_log2(arr_len);                                                           \
+        for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)                         \
+        {                                                                                             \
+            size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH; \
+            const T *key = keys + first;                                                              \
+            size_t k[SEARCH_BATCH_WIDTH];                                                             \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                k[i] = 1;                                                                             \
+            }                                                                                         \
+            for (size_t level = 0; level < depth; level++)                                            \
+            {                                                                                         \
+                for (size_t i = 0; i < width; i++)                                                    \
+                {                                                                                     \
+                    k[i] = 2 * k[i] + (eyt[k[i] - 1] < key[i]);                                       \
+                    __builtin_prefetch(eyt + k[i] - 1);                                               \
+                }                                                                                     \
+            }                                                                                         \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                if (k[i] <= arr_len)                                                                  \
+                {                                                                                     \
+                    k[i] = 2 * k[i] + (eyt[k[i] - 1] < key[i]);                                       \
+                }                                                                                     \
+                out[first + i] = result_slot(k[i], arr_len);                                          \
+            }                                                                                         \
+        }                                                                                             \
+    }
+
+DEFINE_TYPED_EYTZINGER(int32, int32_t)
+DEFINE_TYPED_EYTZINGER(int64, int64_t)
+DEFINE_TYPED_EYTZINGER(float, float)
+DEFINE_TYPED_EYTZINGER(double, double)
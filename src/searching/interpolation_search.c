@@ -0,0 +1,84 @@
+#include "searching/interpolation_search.h"
+#include "searching/binary_search.h"
+
+static inline size_t floor_log2(size_t n)
+{
+    return sizeof(unsigned long long) * 8 - 1 - (size_t)__builtin_clzll((unsigned long long)n);
+}
+
+// 循环中保持：lo 之前的元素都小于 key，hi 及之后的元素都不小于 key，答案在 [lo, hi] 内。
+// 每次探测前检查区间两端，key 落在端点之外时直接得到答案；否则 first < key <= last，
+// 按比例估计的位置一定落在区间内。比例不是有限值(浮点数组两端有无穷大)时取中点。
+//
+// 只按估计位置单侧收缩区间时，即使估计很准，剩下的一侧也可能很长。因此在估计位置
+// 向 key 所在方向再跨出约 sqrt(区间长度) 个元素探测一次(哨兵)：估计误差在这个范围内时
+// 区间直接缩小到哨兵宽度。两处探测地址同时算出并预取，缓存未命中可以重叠。
+// 任何一轮后区间没有减半，就说明分布不适合插值，不再继续探测，立即在整个数组上
+// 改用二分查找。
+#define DEFINE_INTERPOLATION_SEARCH(NAME, T)                                                          \
+    size_t interpolation_search_##NAME(const T *arr, size_t arr_len, T key)                          \
+    {                                                                                                 \
+        if (NULL == arr || 0 == arr_len)                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        size_t lo = 0;                                                                                \
+        size_t hi = arr_len;                                                                          \
+        size_t probes = floor_log2(floor_log2(arr_len) + 1) + INTERPOLATION_SEARCH_EXTRA_PROBES;      \
+        while (hi - lo > INTERPOLATION_SEARCH_MIN_RANGE && probes-- > 0)                              \
+        {                                                                                             \
+            T first = arr[lo];                                                                        \
+            T last = arr[hi - 1];                                                                     \
+            if (!(first < key))                                                                       \
+            {                                                                                         \
+                return lo;                                                                            \
+            }                                                                                         \
+            if (last < key)                                                                           \
+            {                                                                                         \
+                return hi;                                                                            \
+            }                                                                                         \
+            size_t range = hi - lo;                                                                   \
+            size_t span = range - 1;                                                                  \
+            size_t guard = (size_t)1 << (floor_log2(range) / 2);                                      \
+            double frac = ((double)key - (double)first) / ((double)last - (double)first);             \
+            size_t pos = frac > 0.0 && frac <= 1.0 ? lo + (size_t)(frac * (double)span) : lo + span / 2; \
+            size_t right = hi - pos > guard ? pos + guard : hi - 1;                                   \
+            size_t left = pos - lo > guard ? pos - guard : lo;                                        \
+            __builtin_prefetch(arr + right);                                                          \
+            __builtin_prefetch(arr + left);                                                           \
+            if (arr[pos] < key)                                                                       \
+            {                                                                                         \
+                lo = pos + 1;                                                                         \
+                if (!(arr[right] < key))                                                              \
+                {                                                                                     \
+                    hi = right;                                                                       \
+                }                                                                                     \
+                else                                                                                  \
+                {                                                                                     \
+                    lo = right + 1;                                                                   \
+                }                                                                                     \
+            }                                                                                         \
+            else                                                                                      \
+            {                                                                                         \
+                hi = pos;                                                                             \
+                if (arr[left] < key)                                                                  \
+                {                                                                                     \
+                    lo = left + 1;                                                                    \
+                }                                                                                     \
+                else                                                                                  \
+                {                                                                                     \
+                    hi = left;                                                                        \
+                }                                                                                     \
+            }                                                                                         \
+            if (hi - lo > range / 2)                                                                  \
+            {                                                                                         \
+                return lower_bound_##NAME(arr, arr_len, key);                                         \
+            }                                                                                         \
+        }                                                                                             \
+        return lo + lower_bound_##NAME(arr + lo, hi - lo, key);                                       \
+    }
+
+DEFINE_INTERPOLATION_SEARCH(int32, int32_t)
+DEFINE_INTERPOLATION_SEARCH(int64, int64_t)
+DEFINE_INTERPOLATION_SEARCH(float, float)
+DEFINE_INTERPOLATION_SEARCH(double, double)
@@ -0,0 +1,632 @@
+#include <stdlib.h>
+#include "searching/learned_index.h"
+#include "searching/binary_search.h"
+#include "util/scratch_arena.h"
+
+/** 每一层的段数至少减半(任意两个点都能放进同一段)，64 层足够 */
+#define LEARNED_INDEX_MAX_LEVELS 64
+
+// 键与位置的乘积最多约 2^64 * 2^64，凸包计算用 128 位整数，没有舍入误差
+__extension__ typedef __int128 wide_t;
+
+typedef struct
+{
+    uint64_t key;     /**< 段内第一个键(映射为无符号后的值) */
+    double slope;     /**< 位置 = intercept + slope * (x - key) */
+    double intercept;
+} learned_segment_t;
+
+struct learned_index
+{
+    const void *data;
+    size_t arr_len;
+    size_t epsilon;
+    size_t num_levels;
+    size_t level_offset[LEARNED_INDEX_MAX_LEVELS + 1]; /**< 第 l 层的段为 segments[level_offset[l], level_offset[l+1]) */
+    learned_segment_t *segments;
+    size_t memory_bytes;
+};
+
+/* ============================================================================
+ * 流式最优分段线性拟合
+ * ============================================================================
+ */
+
+// 每个点 (x, y) 对应竖直线段 [(x, y-eps), (x, y+eps)]，要找穿过所有线段的直线。
+// 可行直线中斜率最小的一条经过 rect[0](某个上端点)和 rect[2](某个下端点)，
+// 斜率最大的一条经过 rect[1](下端点)和 rect[3](上端点)。新点落在两条极端直线
+// 之外时当前段结束；否则沿上端点的下凸包 upper 和下端点的上凸包 lower 收紧
+// 极端直线。每个点至多进出凸包一次，总代价 O(n)。与 PGM-index 的做法相同。
+
+typedef struct
+{
+    wide_t x;
+    wide_t y;
+} pla_point_t;
+
+typedef struct
+{
+    pla_point_t *data;
+    size_t size;
+    size_t capacity;
+} pla_hull_t;
+
+typedef struct
+{
+    wide_t epsilon;
+    size_t points;
+    uint64_t first_key;
+    pla_point_t rect[4];
+    pla_hull_t upper;
+    pla_hull_t lower;
+    size_t upper_start;
+    size_t lower_start;
+} pla_t;
+
+typedef struct
+{
+    learned_segment_t *data;
+    size_t size;
+    size_t capacity;
+} segment_buffer_t;
+
+/** 两点之差，当作斜率 (dx, dy) 使用 */
+static inline pla_point_t diff(pla_point_t a, pla_point_t b)
+{
+    pla_point_t d = {a.x - b.x, a.y - b.y};
+    return d;
+}
+
+/** 斜率比较，要求两者 dx 同号 */
+static inline int slope_less(pla_point_t a, pla_point_t b)
+{
+    return a.y * b.x < b.y * a.x;
+}
+
+static inline int slope_greater(pla_point_t a, pla_point_t b)
+{
+    return a.y * b.x > b.y * a.x;
+}
+
+static inline wide_t cross(pla_point_t o, pla_point_t a, pla_point_t b)
+{
+    pla_point_t oa = diff(a, o);
+    pla_point_t ob = diff(b, o);
+    return oa.x * ob.y - oa.y * ob.x;
+}
+
+static int hull_push(pla_hull_t *hull, pla_point_t p)
+{
+    if (hull->size == hull->capacity)
+    {
+        size_t capacity = hull->capacity > 0 ? hull->capacity * 2 : 64;
+        pla_point_t *data = scratch_alloc(capacity * sizeof(pla_point_t));
+        if (NULL == data)
+        {
+            return 0;
+        }
+        if (hull->size > 0)
+        {
+            memcpy(data, hull->data, hull->size * sizeof(pla_point_t));
+        }
+        scratch_free(hull->data);
+        hull->data = data;
+        hull->capacity = capacity;
+    }
+    hull->data[hull->size++] = p;
+    return 1;
+}
+
+static void pla_init(pla_t *pla, size_t epsilon)
+{
+    memset(pla, 0, sizeof(pla_t));
+    pla->epsilon = (wide_t)epsilon;
+}
+
+static void pla_free(pla_t *pla)
+{
+    scratch_free(pla->upper.data);
+    scratch_free(pla->lower.data);
+}
+
+/**
+ * @brief 尝试把点 (key, pos) 加入当前段，key 必须严格递增
+ * @return 1 表示加入，0 表示当前段已容不下该点，-1 表示内存不足
+ */
+static int pla_add(pla_t *pla, uint64_t key, size_t pos)
+{
+    pla_point_t p1 = {(wide_t)key, (wide_t)pos + pla->epsilon};
+    pla_point_t p2 = {(wide_t)key, (wide_t)pos - pla->epsilon};
+    pla_point_t *rect = pla->rect;
+
+    if (0 == pla->points)
+    {
+        pla->first_key = key;
+        rect[0] = p1;
+        rect[1] = p2;
+        pla->upper.size = 0;
+        pla->lower.size = 0;
+        pla->upper_start = 0;
+        pla->lower_start = 0;
+        pla->points = 1;
+        return hull_push(&pla->upper, p1) && hull_push(&pla->lower, p2) ? 1 : -1;
+    }
+    if (1 == pla->points)
+    {
+        rect[2] = p2;
+        rect[3] = p1;
+        pla->points = 2;
+        return hull_push(&pla->upper, p1) && hull_push(&pla->lower, p2) ? 1 : -1;
+    }
+
+    pla_point_t slope1 = diff(rect[2], rect[0]);
+    pla_point_t slope2 = diff(rect[3], rect[1]);
+    if (slope_less(diff(p1, rect[2]), slope1) || slope_greater(diff(p2, rect[3]), slope2))
+    {
+        return 0;
+    }
+
+    if (slope_less(diff(p1, rect[1]), slope2))
+    {
+        // 最大斜率收紧：在 lower 上找与 p1 连线斜率最小的点
+        pla_hull_t *lower = &pla->lower;
+        pla_point_t min = diff(lower->data[pla->lower_start], p1);
+        size_t min_i = pla->lower_start;
+        for (size_t i = pla->lower_start + 1; i < lower->size; i++)
+        {
+            pla_point_t val = diff(lower->data[i], p1);
+            if (slope_greater(val, min))
+            {
+                break;
+            }
+            min = val;
+            min_i = i;
+        }
+        rect[1] = lower->data[min_i];
+        rect[3] = p1;
+        pla->lower_start = min_i;
+
+        pla_hull_t *upper = &pla->upper;
+        size_t end = upper->size;
+        while (end >= pla->upper_start + 2 && cross(upper->data[end - 2], upper->data[end - 1], p1) <= 0)
+        {
+            end--;
+        }
+        upper->size = end;
+        if (!hull_push(upper, p1))
+        {
+            return -1;
+        }
+    }
+
+    if (slope_greater(diff(p2, rect[0]), slope1))
+    {
+        // 最小斜率收紧：在 upper 上找与 p2 连线斜率最大的点
+        pla_hull_t *upper = &pla->upper;
+        pla_point_t max = diff(upper->data[pla->upper_start], p2);
+        size_t max_i = pla->upper_start;
+        for (size_t i = pla->upper_start + 1; i < upper->size; i++)
+        {
+            pla_point_t val = diff(upper->data[i], p2);
+            if (slope_less(val, max))
+            {
+                break;
+            }
+            max = val;
+            max_i = i;
+        }
+        rect[0] = upper->data[max_i];
+        rect[2] = p2;
+        pla->upper_start = max_i;
+
+        pla_hull_t *lower = &pla->lower;
+        size_t end = lower->size;
+        while (end >= pla->lower_start + 2 && cross(lower->data[end - 2], lower->data[end - 1], p2) >= 0)
+        {
+            end--;
+        }
+        lower->size = end;
+        if (!hull_push(lower, p2))
+        {
+            return -1;
+        }
+    }
+
+    pla->points++;
+    return 1;
+}
+
+/** 两条极端直线的平均仍是可行直线(可行集合在参数空间是凸的)，取它作为这一段 */
+static learned_segment_t pla_segment(const pla_t *pla)
+{
+    const pla_point_t *rect = pla->rect;
+    learned_segment_t seg = {pla->first_key, 0.0, 0.0};
+    if (1 == pla->points)
+    {
+        seg.intercept = (double)((rect[0].y + rect[1].y) / 2);
+        return seg;
+    }
+    long double s1 = (long double)(rect[2].y - rect[0].y) / (long double)(rect[2].x - rect[0].x);
+    long double s2 = (long double)(rect[3].y - rect[1].y) / (long double)(rect[3].x - rect[1].x);
+    wide_t first = (wide_t)pla->first_key;
+    long double y1 = (long double)rect[0].y + s1 * (long double)(first - rect[0].x);
+    long double y2 = (long double)rect[1].y + s2 * (long double)(first - rect[1].x);
+    seg.slope = (double)((s1 + s2) / 2);
+    seg.intercept = (double)((y1 + y2) / 2);
+    return seg;
+}
+
+static sort_result_t segment_push(segment_buffer_t *buf, learned_segment_t seg)
+{
+    if (buf->size == buf->capacity)
+    {
+        size_t capacity = buf->capacity > 0 ? buf->capacity * 2 : 64;
+        learned_segment_t *data = realloc(buf->data, capacity * sizeof(learned_segment_t));
+        if (NULL == data)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+    buf->data[buf->size++] = seg;
+    return SORT_SUCCESS;
+}
+
+static sort_result_t fit_point(pla_t *pla, segment_buffer_t *buf, uint64_t key, size_t pos)
+{
+    int added = pla_add(pla, key, pos);
+    if (0 == added)
+    {
+        sort_result_t res = segment_push(buf, pla_segment(pla));
+        if (SORT_SUCCESS != res)
+        {
+            return res;
+        }
+        pla->points = 0;
+        added = pla_add(pla, key, pos);
+    }
+    return added < 0 ? SORT_ERROR_ALLOCATION_FAILED : SORT_SUCCESS;
+}
+
+static sort_result_t fit_finish(pla_t *pla, segment_buffer_t *buf)
+{
+    return pla->points > 0 ? segment_push(buf, pla_segment(pla)) : SORT_SUCCESS;
+}
+
+/** 在第 0 层之上逐层拟合各段的起始键，直到只剩一段 */
+static sort_result_t fit_upper_levels(learned_index_t *index, segment_buffer_t *buf)
+{
+    index->num_levels = 1;
+    index->level_offset[0] = 0;
+    index->level_offset[1] = buf->size;
+    while (index->level_offset[index->num_levels] - index->level_offset[index->num_levels - 1] > 1)
+    {
+        if (LEARNED_INDEX_MAX_LEVELS == index->num_levels)
+        {
+            return SORT_ERROR_INVALID_LENGTH;
+        }
+        size_t first = index->level_offset[index->num_levels - 1];
+        size_t last = index->level_offset[index->num_levels];
+        pla_t pla;
+        pla_init(&pla, LEARNED_INDEX_EPSILON_RECURSIVE);
+        sort_result_t res = SORT_SUCCESS;
+        for (size_t j = first; j < last && SORT_SUCCESS == res; j++)
+        {
+            // buf 在循环中会增长，按下标读取
+            res = fit_point(&pla, buf, buf->data[j].key, j - first);
+        }
+        if (SORT_SUCCESS == res)
+        {
+            res = fit_finish(&pla, buf);
+        }
+        pla_free(&pla);
+        if (SORT_SUCCESS != res)
+        {
+            return res;
+        }
+        index->level_offset[++index->num_levels] = buf->size;
+    }
+    return SORT_SUCCESS;
+}
+
+typedef sort_result_t (*fit_level0_func_t)(const void *sorted, size_t arr_len, size_t epsilon, segment_buffer_t *buf);
+
+static sort_result_t build_ex(const void *sorted, size_t arr_len, size_t element_size, size_t epsilon,
+                              fit_level0_func_t fit_level0, learned_index_t **out, sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == out || (NULL == sorted && arr_len > 0))
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_NULL_POINTER;
+    }
+    *out = NULL;
+    learned_index_t *index = calloc(1, sizeof(learned_index_t));
+    if (NULL == index)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    index->data = sorted;
+    index->arr_len = arr_len;
+    index->epsilon = epsilon;
+
+    segment_buffer_t buf = {NULL, 0, 0};
+    sort_result_t res = SORT_SUCCESS;
+    if (arr_len > 0)
+    {
+        res = fit_level0(sorted, arr_len, epsilon, &buf);
+        if (SORT_SUCCESS == res)
+        {
+            res = fit_upper_levels(index, &buf);
+        }
+    }
+    if (SORT_SUCCESS != res)
+    {
+        free(buf.data);
+        free(index);
+        STOP_TIMMING(stats);
+        return res;
+    }
+    if (buf.size > 0 && buf.size < buf.capacity)
+    {
+        learned_segment_t *data = realloc(buf.data, buf.size * sizeof(learned_segment_t));
+        buf.data = NULL != data ? data : buf.data;
+    }
+    index->segments = buf.data;
+    index->memory_bytes = sizeof(learned_index_t) + buf.size * sizeof(learned_segment_t);
+    *out = index;
+    STOP_TIMMING(stats);
+    if (NULL != stats)
+    {
+        // 索引常驻内存，不受 PRINT_SORTING_INFO 控制，总是报告
+        stats->memory_used = index->memory_bytes;
+        stats->max_mamory_used = index->memory_bytes;
+    }
+    return SORT_SUCCESS;
+}
+
+void learned_index_destroy(learned_index_t *index)
+{
+    if (NULL == index)
+    {
+        return;
+    }
+    free(index->segments);
+    free(index);
+}
+
+size_t learned_index_segments(const learned_index_t *index)
+{
+    return NULL == index || 0 == index->num_levels ? 0 : index->level_offset[1];
+}
+
+size_t learned_index_levels(const learned_index_t *index)
+{
+    return NULL == index ? 0 : index->num_levels;
+}
+
+size_t learned_index_memory_bytes(const learned_index_t *index)
+{
+    return NULL == index ? 0 : index->memory_bytes;
+}
+
+/* ============================================================================
+ * 查询
+ * ============================================================================
+ */
+
+/** 段对 x 的预测位置，截断到 [0, limit] */
+static inline size_t predict(const learned_segment_t *seg, uint64_t x, size_t limit)
+{
+    double dx = x > seg->key ? (double)(x - seg->key) : 0.0;
+    double p = seg->intercept + seg->slope * dx;
+    if (!(p > 0.0))
+    {
+        return 0;
+    }
+    return p < (double)limit ? (size_t)p : limit;
+}
+
+static size_t segment_upper_bound(const learned_segment_t *segs, size_t lo, size_t hi, uint64_t x)
+{
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (segs[mid].key <= x)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/** 在 m 个段中找起始键不大于 x 的最后一段(没有时取第 0 段)，先查预测窗口 */
+static size_t find_segment(const learned_segment_t *segs, size_t m, size_t pos, uint64_t x)
+{
+    const size_t eps = LEARNED_INDEX_EPSILON_RECURSIVE;
+    size_t lo = pos > eps + 1 ? pos - eps - 1 : 0;
+    size_t hi = pos + eps + 2 < m ? pos + eps + 2 : m;
+    size_t r;
+    if (lo > 0 && segs[lo - 1].key > x)
+    {
+        r = segment_upper_bound(segs, 0, lo, x);
+    }
+    else
+    {
+        r = segment_upper_bound(segs, lo, hi, x);
+        if (r == hi && hi < m && segs[hi].key <= x)
+        {
+            r = segment_upper_bound(segs, hi, m, x);
+        }
+    }
+    return r > 0 ? r - 1 : 0;
+}
+
+/** 从根向下定位 x 所在的第 0 层段，返回 x 在数据中的预测位置 */
+static inline size_t predict_position(const learned_index_t *index, uint64_t x)
+{
+    const learned_segment_t *segs = index->segments;
+    size_t s = 0;
+    for (size_t l = index->num_levels - 1; l > 0; l--)
+    {
+        size_t below = index->level_offset[l - 1];
+        size_t m = index->level_offset[l] - below;
+        size_t pos = predict(segs + index->level_offset[l] + s, x, m);
+        s = find_segment(segs + below, m, pos, x);
+    }
+    return predict(segs + s, x, index->arr_len);
+}
+
+// 有符号键翻转符号位后按无符号比较，顺序不变
+#define KEY_TO_U64_int64(k) ((uint64_t)(k) ^ ((uint64_t)1 << 63))
+#define KEY_TO_U64_uint64(k) ((uint64_t)(k))
+
+#define DEFINE_LEARNED_INDEX(NAME, T)                                                                 \
+    static sort_result_t fit_level0_##NAME(const void *sorted, size_t arr_len, size_t epsilon, segment_buffer_t *buf) \
+    {                                                                                                 \
+        const T *keys = (const T *)sorted;                                                            \
+        pla_t pla;                                                                                    \
+        pla_init(&pla, epsilon);                                                                      \
+        sort_result_t res = SORT_SUCCESS;                                                             \
+        for (size_t i = 0; i < arr_len && SORT_SUCCESS == res; i++)                                   \
+        {                                                                                             \
+            /* 重复的键只取第一次出现的位置，即它的 lower bound */                                    \
+            if (i > 0 && keys[i] == keys[i - 1])                                                      \
+            {                                                                                         \
+                continue;                                                                             \
+            }                                                                                         \
+            res = fit_point(&pla, buf, KEY_TO_U64_##NAME(keys[i]), i);                                \
+        }                                                                                             \
+        if (SORT_SUCCESS == res)                                                                      \
+        {                                                                                             \
+            res = fit_finish(&pla, buf);                                                              \
+        }                                                                                             \
+        pla_free(&pla);                                                                               \
+        return res;                                                                                   \
+    }                                                                                                 \
+                                                                                                      \
+    sort_result_t learned_index_build_##NAME##_ex(const T *sorted, size_t arr_len, size_t epsilon,    \
+                                                  learned_index_t **out, sort_stats_t *stats)         \
+    {                                                                                                 \
+        return build_ex(sorted, arr_len, sizeof(T), epsilon, fit_level0_##NAME, out, stats);          \
+    }                                                                                                 \
+                                                                                                      \
+    sort_result_t learned_index_build_##NAME(const T *sorted, size_t arr_len, size_t epsilon, learned_index_t **out) \
+    {                                                                                                 \
+        return learned_index_build_##NAME##_ex(sorted, arr_len, epsilon, out, NULL);                  \
+    }                                                                                                 \
+                                                                                                      \
+    /* 在预测位置附近的窗口里查找，窗口没有覆盖答案时退回到窗口外 */                                  \
+    static inline size_t last_mile_##NAME(const learned_index_t *index, T key, size_t pos)           \
+    {                                                                                                 \
+        const T *data = (const T *)index->data;                                                       \
+        size_t n = index->arr_len;                                                                    \
+        size_t eps = index->epsilon;                                                                  \
+        size_t lo = pos > eps + 1 ? pos - eps - 1 : 0;                                                \
+        size_t hi = pos + eps + 2 < n ? pos + eps + 2 : n;                                            \
+        /* 窗口只有十几个缓存行，一次全部预取，二分查找的各步不再逐个等待内存 */                      \
+        for (const char *p = (const char *)(data + lo); p < (const char *)(data + hi); p += 64)     \
+        {                                                                                             \
+            __builtin_prefetch(p);                                                                    \
+        }                                                                                             \
+        if (lo > 0 && !(data[lo - 1] < key))                                                          \
+        {                                                                                             \
+            return lower_bound_##NAME(data, lo, key);                                                 \
+        }                                                                                             \
+        size_t r = lo + lower_bound_##NAME(data + lo, hi - lo, key);                                  \
+        if (r == hi && hi < n && data[hi] < key)                                                      \
+        {                                                                                             \
+            r = hi + lower_bound_##NAME(data + hi, n - hi, key);                                      \
+        }                                                                                             \
+        return r;                                                                                     \
+    }                                                                                                 \
+                                                                                                      \
+    size_t learned_index_lower_bound_##NAME(const learned_index_t *index, T key)                      \
+    {                                                                                                 \
+        if (NULL == index || 0 == index->arr_len)                                                     \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        return last_mile_##NAME(index, key, predict_position(index, KEY_TO_U64_##NAME(key)));         \
+    }                                                                                                 \
+                                                                                                      \
+    void learned_index_lower_bound_##NAME##_batch(const learned_index_t *index, const T *keys, size_t num_keys, size_t *out) \
+    {                                                                                                 \
+        if (NULL == keys || NULL == out)                                                              \
+        {                                                                                             \
+            return;                                                                                   \
+        }                                                                                             \
+        if (NULL == index || 0 == index->arr_len)                                                     \
+        {                                                                                             \
+            memset(out, 0, num_keys * sizeof(size_t));                                                \
+            return;                                                                                   \
+        }                                                                                             \
+        const T *data = (const T *)index->data;                                                       \
+        size_t n = index->arr_len;                                                                    \
+        size_t eps = index->epsilon;                                                                  \
+        size_t window = 2 * eps + 3;                                                                  \
+        if (window > n)                                                                               \
+        {                                                                                             \
+            for (size_t i = 0; i < num_keys; i++)                                                     \
+            {                                                                                         \
+                out[i] = learned_index_lower_bound_##NAME(index, keys[i]);                            \
+            }                                                                                         \
+            return;                                                                                   \
+        }                                                                                             \
+        /* 窗口平移到数组之内而不截断，所有查询的窗口等长，可以像二分查找的批量版本一样同步推进 */ \
+        for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)                         \
+        {                                                                                             \
+            size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH; \
+            const T *key = keys + first;                                                              \
+            const T *base[SEARCH_BATCH_WIDTH];                                                        \
+            size_t lo[SEARCH_BATCH_WIDTH];                                                            \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                size_t pos = predict_position(index, KEY_TO_U64_##NAME(key[i]));                      \
+                size_t l = pos > eps + 1 ? pos - eps - 1 : 0;                                         \
+                lo[i] = l < n - window ? l : n - window;                                              \
+                base[i] = data + lo[i];                                                               \
+                for (const char *p = (const char *)base[i]; p < (const char *)(base[i] + window); p += 64) \
+                {                                                                                     \
+                    __builtin_prefetch(p);                                                            \
+                }                                                                                     \
+            }                                                                                         \
+            size_t len = window;                                                                      \
+            while (len > 1)                                                                           \
+            {                                                                                         \
+                size_t half = len / 2;                                                                \
+                len -= half;                                                                          \
+                for (size_t i = 0; i < width; i++)                                                    \
+                {                                                                                     \
+                    const T *b = base[i][half] < key[i] ? base[i] + half : base[i];                   \
+                    base[i] = b;                                                                      \
+                    __builtin_prefetch(b + len / 2);                                                  \
+                }                                                                                     \
+            }                                                                                         \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                size_t r = (size_t)(base[i] - data) + (*base[i] < key[i]);                            \
+                size_t hi = lo[i] + window;                                                           \
+                if (lo[i] > 0 && !(data[lo[i] - 1] < key[i]))                                         \
+                {                                                                                     \
+                    r = lower_bound_##NAME(data, lo[i], key[i]);                                      \
+                }                                                                                     \
+                else if (r == hi && hi < n && data[hi] < key[i])                                      \
+                {                                                                                     \
+                    r = hi + lower_bound_##NAME(data + hi, n - hi, key[i]);                           \
+                }                                                                                     \
+                out[first + i] = r;                                                                   \
+            }                                                                                         \
+        }                                                                                             \
+    }
+
+DEFINE_LEARNED_INDEX(int64, int64_t)
+DEFINE_LEARNED_INDEX(uint64, uint64_t)
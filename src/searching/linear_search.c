@@ -0,0 +1,363 @@
+#include "searching/linear_search.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINEAR_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+/* ============================================================================
+ * 指令集选择与分界点
+ * ============================================================================
+ */
+
+static int simd_level = -1;
+static size_t crossover_bytes = LINEAR_SEARCH_DEFAULT_CROSSOVER_BYTES;
+
+static linear_search_simd_t detect_simd_level(void)
+{
+#if defined(LINEAR_SEARCH_X86)
+    if (sort_cpu_has_avx2())
+    {
+        return LINEAR_SEARCH_AVX2;
+    }
+    // x86-64 总是支持 SSE2
+    return LINEAR_SEARCH_SSE;
+#else
+    return LINEAR_SEARCH_SCALAR;
+#endif
+}
+
+linear_search_simd_t linear_search_simd_level(void)
+{
+    int level = __atomic_load_n(&simd_level, __ATOMIC_RELAXED);
+    if (level < 0)
+    {
+        level = (int)detect_simd_level();
+        __atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+    }
+    return (linear_search_simd_t)level;
+}
+
+linear_search_simd_t linear_search_set_simd_level(linear_search_simd_t level)
+{
+    linear_search_simd_t max = detect_simd_level();
+    level = level > max ? max : level;
+    __atomic_store_n(&simd_level, (int)level, __ATOMIC_RELAXED);
+    return level;
+}
+
+size_t linear_search_crossover_bytes(void)
+{
+    return __atomic_load_n(&crossover_bytes, __ATOMIC_RELAXED);
+}
+
+void linear_search_set_crossover_bytes(size_t bytes)
+{
+    __atomic_store_n(&crossover_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ * 标量实现
+ * ============================================================================
+ */
+
+#define DEFINE_SCALAR_LINEAR(NAME, T)                                                                 \
+    static size_t find_##NAME##_scalar(const T *arr, size_t arr_len, T key)                          \
+    {                                                                                                 \
+        for (size_t i = 0; i < arr_len; i++)                                                          \
+        {                                                                                             \
+            if (arr[i] == key)                                                                        \
+            {                                                                                         \
+                return i;                                                                             \
+            }                                                                                         \
+        }                                                                                             \
+        return SEARCH_NOT_FOUND;                                                                      \
+    }                                                                                                 \
+                                                                                                      \
+    static size_t count_##NAME##_scalar(const T *arr, size_t arr_len, T key)                         \
+    {                                                                                                 \
+        size_t count = 0;                                                                             \
+        for (size_t i = 0; i < arr_len; i++)                                                          \
+        {                                                                                             \
+            count += arr[i] == key;                                                                   \
+        }                                                                                             \
+        return count;                                                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    static size_t count_not_greater_##NAME##_scalar(const T *arr, size_t arr_len, T key)             \
+    {                                                                                                 \
+        size_t count = 0;                                                                             \
+        for (size_t i = 0; i < arr_len; i++)                                                          \
+        {                                                                                             \
+            count += !(arr[i] > key);                                                                 \
+        }                                                                                             \
+        return count;                                                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    static size_t greater_##NAME##_scalar(const T *arr, size_t arr_len, T key)                       \
+    {                                                                                                 \
+        for (size_t i = 0; i < arr_len; i++)                                                          \
+        {                                                                                             \
+            if (arr[i] > key)                                                                         \
+            {                                                                                         \
+                return i;                                                                             \
+            }                                                                                         \
+        }                                                                                             \
+        return arr_len;                                                                               \
+    }
+
+DEFINE_SCALAR_LINEAR(int32, int32_t)
+DEFINE_SCALAR_LINEAR(int64, int64_t)
+DEFINE_SCALAR_LINEAR(float, float)
+
+/* ============================================================================
+ * SIMD 实现
+ * ============================================================================
+ */
+
+// 每轮比较两个向量，位图拼成 2 * LANES 位；尾部不足两个向量的元素逐个比较
+#define DEFINE_SIMD_LINEAR(ISA, NAME, T, ATTR, LANES, VEC, SET1, LOAD, CMPEQ, CMPGT, MASK)           \
+    ATTR static size_t find_##NAME##_##ISA(const T *arr, size_t arr_len, T key)                      \
+    {                                                                                                 \
+        VEC k = SET1(key);                                                                            \
+        size_t i = 0;                                                                                 \
+        for (; i + 2 * LANES <= arr_len; i += 2 * LANES)                                              \
+        {                                                                                             \
+            unsigned mask = MASK(CMPEQ(LOAD(arr + i), k)) | MASK(CMPEQ(LOAD(arr + i + LANES), k)) << LANES; \
+            if (0 != mask)                                                                            \
+            {                                                                                         \
+                return i + (size_t)__builtin_ctz(mask);                                               \
+            }                                                                                         \
+        }                                                                                             \
+        size_t r = find_##NAME##_scalar(arr + i, arr_len - i, key);                                   \
+        return SEARCH_NOT_FOUND == r ? r : i + r;                                                     \
+    }                                                                                                 \
+                                                                                                      \
+    ATTR static size_t count_##NAME##_##ISA(const T *arr, size_t arr_len, T key)                     \
+    {                                                                                                 \
+        VEC k = SET1(key);                                                                            \
+        size_t count = 0;                                                                             \
+        size_t i = 0;                                                                                 \
+        for (; i + 2 * LANES <= arr_len; i += 2 * LANES)                                              \
+        {                                                                                             \
+            unsigned mask = MASK(CMPEQ(LOAD(arr + i), k)) | MASK(CMPEQ(LOAD(arr + i + LANES), k)) << LANES; \
+            count += (size_t)__builtin_popcount(mask);                                                \
+        }                                                                                             \
+        return count + count_##NAME##_scalar(arr + i, arr_len - i, key);                              \
+    }                                                                                                 \
+                                                                                                      \
+    ATTR static size_t count_not_greater_##NAME##_##ISA(const T *arr, size_t arr_len, T key)         \
+    {                                                                                                 \
+        VEC k = SET1(key);                                                                            \
+        size_t count = 0;                                                                             \
+        size_t i = 0;                                                                                 \
+        for (; i + 2 * LANES <= arr_len; i += 2 * LANES)                                              \
+        {                                                                                             \
+            unsigned mask = MASK(CMPGT(LOAD(arr + i), k)) | MASK(CMPGT(LOAD(arr + i + LANES), k)) << LANES; \
+            count += 2 * LANES - (size_t)__builtin_popcount(mask);                                    \
+        }                                                                                             \
+        return count + count_not_greater_##NAME##_scalar(arr + i, arr_len - i, key);                  \
+    }                                                                                                 \
+                                                                                                      \
+    ATTR static size_t greater_##NAME##_##ISA(const T *arr, size_t arr_len, T key)                   \
+    {                                                                                                 \
+        VEC k = SET1(key);                                                                            \
+        size_t i = 0;                                                                                 \
+        for (; i + 2 * LANES <= arr_len; i += 2 * LANES)                                              \
+        {                                                                                             \
+            unsigned mask = MASK(CMPGT(LOAD(arr + i), k)) | MASK(CMPGT(LOAD(arr + i + LANES), k)) << LANES; \
+            if (0 != mask)                                                                            \
+            {                                                                                         \
+                return i + (size_t)__builtin_ctz(mask);                                               \
+            }                                                                                         \
+        }                                                                                             \
+        return i + greater_##NAME##_scalar(arr + i, arr_len - i, key);                                \
+    }
+
+#if defined(LINEAR_SEARCH_X86)
+
+/** int64 的 SSE 比较需要 SSE4.2(pcmpgtq)，不支持时 SSE 一级退回标量 */
+static int cpu_has_sse42(void)
+{
+    static int has_sse42 = -1;
+    if (has_sse42 < 0)
+    {
+        __builtin_cpu_init();
+        has_sse42 = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+    }
+    return has_sse42;
+}
+
+#define LINEAR_AVX2 __attribute__((target("avx2")))
+#define LINEAR_SSE42 __attribute__((target("sse4.2")))
+
+#define AVX2_LOAD_I(p) _mm256_loadu_si256((const __m256i *)(p))
+#define AVX2_MASK_I32(v) (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(v))
+#define AVX2_MASK_I64(v) (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(v))
+#define AVX2_EQ_PS(a, b) _mm256_cmp_ps((a), (b), _CMP_EQ_OQ)
+#define AVX2_GT_PS(a, b) _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define SSE_LOAD_I(p) _mm_loadu_si128((const __m128i *)(p))
+#define SSE_MASK_I32(v) (unsigned)_mm_movemask_ps(_mm_castsi128_ps(v))
+#define SSE_MASK_I64(v) (unsigned)_mm_movemask_pd(_mm_castsi128_pd(v))
+#define SSE_MASK_PS(v) (unsigned)_mm_movemask_ps(v)
+#define AVX2_MASK_PS(v) (unsigned)_mm256_movemask_ps(v)
+
+DEFINE_SIMD_LINEAR(avx2, int32, int32_t, LINEAR_AVX2, 8, __m256i, _mm256_set1_epi32, AVX2_LOAD_I,
+                   _mm256_cmpeq_epi32, _mm256_cmpgt_epi32, AVX2_MASK_I32)
+DEFINE_SIMD_LINEAR(avx2, int64, int64_t, LINEAR_AVX2, 4, __m256i, _mm256_set1_epi64x, AVX2_LOAD_I,
+                   _mm256_cmpeq_epi64, _mm256_cmpgt_epi64, AVX2_MASK_I64)
+DEFINE_SIMD_LINEAR(avx2, float, float, LINEAR_AVX2, 8, __m256, _mm256_set1_ps, _mm256_loadu_ps,
+                   AVX2_EQ_PS, AVX2_GT_PS, AVX2_MASK_PS)
+DEFINE_SIMD_LINEAR(sse, int32, int32_t, , 4, __m128i, _mm_set1_epi32, SSE_LOAD_I,
+                   _mm_cmpeq_epi32, _mm_cmpgt_epi32, SSE_MASK_I32)
+DEFINE_SIMD_LINEAR(sse, int64, int64_t, LINEAR_SSE42, 2, __m128i, _mm_set1_epi64x, SSE_LOAD_I,
+                   _mm_cmpeq_epi64, _mm_cmpgt_epi64, SSE_MASK_I64)
+DEFINE_SIMD_LINEAR(sse, float, float, , 4, __m128, _mm_set1_ps, _mm_loadu_ps,
+                   _mm_cmpeq_ps, _mm_cmpgt_ps, SSE_MASK_PS)
+
+#define SSE_SUPPORTED_int32 1
+#define SSE_SUPPORTED_float 1
+#define SSE_SUPPORTED_int64 cpu_has_sse42()
+
+#define LINEAR_DISPATCH(OP, NAME, arr, arr_len, key)                                                  \
+    do                                                                                                \
+    {                                                                                                 \
+        linear_search_simd_t level_ = linear_search_simd_level();                                     \
+        if (LINEAR_SEARCH_AVX2 == level_)                                                             \
+        {                                                                                             \
+            return OP##_##NAME##_avx2((arr), (arr_len), (key));                                       \
+        }                                                                                             \
+        if (LINEAR_SEARCH_SSE == level_ && SSE_SUPPORTED_##NAME)                                      \
+        {                                                                                             \
+            return OP##_##NAME##_sse((arr), (arr_len), (key));                                        \
+        }                                                                                             \
+        return OP##_##NAME##_scalar((arr), (arr_len), (key));                                         \
+    } while (0)
+
+#else
+
+#define LINEAR_DISPATCH(OP, NAME, arr, arr_len, key) return OP##_##NAME##_scalar((arr), (arr_len), (key))
+
+#endif // LINEAR_SEARCH_X86
+
+#define DEFINE_LINEAR_SEARCH(NAME, T)                                                                 \
+    size_t linear_find_##NAME(const T *arr, size_t arr_len, T key)                                    \
+    {                                                                                                 \
+        if (NULL == arr)                                                                              \
+        {                                                                                             \
+            return SEARCH_NOT_FOUND;                                                                  \
+        }                                                                                             \
+        LINEAR_DISPATCH(find, NAME, arr, arr_len, key);                                               \
+    }                                                                                                 \
+                                                                                                      \
+    size_t linear_count_##NAME(const T *arr, size_t arr_len, T key)                                   \
+    {                                                                                                 \
+        if (NULL == arr)                                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        LINEAR_DISPATCH(count, NAME, arr, arr_len, key);                                              \
+    }                                                                                                 \
+                                                                                                      \
+    size_t linear_find_first_greater_##NAME(const T *arr, size_t arr_len, T key)                      \
+    {                                                                                                 \
+        if (NULL == arr)                                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        LINEAR_DISPATCH(greater, NAME, arr, arr_len, key);                                            \
+    }                                                                                                 \
+                                                                                                      \
+    /* 有序数组上不大于 key 的元素个数就是 upper bound；整段计数没有依赖数据的分支，    */       \
+    /* 比在第一个大于 key 处提前退出更快(退出位置随机，分支几乎每次都预测失败)         */       \
+    static size_t linear_upper_bound_##NAME(const T *arr, size_t arr_len, T key)                      \
+    {                                                                                                 \
+        if (NULL == arr)                                                                              \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        LINEAR_DISPATCH(count_not_greater, NAME, arr, arr_len, key);                                  \
+    }                                                                                                 \
+                                                                                                      \
+    size_t adaptive_upper_bound_##NAME(const T *arr, size_t arr_len, T key)                           \
+    {                                                                                                 \
+        if (arr_len * sizeof(T) <= linear_search_crossover_bytes())                                   \
+        {                                                                                             \
+            return linear_upper_bound_##NAME(arr, arr_len, key);                                     \
+        }                                                                                             \
+        return upper_bound_##NAME(arr, arr_len, key);                                                 \
+    }
+
+DEFINE_LINEAR_SEARCH(int32, int32_t)
+DEFINE_LINEAR_SEARCH(int64, int64_t)
+DEFINE_LINEAR_SEARCH(float, float)
+
+/* ============================================================================
+ * 分界点标定
+ * ============================================================================
+ */
+
+#define CALIBRATE_MAX_LENGTH 2048
+#define CALIBRATE_QUERIES 512
+#define CALIBRATE_REPEATS 5
+
+/** 对 arr_len 个元素的有序数组，用 search 完成全部查询的最短耗时(纳秒) */
+static uint64_t time_queries(size_t (*search)(const int32_t *, size_t, int32_t), const int32_t *arr,
+                             size_t arr_len, const int32_t *queries)
+{
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < CALIBRATE_REPEATS; r++)
+    {
+        volatile size_t sink = 0;
+        uint64_t start = sort_monotonic_ns();
+        for (size_t q = 0; q < CALIBRATE_QUERIES; q++)
+        {
+            sink += search(arr, arr_len, queries[q]);
+        }
+        uint64_t elapsed = sort_monotonic_ns() - start;
+        best = elapsed < best ? elapsed : best;
+        (void)sink;
+    }
+    return best;
+}
+
+size_t linear_search_calibrate(void)
+{
+    static const size_t lengths[] = {4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048};
+    int32_t arr[CALIBRATE_MAX_LENGTH];
+    int32_t queries[CALIBRATE_QUERIES];
+    for (size_t i = 0; i < CALIBRATE_MAX_LENGTH; i++)
+    {
+        arr[i] = (int32_t)(2 * i);
+    }
+    size_t crossover = 0;
+    int losses = 0;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+    {
+        size_t arr_len = lengths[l];
+        for (size_t q = 0; q < CALIBRATE_QUERIES; q++)
+        {
+            // xorshift，查询均匀落在数组范围内
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            queries[q] = (int32_t)(state % (2 * arr_len + 1));
+        }
+        uint64_t linear = time_queries(linear_upper_bound_int32, arr, arr_len, queries);
+        uint64_t binary = time_queries(upper_bound_int32, arr, arr_len, queries);
+        if (linear <= binary)
+        {
+            crossover = arr_len * sizeof(int32_t);
+            losses = 0;
+        }
+        else if (0 != crossover && ++losses == 2)
+        {
+            // 几个元素时函数调用等固定开销占主导，顺序扫描可能先输后赢，
+            // 所以赢过之后再连续输两次才停止，也避免单次噪声造成的误判
+            break;
+        }
+    }
+    linear_search_set_crossover_bytes(crossover);
+    return crossover;
+}
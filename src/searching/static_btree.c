@@ -0,0 +1,327 @@
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include "searching/static_btree.h"
+#include "searching/binary_search.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STREE_X86 1
+#include <immintrin.h>
+#endif
+
+#define STREE_NODE_BYTES 64
+
+/** 层数上限：每个节点至少 9 个孩子，64 位下标不会超过 21 层 */
+#define STREE_MAX_LAYERS 32
+
+// 节点编号从 0 开始，按层连续存放：第 0 层是叶子，最高层只有根节点。
+// 第 h 层第 k 个节点的第 j 个孩子是第 h-1 层的第 k*(B+1)+j 个节点；
+// 它的第 j 个键是第 j+1 个孩子子树里最小的键，即该子树最左叶子的第一个键，
+// 子树不存在时为类型的最大值。节点内小于 key 的键数就是下一步的孩子编号，
+// 到了叶子层，叶子编号 * B 加上叶子内小于 key 的键数就是 lower bound。
+struct stree
+{
+    void *nodes;
+    size_t arr_len;
+    size_t element_size;
+    size_t num_layers;
+    size_t layer_offset[STREE_MAX_LAYERS]; /**< 每层第一个节点的编号 */
+    size_t memory_bytes;
+    int use_avx2;
+};
+
+static sort_result_t build(const void *sorted, size_t arr_len, size_t element_size, const void *max_value, stree_t **out)
+{
+    if (NULL == out || (NULL == sorted && arr_len > 0))
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    *out = NULL;
+    size_t b = STREE_NODE_BYTES / element_size;
+    // 空数组也保留一个全是最大值的叶子，查询不用特判
+    size_t nodes = arr_len > 0 ? (arr_len - 1) / b + 1 : 1;
+    if (nodes > SIZE_MAX / STREE_NODE_BYTES / 2)
+    {
+        return SORT_ERROR_INVALID_LENGTH;
+    }
+    stree_t *tree = calloc(1, sizeof(stree_t));
+    if (NULL == tree)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    size_t total = 0;
+    for (;;)
+    {
+        tree->layer_offset[tree->num_layers++] = total;
+        total += nodes;
+        if (1 == nodes)
+        {
+            break;
+        }
+        nodes = (nodes + b) / (b + 1);
+    }
+    tree->memory_bytes = total * STREE_NODE_BYTES;
+    if (0 != posix_memalign(&tree->nodes, STREE_NODE_BYTES, tree->memory_bytes))
+    {
+        free(tree);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    tree->arr_len = arr_len;
+    tree->element_size = element_size;
+#if defined(STREE_X86)
+    tree->use_avx2 = sort_cpu_has_avx2();
+#endif
+
+    char *base = (char *)tree->nodes;
+    size_t num_leaves = 1 < tree->num_layers ? tree->layer_offset[1] : total;
+    if (arr_len > 0)
+    {
+        memcpy(base, sorted, arr_len * element_size);
+    }
+    for (size_t i = arr_len; i < num_leaves * b; i++)
+    {
+        memcpy(base + i * element_size, max_value, element_size);
+    }
+
+    // span 为第 h-1 层一个节点的子树覆盖的叶子数
+    size_t span = 1;
+    for (size_t h = 1; h < tree->num_layers; h++)
+    {
+        size_t first = tree->layer_offset[h];
+        size_t count = (h + 1 < tree->num_layers ? tree->layer_offset[h + 1] : total) - first;
+        char *node = base + first * STREE_NODE_BYTES;
+        for (size_t k = 0; k < count; k++, node += STREE_NODE_BYTES)
+        {
+            for (size_t j = 0; j < b; j++)
+            {
+                size_t leaf = (k * (b + 1) + j + 1) * span;
+                const void *src = leaf * b < arr_len ? base + leaf * b * element_size : max_value;
+                memcpy(node + j * element_size, src, element_size);
+            }
+        }
+        span *= b + 1;
+    }
+    *out = tree;
+    return SORT_SUCCESS;
+}
+
+static sort_result_t build_ex(const void *sorted, size_t arr_len, size_t element_size, const void *max_value,
+                              stree_t **out, sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    sort_result_t res = build(sorted, arr_len, element_size, max_value, out);
+    STOP_TIMMING(stats);
+    if (NULL != stats && SORT_SUCCESS == res)
+    {
+        // 索引常驻内存，不受 PRINT_SORTING_INFO 控制，总是报告
+        stats->memory_used = (*out)->memory_bytes;
+        stats->max_mamory_used = (*out)->memory_bytes;
+    }
+    return res;
+}
+
+void stree_destroy(stree_t *tree)
+{
+    if (NULL == tree)
+    {
+        return;
+    }
+    free(tree->nodes);
+    free(tree);
+}
+
+size_t stree_size(const stree_t *tree)
+{
+    return NULL == tree ? 0 : tree->arr_len;
+}
+
+size_t stree_memory_bytes(const stree_t *tree)
+{
+    return NULL == tree ? 0 : tree->memory_bytes;
+}
+
+/* ============================================================================
+ * 节点内计数：小于 key 的键的个数
+ * ============================================================================
+ */
+
+#if defined(STREE_X86)
+
+#define STREE_AVX2 __attribute__((target("avx2")))
+
+STREE_AVX2 static inline size_t rank_avx2_int32(const int32_t *node, int32_t key)
+{
+    __m256i x = _mm256_set1_epi32(key);
+    __m256i lo = _mm256_cmpgt_epi32(x, _mm256_load_si256((const __m256i *)node));
+    __m256i hi = _mm256_cmpgt_epi32(x, _mm256_load_si256((const __m256i *)node + 1));
+    unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(lo)) |
+                    (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8;
+    return (size_t)__builtin_popcount(mask);
+}
+
+STREE_AVX2 static inline size_t rank_avx2_int64(const int64_t *node, int64_t key)
+{
+    __m256i x = _mm256_set1_epi64x(key);
+    __m256i lo = _mm256_cmpgt_epi64(x, _mm256_load_si256((const __m256i *)node));
+    __m256i hi = _mm256_cmpgt_epi64(x, _mm256_load_si256((const __m256i *)node + 1));
+    unsigned mask = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(lo)) |
+                    (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4;
+    return (size_t)__builtin_popcount(mask);
+}
+
+STREE_AVX2 static inline size_t rank_avx2_float(const float *node, float key)
+{
+    __m256 x = _mm256_set1_ps(key);
+    __m256 lo = _mm256_cmp_ps(_mm256_load_ps(node), x, _CMP_LT_OQ);
+    __m256 hi = _mm256_cmp_ps(_mm256_load_ps(node + 8), x, _CMP_LT_OQ);
+    unsigned mask = (unsigned)_mm256_movemask_ps(lo) | (unsigned)_mm256_movemask_ps(hi) << 8;
+    return (size_t)__builtin_popcount(mask);
+}
+
+STREE_AVX2 static inline size_t rank_avx2_double(const double *node, double key)
+{
+    __m256d x = _mm256_set1_pd(key);
+    __m256d lo = _mm256_cmp_pd(_mm256_load_pd(node), x, _CMP_LT_OQ);
+    __m256d hi = _mm256_cmp_pd(_mm256_load_pd(node + 4), x, _CMP_LT_OQ);
+    unsigned mask = (unsigned)_mm256_movemask_pd(lo) | (unsigned)_mm256_movemask_pd(hi) << 4;
+    return (size_t)__builtin_popcount(mask);
+}
+
+#endif // STREE_X86
+
+/* ============================================================================
+ * 查询
+ * ============================================================================
+ */
+
+// 用给定的节点计数函数生成单个查询和批量查询，AVX2 与标量版本各生成一份
+#define DEFINE_STREE_SEARCH(SUFFIX, NAME, T, ATTR, RANK)                                              \
+    ATTR static size_t lower_bound_##NAME##_##SUFFIX(const stree_t *tree, T key)                       \
+    {                                                                                                 \
+        enum { B = STREE_NODE_BYTES / sizeof(T) };                                                    \
+        const T *nodes = (const T *)tree->nodes;                                                      \
+        size_t k = 0;                                                                                 \
+        for (size_t h = tree->num_layers - 1; h > 0; h--)                                             \
+        {                                                                                             \
+            k = k * (B + 1) + RANK(nodes + (tree->layer_offset[h] + k) * B, key);                     \
+        }                                                                                             \
+        size_t i = k * B + RANK(nodes + k * B, key);                                                  \
+        return i < tree->arr_len ? i : tree->arr_len;                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    ATTR static void lower_bound_batch_##NAME##_##SUFFIX(const stree_t *tree, const T *keys, size_t num_keys, size_t *out) \
+    {                                                                                                 \
+        enum { B = STREE_NODE_BYTES / sizeof(T) };                                                    \
+        const T *nodes = (const T *)tree->nodes;                                                      \
+        for (size_t first = 0; first < num_keys; first += SEARCH_BATCH_WIDTH)                         \
+        {                                                                                             \
+            size_t width = num_keys - first < SEARCH_BATCH_WIDTH ? num_keys - first : SEARCH_BATCH_WIDTH; \
+            const T *key = keys + first;                                                              \
+            size_t k[SEARCH_BATCH_WIDTH] = {0};                                                       \
+            for (size_t h = tree->num_layers - 1; h > 0; h--)                                         \
+            {                                                                                         \
+                const T *layer = nodes + tree->layer_offset[h] * B;                                   \
+                const T *below = nodes + tree->layer_offset[h - 1] * B;                               \
+                for (size_t i = 0; i < width; i++)                                                    \
+                {                                                                                     \
+                    k[i] = k[i] * (B + 1) + RANK(layer + k[i] * B, key[i]);                           \
+                    __builtin_prefetch(below + k[i] * B);                                             \
+                }                                                                                     \
+            }                                                                                         \
+            for (size_t i = 0; i < width; i++)                                                        \
+            {                                                                                         \
+                size_t r = k[i] * B + RANK(nodes + k[i] * B, key[i]);                                 \
+                out[first + i] = r < tree->arr_len ? r : tree->arr_len;                               \
+            }                                                                                         \
+        }                                                                                             \
+    }
+
+#define DEFINE_STREE_SCALAR_RANK(NAME, T)                                                             \
+    static inline size_t rank_scalar_##NAME(const T *node, T key)                                    \
+    {                                                                                                 \
+        size_t count = 0;                                                                             \
+        for (size_t j = 0; j < STREE_NODE_BYTES / sizeof(T); j++)                                     \
+        {                                                                                             \
+            count += node[j] < key;                                                                   \
+        }                                                                                             \
+        return count;                                                                                 \
+    }
+
+// 非 x86 平台上 avx2 版本只是标量版本的副本，use_avx2 恒为 0，不会被选中
+#if defined(STREE_X86)
+#define DEFINE_STREE_AVX2_SEARCH(NAME, T) DEFINE_STREE_SEARCH(avx2, NAME, T, STREE_AVX2, rank_avx2_##NAME)
+#else
+#define DEFINE_STREE_AVX2_SEARCH(NAME, T) DEFINE_STREE_SEARCH(avx2, NAME, T, , rank_scalar_##NAME)
+#endif
+
+#define DEFINE_STREE(NAME, T, MAX_VALUE)                                                              \
+    DEFINE_STREE_SCALAR_RANK(NAME, T)                                                                 \
+    DEFINE_STREE_SEARCH(scalar, NAME, T, , rank_scalar_##NAME)                                        \
+    DEFINE_STREE_AVX2_SEARCH(NAME, T)                                                                 \
+                                                                                                      \
+    sort_result_t stree_build_##NAME##_ex(const T *sorted, size_t arr_len, stree_t **out, sort_stats_t *stats) \
+    {                                                                                                 \
+        const T max_value = MAX_VALUE;                                                                \
+        return build_ex(sorted, arr_len, sizeof(T), &max_value, out, stats);                          \
+    }                                                                                                 \
+                                                                                                      \
+    sort_result_t stree_build_##NAME(const T *sorted, size_t arr_len, stree_t **out)                  \
+    {                                                                                                 \
+        return stree_build_##NAME##_ex(sorted, arr_len, out, NULL);                                   \
+    }                                                                                                 \
+                                                                                                      \
+    size_t stree_lower_bound_##NAME(const stree_t *tree, T key)                                       \
+    {                                                                                                 \
+        if (NULL == tree)                                                                             \
+        {                                                                                             \
+            return 0;                                                                                 \
+        }                                                                                             \
+        return tree->use_avx2 ? lower_bound_##NAME##_avx2(tree, key) : lower_bound_##NAME##_scalar(tree, key); \
+    }                                                                                                 \
+                                                                                                      \
+    void stree_lower_bound_##NAME##_batch(const stree_t *tree, const T *keys, size_t num_keys, size_t *out) \
+    {                                                                                                 \
+        if (NULL == keys || NULL == out)                                                              \
+        {                                                                                             \
+            return;                                                                                   \
+        }                                                                                             \
+        if (NULL == tree)                                                                             \
+        {                                                                                             \
+            memset(out, 0, num_keys * sizeof(size_t));                                                \
+            return;                                                                                   \
+        }                                                                                             \
+        if (tree->use_avx2)                                                                           \
+        {                                                                                             \
+            lower_bound_batch_##NAME##_avx2(tree, keys, num_keys, out);                               \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            lower_bound_batch_##NAME##_scalar(tree, keys, num_keys, out);                             \
+        }                                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    void stree_range_##NAME(const stree_t *tree, T lo, T hi, size_t *begin, size_t *end)              \
+    {                                                                                                 \
+        size_t b = stree_lower_bound_##NAME(tree, lo);                                                \
+        size_t e = lo < hi ? stree_lower_bound_##NAME(tree, hi) : b;                                  \
+        if (NULL != begin)                                                                            \
+        {                                                                                             \
+            *begin = b;                                                                               \
+        }                                                                                             \
+        if (NULL != end)                                                                              \
+        {                                                                                             \
+            *end = e;                                                                                 \
+        }                                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    const T *stree_keys_##NAME(const stree_t *tree)                                                   \
+    {                                                                                                 \
+        return NULL == tree ? NULL : (const T *)tree->nodes;                                          \
+    }
+
+DEFINE_STREE(int32, int32_t, INT32_MAX)
+DEFINE_STREE(int64, int64_t, INT64_MAX)
+DEFINE_STREE(float, float, INFINITY)
+DEFINE_STREE(double, double, INFINITY)
@@ -0,0 +1,377 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "sorting/batch_sort.h"
+#include "sorting/parallel_sort.h"
+#include "sorting/quick_sort.h"
+#include "sorting/sorting_network.h"
+#include "util/thread_pool.h"
+#include "util/scratch_arena.h"
+
+// 元素不超过该大小时暂存空间放在栈上
+#define BATCH_SORT_STACK_TMP_SIZE 64
+
+// 每个线程分到的任务数，用于负载均衡
+#define BATCH_SORT_TASKS_PER_THREAD 4
+
+// 长度分级：0~SORTING_NETWORK_MAX 各占一级，更长的段按 log2 分级，
+// 最后一级留给单独并行排序的大段
+#define BATCH_SORT_NUM_CLASSES (SORTING_NETWORK_MAX + 64 + 1)
+#define BATCH_SORT_LARGE_CLASS (BATCH_SORT_NUM_CLASSES - 1)
+// 不需要排序的段(长度不超过 1)
+#define BATCH_SORT_SKIP BATCH_SORT_NUM_CLASSES
+
+// 按长度分级的窗口大小(字节)。整批一起分级会打乱内存访问顺序，数据放不进
+// 缓存时比按原顺序处理还慢，所以只在相邻的一小段数据内分级
+#define BATCH_SORT_WINDOW_BYTES ((size_t)256 << 10)
+
+typedef struct
+{
+    char *arr;
+    const size_t *offsets;
+    size_t element_size;
+    compare_func_t *cmp;
+    sort_result_t *results;
+    const size_t *order; // 按长度分级后的段处理顺序，只包含长度不小于 2 的段
+} batch_t;
+
+typedef struct
+{
+    const batch_t *batch;
+    size_t first; // 负责 order[first, last)
+    size_t last;
+    sort_result_t result;
+    sort_stats_t stats;
+} batch_task_t;
+
+static inline size_t log2_floor(size_t n)
+{
+    size_t log = 0;
+    while (n >>= 1)
+    {
+        log++;
+    }
+    return log;
+}
+
+static inline size_t size_class(size_t len)
+{
+    return len <= SORTING_NETWORK_MAX ? len : SORTING_NETWORK_MAX + log2_floor(len);
+}
+
+/** 长度不超过 1 的段返回 BATCH_SORT_SKIP，长度达到 large_cutoff 的段归入 BATCH_SORT_LARGE_CLASS */
+static inline size_t segment_class(size_t len, size_t large_cutoff)
+{
+    if (len <= 1)
+    {
+        return BATCH_SORT_SKIP;
+    }
+    return len >= large_cutoff ? BATCH_SORT_LARGE_CLASS : size_class(len);
+}
+
+/** 排序一段的估计代价 */
+static inline size_t segment_work(size_t len)
+{
+    return len * (log2_floor(len) + 1);
+}
+
+static inline void record_result(const batch_t *b, size_t seg, sort_result_t res)
+{
+    if (NULL != b->results)
+    {
+        b->results[seg] = res;
+    }
+}
+
+/**
+ * 生成处理顺序：段按内存顺序划成约 BATCH_SORT_WINDOW_BYTES 的窗口，窗口内
+ * 按长度分级(counting sort)，同一排序网络连续执行。需要单独并行排序的大段
+ * 依次放在 order[num_small, ...)。返回其余各段的估计工作量之和。
+ */
+static size_t build_order(const size_t *offsets, size_t num_segments, size_t element_size,
+                          size_t large_cutoff, size_t num_small, size_t *order)
+{
+    size_t pos = 0;
+    size_t large_pos = num_small;
+    size_t work = 0;
+    size_t w_begin = 0;
+    while (w_begin < num_segments)
+    {
+        size_t class_start[BATCH_SORT_LARGE_CLASS + 1] = {0};
+        size_t bytes = 0;
+        size_t w_end = w_begin;
+        while (w_end < num_segments && bytes < BATCH_SORT_WINDOW_BYTES)
+        {
+            size_t len = offsets[w_end + 1] - offsets[w_end];
+            size_t cls = segment_class(len, large_cutoff);
+            if (cls < BATCH_SORT_LARGE_CLASS)
+            {
+                class_start[cls + 1]++;
+                bytes += len * element_size;
+            }
+            w_end++;
+        }
+        class_start[0] = pos;
+        for (size_t c = 0; c < BATCH_SORT_LARGE_CLASS; c++)
+        {
+            class_start[c + 1] += class_start[c];
+        }
+        pos = class_start[BATCH_SORT_LARGE_CLASS];
+
+        for (size_t i = w_begin; i < w_end; i++)
+        {
+            size_t len = offsets[i + 1] - offsets[i];
+            size_t cls = segment_class(len, large_cutoff);
+            if (cls == BATCH_SORT_LARGE_CLASS)
+            {
+                order[large_pos++] = i;
+            }
+            else if (cls != BATCH_SORT_SKIP)
+            {
+                order[class_start[cls]++] = i;
+                work += segment_work(len);
+            }
+        }
+        w_begin = w_end;
+    }
+    return work;
+}
+
+/**
+ * 依次排序 order[first, last) 中的段，返回第一个错误码。
+ * 暂存空间整个区间只准备一次。
+ */
+static sort_result_t sort_range(const batch_t *b, size_t first, size_t last, sort_stats_t *stats)
+{
+    size_t es = b->element_size;
+    char stack_tmp[BATCH_SORT_STACK_TMP_SIZE];
+    void *tmp = stack_tmp;
+    if (es > BATCH_SORT_STACK_TMP_SIZE)
+    {
+        tmp = scratch_alloc(es);
+        if (NULL == tmp)
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                record_result(b, b->order[i], SORT_ERROR_ALLOCATION_FAILED);
+            }
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, es);
+    }
+
+    sort_result_t first_error = SORT_SUCCESS;
+    for (size_t i = first; i < last; i++)
+    {
+        size_t seg = b->order[i];
+        size_t begin = b->offsets[seg];
+        size_t len = b->offsets[seg + 1] - begin;
+        char *base = INDEX_OF(b->arr, es, begin);
+        sort_result_t res = len <= SORTING_NETWORK_MAX
+                                ? generic_network_sort_ex(base, len, es, b->cmp, stats)
+                                : generic_quick_sort_with_buffer_ex(base, len, es, b->cmp, tmp, stats);
+        record_result(b, seg, res);
+        if (res != SORT_SUCCESS && first_error == SORT_SUCCESS)
+        {
+            first_error = res;
+        }
+    }
+
+    if (tmp != stack_tmp)
+    {
+        scratch_free(tmp);
+        DECRE_MEMORY_USED(stats, es);
+    }
+    return first_error;
+}
+
+static void sort_range_task(void *arg)
+{
+    batch_task_t *task = (batch_task_t *)arg;
+    task->result = sort_range(task->batch, task->first, task->last, &task->stats);
+}
+
+/**
+ * 按估计工作量把 order[0, count) 切成至多 num_tasks 个连续区间并行排序。
+ * 任务数组分配失败时退化为在当前线程顺序执行。
+ */
+static sort_result_t sort_parallel(thread_pool_t *pool, const batch_t *b, size_t count,
+                                   size_t total_work, sort_stats_t *stats)
+{
+    size_t num_tasks = thread_pool_size(pool) * BATCH_SORT_TASKS_PER_THREAD;
+    if (num_tasks > count)
+    {
+        num_tasks = count;
+    }
+    batch_task_t *tasks = (batch_task_t *)scratch_calloc(num_tasks, sizeof(batch_task_t));
+    if (NULL == tasks)
+    {
+        return sort_range(b, 0, count, stats);
+    }
+    INCRE_MEMORY_USED(stats, num_tasks * sizeof(batch_task_t));
+
+    thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+    size_t used = 0;
+    size_t first = 0;
+    size_t work = 0;
+    for (size_t i = 0; i < count && used < num_tasks; i++)
+    {
+        size_t seg = b->order[i];
+        work += segment_work(b->offsets[seg + 1] - b->offsets[seg]);
+        // 累计工作量越过第 used + 1 个等分点，或已经到最后一段时切出一个任务
+        if (i + 1 == count || work >= total_work / num_tasks * (used + 1))
+        {
+            batch_task_t *task = &tasks[used++];
+            task->batch = b;
+            task->first = first;
+            task->last = used == num_tasks ? count : i + 1;
+            first = task->last;
+            if (thread_pool_submit(pool, &group, sort_range_task, task) != 0)
+            {
+                sort_range_task(task);
+            }
+            if (first == count)
+            {
+                break;
+            }
+        }
+    }
+    thread_pool_wait(pool, &group);
+
+    sort_result_t first_error = SORT_SUCCESS;
+    for (size_t i = 0; i < used; i++)
+    {
+        if (NULL != stats)
+        {
+            sort_stats_merge(stats, &tasks[i].stats);
+        }
+        if (tasks[i].result != SORT_SUCCESS && first_error == SORT_SUCCESS)
+        {
+            first_error = tasks[i].result;
+        }
+    }
+    scratch_free(tasks);
+    DECRE_MEMORY_USED(stats, num_tasks * sizeof(batch_task_t));
+    return first_error;
+}
+
+sort_result_t generic_sort_batch(
+    void *arr,
+    const size_t *offsets,
+    size_t num_segments,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_result_t *results)
+{
+    return generic_sort_batch_ex(arr, offsets, num_segments, element_size, cmp, results, NULL);
+}
+
+sort_result_t generic_sort_batch_ex(
+    void *arr,
+    const size_t *offsets,
+    size_t num_segments,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_result_t *results,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    if (NULL == arr || NULL == offsets || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    size_t total_len = 0;
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        if (offsets[i + 1] < offsets[i])
+        {
+            return SORT_ERROR_INVALID_ARGUMENT;
+        }
+        total_len += offsets[i + 1] - offsets[i];
+    }
+    RECORD_ARR_LEN(stats, total_len);
+
+    thread_pool_t *pool = thread_pool_global();
+    size_t cutoff = parallel_sort_get_cutoff();
+    if (NULL == pool || thread_pool_size(pool) <= 1 || total_len < cutoff)
+    {
+        pool = NULL;
+    }
+
+    size_t large_cutoff = NULL != pool ? cutoff : SIZE_MAX;
+    size_t num_small = 0;
+    size_t num_large = 0;
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        size_t cls = segment_class(offsets[i + 1] - offsets[i], large_cutoff);
+        if (cls == BATCH_SORT_SKIP)
+        {
+            if (NULL != results)
+            {
+                results[i] = SORT_SUCCESS;
+            }
+        }
+        else if (cls == BATCH_SORT_LARGE_CLASS)
+        {
+            num_large++;
+        }
+        else
+        {
+            num_small++;
+        }
+    }
+    size_t num_sorted = num_small + num_large;
+    if (num_sorted == 0)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+
+    size_t *order = (size_t *)scratch_alloc(num_sorted * sizeof(size_t));
+    if (NULL == order)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, num_sorted * sizeof(size_t));
+    size_t small_work = build_order(offsets, num_segments, element_size, large_cutoff, num_small, order);
+
+    batch_t b = {(char *)arr, offsets, element_size, cmp, results, order};
+    sort_result_t res = SORT_SUCCESS;
+    if (NULL != pool && num_small > 1)
+    {
+        res = sort_parallel(pool, &b, num_small, small_work, stats);
+    }
+    else
+    {
+        res = sort_range(&b, 0, num_small, stats);
+    }
+
+    // 大段各自占满线程池
+    for (size_t i = num_small; i < num_sorted; i++)
+    {
+        size_t seg = order[i];
+        size_t len = offsets[seg + 1] - offsets[seg];
+        sort_stats_t local;
+        sort_result_t seg_res = generic_parallel_sort_ex(INDEX_OF(arr, element_size, offsets[seg]), len,
+                                                         element_size, cmp, NULL != stats ? &local : NULL);
+        if (NULL != stats)
+        {
+            sort_stats_merge(stats, &local);
+        }
+        record_result(&b, seg, seg_res);
+        if (seg_res != SORT_SUCCESS && res == SORT_SUCCESS)
+        {
+            res = seg_res;
+        }
+    }
+
+    scratch_free(order);
+    DECRE_MEMORY_USED(stats, num_sorted * sizeof(size_t));
+    STOP_TIMMING(stats);
+    return res;
+}
@@ -0,0 +1,660 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define _FILE_OFFSET_BITS 64
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sorting/external_sort.h"
+#include "sorting/parallel_sort.h"
+#include "util/scratch_arena.h"
+
+typedef struct
+{
+    off_t offset;
+    off_t length;
+} ext_run_t;
+
+typedef struct
+{
+    int fd;
+    off_t next; // 下一块在文件中的偏移
+    off_t end;
+    char *buf;
+    size_t filled; // 缓冲区中有效字节数，0 表示该 run 已读完
+    size_t pos;
+} run_reader_t;
+
+typedef struct
+{
+    size_t record_size;
+    compare_func_t *cmp;
+    int stable;
+    const char *temp_dir;
+    sort_stats_t *stats;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+} ext_ctx_t;
+
+typedef struct
+{
+    ext_ctx_t *ctx;
+    run_reader_t *readers;
+    size_t block;
+} merge_state_t;
+
+static int read_full(int fd, void *buf, size_t len, off_t offset)
+{
+    char *p = (char *)buf;
+    while (len > 0)
+    {
+        ssize_t n = pread(fd, p, len, offset);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t len)
+{
+    const char *p = (const char *)buf;
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/** 在 dir 下创建临时文件并立即 unlink，只保留文件描述符 */
+static int open_temp(const char *dir)
+{
+    static const char name[] = "/algorithms_extsort_XXXXXX";
+    size_t dir_len = strlen(dir);
+    char *path = (char *)scratch_alloc(dir_len + sizeof(name));
+    if (NULL == path)
+    {
+        return -1;
+    }
+    memcpy(path, dir, dir_len);
+    memcpy(path + dir_len, name, sizeof(name));
+    int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        unlink(path);
+    }
+    scratch_free(path);
+    return fd;
+}
+
+/* ============================================================================
+ * 生成初始 run
+ * ============================================================================
+ */
+
+/**
+ * 一个 run 的记录数：run 缓冲加上排序它的辅助空间不超过预算。
+ * 辅助空间含与线程数有关的固定部分，从整个预算放下的记录数开始按比例缩小直到放得下
+ */
+static size_t run_records_for_budget(size_t budget, size_t record_size, int stable)
+{
+    size_t run_records = budget / record_size;
+    while (run_records > 1)
+    {
+        size_t need = run_records * record_size + parallel_sort_scratch_bytes(run_records, record_size, stable);
+        if (need <= budget)
+        {
+            break;
+        }
+        size_t scaled = (size_t)((double)run_records * ((double)budget / (double)need));
+        run_records = scaled < run_records ? scaled : run_records - 1;
+    }
+    return run_records > 0 ? run_records : 1;
+}
+
+static sort_result_t sort_run(ext_ctx_t *ctx, void *buf, size_t count)
+{
+    sort_result_t ret;
+    if (NULL == ctx->stats)
+    {
+        ret = ctx->stable ? generic_parallel_stable_sort(buf, count, ctx->record_size, ctx->cmp)
+                          : generic_parallel_sort(buf, count, ctx->record_size, ctx->cmp);
+    }
+    else
+    {
+        // 排序函数会重置统计，先记到局部变量再累加
+        sort_stats_t local;
+        ret = ctx->stable ? generic_parallel_stable_sort_ex(buf, count, ctx->record_size, ctx->cmp, &local)
+                          : generic_parallel_sort_ex(buf, count, ctx->record_size, ctx->cmp, &local);
+        // 各 run 依次排序、辅助空间用完即释放，峰值是当前占用加本次排序的峰值，不能逐次相加
+        size_t peak = ctx->stats->memory_used + local.max_mamory_used;
+        if (peak < ctx->stats->max_mamory_used)
+        {
+            peak = ctx->stats->max_mamory_used;
+        }
+        sort_stats_merge(ctx->stats, &local);
+        ctx->stats->max_mamory_used = peak;
+    }
+    return ret;
+}
+
+/* ============================================================================
+ * 败者树 k 路归并
+ * ============================================================================
+ */
+
+static int reader_fill(merge_state_t *m, run_reader_t *r)
+{
+    r->pos = 0;
+    if (r->next >= r->end)
+    {
+        r->filled = 0;
+        return 0;
+    }
+    size_t len = (size_t)(r->end - r->next) < m->block ? (size_t)(r->end - r->next) : m->block;
+    if (read_full(r->fd, r->buf, len, r->next) != 0)
+    {
+        return -1;
+    }
+    m->ctx->bytes_read += len;
+    r->next += len;
+    r->filled = len;
+    if (r->next < r->end)
+    {
+        // 当前块被消费的同时让内核把下一块读进页缓存
+        size_t ahead = (size_t)(r->end - r->next) < m->block ? (size_t)(r->end - r->next) : m->block;
+        posix_fadvise(r->fd, r->next, (off_t)ahead, POSIX_FADV_WILLNEED);
+    }
+    return 0;
+}
+
+/** a 是否胜过 b：读完的 run 视为正无穷，相等时 run 下标小的胜出以保持稳定 */
+static inline int beats(const merge_state_t *m, size_t a, size_t b)
+{
+    const run_reader_t *ra = &m->readers[a];
+    const run_reader_t *rb = &m->readers[b];
+    if (ra->filled == 0)
+    {
+        return 0;
+    }
+    if (rb->filled == 0)
+    {
+        return 1;
+    }
+    int c = COUNTED_CMP(m->ctx->stats, m->ctx->cmp, ra->buf + ra->pos, rb->buf + rb->pos);
+    return c < 0 || (c == 0 && a < b);
+}
+
+/**
+ * 把 runs[0, k) 归并后顺序写入 out_fd。
+ * blocks 为 k + 1 个 block 字节的缓冲区，最后一个作为输出缓冲；
+ * tree 至少 3k 个元素：前 k 个是败者树内部结点 [1, k)，
+ * 后 2k 个在建树时存各结点的胜者，叶子 i 位于 k + i。
+ */
+static sort_result_t merge_runs(
+    ext_ctx_t *ctx,
+    int in_fd,
+    const ext_run_t *runs,
+    size_t k,
+    int out_fd,
+    char *blocks,
+    size_t block,
+    run_reader_t *readers,
+    size_t *tree)
+{
+    size_t rs = ctx->record_size;
+    merge_state_t m = {ctx, readers, block};
+    for (size_t i = 0; i < k; i++)
+    {
+        run_reader_t *r = &readers[i];
+        r->fd = in_fd;
+        r->next = runs[i].offset;
+        r->end = runs[i].offset + runs[i].length;
+        r->buf = blocks + i * block;
+        r->filled = 0;
+        r->pos = 0;
+        posix_fadvise(in_fd, r->next, (off_t)block, POSIX_FADV_WILLNEED);
+    }
+    for (size_t i = 0; i < k; i++)
+    {
+        if (reader_fill(&m, &readers[i]) != 0)
+        {
+            return SORT_ERROR_IO;
+        }
+    }
+
+    size_t *loser = tree;
+    size_t *win = tree + k;
+    for (size_t i = 0; i < k; i++)
+    {
+        win[k + i] = i;
+    }
+    for (size_t node = k - 1; node >= 1; node--)
+    {
+        size_t a = win[2 * node];
+        size_t b = win[2 * node + 1];
+        if (beats(&m, a, b))
+        {
+            win[node] = a;
+            loser[node] = b;
+        }
+        else
+        {
+            win[node] = b;
+            loser[node] = a;
+        }
+    }
+    size_t winner = k > 1 ? win[1] : 0;
+
+    char *out = blocks + k * block;
+    size_t out_len = 0;
+    while (readers[winner].filled != 0)
+    {
+        run_reader_t *r = &readers[winner];
+        memcpy(out + out_len, r->buf + r->pos, rs);
+        INCRE_MOVEMENTS(ctx->stats);
+        out_len += rs;
+        if (out_len == block)
+        {
+            if (write_full(out_fd, out, out_len) != 0)
+            {
+                return SORT_ERROR_IO;
+            }
+            ctx->bytes_written += out_len;
+            out_len = 0;
+        }
+        r->pos += rs;
+        if (r->pos == r->filled && reader_fill(&m, r) != 0)
+        {
+            return SORT_ERROR_IO;
+        }
+        // 只需沿胜者所在叶子到根重赛一遍，每条输出记录 log2(k) 次比较
+        for (size_t node = (winner + k) / 2; node >= 1; node /= 2)
+        {
+            if (beats(&m, loser[node], winner))
+            {
+                size_t t = loser[node];
+                loser[node] = winner;
+                winner = t;
+            }
+        }
+    }
+    if (out_len > 0)
+    {
+        if (write_full(out_fd, out, out_len) != 0)
+        {
+            return SORT_ERROR_IO;
+        }
+        ctx->bytes_written += out_len;
+    }
+    return SORT_SUCCESS;
+}
+
+static size_t pow_saturating(size_t base, size_t exp)
+{
+    size_t result = 1;
+    while (exp-- > 0)
+    {
+        if (result > SIZE_MAX / base)
+        {
+            return SIZE_MAX;
+        }
+        result *= base;
+    }
+    return result;
+}
+
+/**
+ * 按预算确定归并路数和每路缓冲大小：先用允许的最大路数算出最少趟数，
+ * 再在这个趟数下取最小的路数，剩余预算全部分给各路缓冲，减少 pread 次数。
+ */
+static void plan_merge(size_t budget, size_t record_size, size_t num_runs, size_t *fan_in, size_t *block)
+{
+    size_t min_block = EXTERNAL_SORT_MIN_BLOCK / record_size * record_size;
+    if (min_block == 0 || budget / 3 < min_block)
+    {
+        min_block = budget / 3 / record_size * record_size;
+    }
+    size_t max_fan_in = budget / min_block - 1;
+
+    size_t passes = 1;
+    while (pow_saturating(max_fan_in, passes) < num_runs)
+    {
+        passes++;
+    }
+    size_t k = 2;
+    while (pow_saturating(k, passes) < num_runs)
+    {
+        k++;
+    }
+    if (k > num_runs)
+    {
+        k = num_runs;
+    }
+    *fan_in = k;
+    *block = budget / (k + 1) / record_size * record_size;
+}
+
+/* ============================================================================
+ * 对外接口
+ * ============================================================================
+ */
+
+static sort_result_t open_output(const char *output_path, int *out_fd)
+{
+    *out_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    return *out_fd < 0 ? SORT_ERROR_IO : SORT_SUCCESS;
+}
+
+/** 数据能整体放进预算：读入、排序、写出，不产生临时文件 */
+static sort_result_t sort_in_memory(ext_ctx_t *ctx, int in_fd, size_t total, const char *output_path)
+{
+    char *buf = (char *)scratch_alloc(total > 0 ? total : 1);
+    if (NULL == buf)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(ctx->stats, total);
+    sort_result_t ret = SORT_SUCCESS;
+    if (read_full(in_fd, buf, total, 0) != 0)
+    {
+        ret = SORT_ERROR_IO;
+    }
+    else
+    {
+        ctx->bytes_read += total;
+        ret = sort_run(ctx, buf, total / ctx->record_size);
+    }
+
+    int out_fd = -1;
+    if (SORT_SUCCESS == ret)
+    {
+        ret = open_output(output_path, &out_fd);
+    }
+    if (SORT_SUCCESS == ret)
+    {
+        if (write_full(out_fd, buf, total) != 0)
+        {
+            ret = SORT_ERROR_IO;
+        }
+        else
+        {
+            ctx->bytes_written += total;
+        }
+        if (close(out_fd) != 0)
+        {
+            ret = SORT_ERROR_IO;
+        }
+    }
+    scratch_free(buf);
+    DECRE_MEMORY_USED(ctx->stats, total);
+    return ret;
+}
+
+/** 把输入切成预算大小的块，逐块排序后追加写入临时文件 tmp_fd */
+static sort_result_t form_runs(ext_ctx_t *ctx, int in_fd, size_t total, size_t run_bytes, int tmp_fd, ext_run_t *runs)
+{
+    char *buf = (char *)scratch_alloc(run_bytes);
+    if (NULL == buf)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(ctx->stats, run_bytes);
+    posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    sort_result_t ret = SORT_SUCCESS;
+    size_t r = 0;
+    for (size_t offset = 0; offset < total && SORT_SUCCESS == ret; offset += run_bytes, r++)
+    {
+        size_t len = total - offset < run_bytes ? total - offset : run_bytes;
+        if (read_full(in_fd, buf, len, (off_t)offset) != 0)
+        {
+            ret = SORT_ERROR_IO;
+            break;
+        }
+        ctx->bytes_read += len;
+        ret = sort_run(ctx, buf, len / ctx->record_size);
+        if (SORT_SUCCESS != ret)
+        {
+            break;
+        }
+        if (write_full(tmp_fd, buf, len) != 0)
+        {
+            ret = SORT_ERROR_IO;
+            break;
+        }
+        ctx->bytes_written += len;
+        runs[r].offset = (off_t)offset;
+        runs[r].length = (off_t)len;
+    }
+    scratch_free(buf);
+    DECRE_MEMORY_USED(ctx->stats, run_bytes);
+    return ret;
+}
+
+/**
+ * 逐趟归并，直到只剩一个 run。每趟把相邻的 k 个 run 归并成一个，
+ * 相邻分组加上败者树按 run 下标决胜，使稳定的初始 run 归并后仍稳定。
+ * 最后一趟直接写入输出文件。
+ */
+static sort_result_t merge_passes(
+    ext_ctx_t *ctx,
+    int tmp_fd,
+    ext_run_t *runs,
+    size_t num_runs,
+    size_t budget,
+    const char *output_path,
+    size_t *passes)
+{
+    size_t k;
+    size_t block;
+    plan_merge(budget, ctx->record_size, num_runs, &k, &block);
+
+    size_t blocks_bytes = (k + 1) * block;
+    char *blocks = (char *)scratch_alloc(blocks_bytes);
+    run_reader_t *readers = (run_reader_t *)scratch_alloc(k * sizeof(run_reader_t));
+    size_t *tree = (size_t *)scratch_alloc(3 * k * sizeof(size_t));
+    if (NULL == blocks || NULL == readers || NULL == tree)
+    {
+        scratch_free(blocks);
+        scratch_free(readers);
+        scratch_free(tree);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(ctx->stats, blocks_bytes);
+
+    sort_result_t ret = SORT_SUCCESS;
+    int in_fd = tmp_fd;
+    *passes = 0;
+    while (SORT_SUCCESS == ret)
+    {
+        size_t groups = (num_runs + k - 1) / k;
+        int out_fd = -1;
+        ret = groups == 1 ? open_output(output_path, &out_fd) : SORT_SUCCESS;
+        if (SORT_SUCCESS == ret && groups > 1)
+        {
+            out_fd = open_temp(ctx->temp_dir);
+            ret = out_fd < 0 ? SORT_ERROR_IO : SORT_SUCCESS;
+        }
+        if (SORT_SUCCESS != ret)
+        {
+            break;
+        }
+
+        off_t out_offset = 0;
+        for (size_t g = 0; g < groups && SORT_SUCCESS == ret; g++)
+        {
+            size_t first = g * k;
+            size_t count = num_runs - first < k ? num_runs - first : k;
+            off_t length = 0;
+            for (size_t i = first; i < first + count; i++)
+            {
+                length += runs[i].length;
+            }
+            ret = merge_runs(ctx, in_fd, runs + first, count, out_fd, blocks, block, readers, tree);
+            // 本趟输出的第 g 个 run，前面的 run 已经读完，可以原地覆盖
+            runs[g].offset = out_offset;
+            runs[g].length = length;
+            out_offset += length;
+        }
+        (*passes)++;
+        close(in_fd);
+        in_fd = -1;
+        if (groups == 1)
+        {
+            if (close(out_fd) != 0 && SORT_SUCCESS == ret)
+            {
+                ret = SORT_ERROR_IO;
+            }
+            break;
+        }
+        in_fd = out_fd;
+        num_runs = groups;
+    }
+    if (in_fd >= 0)
+    {
+        close(in_fd);
+    }
+
+    scratch_free(blocks);
+    scratch_free(readers);
+    scratch_free(tree);
+    DECRE_MEMORY_USED(ctx->stats, blocks_bytes);
+    return ret;
+}
+
+sort_result_t generic_external_sort(
+    const char *input_path,
+    const char *output_path,
+    size_t record_size,
+    compare_func_t cmp,
+    const external_sort_options_t *options,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, record_size);
+    if (NULL == input_path || NULL == output_path || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (record_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    size_t budget = EXTERNAL_SORT_DEFAULT_BUDGET;
+    const char *temp_dir = NULL;
+    int stable = 0;
+    if (NULL != options)
+    {
+        budget = options->memory_budget > 0 ? options->memory_budget : budget;
+        temp_dir = options->temp_dir;
+        stable = options->stable;
+    }
+    if (NULL == temp_dir)
+    {
+        temp_dir = getenv("TMPDIR");
+    }
+    if (NULL == temp_dir || '\0' == temp_dir[0])
+    {
+        temp_dir = "/tmp";
+    }
+    if (budget / record_size < 3)
+    {
+        return SORT_ERROR_INVALID_ARGUMENT;
+    }
+
+    int in_fd = open(input_path, O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0)
+    {
+        return SORT_ERROR_IO;
+    }
+    struct stat st;
+    if (fstat(in_fd, &st) != 0)
+    {
+        close(in_fd);
+        return SORT_ERROR_IO;
+    }
+    size_t total = (size_t)st.st_size;
+    if (total % record_size != 0)
+    {
+        close(in_fd);
+        return SORT_ERROR_INVALID_LENGTH;
+    }
+    RECORD_ARR_LEN(stats, total / record_size);
+
+    ext_ctx_t ctx = {record_size, cmp, stable, temp_dir, stats, 0, 0};
+    size_t run_records = run_records_for_budget(budget, record_size, stable);
+    size_t run_bytes = run_records * record_size;
+
+    sort_result_t ret;
+    size_t passes = 0;
+    if (total <= run_bytes)
+    {
+        ret = sort_in_memory(&ctx, in_fd, total, output_path);
+        close(in_fd);
+    }
+    else
+    {
+        size_t num_runs = (total + run_bytes - 1) / run_bytes;
+        ext_run_t *runs = (ext_run_t *)scratch_alloc(num_runs * sizeof(ext_run_t));
+        int tmp_fd = open_temp(temp_dir);
+        if (NULL == runs || tmp_fd < 0)
+        {
+            ret = NULL == runs ? SORT_ERROR_ALLOCATION_FAILED : SORT_ERROR_IO;
+            if (tmp_fd >= 0)
+            {
+                close(tmp_fd);
+            }
+            close(in_fd);
+        }
+        else
+        {
+            ret = form_runs(&ctx, in_fd, total, run_bytes, tmp_fd, runs);
+            // 输出可能就是输入文件，必须在 run 全部写出后才关闭输入、截断输出
+            close(in_fd);
+            if (SORT_SUCCESS == ret)
+            {
+                ret = merge_passes(&ctx, tmp_fd, runs, num_runs, budget, output_path, &passes);
+            }
+            else
+            {
+                close(tmp_fd);
+            }
+        }
+        scratch_free(runs);
+    }
+
+    if (NULL != stats)
+    {
+        stats->io_bytes_read += ctx.bytes_read;
+        stats->io_bytes_written += ctx.bytes_written;
+        stats->merge_passes = passes;
+    }
+    if (SORT_SUCCESS != ret)
+    {
+        return ret;
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
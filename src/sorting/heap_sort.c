@@ -0,0 +1,81 @@
+#include "sorting/heap_sort.h"
+
+static inline void sift_down(
+    char *arr,
+    size_t root,
+    size_t heap_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sized_swap_func_t *swap,
+    sort_stats_t *stats)
+{
+    for (;;)
+    {
+        size_t child = 2 * root + 1;
+        if (child >= heap_len)
+        {
+            break;
+        }
+        if (child + 1 < heap_len &&
+            COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, child), INDEX_OF(arr, element_size, child + 1)) < 0)
+        {
+            child++;
+        }
+        if (COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, root), INDEX_OF(arr, element_size, child)) >= 0)
+        {
+            break;
+        }
+        swap(INDEX_OF(arr, element_size, root), INDEX_OF(arr, element_size, child), element_size);
+        INCRE_MOVEMENTS_BY(stats, 2);
+        root = child;
+    }
+}
+
+sort_result_t generic_heap_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_heap_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_heap_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    char *base = (char *)arr;
+    sized_swap_func_t *swap = select_swap_func(element_size);
+    for (size_t i = arr_len / 2; i > 0; i--)
+    {
+        sift_down(base, i - 1, arr_len, element_size, cmp, swap, stats);
+    }
+    for (size_t end = arr_len - 1; end > 0; end--)
+    {
+        swap(base, INDEX_OF(base, element_size, end), element_size);
+        INCRE_MOVEMENTS_BY(stats, 2);
+        sift_down(base, 0, end, element_size, cmp, swap, stats);
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include "sorting/indirect_sort.h"
+#include "sorting/quick_sort.h"
+#include "util/scratch_arena.h"
+
+/**
+ * 被排序的引用。比较函数随元素一起保存，包装比较函数不需要全局或
+ * 线程局部状态，因此也可以交给并行排序算法使用。
+ */
+typedef struct
+{
+    const void *ptr;
+    compare_func_t *cmp;
+} indirect_ref_t;
+
+static int compare_refs(const void *const a, const void *const b)
+{
+    const indirect_ref_t *ra = (const indirect_ref_t *)a;
+    const indirect_ref_t *rb = (const indirect_ref_t *)b;
+    return ra->cmp(ra->ptr, rb->ptr);
+}
+
+sort_result_t generic_sort_pointers(
+    void *ptr_arr[],
+    size_t arr_len,
+    compare_func_t cmp,
+    generic_sort_func_t *sort)
+{
+    if (NULL == ptr_arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    if (NULL == sort)
+    {
+        sort = generic_quick_sort;
+    }
+
+    indirect_ref_t *refs = (indirect_ref_t *)scratch_alloc(arr_len * sizeof(indirect_ref_t));
+    if (NULL == refs)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        refs[i].ptr = ptr_arr[i];
+        refs[i].cmp = cmp;
+    }
+
+    sort_result_t res = sort(refs, arr_len, sizeof(indirect_ref_t), compare_refs);
+    if (res == SORT_SUCCESS)
+    {
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            ptr_arr[i] = (void *)refs[i].ptr;
+        }
+    }
+    scratch_free(refs);
+    return res;
+}
+
+sort_result_t generic_argsort(
+    const void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    generic_sort_func_t *sort,
+    size_t *indices)
+{
+    if (NULL == arr || NULL == cmp || NULL == indices)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len == 1)
+    {
+        indices[0] = 0;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    if (NULL == sort)
+    {
+        sort = generic_quick_sort;
+    }
+
+    indirect_ref_t *refs = (indirect_ref_t *)scratch_alloc(arr_len * sizeof(indirect_ref_t));
+    if (NULL == refs)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        refs[i].ptr = INDEX_OF(arr, element_size, i);
+        refs[i].cmp = cmp;
+    }
+
+    sort_result_t res = sort(refs, arr_len, sizeof(indirect_ref_t), compare_refs);
+    if (res == SORT_SUCCESS)
+    {
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            indices[i] = (size_t)((const char *)refs[i].ptr - (const char *)arr) / element_size;
+        }
+    }
+    scratch_free(refs);
+    return res;
+}
+
+#define BITMAP_WORD_BITS (sizeof(unsigned long) * 8)
+#define BITMAP_TEST(bitmap, i) (((bitmap)[(i) / BITMAP_WORD_BITS] >> ((i) % BITMAP_WORD_BITS)) & 1UL)
+#define BITMAP_SET(bitmap, i) ((bitmap)[(i) / BITMAP_WORD_BITS] |= 1UL << ((i) % BITMAP_WORD_BITS))
+
+sort_result_t apply_permutation(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    const size_t *perm)
+{
+    if (NULL == arr || NULL == perm)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len <= 1)
+    {
+        return arr_len == 1 && perm[0] != 0 ? SORT_ERROR_INVALID_ARGUMENT : SORT_SUCCESS;
+    }
+
+    size_t words = (arr_len + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS;
+    unsigned long *visited = (unsigned long *)scratch_calloc(words, sizeof(unsigned long));
+    void *tmp = scratch_alloc(element_size);
+    if (NULL == visited || NULL == tmp)
+    {
+        scratch_free(visited);
+        scratch_free(tmp);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+
+    // 先检查 perm 是否为一个排列，避免移动到一半才发现错误
+    sort_result_t res = SORT_SUCCESS;
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        if (perm[i] >= arr_len || BITMAP_TEST(visited, perm[i]))
+        {
+            res = SORT_ERROR_INVALID_ARGUMENT;
+            break;
+        }
+        BITMAP_SET(visited, perm[i]);
+    }
+
+    if (res == SORT_SUCCESS)
+    {
+        memset(visited, 0, words * sizeof(unsigned long));
+        for (size_t start = 0; start < arr_len; start++)
+        {
+            if (BITMAP_TEST(visited, start) || perm[start] == start)
+            {
+                continue;
+            }
+            // 沿环 start <- perm[start] <- perm[perm[start]] ... 依次搬运
+            memcpy(tmp, INDEX_OF(arr, element_size, start), element_size);
+            size_t cur = start;
+            for (;;)
+            {
+                BITMAP_SET(visited, cur);
+                size_t next = perm[cur];
+                if (next == start)
+                {
+                    memcpy(INDEX_OF(arr, element_size, cur), tmp, element_size);
+                    break;
+                }
+                memcpy(INDEX_OF(arr, element_size, cur), INDEX_OF(arr, element_size, next), element_size);
+                cur = next;
+            }
+        }
+    }
+
+    scratch_free(visited);
+    scratch_free(tmp);
+    return res;
+}
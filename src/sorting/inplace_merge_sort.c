@@ -0,0 +1,319 @@
+#include "sorting/inplace_merge_sort.h"
+#include "sorting/insertion_sort.h"
+#include "util/scratch_arena.h"
+
+typedef struct
+{
+    char *arr;
+    size_t element_size;
+    compare_func_t *cmp;
+    sized_swap_func_t *swap;
+    char *buf;
+    size_t buf_len; // 辅助空间能放下的元素个数
+    sort_stats_t *stats;
+} inplace_merge_ctx_t;
+
+#define AT(ctx, i) ((ctx)->arr + (i) * (ctx)->element_size)
+
+/** 向上取整的整数平方根 */
+static size_t ceil_sqrt(size_t n)
+{
+    size_t r = 0;
+    for (size_t bit = (size_t)1 << (sizeof(size_t) * 4 - 1); bit > 0; bit >>= 1)
+    {
+        size_t c = r | bit;
+        if (c <= n / c)
+        {
+            r = c;
+        }
+    }
+    return r * r < n ? r + 1 : r;
+}
+
+/* ============================================================================
+ * 旋转
+ * ============================================================================
+ */
+
+static void reverse(const inplace_merge_ctx_t *ctx, size_t lo, size_t hi)
+{
+    while (hi - lo > 1)
+    {
+        hi--;
+        ctx->swap(AT(ctx, lo), AT(ctx, hi), ctx->element_size);
+        lo++;
+    }
+}
+
+/** 把 [lo, mid) 与 [mid, hi) 两块互换位置 */
+static void rotate(const inplace_merge_ctx_t *ctx, size_t lo, size_t mid, size_t hi)
+{
+    size_t es = ctx->element_size;
+    size_t left = mid - lo;
+    size_t right = hi - mid;
+    INCRE_MOVEMENTS_BY(ctx->stats, left + right);
+    if (left <= right && left <= ctx->buf_len)
+    {
+        memcpy(ctx->buf, AT(ctx, lo), left * es);
+        memmove(AT(ctx, lo), AT(ctx, mid), right * es);
+        memcpy(AT(ctx, lo + right), ctx->buf, left * es);
+        return;
+    }
+    if (right <= ctx->buf_len)
+    {
+        memcpy(ctx->buf, AT(ctx, mid), right * es);
+        memmove(AT(ctx, lo + right), AT(ctx, lo), left * es);
+        memcpy(AT(ctx, lo), ctx->buf, right * es);
+        return;
+    }
+    reverse(ctx, lo, mid);
+    reverse(ctx, mid, hi);
+    reverse(ctx, lo, hi);
+}
+
+/* ============================================================================
+ * 归并
+ * ============================================================================
+ */
+
+/** 左半复制到辅助空间，从前往后归并；相等时取左半，保持稳定 */
+static void merge_left_buffered(const inplace_merge_ctx_t *ctx, size_t lo, size_t mid, size_t hi)
+{
+    size_t es = ctx->element_size;
+    size_t left = mid - lo;
+    memcpy(ctx->buf, AT(ctx, lo), left * es);
+    INCRE_MOVEMENTS_BY(ctx->stats, left + (hi - lo));
+    size_t i = 0, j = mid, k = lo;
+    while (i < left && j < hi)
+    {
+        if (COUNTED_CMP(ctx->stats, ctx->cmp, ctx->buf + i * es, AT(ctx, j)) <= 0)
+        {
+            memcpy(AT(ctx, k), ctx->buf + i * es, es);
+            i++;
+        }
+        else
+        {
+            memcpy(AT(ctx, k), AT(ctx, j), es);
+            j++;
+        }
+        k++;
+    }
+    // 右半剩下的已经在原位
+    memcpy(AT(ctx, k), ctx->buf + i * es, (left - i) * es);
+}
+
+/** 右半复制到辅助空间，从后往前归并；相等时取右半放在后面，保持稳定 */
+static void merge_right_buffered(const inplace_merge_ctx_t *ctx, size_t lo, size_t mid, size_t hi)
+{
+    size_t es = ctx->element_size;
+    size_t right = hi - mid;
+    memcpy(ctx->buf, AT(ctx, mid), right * es);
+    INCRE_MOVEMENTS_BY(ctx->stats, right + (hi - lo));
+    size_t i = mid, j = right, k = hi;
+    while (i > lo && j > 0)
+    {
+        k--;
+        if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(ctx, i - 1), ctx->buf + (j - 1) * es) > 0)
+        {
+            memcpy(AT(ctx, k), AT(ctx, i - 1), es);
+            i--;
+        }
+        else
+        {
+            memcpy(AT(ctx, k), ctx->buf + (j - 1) * es, es);
+            j--;
+        }
+    }
+    // 左半剩下的已经在原位
+    memcpy(AT(ctx, lo), ctx->buf, j * es);
+}
+
+/** 归并相邻的有序段 [lo, mid) 与 [mid, hi) */
+static void merge(const inplace_merge_ctx_t *ctx, size_t lo, size_t mid, size_t hi)
+{
+    while (lo < mid && mid < hi)
+    {
+        // 两段已经整体有序
+        if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(ctx, mid - 1), AT(ctx, mid)) <= 0)
+        {
+            return;
+        }
+        size_t left = mid - lo;
+        size_t right = hi - mid;
+        if (left <= right && left <= ctx->buf_len)
+        {
+            merge_left_buffered(ctx, lo, mid, hi);
+            return;
+        }
+        if (right <= ctx->buf_len)
+        {
+            merge_right_buffered(ctx, lo, mid, hi);
+            return;
+        }
+        if (left <= ctx->buf_len)
+        {
+            merge_left_buffered(ctx, lo, mid, hi);
+            return;
+        }
+
+        // SymMerge：在以 [lo, hi) 中点为对称轴的区间里二分，找出最小的 start，
+        // 使得 arr[start, mid) 都应排在 arr[mid, end) 之后(end 与 start 关于中点对称)
+        size_t half = lo + (hi - lo) / 2;
+        size_t sum = half + mid;
+        size_t start, r;
+        if (mid > half)
+        {
+            start = sum - hi;
+            r = half;
+        }
+        else
+        {
+            start = lo;
+            r = mid;
+        }
+        size_t p = sum - 1;
+        while (start < r)
+        {
+            size_t c = start + (r - start) / 2;
+            if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(ctx, p - c), AT(ctx, c)) >= 0)
+            {
+                start = c + 1;
+            }
+            else
+            {
+                r = c;
+            }
+        }
+        size_t end = sum - start;
+        if (start < mid && mid < end)
+        {
+            rotate(ctx, start, mid, end);
+        }
+        // 递归较小的一侧，较大的一侧循环处理，栈深度为 O(log n)
+        if (half - lo <= hi - half)
+        {
+            merge(ctx, lo, start, half);
+            lo = half;
+            mid = end;
+        }
+        else
+        {
+            merge(ctx, half, end, hi);
+            hi = half;
+            mid = start;
+        }
+    }
+}
+
+/* ============================================================================
+ * 排序
+ * ============================================================================
+ */
+
+sort_result_t generic_inplace_merge_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_inplace_merge_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_inplace_merge_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (0 == element_size)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+
+    size_t buffer_len = ceil_sqrt(arr_len);
+    size_t buffer_bytes = buffer_len * element_size;
+    void *buffer = scratch_alloc(buffer_bytes);
+    if (NULL == buffer)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, buffer_bytes);
+    sort_result_t res = generic_inplace_merge_sort_with_buffer_ex(arr, arr_len, element_size, cmp, buffer, buffer_len, stats);
+    scratch_free(buffer);
+    DECRE_MEMORY_USED(stats, buffer_bytes);
+    STOP_TIMMING(stats);
+    return res;
+}
+
+sort_result_t generic_inplace_merge_sort_with_buffer(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    size_t buffer_len)
+{
+    return generic_inplace_merge_sort_with_buffer_ex(arr, arr_len, element_size, cmp, buffer, buffer_len, NULL);
+}
+
+sort_result_t generic_inplace_merge_sort_with_buffer_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    size_t buffer_len,
+    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp || NULL == buffer)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (0 == element_size)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (0 == buffer_len)
+    {
+        return SORT_ERROR_INVALID_ARGUMENT;
+    }
+
+    inplace_merge_ctx_t ctx = {
+        (char *)arr, element_size, cmp, select_swap_func(element_size), (char *)buffer, buffer_len, stats};
+
+    // 插入排序的暂存元素借用辅助空间的第一个位置
+    for (size_t lo = 0; lo < arr_len; lo += INPLACE_MERGE_SORT_RUN_LENGTH)
+    {
+        size_t len = arr_len - lo < INPLACE_MERGE_SORT_RUN_LENGTH ? arr_len - lo : INPLACE_MERGE_SORT_RUN_LENGTH;
+        generic_insertion_sort_with_buffer_ex(AT(&ctx, lo), len, element_size, cmp, buffer, stats);
+    }
+    for (size_t width = INPLACE_MERGE_SORT_RUN_LENGTH; width < arr_len; width *= 2)
+    {
+        for (size_t lo = 0; lo + width < arr_len; lo += 2 * width)
+        {
+            size_t hi = arr_len - lo - width > width ? lo + 2 * width : arr_len;
+            merge(&ctx, lo, lo + width, hi);
+        }
+        if (width > arr_len / 2)
+        {
+            break;
+        }
+    }
+    return SORT_SUCCESS;
+}
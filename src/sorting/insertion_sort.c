@@ -2,40 +2,69 @@
 #include <stdlib.h>
 #include "sorting/sort_common.h"
 #include "sorting/insertion_sort.h"
+#include "util/scratch_arena.h"
 
+// 元素不超过该大小时暂存空间放在栈上
+#define INSERTION_SORT_STACK_TMP_SIZE 64
 
 sort_result_t generic_insertion_sort(void *ptr_arr[],
                                      size_t arr_len,
                                      size_t element_size,
                                      compare_func_t cmp)
 {
+    return generic_insertion_sort_ex(ptr_arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_insertion_sort_ex(void *ptr_arr[],
+                                        size_t arr_len,
+                                        size_t element_size,
+                                        compare_func_t cmp,
+                                        sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
     if (NULL == ptr_arr || NULL == cmp)
     {
         return SORT_ERROR_NULL_POINTER;
     }
     if (arr_len == 0 || arr_len == 1)
     {
+        STOP_TIMMING(stats);
         return SORT_SUCCESS;
     }
 
-    void *key = malloc(element_size);
-    if (NULL == key)
+    char stack_key[INSERTION_SORT_STACK_TMP_SIZE];
+    void *key = stack_key;
+    if (element_size > INSERTION_SORT_STACK_TMP_SIZE)
     {
-        return SORT_ERROR_ALLOCATION_FAILED;
+        key = scratch_alloc(element_size);
+        if (NULL == key)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
     }
 
     for (size_t i = 1; i < arr_len; i++)
     {
         memcpy(key, ptr_arr[i], element_size);
-        size_t j = i - 1;
-        while (j > 0 && cmp(ptr_arr[j], key) > 0)
+        size_t j = i;
+        while (j > 0 && COUNTED_CMP(stats, cmp, ptr_arr[j - 1], key) > 0)
         {
-            memcpy(ptr_arr[j + 1], ptr_arr[j], element_size);
+            memcpy(ptr_arr[j], ptr_arr[j - 1], element_size);
+            INCRE_MOVEMENTS(stats);
             j--;
         }
-        memcpy(ptr_arr[j + 1], key, element_size);
+        memcpy(ptr_arr[j], key, element_size);
+        INCRE_MOVEMENTS_BY(stats, 2);
     }
-    free(key);
+    if (key != stack_key)
+    {
+        scratch_free(key);
+        DECRE_MEMORY_USED(stats, element_size);
+    }
+    STOP_TIMMING(stats);
     return SORT_SUCCESS;
 }
 
@@ -44,7 +73,18 @@ sort_result_t generic_insertion_sort_with_binary_search(void *ptr_arr[],
                                                         size_t element_size,
                                                         compare_func_t cmp)
 {
+    return generic_insertion_sort_with_binary_search_ex(ptr_arr, arr_len, element_size, cmp, NULL);
+}
 
+sort_result_t generic_insertion_sort_with_binary_search_ex(void *ptr_arr[],
+                                                           size_t arr_len,
+                                                           size_t element_size,
+                                                           compare_func_t cmp,
+                                                           sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
     if (NULL == ptr_arr || NULL == cmp)
     {
         return SORT_ERROR_NULL_POINTER;
@@ -52,13 +92,20 @@ sort_result_t generic_insertion_sort_with_binary_search(void *ptr_arr[],
 
     if (arr_len <= 1)
     {
+        STOP_TIMMING(stats);
         return SORT_SUCCESS;
     }
 
-    void *key = malloc(element_size);
-    if (NULL == key)
+    char stack_key[INSERTION_SORT_STACK_TMP_SIZE];
+    void *key = stack_key;
+    if (element_size > INSERTION_SORT_STACK_TMP_SIZE)
     {
-        return SORT_ERROR_ALLOCATION_FAILED;
+        key = scratch_alloc(element_size);
+        if (NULL == key)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
     }
 
     for (size_t i = 1; i < arr_len; i++)
@@ -72,7 +119,7 @@ sort_result_t generic_insertion_sort_with_binary_search(void *ptr_arr[],
         {
 
             mid = left + (right - left) / 2;
-            if (cmp(ptr_arr[mid], key) < 0)
+            if (COUNTED_CMP(stats, cmp, ptr_arr[mid], key) < 0)
             {
                 // 如果中点的值比key小，则key应该在中点的右侧，所以将左界设置为mid + 1
                 left = mid + 1;
@@ -89,9 +136,104 @@ sort_result_t generic_insertion_sort_with_binary_search(void *ptr_arr[],
             memcpy(ptr_arr[j], ptr_arr[j - 1], element_size);
         }
         memcpy(ptr_arr[left], key, element_size);
+        INCRE_MOVEMENTS_BY(stats, i - left + 1);
+    }
+
+
+    if (key != stack_key)
+    {
+        scratch_free(key);
+        DECRE_MEMORY_USED(stats, element_size);
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
+
+sort_result_t generic_insertion_sort_with_buffer(void *arr,
+                                                 size_t arr_len,
+                                                 size_t element_size,
+                                                 compare_func_t cmp,
+                                                 void *tmp)
+{
+    return generic_insertion_sort_with_buffer_ex(arr, arr_len, element_size, cmp, tmp, NULL);
+}
+
+sort_result_t generic_insertion_sort_with_buffer_ex(void *arr,
+                                                    size_t arr_len,
+                                                    size_t element_size,
+                                                    compare_func_t cmp,
+                                                    void *tmp,
+                                                    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp || NULL == tmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+
+    for (size_t i = 1; i < arr_len; i++)
+    {
+        void *cur = INDEX_OF(arr, element_size, i);
+        if (COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, i - 1), cur) <= 0)
+        {
+            continue;
+        }
+        memcpy(tmp, cur, element_size);
+        size_t j = i - 1;
+        while (j > 0 && COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, j - 1), tmp) > 0)
+        {
+            j--;
+        }
+        memmove(INDEX_OF(arr, element_size, j + 1), INDEX_OF(arr, element_size, j), (i - j) * element_size);
+        memcpy(INDEX_OF(arr, element_size, j), tmp, element_size);
+        INCRE_MOVEMENTS_BY(stats, i - j + 1);
     }
+    return SORT_SUCCESS;
+}
 
+sort_result_t generic_binary_insertion_sort_with_buffer(void *arr,
+                                                        size_t arr_len,
+                                                        size_t element_size,
+                                                        compare_func_t cmp,
+                                                        size_t start,
+                                                        void *tmp)
+{
+    return generic_binary_insertion_sort_with_buffer_ex(arr, arr_len, element_size, cmp, start, tmp, NULL);
+}
 
-    free(key);
+sort_result_t generic_binary_insertion_sort_with_buffer_ex(void *arr,
+                                                           size_t arr_len,
+                                                           size_t element_size,
+                                                           compare_func_t cmp,
+                                                           size_t start,
+                                                           void *tmp,
+                                                           sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp || NULL == tmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+
+    for (size_t i = start > 0 ? start : 1; i < arr_len; i++)
+    {
+        memcpy(tmp, INDEX_OF(arr, element_size, i), element_size);
+        size_t left = 0;
+        size_t right = i;
+        while (left < right)
+        {
+            size_t mid = left + (right - left) / 2;
+            if (COUNTED_CMP(stats, cmp, tmp, INDEX_OF(arr, element_size, mid)) < 0)
+            {
+                right = mid;
+            }
+            else
+            {
+                // 相等时继续向右找，保证稳定
+                left = mid + 1;
+            }
+        }
+        memmove(INDEX_OF(arr, element_size, left + 1), INDEX_OF(arr, element_size, left), (i - left) * element_size);
+        memcpy(INDEX_OF(arr, element_size, left), tmp, element_size);
+        INCRE_MOVEMENTS_BY(stats, i - left + 1);
+    }
     return SORT_SUCCESS;
 }
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "sorting/key_sort.h"
+#include "sorting/radix_sort.h"
+#include "sorting/merge_sort.h"
+#include "sorting/indirect_sort.h"
+#include "util/scratch_arena.h"
+
+typedef struct
+{
+    uint64_t key;
+    size_t index;
+} key_index_pair_t;
+
+typedef struct
+{
+    compare_func_t *cmp;
+    size_t comparisons;
+} key_sort_ctx_t;
+
+/** 键相同的一段元素的引用，比较时计数 */
+typedef struct
+{
+    const void *ptr;
+    key_sort_ctx_t *ctx;
+} tie_ref_t;
+
+static int compare_tie_refs(const void *const a, const void *const b)
+{
+    const tie_ref_t *ra = (const tie_ref_t *)a;
+    const tie_ref_t *rb = (const tie_ref_t *)b;
+    ra->ctx->comparisons++;
+    return ra->ctx->cmp(ra->ptr, rb->ptr);
+}
+
+/** 对 pairs[begin, end) 这段键相同的元素用完整比较函数做稳定排序 */
+static sort_result_t sort_tie_run(key_index_pair_t *pairs, size_t begin, size_t end,
+                                  const void *arr, size_t element_size,
+                                  key_sort_ctx_t *ctx, tie_ref_t *refs, tie_ref_t *buffer)
+{
+    size_t run_len = end - begin;
+    for (size_t i = 0; i < run_len; i++)
+    {
+        refs[i].ptr = INDEX_OF(arr, element_size, pairs[begin + i].index);
+        refs[i].ctx = ctx;
+    }
+    sort_result_t res = generic_merge_sort_with_buffer(refs, run_len, sizeof(tie_ref_t), compare_tie_refs, buffer);
+    if (res != SORT_SUCCESS)
+    {
+        return res;
+    }
+    for (size_t i = 0; i < run_len; i++)
+    {
+        pairs[begin + i].index = (size_t)((const char *)refs[i].ptr - (const char *)arr) / element_size;
+    }
+    return SORT_SUCCESS;
+}
+
+static size_t estimated_comparisons(size_t n)
+{
+    size_t log2n = 0;
+    while (((size_t)1 << log2n) < n)
+    {
+        log2n++;
+    }
+    return n * log2n;
+}
+
+sort_result_t generic_key_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    sort_key_func_t *key,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == key)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+
+    size_t pairs_size = arr_len * sizeof(key_index_pair_t);
+    key_index_pair_t *pairs = (key_index_pair_t *)scratch_alloc(pairs_size);
+    if (NULL == pairs)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, pairs_size);
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        pairs[i].key = key(INDEX_OF(arr, element_size, i));
+        pairs[i].index = i;
+    }
+
+    // LSD 基数排序是稳定的，键相同的元素仍按原下标升序排列
+    sort_result_t res = generic_radix_sort(pairs, arr_len, sizeof(key_index_pair_t),
+                                           offsetof(key_index_pair_t, key), RADIX_KEY_UINT64);
+
+    key_sort_ctx_t ctx = {cmp, 0};
+    if (res == SORT_SUCCESS && NULL != cmp)
+    {
+        size_t max_run = 1;
+        for (size_t begin = 0, end; begin < arr_len; begin = end)
+        {
+            for (end = begin + 1; end < arr_len && pairs[end].key == pairs[begin].key; end++)
+            {
+            }
+            max_run = end - begin > max_run ? end - begin : max_run;
+        }
+
+        if (max_run > 1)
+        {
+            size_t refs_size = 2 * max_run * sizeof(tie_ref_t);
+            tie_ref_t *refs = (tie_ref_t *)scratch_alloc(refs_size);
+            if (NULL == refs)
+            {
+                res = SORT_ERROR_ALLOCATION_FAILED;
+            }
+            else
+            {
+                INCRE_MEMORY_USED(stats, refs_size);
+                for (size_t begin = 0, end; begin < arr_len && res == SORT_SUCCESS; begin = end)
+                {
+                    for (end = begin + 1; end < arr_len && pairs[end].key == pairs[begin].key; end++)
+                    {
+                    }
+                    if (end - begin > 1)
+                    {
+                        res = sort_tie_run(pairs, begin, end, arr, element_size, &ctx, refs, refs + max_run);
+                    }
+                }
+                scratch_free(refs);
+                DECRE_MEMORY_USED(stats, refs_size);
+            }
+        }
+    }
+
+    if (res == SORT_SUCCESS)
+    {
+        // 下标原地收拢到 pairs 的前半部分，作为置换交给 apply_permutation
+        size_t *perm = (size_t *)pairs;
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            perm[i] = pairs[i].index;
+        }
+        res = apply_permutation(arr, arr_len, element_size, perm);
+    }
+
+    scratch_free(pairs);
+    DECRE_MEMORY_USED(stats, pairs_size);
+    if (NULL != stats)
+    {
+        size_t baseline = estimated_comparisons(arr_len);
+        stats->comparisons = ctx.comparisons;
+        stats->comparisons_avoided = baseline > ctx.comparisons ? baseline - ctx.comparisons : 0;
+    }
+    STOP_TIMMING(stats);
+    return res;
+}
@@ -1,23 +1,42 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "sorting/merge_sort.h"
+#include "sorting/insertion_sort.h"
+#include "util/scratch_arena.h"
 
+// 元素不超过该大小时插入排序的暂存空间放在栈上
+#define MERGE_SORT_STACK_TMP_SIZE 64
 
+typedef struct
+{
+    size_t element_size;
+    compare_func_t *cmp;
+    void *tmp;
+    sort_stats_t *stats;
+} merge_sort_ctx_t;
 
-static inline sort_result_t internal_merge_sort(
-    void *arr,
+static void split_merge(
+    const merge_sort_ctx_t *ctx,
+    char *src,
+    char *dst,
     size_t left,
-    size_t right,
-    size_t element_size,
-    compare_func_t cmp);
+    size_t right);
 
-static inline sort_result_t merge(
-    void *arr,
+static inline void merge(
+    const merge_sort_ctx_t *ctx,
+    const char *src,
+    char *dst,
     size_t left,
     size_t mid,
-    size_t right,
+    size_t right);
+
+static sort_result_t merge_sort_impl(
+    void *arr,
+    size_t arr_len,
     size_t element_size,
-    compare_func_t cmp);
+    compare_func_t cmp,
+    void *buffer,
+    sort_stats_t *stats);
 
 sort_result_t generic_merge_sort(
     void *arr,
@@ -25,99 +44,185 @@ sort_result_t generic_merge_sort(
     size_t element_size,
     compare_func_t cmp)
 {
+    return generic_merge_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_merge_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
     if (arr == NULL || NULL == cmp)
     {
         return SORT_ERROR_NULL_POINTER;
     }
     if (arr_len <= 1)
     {
+        STOP_TIMMING(stats);
         return SORT_SUCCESS;
     }
     if (element_size == 0)
     {
         return SORT_ERROR_INVALID_ELEMENT_SIZE;
     }
-    return internal_merge_sort(arr, 0, arr_len - 1, element_size, cmp);
+
+    void *buffer = scratch_alloc(arr_len * element_size);
+    if (NULL == buffer)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, arr_len * element_size);
+    sort_result_t res = merge_sort_impl(arr, arr_len, element_size, cmp, buffer, stats);
+    scratch_free(buffer);
+    DECRE_MEMORY_USED(stats, arr_len * element_size);
+    STOP_TIMMING(stats);
+    return res;
 }
 
-static inline sort_result_t internal_merge_sort(
+sort_result_t generic_merge_sort_with_buffer(
     void *arr,
-    size_t left,
-    size_t right,
+    size_t arr_len,
     size_t element_size,
-    compare_func_t cmp)
+    compare_func_t cmp,
+    void *buffer)
+{
+    return generic_merge_sort_with_buffer_ex(arr, arr_len, element_size, cmp, buffer, NULL);
+}
+
+sort_result_t generic_merge_sort_with_buffer_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (arr == NULL || NULL == cmp || NULL == buffer)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    sort_result_t res = merge_sort_impl(arr, arr_len, element_size, cmp, buffer, stats);
+    STOP_TIMMING(stats);
+    return res;
+}
+
+static sort_result_t merge_sort_impl(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *buffer,
+    sort_stats_t *stats)
 {
-    if (left < right)
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
     {
-        size_t mid = left + (right - left) / 2;
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
 
-        sort_result_t res = internal_merge_sort(arr, left, mid, element_size, cmp);
-        if (res != SORT_SUCCESS)
-            return res;
+    char stack_tmp[MERGE_SORT_STACK_TMP_SIZE];
+    void *tmp = stack_tmp;
+    if (element_size > MERGE_SORT_STACK_TMP_SIZE)
+    {
+        tmp = scratch_alloc(element_size);
+        if (NULL == tmp)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
+    }
 
-        res = internal_merge_sort(arr, mid + 1, right, element_size, cmp);
-        if (res != SORT_SUCCESS)
-            return res;
+    merge_sort_ctx_t ctx = {element_size, cmp, tmp, stats};
+    // 两块空间内容一致，之后以 buffer 为源、arr 为目的开始递归
+    memcpy(buffer, arr, arr_len * element_size);
+    INCRE_MOVEMENTS_BY(stats, arr_len);
+    split_merge(&ctx, (char *)buffer, (char *)arr, 0, arr_len);
 
-        return merge(arr, left, mid, right, element_size, cmp);
+    if (tmp != stack_tmp)
+    {
+        scratch_free(tmp);
+        DECRE_MEMORY_USED(stats, element_size);
     }
     return SORT_SUCCESS;
 }
 
-static inline sort_result_t merge(
-    void *arr,
+/**
+ * 把 src[left, right) 排好序写入 dst[left, right)。
+ * 调用时两者在该区间内的内容相同；两个子区间以 dst 为源、src 为目的
+ * 排序，再从 src 归并回 dst，因此每层只做一次元素拷贝。
+ */
+static void split_merge(
+    const merge_sort_ctx_t *ctx,
+    char *src,
+    char *dst,
+    size_t left,
+    size_t right)
+{
+    size_t es = ctx->element_size;
+    if (right - left <= MERGE_SORT_RUN_LENGTH)
+    {
+        generic_insertion_sort_with_buffer_ex(INDEX_OF(dst, es, left), right - left, es, ctx->cmp, ctx->tmp, ctx->stats);
+        return;
+    }
+
+    size_t mid = left + (right - left) / 2;
+    split_merge(ctx, dst, src, left, mid);
+    split_merge(ctx, dst, src, mid, right);
+    merge(ctx, src, dst, left, mid, right);
+}
+
+static inline void merge(
+    const merge_sort_ctx_t *ctx,
+    const char *src,
+    char *dst,
     size_t left,
     size_t mid,
-    size_t right,
-    size_t element_size,
-    compare_func_t cmp)
+    size_t right)
 {
-    size_t size_l = mid - left + 1;
-    size_t size_r = right - mid;
+    size_t es = ctx->element_size;
+    compare_func_t *cmp = ctx->cmp;
 
-    void *left_arr = malloc(size_l * element_size);
-    void *right_arr = malloc(size_r * element_size);
-    if (left_arr == NULL || right_arr == NULL)
+    INCRE_MOVEMENTS_BY(ctx->stats, right - left);
+    // 左半最大值不大于右半最小值时两半已经有序，整体拷贝即可
+    if (COUNTED_CMP(ctx->stats, cmp, INDEX_OF(src, es, mid - 1), INDEX_OF(src, es, mid)) <= 0)
     {
-        if (left_arr)
-            free(left_arr);
-        if (right_arr)
-            free(right_arr);
-        return SORT_ERROR_ALLOCATION_FAILED;
+        memcpy(INDEX_OF(dst, es, left), INDEX_OF(src, es, left), (right - left) * es);
+        return;
     }
-    memcpy(left_arr, INDEX_OF(arr, element_size, left), size_l * element_size);
-    memcpy(right_arr, INDEX_OF(arr, element_size, mid + 1), size_r * element_size);
 
-    size_t i = 0, j = 0, k = left;
-    while (i < size_l && j < size_r)
+    size_t i = left, j = mid, k = left;
+    while (i < mid && j < right)
     {
-        if (cmp(INDEX_OF(left_arr, element_size, i), INDEX_OF(right_arr, element_size, j)) <= 0)
+        if (COUNTED_CMP(ctx->stats, cmp, INDEX_OF(src, es, i), INDEX_OF(src, es, j)) <= 0)
         {
-            memcpy(INDEX_OF(arr, element_size, k), INDEX_OF(left_arr, element_size, i), element_size);
+            memcpy(INDEX_OF(dst, es, k), INDEX_OF(src, es, i), es);
             i++;
-            k++;
         }
         else
         {
-            memcpy(INDEX_OF(arr, element_size, k), INDEX_OF(right_arr, element_size, j), element_size);
+            memcpy(INDEX_OF(dst, es, k), INDEX_OF(src, es, j), es);
             j++;
-            k++;
         }
+        k++;
     }
 
-    while (i < size_l)
+    if (i < mid)
     {
-        memcpy(INDEX_OF(arr, element_size, k), INDEX_OF(left_arr, element_size, i), element_size);
-        i++;
-        k++;
+        memcpy(INDEX_OF(dst, es, k), INDEX_OF(src, es, i), (mid - i) * es);
     }
-    while (j < size_r)
+    if (j < right)
     {
-        memcpy(INDEX_OF(arr, element_size, k), INDEX_OF(right_arr, element_size, j), element_size);
-        j++;
-        k++;
+        memcpy(INDEX_OF(dst, es, k), INDEX_OF(src, es, j), (right - j) * es);
     }
-    free(left_arr);
-    free(right_arr);
-    return SORT_SUCCESS;
 }
@@ -0,0 +1,376 @@
+#include "sorting/nth_element.h"
+#include "sorting/quick_sort.h"
+
+// 超过该长度时用九数取中选枢轴，与快速排序一致
+#define NTH_ELEMENT_NINTHER_THRESHOLD 128
+
+// median-of-medians 每组元素个数
+#define NTH_ELEMENT_GROUP_SIZE 5
+
+typedef struct
+{
+    size_t element_size;
+    compare_func_t *cmp;
+    sized_swap_func_t *swap;
+    sort_stats_t *stats;
+} select_ctx_t;
+
+#define SEL_CMP(ctx, a, b) COUNTED_CMP((ctx)->stats, (ctx)->cmp, (a), (b))
+
+#define SEL_SWAP(ctx, a, b)                              \
+    do                                                   \
+    {                                                    \
+        if ((a) != (b))                                  \
+        {                                                \
+            (ctx)->swap((a), (b), (ctx)->element_size);  \
+            INCRE_MOVEMENTS_BY((ctx)->stats, 2);         \
+        }                                                \
+    } while (0)
+
+static inline size_t log2_floor(size_t n)
+{
+    size_t log = 0;
+    while (n >>= 1)
+    {
+        log++;
+    }
+    return log;
+}
+
+static inline void sort2(const select_ctx_t *ctx, char *a, char *b)
+{
+    if (SEL_CMP(ctx, b, a) < 0)
+    {
+        SEL_SWAP(ctx, a, b);
+    }
+}
+
+static inline void sort3(const select_ctx_t *ctx, char *a, char *b, char *c)
+{
+    sort2(ctx, a, b);
+    sort2(ctx, b, c);
+    sort2(ctx, a, b);
+}
+
+/**
+ * 短区间直接处理：不超过 SORTING_NETWORK_MAX 个元素时用排序网络整段排好；
+ * 否则(调大阈值时)从离 nth 较近的一端开始，逐个把最小(最大)值换到位，
+ * 只交换不复制，不需要暂存空间。
+ */
+static void small_select(const select_ctx_t *ctx, char *begin, char *end, char *nth)
+{
+    size_t es = ctx->element_size;
+    size_t size = (size_t)(end - begin) / es;
+    if (size <= SORTING_NETWORK_MAX)
+    {
+        generic_network_sort_ex(begin, size, es, ctx->cmp, ctx->stats);
+        return;
+    }
+    if ((size_t)(nth - begin) <= (size_t)(end - es - nth))
+    {
+        for (char *cur = begin; cur <= nth; cur += es)
+        {
+            char *min = cur;
+            for (char *p = cur + es; p < end; p += es)
+            {
+                if (SEL_CMP(ctx, p, min) < 0)
+                {
+                    min = p;
+                }
+            }
+            SEL_SWAP(ctx, cur, min);
+        }
+    }
+    else
+    {
+        for (char *cur = end - es; cur >= nth; cur -= es)
+        {
+            char *max = cur;
+            for (char *p = begin; p < cur; p += es)
+            {
+                if (SEL_CMP(ctx, max, p) < 0)
+                {
+                    max = p;
+                }
+            }
+            SEL_SWAP(ctx, cur, max);
+        }
+    }
+}
+
+/**
+ * 以 *begin 为枢轴做 Hoare 划分，两侧扫描都在遇到相等元素时停下，
+ * 大量重复值时分界点仍落在中间。返回 cut：[begin, cut) 不大于枢轴，
+ * [cut, end) 不小于枢轴，且两段都非空。
+ * 取中时保证了 [begin + 1, end) 中存在不小于枢轴的元素，左扫描不需要边界检查；
+ * 右扫描最迟停在枢轴本身。
+ */
+static char *partition_hoare(const select_ctx_t *ctx, char *begin, char *end)
+{
+    size_t es = ctx->element_size;
+    const char *pivot = begin;
+    char *first = begin + es;
+    char *last = end;
+    for (;;)
+    {
+        while (SEL_CMP(ctx, first, pivot) < 0)
+        {
+            first += es;
+        }
+        last -= es;
+        while (SEL_CMP(ctx, pivot, last) < 0)
+        {
+            last -= es;
+        }
+        if (first >= last)
+        {
+            return first;
+        }
+        SEL_SWAP(ctx, first, last);
+        first += es;
+    }
+}
+
+/**
+ * 以 *begin 为枢轴三路划分：[begin, *lt) 小于、[*lt, *gt) 等于、[*gt, end) 大于枢轴。
+ * 等于区间始终以 *lt 开头，直接与 *lt 比较，不需要复制枢轴。
+ */
+static void partition_three_way(const select_ctx_t *ctx, char *begin, char *end, char **lt_out, char **gt_out)
+{
+    size_t es = ctx->element_size;
+    char *lt = begin;
+    char *cur = begin + es;
+    char *gt = end;
+    while (cur < gt)
+    {
+        int c = SEL_CMP(ctx, cur, lt);
+        if (c < 0)
+        {
+            SEL_SWAP(ctx, lt, cur);
+            lt += es;
+            cur += es;
+        }
+        else if (c > 0)
+        {
+            gt -= es;
+            SEL_SWAP(ctx, cur, gt);
+        }
+        else
+        {
+            cur += es;
+        }
+    }
+    *lt_out = lt;
+    *gt_out = gt;
+}
+
+/**
+ * median-of-medians 选择，最坏 O(n)。
+ * 每 5 个一组取中位数并集中到区间开头，递归选出这些中位数的中位数作枢轴，
+ * 小于和大于枢轴的部分都不超过约 7n/10。
+ */
+static void mom_select(const select_ctx_t *ctx, char *begin, char *end, char *nth)
+{
+    size_t es = ctx->element_size;
+    for (;;)
+    {
+        size_t size = (size_t)(end - begin) / es;
+        if (size <= NTH_ELEMENT_INSERTION_THRESHOLD)
+        {
+            small_select(ctx, begin, end, nth);
+            return;
+        }
+
+        size_t groups = size / NTH_ELEMENT_GROUP_SIZE;
+        for (size_t g = 0; g < groups; g++)
+        {
+            char *group = begin + g * NTH_ELEMENT_GROUP_SIZE * es;
+            char *median = group + (NTH_ELEMENT_GROUP_SIZE / 2) * es;
+            small_select(ctx, group, group + NTH_ELEMENT_GROUP_SIZE * es, median);
+            // 目标位置所在的组下标不超过 g，已经处理过
+            SEL_SWAP(ctx, begin + g * es, median);
+        }
+        char *pivot = begin + (groups / 2) * es;
+        mom_select(ctx, begin, begin + groups * es, pivot);
+        SEL_SWAP(ctx, begin, pivot);
+
+        char *lt;
+        char *gt;
+        partition_three_way(ctx, begin, end, &lt, &gt);
+        if (nth < lt)
+        {
+            end = lt;
+        }
+        else if (nth >= gt)
+        {
+            begin = gt;
+        }
+        else
+        {
+            return;
+        }
+    }
+}
+
+static void introselect(const select_ctx_t *ctx, char *begin, char *end, char *nth, size_t budget)
+{
+    size_t es = ctx->element_size;
+    for (;;)
+    {
+        size_t size = (size_t)(end - begin) / es;
+        if (size <= NTH_ELEMENT_INSERTION_THRESHOLD)
+        {
+            small_select(ctx, begin, end, nth);
+            return;
+        }
+        if (budget == 0)
+        {
+            mom_select(ctx, begin, end, nth);
+            return;
+        }
+        budget--;
+
+        // 取中后枢轴放在 begin，最大值留在 [begin + 1, end) 中作为哨兵
+        char *mid = begin + (size / 2) * es;
+        if (size > NTH_ELEMENT_NINTHER_THRESHOLD)
+        {
+            sort3(ctx, begin, mid, end - es);
+            sort3(ctx, begin + es, mid - es, end - 2 * es);
+            sort3(ctx, begin + 2 * es, mid + es, end - 3 * es);
+            sort3(ctx, mid - es, mid, mid + es);
+        }
+        else
+        {
+            sort3(ctx, begin + es, mid, end - es);
+        }
+        SEL_SWAP(ctx, begin, mid);
+
+        char *cut = partition_hoare(ctx, begin, end);
+        if (cut <= nth)
+        {
+            begin = cut;
+        }
+        else
+        {
+            end = cut;
+        }
+    }
+}
+
+static void nth_element_impl(void *arr, size_t arr_len, size_t element_size, compare_func_t cmp, size_t nth, sort_stats_t *stats)
+{
+    select_ctx_t ctx = {element_size, cmp, select_swap_func(element_size), stats};
+    char *begin = (char *)arr;
+    introselect(&ctx, begin, begin + arr_len * element_size, begin + nth * element_size, 2 * log2_floor(arr_len));
+}
+
+sort_result_t generic_nth_element(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t nth)
+{
+    return generic_nth_element_ex(arr, arr_len, element_size, cmp, nth, NULL);
+}
+
+sort_result_t generic_nth_element_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t nth,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (nth >= arr_len)
+    {
+        return SORT_ERROR_INVALID_ARGUMENT;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    nth_element_impl(arr, arr_len, element_size, cmp, nth, stats);
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
+
+sort_result_t generic_partial_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t k)
+{
+    return generic_partial_sort_ex(arr, arr_len, element_size, cmp, k, NULL);
+}
+
+sort_result_t generic_partial_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    size_t k,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (k > arr_len)
+    {
+        return SORT_ERROR_INVALID_ARGUMENT;
+    }
+    if (arr_len <= 1 || k == 0)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    // 第 k 小就位后前 k - 1 个都不大于它，只需再排这一段
+    size_t sort_len = k;
+    if (k < arr_len)
+    {
+        nth_element_impl(arr, arr_len, element_size, cmp, k - 1, stats);
+        sort_len = k - 1;
+    }
+
+    sort_result_t ret;
+    if (NULL == stats)
+    {
+        ret = generic_quick_sort(arr, sort_len, element_size, cmp);
+    }
+    else
+    {
+        // generic_quick_sort_ex 会重置统计，先记到局部变量再累加
+        sort_stats_t local;
+        ret = generic_quick_sort_ex(arr, sort_len, element_size, cmp, &local);
+        sort_stats_merge(stats, &local);
+    }
+    if (ret != SORT_SUCCESS)
+    {
+        return ret;
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
@@ -0,0 +1,690 @@
+#include <stdlib.h>
+#include "sorting/parallel_sort.h"
+#include "sorting/quick_sort.h"
+#include "sorting/merge_sort.h"
+#include "util/thread_pool.h"
+#include "util/scratch_arena.h"
+
+// 每个桶的抽样数
+#define SAMPLESORT_OVERSAMPLING 32
+// 桶数上限，加上相等桶后的桶编号仍能放进一个字节
+#define SAMPLESORT_MAX_BUCKETS 128
+// 每个线程分到的桶/块数，用于负载均衡
+#define PARALLEL_SORT_TASKS_PER_THREAD 4
+// 并行归并中每段输出的最小元素数
+#define PARALLEL_MERGE_MIN_SEGMENT 4096
+
+static size_t sequential_cutoff = PARALLEL_SORT_SEQUENTIAL_CUTOFF;
+
+void parallel_sort_set_cutoff(size_t cutoff)
+{
+    sequential_cutoff = cutoff == 0 ? PARALLEL_SORT_SEQUENTIAL_CUTOFF : cutoff;
+}
+
+size_t parallel_sort_get_cutoff(void)
+{
+    return sequential_cutoff;
+}
+
+static inline void submit_or_run(thread_pool_t *pool,
+                                 thread_pool_group_t *group,
+                                 thread_pool_task_func_t *func,
+                                 void *arg)
+{
+    if (thread_pool_submit(pool, group, func, arg) != 0)
+    {
+        func(arg);
+    }
+}
+
+/**
+ * 把 part 中的计数累加到 acc，acc 为 NULL(不统计)时什么也不做。
+ */
+static inline void accumulate_stats(sort_stats_t *acc, const sort_stats_t *part)
+{
+    if (NULL != acc)
+    {
+        sort_stats_merge(acc, part);
+    }
+}
+
+static inline thread_pool_t *usable_pool(size_t arr_len)
+{
+    thread_pool_t *pool = thread_pool_global();
+    if (NULL == pool || thread_pool_size(pool) <= 1 || arr_len < sequential_cutoff)
+    {
+        return NULL;
+    }
+    return pool;
+}
+
+/* ============================================================================
+ * 并行样本排序
+ * ============================================================================
+ */
+
+typedef struct
+{
+    char *arr;
+    char *buffer;
+    unsigned char *bucket_ids;
+    size_t arr_len;
+    size_t element_size;
+    compare_func_t *cmp;
+    const char *splitters;
+    size_t num_splitters;
+    int has_equal_buckets;
+    size_t num_blocks;
+    size_t num_ids;
+    // 第 i 块的计数位于 counts[i * num_ids, (i + 1) * num_ids)，分发前转换为写入位置
+    size_t *counts;
+    // 桶 id 在辅助空间中的区间为 [bucket_starts[id], bucket_starts[id + 1])
+    size_t *bucket_starts;
+    // 不为 NULL 时各任务把计数记在自己的 stats 中，结束后汇总
+    sort_stats_t *stats;
+} samplesort_t;
+
+typedef struct
+{
+    samplesort_t *sort;
+    size_t index;
+    sort_stats_t stats;
+} samplesort_task_t;
+
+#define TASK_STATS(s, task) (NULL != (s)->stats ? &(task)->stats : NULL)
+
+static inline size_t block_begin(const samplesort_t *s, size_t block)
+{
+    return block * s->arr_len / s->num_blocks;
+}
+
+/**
+ * 桶编号：2k 表示落在第 k-1 和第 k 个分割元素之间，
+ * 2k-1 表示等于第 k-1 个分割元素(仅在分割元素有重复时使用)。
+ */
+static inline unsigned char classify(const samplesort_t *s, const char *elem, sort_stats_t *stats)
+{
+    size_t es = s->element_size;
+    size_t lo = 0;
+    size_t hi = s->num_splitters;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (COUNTED_CMP(stats, s->cmp, INDEX_OF(s->splitters, es, mid), elem) <= 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (s->has_equal_buckets && lo > 0 && COUNTED_CMP(stats, s->cmp, INDEX_OF(s->splitters, es, lo - 1), elem) == 0)
+    {
+        return (unsigned char)(2 * lo - 1);
+    }
+    return (unsigned char)(2 * lo);
+}
+
+static void classify_block_task(void *arg)
+{
+    samplesort_task_t *task = (samplesort_task_t *)arg;
+    samplesort_t *s = task->sort;
+    size_t *counts = s->counts + task->index * s->num_ids;
+    sort_stats_t *stats = TASK_STATS(s, task);
+    size_t end = block_begin(s, task->index + 1);
+    for (size_t i = block_begin(s, task->index); i < end; i++)
+    {
+        unsigned char id = classify(s, INDEX_OF(s->arr, s->element_size, i), stats);
+        s->bucket_ids[i] = id;
+        counts[id]++;
+    }
+}
+
+static void scatter_block_task(void *arg)
+{
+    samplesort_task_t *task = (samplesort_task_t *)arg;
+    samplesort_t *s = task->sort;
+    size_t es = s->element_size;
+    size_t *offsets = s->counts + task->index * s->num_ids;
+    size_t end = block_begin(s, task->index + 1);
+    for (size_t i = block_begin(s, task->index); i < end; i++)
+    {
+        memcpy(INDEX_OF(s->buffer, es, offsets[s->bucket_ids[i]]++), INDEX_OF(s->arr, es, i), es);
+    }
+    INCRE_MOVEMENTS_BY(TASK_STATS(s, task), end - block_begin(s, task->index));
+}
+
+static void sort_bucket_task(void *arg)
+{
+    samplesort_task_t *task = (samplesort_task_t *)arg;
+    samplesort_t *s = task->sort;
+    size_t es = s->element_size;
+    size_t begin = s->bucket_starts[task->index];
+    size_t len = s->bucket_starts[task->index + 1] - begin;
+    sort_stats_t *stats = TASK_STATS(s, task);
+    // 奇数编号的桶内元素全部相等
+    if (task->index % 2 == 0)
+    {
+        // _ex 会先重置传入的统计，先记到 local 再累加，以免清掉 stats 里已有的计数
+        sort_stats_t local;
+        generic_quick_sort_ex(INDEX_OF(s->buffer, es, begin), len, es, s->cmp, NULL != stats ? &local : NULL);
+        accumulate_stats(stats, &local);
+    }
+    memcpy(INDEX_OF(s->arr, es, begin), INDEX_OF(s->buffer, es, begin), len * es);
+    INCRE_MOVEMENTS_BY(stats, len);
+}
+
+/**
+ * 抽样并排序，取等间隔的样本作为分割元素。
+ */
+static sort_result_t choose_splitters(samplesort_t *s, size_t num_buckets, char *splitters)
+{
+    size_t es = s->element_size;
+    size_t num_samples = num_buckets * SAMPLESORT_OVERSAMPLING;
+    char *samples = (char *)scratch_alloc(num_samples * es);
+    if (NULL == samples)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(s->stats, num_samples * es);
+
+    // 固定种子的线性同余生成器，结果可复现
+    unsigned long long state = 0x9E3779B97F4A7C15ull ^ s->arr_len;
+    for (size_t i = 0; i < num_samples; i++)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        memcpy(INDEX_OF(samples, es, i), INDEX_OF(s->arr, es, (size_t)(state >> 33) % s->arr_len), es);
+    }
+    sort_stats_t local;
+    generic_quick_sort_ex(samples, num_samples, es, s->cmp, NULL != s->stats ? &local : NULL);
+    accumulate_stats(s->stats, &local);
+
+    s->has_equal_buckets = 0;
+    for (size_t k = 0; k + 1 < num_buckets; k++)
+    {
+        memcpy(INDEX_OF(splitters, es, k), INDEX_OF(samples, es, (k + 1) * SAMPLESORT_OVERSAMPLING - 1), es);
+        if (k > 0 && COUNTED_CMP(s->stats, s->cmp, INDEX_OF(splitters, es, k - 1), INDEX_OF(splitters, es, k)) == 0)
+        {
+            s->has_equal_buckets = 1;
+        }
+    }
+    scratch_free(samples);
+    DECRE_MEMORY_USED(s->stats, num_samples * es);
+    return SORT_SUCCESS;
+}
+
+/** 桶数：每线程 PARALLEL_SORT_TASKS_PER_THREAD 个，元素太少时减少，小于 2 时不做样本排序 */
+static size_t samplesort_buckets(size_t threads, size_t arr_len)
+{
+    size_t num_buckets = threads * PARALLEL_SORT_TASKS_PER_THREAD;
+    if (num_buckets > SAMPLESORT_MAX_BUCKETS)
+    {
+        num_buckets = SAMPLESORT_MAX_BUCKETS;
+    }
+    if (num_buckets * SAMPLESORT_OVERSAMPLING * 2 > arr_len)
+    {
+        num_buckets = arr_len / (SAMPLESORT_OVERSAMPLING * 2);
+    }
+    return num_buckets;
+}
+
+/**
+ * 样本排序同时占用的辅助空间上界：分类缓冲、桶编号、计数等常驻部分，选分割元素时的
+ * 抽样，以及每个桶排序大记录时临时存放的一个元素
+ */
+static size_t samplesort_scratch_bytes(size_t threads, size_t arr_len, size_t element_size)
+{
+    size_t num_buckets = samplesort_buckets(threads, arr_len);
+    if (num_buckets < 2)
+    {
+        return element_size;
+    }
+    size_t num_splitters = num_buckets - 1;
+    size_t num_ids = 2 * num_splitters + 1;
+    size_t num_blocks = threads * PARALLEL_SORT_TASKS_PER_THREAD;
+    size_t num_tasks = num_blocks > num_ids ? num_blocks : num_ids;
+    return num_splitters * element_size + arr_len * element_size + arr_len +
+           num_blocks * num_ids * sizeof(size_t) + (num_ids + 1) * sizeof(size_t) +
+           num_tasks * sizeof(samplesort_task_t) + num_buckets * SAMPLESORT_OVERSAMPLING * element_size +
+           num_ids * element_size;
+}
+
+static sort_result_t parallel_samplesort(thread_pool_t *pool, void *arr, size_t arr_len, size_t element_size,
+                                         compare_func_t cmp, sort_stats_t *stats)
+{
+    size_t threads = thread_pool_size(pool);
+    size_t num_buckets = samplesort_buckets(threads, arr_len);
+    if (num_buckets < 2)
+    {
+        return generic_quick_sort_ex(arr, arr_len, element_size, cmp, stats);
+    }
+
+    samplesort_t s;
+    thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+    memset(&s, 0, sizeof(s));
+    s.arr = (char *)arr;
+    s.arr_len = arr_len;
+    s.element_size = element_size;
+    s.cmp = cmp;
+    s.num_splitters = num_buckets - 1;
+    s.num_ids = 2 * s.num_splitters + 1;
+    s.num_blocks = threads * PARALLEL_SORT_TASKS_PER_THREAD;
+    s.stats = stats;
+    size_t num_tasks = s.num_blocks > s.num_ids ? s.num_blocks : s.num_ids;
+
+    char *splitters = (char *)scratch_alloc(s.num_splitters * element_size);
+    s.buffer = (char *)scratch_alloc(arr_len * element_size);
+    s.bucket_ids = (unsigned char *)scratch_alloc(arr_len);
+    s.counts = (size_t *)scratch_calloc(s.num_blocks * s.num_ids, sizeof(size_t));
+    s.bucket_starts = (size_t *)scratch_alloc((s.num_ids + 1) * sizeof(size_t));
+    // 任务数组在三个阶段中复用，calloc 使各任务的局部统计从 0 开始累加
+    samplesort_task_t *tasks = (samplesort_task_t *)scratch_calloc(num_tasks, sizeof(samplesort_task_t));
+    size_t scratch_size = s.num_splitters * element_size + arr_len * element_size + arr_len +
+                          s.num_blocks * s.num_ids * sizeof(size_t) + (s.num_ids + 1) * sizeof(size_t) +
+                          num_tasks * sizeof(samplesort_task_t);
+    sort_result_t res = SORT_ERROR_ALLOCATION_FAILED;
+    if (NULL == splitters || NULL == s.buffer || NULL == s.bucket_ids ||
+        NULL == s.counts || NULL == s.bucket_starts || NULL == tasks)
+    {
+        goto cleanup;
+    }
+    INCRE_MEMORY_USED(stats, scratch_size);
+    res = choose_splitters(&s, num_buckets, splitters);
+    if (res != SORT_SUCCESS)
+    {
+        goto cleanup;
+    }
+    s.splitters = splitters;
+
+    for (size_t i = 0; i < s.num_blocks; i++)
+    {
+        tasks[i].sort = &s;
+        tasks[i].index = i;
+        submit_or_run(pool, &group, classify_block_task, &tasks[i]);
+    }
+    thread_pool_wait(pool, &group);
+
+    // 按 (桶, 块) 顺序做前缀和，把计数转换为各块在每个桶中的写入位置
+    size_t sum = 0;
+    for (size_t id = 0; id < s.num_ids; id++)
+    {
+        s.bucket_starts[id] = sum;
+        for (size_t i = 0; i < s.num_blocks; i++)
+        {
+            size_t count = s.counts[i * s.num_ids + id];
+            s.counts[i * s.num_ids + id] = sum;
+            sum += count;
+        }
+    }
+    s.bucket_starts[s.num_ids] = sum;
+
+    for (size_t i = 0; i < s.num_blocks; i++)
+    {
+        submit_or_run(pool, &group, scatter_block_task, &tasks[i]);
+    }
+    thread_pool_wait(pool, &group);
+
+    for (size_t id = 0; id < s.num_ids; id++)
+    {
+        tasks[id].sort = &s;
+        tasks[id].index = id;
+        if (s.bucket_starts[id + 1] > s.bucket_starts[id])
+        {
+            submit_or_run(pool, &group, sort_bucket_task, &tasks[id]);
+        }
+    }
+    thread_pool_wait(pool, &group);
+
+    for (size_t i = 0; i < num_tasks; i++)
+    {
+        accumulate_stats(stats, &tasks[i].stats);
+    }
+    DECRE_MEMORY_USED(stats, scratch_size);
+    (void)scratch_size;
+
+cleanup:
+    scratch_free(splitters);
+    scratch_free(s.buffer);
+    scratch_free(s.bucket_ids);
+    scratch_free(s.counts);
+    scratch_free(s.bucket_starts);
+    scratch_free(tasks);
+    return res;
+}
+
+sort_result_t generic_parallel_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_parallel_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_parallel_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0 && arr_len > 1)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    thread_pool_t *pool = usable_pool(arr_len);
+    if (NULL == pool)
+    {
+        return generic_quick_sort_ex(arr, arr_len, element_size, cmp, stats);
+    }
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    sort_result_t res = parallel_samplesort(pool, arr, arr_len, element_size, cmp, stats);
+    if (res == SORT_ERROR_ALLOCATION_FAILED)
+    {
+        // 辅助空间不足时退化为原地的顺序排序
+        return generic_quick_sort_ex(arr, arr_len, element_size, cmp, stats);
+    }
+    STOP_TIMMING(stats);
+    return res;
+}
+
+/* ============================================================================
+ * 并行归并排序
+ * ============================================================================
+ */
+
+typedef struct
+{
+    char *arr;
+    char *buffer;
+    size_t element_size;
+    compare_func_t *cmp;
+    size_t begin;
+    size_t end;
+    sort_stats_t *stats; /**< 指向 local 或为 NULL */
+    sort_stats_t local;
+} chunk_task_t;
+
+typedef struct
+{
+    const char *src;
+    char *dst;
+    size_t element_size;
+    compare_func_t *cmp;
+    // 归并 src[left, mid) 与 src[mid, right)，本段负责输出的第 [out_begin, out_end) 个元素
+    size_t left;
+    size_t mid;
+    size_t right;
+    size_t out_begin;
+    size_t out_end;
+    sort_stats_t *stats; /**< 指向 local 或为 NULL */
+    sort_stats_t local;
+} merge_segment_task_t;
+
+static void sort_chunk_task(void *arg)
+{
+    chunk_task_t *task = (chunk_task_t *)arg;
+    size_t es = task->element_size;
+    sort_stats_t local;
+    generic_merge_sort_with_buffer_ex(INDEX_OF(task->arr, es, task->begin), task->end - task->begin, es,
+                                      task->cmp, INDEX_OF(task->buffer, es, task->begin),
+                                      NULL != task->stats ? &local : NULL);
+    accumulate_stats(task->stats, &local);
+}
+
+static void copy_chunk_task(void *arg)
+{
+    chunk_task_t *task = (chunk_task_t *)arg;
+    size_t es = task->element_size;
+    memcpy(INDEX_OF(task->arr, es, task->begin), INDEX_OF(task->buffer, es, task->begin),
+           (task->end - task->begin) * es);
+    INCRE_MOVEMENTS_BY(task->stats, task->end - task->begin);
+}
+
+/**
+ * merge path：归并输出的前 diag 个元素中来自左侧序列的个数。
+ * 相等时左侧优先，保证稳定。
+ */
+static size_t co_rank(const char *a, size_t a_len, const char *b, size_t b_len,
+                      size_t diag, size_t es, compare_func_t *cmp, sort_stats_t *stats)
+{
+    size_t lo = diag > b_len ? diag - b_len : 0;
+    size_t hi = diag < a_len ? diag : a_len;
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = diag - i;
+        if (j > 0 && COUNTED_CMP(stats, cmp, INDEX_OF(a, es, i), INDEX_OF(b, es, j - 1)) <= 0)
+        {
+            lo = i + 1;
+        }
+        else
+        {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+static void merge_segment_task(void *arg)
+{
+    merge_segment_task_t *task = (merge_segment_task_t *)arg;
+    size_t es = task->element_size;
+    compare_func_t *cmp = task->cmp;
+    const char *a = INDEX_OF(task->src, es, task->left);
+    const char *b = INDEX_OF(task->src, es, task->mid);
+    size_t a_len = task->mid - task->left;
+    size_t b_len = task->right - task->mid;
+
+    sort_stats_t *stats = task->stats;
+    size_t i = co_rank(a, a_len, b, b_len, task->out_begin, es, cmp, stats);
+    size_t j = task->out_begin - i;
+    size_t i_end = co_rank(a, a_len, b, b_len, task->out_end, es, cmp, stats);
+    size_t j_end = task->out_end - i_end;
+    char *out = INDEX_OF(task->dst, es, task->left + task->out_begin);
+
+    while (i < i_end && j < j_end)
+    {
+        if (COUNTED_CMP(stats, cmp, INDEX_OF(a, es, i), INDEX_OF(b, es, j)) <= 0)
+        {
+            memcpy(out, INDEX_OF(a, es, i), es);
+            i++;
+        }
+        else
+        {
+            memcpy(out, INDEX_OF(b, es, j), es);
+            j++;
+        }
+        out += es;
+    }
+    memcpy(out, INDEX_OF(a, es, i), (i_end - i) * es);
+    out += (i_end - i) * es;
+    memcpy(out, INDEX_OF(b, es, j), (j_end - j) * es);
+    INCRE_MOVEMENTS_BY(stats, task->out_end - task->out_begin);
+}
+
+/** 初始块数：不少于线程数的 2 的幂，便于逐层两两归并 */
+static size_t merge_chunks(size_t threads)
+{
+    size_t num_chunks = 2;
+    while (num_chunks < threads)
+    {
+        num_chunks *= 2;
+    }
+    return num_chunks;
+}
+
+/** 并行归并排序的辅助空间上界，含各块排序大记录时临时存放的一个元素 */
+static size_t merge_sort_scratch_bytes(size_t threads, size_t arr_len, size_t element_size)
+{
+    size_t num_chunks = merge_chunks(threads);
+    size_t max_segments = threads * PARALLEL_SORT_TASKS_PER_THREAD + num_chunks;
+    return arr_len * element_size + num_chunks * sizeof(chunk_task_t) +
+           max_segments * sizeof(merge_segment_task_t) + num_chunks * element_size;
+}
+
+static sort_result_t parallel_merge_sort(thread_pool_t *pool, void *arr, size_t arr_len, size_t element_size,
+                                         compare_func_t cmp, sort_stats_t *stats)
+{
+    size_t threads = thread_pool_size(pool);
+    size_t num_chunks = merge_chunks(threads);
+
+    char *buffer = (char *)scratch_alloc(arr_len * element_size);
+    chunk_task_t *chunks = (chunk_task_t *)scratch_alloc(num_chunks * sizeof(chunk_task_t));
+    // 每层的分段数不超过 threads * PARALLEL_SORT_TASKS_PER_THREAD + num_chunks
+    size_t max_segments = threads * PARALLEL_SORT_TASKS_PER_THREAD + num_chunks;
+    merge_segment_task_t *segments = (merge_segment_task_t *)scratch_alloc(max_segments * sizeof(merge_segment_task_t));
+    if (NULL == buffer || NULL == chunks || NULL == segments)
+    {
+        scratch_free(buffer);
+        scratch_free(chunks);
+        scratch_free(segments);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    size_t scratch_size = arr_len * element_size + num_chunks * sizeof(chunk_task_t) +
+                          max_segments * sizeof(merge_segment_task_t);
+    INCRE_MEMORY_USED(stats, scratch_size);
+
+    thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        chunks[c].arr = (char *)arr;
+        chunks[c].buffer = buffer;
+        chunks[c].element_size = element_size;
+        chunks[c].cmp = cmp;
+        chunks[c].begin = c * arr_len / num_chunks;
+        chunks[c].end = (c + 1) * arr_len / num_chunks;
+        memset(&chunks[c].local, 0, sizeof(sort_stats_t));
+        chunks[c].stats = NULL != stats ? &chunks[c].local : NULL;
+        submit_or_run(pool, &group, sort_chunk_task, &chunks[c]);
+    }
+    thread_pool_wait(pool, &group);
+
+    char *src = (char *)arr;
+    char *dst = buffer;
+    for (size_t width = 1; width < num_chunks; width *= 2)
+    {
+        size_t pairs = num_chunks / (2 * width);
+        size_t segments_per_pair = (threads * PARALLEL_SORT_TASKS_PER_THREAD + pairs - 1) / pairs;
+        size_t num_segments = 0;
+        for (size_t p = 0; p < pairs; p++)
+        {
+            size_t left = chunks[2 * p * width].begin;
+            size_t mid = chunks[(2 * p + 1) * width].begin;
+            size_t right = chunks[(2 * p + 2) * width - 1].end;
+            size_t total = right - left;
+            size_t parts = segments_per_pair;
+            if (parts > total / PARALLEL_MERGE_MIN_SEGMENT)
+            {
+                parts = total / PARALLEL_MERGE_MIN_SEGMENT;
+            }
+            if (parts == 0)
+            {
+                parts = 1;
+            }
+            for (size_t k = 0; k < parts; k++)
+            {
+                merge_segment_task_t *seg = &segments[num_segments++];
+                seg->src = src;
+                seg->dst = dst;
+                seg->element_size = element_size;
+                seg->cmp = cmp;
+                seg->left = left;
+                seg->mid = mid;
+                seg->right = right;
+                seg->out_begin = k * total / parts;
+                seg->out_end = (k + 1) * total / parts;
+                memset(&seg->local, 0, sizeof(sort_stats_t));
+                seg->stats = NULL != stats ? &seg->local : NULL;
+                submit_or_run(pool, &group, merge_segment_task, seg);
+            }
+        }
+        thread_pool_wait(pool, &group);
+        for (size_t k = 0; k < num_segments; k++)
+        {
+            accumulate_stats(stats, &segments[k].local);
+        }
+        char *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != (char *)arr)
+    {
+        for (size_t c = 0; c < num_chunks; c++)
+        {
+            submit_or_run(pool, &group, copy_chunk_task, &chunks[c]);
+        }
+        thread_pool_wait(pool, &group);
+    }
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        accumulate_stats(stats, &chunks[c].local);
+    }
+
+    scratch_free(buffer);
+    scratch_free(chunks);
+    scratch_free(segments);
+    DECRE_MEMORY_USED(stats, scratch_size);
+    (void)scratch_size;
+    return SORT_SUCCESS;
+}
+
+sort_result_t generic_parallel_stable_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_parallel_stable_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_parallel_stable_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0 && arr_len > 1)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    thread_pool_t *pool = usable_pool(arr_len);
+    if (NULL == pool)
+    {
+        return generic_merge_sort_ex(arr, arr_len, element_size, cmp, stats);
+    }
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    sort_result_t res = parallel_merge_sort(pool, arr, arr_len, element_size, cmp, stats);
+    STOP_TIMMING(stats);
+    return res;
+}
+
+size_t parallel_sort_scratch_bytes(size_t arr_len, size_t element_size, int stable)
+{
+    thread_pool_t *pool = usable_pool(arr_len);
+    if (NULL == pool)
+    {
+        // 顺序的归并排序需要 n 个元素，快速排序原地进行，大记录时另需一个元素
+        return stable ? arr_len * element_size + element_size : element_size;
+    }
+    size_t threads = thread_pool_size(pool);
+    return stable ? merge_sort_scratch_bytes(threads, arr_len, element_size)
+                  : samplesort_scratch_bytes(threads, arr_len, element_size);
+}
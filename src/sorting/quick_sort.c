@@ -0,0 +1,408 @@
+#include <stdlib.h>
+#include "sorting/quick_sort.h"
+#include "sorting/heap_sort.h"
+#include "sorting/insertion_sort.h"
+#include "util/scratch_arena.h"
+
+// 元素不超过该大小时暂存空间放在栈上
+#define QUICK_SORT_STACK_TMP_SIZE 64
+
+// partial_insertion_sort 允许的最大移动元素个数
+#define PARTIAL_INSERTION_SORT_LIMIT 8
+
+typedef struct
+{
+    size_t element_size;
+    compare_func_t *cmp;
+    sized_swap_func_t *swap;
+    void *tmp;
+    sort_stats_t *stats;
+} quick_sort_ctx_t;
+
+#define QS_CMP(ctx, a, b) COUNTED_CMP((ctx)->stats, (ctx)->cmp, (a), (b))
+
+#define QS_SWAP(ctx, a, b)                               \
+    do                                                   \
+    {                                                    \
+        (ctx)->swap((a), (b), (ctx)->element_size);      \
+        INCRE_MOVEMENTS_BY((ctx)->stats, 2);             \
+    } while (0)
+
+static inline void sort2(const quick_sort_ctx_t *ctx, char *a, char *b)
+{
+    if (QS_CMP(ctx, b, a) < 0)
+    {
+        QS_SWAP(ctx, a, b);
+    }
+}
+
+static inline void sort3(const quick_sort_ctx_t *ctx, char *a, char *b, char *c)
+{
+    sort2(ctx, a, b);
+    sort2(ctx, b, c);
+    sort2(ctx, a, b);
+}
+
+static inline size_t log2_floor(size_t n)
+{
+    size_t log = 0;
+    while (n >>= 1)
+    {
+        log++;
+    }
+    return log;
+}
+
+/**
+ * 插入排序，但移动的元素总数超过 PARTIAL_INSERTION_SORT_LIMIT 时放弃。
+ * 返回 1 表示区间已完全有序。
+ */
+static int partial_insertion_sort(const quick_sort_ctx_t *ctx, char *begin, char *end)
+{
+    size_t es = ctx->element_size;
+    size_t moved = 0;
+    if (begin == end)
+    {
+        return 1;
+    }
+    for (char *cur = begin + es; cur < end; cur += es)
+    {
+        if (QS_CMP(ctx, cur - es, cur) <= 0)
+        {
+            continue;
+        }
+        memcpy(ctx->tmp, cur, es);
+        char *pos = cur - es;
+        while (pos > begin && QS_CMP(ctx, pos - es, ctx->tmp) > 0)
+        {
+            pos -= es;
+        }
+        memmove(pos + es, pos, (size_t)(cur - pos));
+        memcpy(pos, ctx->tmp, es);
+        moved += (size_t)(cur - pos) / es;
+        INCRE_MOVEMENTS_BY(ctx->stats, (size_t)(cur - pos) / es + 2);
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT)
+        {
+            return cur + es == end;
+        }
+    }
+    return 1;
+}
+
+/**
+ * 以 *begin 为枢轴划分 [begin, end)，小于枢轴的放左边，大于等于的放右边。
+ * 枢轴在划分过程中一直留在 begin，最后与分界处交换。
+ * already_partitioned 表示划分过程中没有发生任何交换。
+ */
+static char *partition_right(const quick_sort_ctx_t *ctx, char *begin, char *end, int *already_partitioned)
+{
+    size_t es = ctx->element_size;
+    const char *pivot = begin;
+    char *first = begin;
+    char *last = end;
+
+    // 三数取中保证右侧存在不小于枢轴的元素，这里不需要边界检查
+    do
+    {
+        first += es;
+    } while (QS_CMP(ctx, first, pivot) < 0);
+
+    if (first - es == begin)
+    {
+        while (first < last)
+        {
+            last -= es;
+            if (QS_CMP(ctx, last, pivot) < 0)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        do
+        {
+            last -= es;
+        } while (QS_CMP(ctx, last, pivot) >= 0);
+    }
+
+    *already_partitioned = first >= last;
+
+    while (first < last)
+    {
+        QS_SWAP(ctx, first, last);
+        do
+        {
+            first += es;
+        } while (QS_CMP(ctx, first, pivot) < 0);
+        do
+        {
+            last -= es;
+        } while (QS_CMP(ctx, last, pivot) >= 0);
+    }
+
+    char *pivot_pos = first - es;
+    if (pivot_pos != begin)
+    {
+        QS_SWAP(ctx, begin, pivot_pos);
+    }
+    return pivot_pos;
+}
+
+/**
+ * 与 partition_right 相反，等于枢轴的元素放在左边。
+ * 仅在枢轴等于左侧前驱时使用，此时左边这一段全部等于枢轴，无需再排序。
+ */
+static char *partition_left(const quick_sort_ctx_t *ctx, char *begin, char *end)
+{
+    size_t es = ctx->element_size;
+    const char *pivot = begin;
+    char *first = begin;
+    char *last = end;
+
+    do
+    {
+        last -= es;
+    } while (QS_CMP(ctx, pivot, last) < 0);
+
+    if (last + es == end)
+    {
+        while (first < last)
+        {
+            first += es;
+            if (QS_CMP(ctx, pivot, first) < 0)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        do
+        {
+            first += es;
+        } while (QS_CMP(ctx, pivot, first) >= 0);
+    }
+
+    while (first < last)
+    {
+        QS_SWAP(ctx, first, last);
+        do
+        {
+            last -= es;
+        } while (QS_CMP(ctx, pivot, last) < 0);
+        do
+        {
+            first += es;
+        } while (QS_CMP(ctx, pivot, first) >= 0);
+    }
+
+    if (last != begin)
+    {
+        QS_SWAP(ctx, begin, last);
+    }
+    return last;
+}
+
+/**
+ * 划分极不平衡时，交换几处元素打破输入中的模式。
+ */
+static void break_patterns(const quick_sort_ctx_t *ctx, char *begin, char *end, size_t size)
+{
+    size_t es = ctx->element_size;
+    if (size < QUICK_SORT_INSERTION_THRESHOLD)
+    {
+        return;
+    }
+    size_t q = size / 4;
+    QS_SWAP(ctx, begin, begin + q * es);
+    QS_SWAP(ctx, end - es, end - q * es);
+    if (size > QUICK_SORT_NINTHER_THRESHOLD)
+    {
+        QS_SWAP(ctx, begin + es, begin + (q + 1) * es);
+        QS_SWAP(ctx, begin + 2 * es, begin + (q + 2) * es);
+        QS_SWAP(ctx, end - 2 * es, end - (q + 1) * es);
+        QS_SWAP(ctx, end - 3 * es, end - (q + 2) * es);
+    }
+}
+
+/**
+ * 堆排序兜底。generic_heap_sort_ex 会重置统计，先记到局部变量再累加。
+ */
+static void heap_sort_fallback(const quick_sort_ctx_t *ctx, char *begin, size_t size)
+{
+    if (NULL == ctx->stats)
+    {
+        generic_heap_sort(begin, size, ctx->element_size, ctx->cmp);
+        return;
+    }
+    sort_stats_t local;
+    generic_heap_sort_ex(begin, size, ctx->element_size, ctx->cmp, &local);
+    sort_stats_merge(ctx->stats, &local);
+}
+
+static void pdq_sort_loop(const quick_sort_ctx_t *ctx, char *begin, char *end, size_t bad_allowed, int leftmost)
+{
+    size_t es = ctx->element_size;
+    compare_func_t *cmp = ctx->cmp;
+
+    for (;;)
+    {
+        size_t size = (size_t)(end - begin) / es;
+        if (size < QUICK_SORT_INSERTION_THRESHOLD)
+        {
+            if (size <= SORTING_NETWORK_MAX)
+            {
+                generic_network_sort_ex(begin, size, es, cmp, ctx->stats);
+            }
+            else
+            {
+                generic_insertion_sort_with_buffer_ex(begin, size, es, cmp, ctx->tmp, ctx->stats);
+            }
+            return;
+        }
+
+        // 选取枢轴并放到 begin
+        size_t half = size / 2;
+        char *mid = begin + half * es;
+        if (size > QUICK_SORT_NINTHER_THRESHOLD)
+        {
+            sort3(ctx, begin, mid, end - es);
+            sort3(ctx, begin + es, mid - es, end - 2 * es);
+            sort3(ctx, begin + 2 * es, mid + es, end - 3 * es);
+            sort3(ctx, mid - es, mid, mid + es);
+            QS_SWAP(ctx, begin, mid);
+        }
+        else
+        {
+            sort3(ctx, mid, begin, end - es);
+        }
+
+        // 枢轴与前驱相等说明左侧子区间已处理过的值都 <= 枢轴，
+        // 等于枢轴的元素可以全部归到左边不再处理
+        if (!leftmost && QS_CMP(ctx, begin - es, begin) >= 0)
+        {
+            begin = partition_left(ctx, begin, end) + es;
+            continue;
+        }
+
+        int already_partitioned = 0;
+        char *pivot_pos = partition_right(ctx, begin, end, &already_partitioned);
+        size_t l_size = (size_t)(pivot_pos - begin) / es;
+        size_t r_size = (size_t)(end - pivot_pos) / es - 1;
+        int highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced)
+        {
+            if (--bad_allowed == 0)
+            {
+                heap_sort_fallback(ctx, begin, size);
+                return;
+            }
+            break_patterns(ctx, begin, pivot_pos, l_size);
+            break_patterns(ctx, pivot_pos + es, end, r_size);
+        }
+        else if (already_partitioned &&
+                 partial_insertion_sort(ctx, begin, pivot_pos) &&
+                 partial_insertion_sort(ctx, pivot_pos + es, end))
+        {
+            return;
+        }
+
+        // 递归处理较小的一侧，较大的一侧继续循环，栈深度为 O(log n)
+        if (l_size < r_size)
+        {
+            pdq_sort_loop(ctx, begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + es;
+            leftmost = 0;
+        }
+        else
+        {
+            pdq_sort_loop(ctx, pivot_pos + es, end, bad_allowed, 0);
+            end = pivot_pos;
+        }
+    }
+}
+
+sort_result_t generic_quick_sort_with_buffer_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    void *tmp,
+    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp || NULL == tmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    quick_sort_ctx_t ctx = {element_size, cmp, select_swap_func(element_size), tmp, stats};
+    char *begin = (char *)arr;
+    pdq_sort_loop(&ctx, begin, begin + arr_len * element_size, log2_floor(arr_len), 1);
+    return SORT_SUCCESS;
+}
+
+sort_result_t generic_quick_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_quick_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_quick_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+
+    char stack_tmp[QUICK_SORT_STACK_TMP_SIZE];
+    void *tmp = stack_tmp;
+    if (element_size > QUICK_SORT_STACK_TMP_SIZE)
+    {
+        tmp = scratch_alloc(element_size);
+        if (NULL == tmp)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
+    }
+
+    generic_quick_sort_with_buffer_ex(arr, arr_len, element_size, cmp, tmp, stats);
+
+    if (tmp != stack_tmp)
+    {
+        scratch_free(tmp);
+        DECRE_MEMORY_USED(stats, element_size);
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#ifndef RADIX_KEY_H
+#define RADIX_KEY_H
+#include <stdint.h>
+#include "sorting/radix_sort.h"
+
+// 基数排序键的保序编码，radix_sort.c 与 sort_by_key.c 共用，不对外公开。
+// 有符号整数翻转符号位；IEEE 浮点数负数翻转全部位、非负数只翻转符号位，
+// 编码后按无符号整数比较即为原来的顺序。
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+
+static inline size_t key_width(radix_key_type_t type)
+{
+    switch (type)
+    {
+    case RADIX_KEY_UINT32:
+    case RADIX_KEY_INT32:
+    case RADIX_KEY_FLOAT:
+        return sizeof(uint32_t);
+    case RADIX_KEY_UINT64:
+    case RADIX_KEY_INT64:
+    case RADIX_KEY_DOUBLE:
+        return sizeof(uint64_t);
+    default:
+        return 0;
+    }
+}
+
+static inline uint32_t encode_u32(uint32_t bits, radix_key_type_t type)
+{
+    if (type == RADIX_KEY_INT32)
+    {
+        return bits ^ 0x80000000u;
+    }
+    if (type == RADIX_KEY_FLOAT)
+    {
+        // 负数翻转全部位，非负数只翻转符号位
+        return bits ^ ((uint32_t)(-(int32_t)(bits >> 31)) | 0x80000000u);
+    }
+    return bits;
+}
+
+static inline uint32_t decode_u32(uint32_t bits, radix_key_type_t type)
+{
+    if (type == RADIX_KEY_INT32)
+    {
+        return bits ^ 0x80000000u;
+    }
+    if (type == RADIX_KEY_FLOAT)
+    {
+        return bits ^ (((bits >> 31) - 1u) | 0x80000000u);
+    }
+    return bits;
+}
+
+static inline uint64_t encode_u64(uint64_t bits, radix_key_type_t type)
+{
+    if (type == RADIX_KEY_INT64)
+    {
+        return bits ^ 0x8000000000000000ull;
+    }
+    if (type == RADIX_KEY_DOUBLE)
+    {
+        return bits ^ ((uint64_t)(-(int64_t)(bits >> 63)) | 0x8000000000000000ull);
+    }
+    return bits;
+}
+
+static inline uint64_t decode_u64(uint64_t bits, radix_key_type_t type)
+{
+    if (type == RADIX_KEY_INT64)
+    {
+        return bits ^ 0x8000000000000000ull;
+    }
+    if (type == RADIX_KEY_DOUBLE)
+    {
+        return bits ^ (((bits >> 63) - 1u) | 0x8000000000000000ull);
+    }
+    return bits;
+}
+
+#endif // RADIX_KEY_H
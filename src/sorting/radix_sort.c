@@ -0,0 +1,526 @@
+#include <stdlib.h>
+#include "sorting/radix_sort.h"
+#include "sorting/sorting_network.h"
+#include "util/scratch_arena.h"
+#include "radix_key.h"
+
+// American flag 排序中小于该长度的桶改用排序网络或插入排序
+#define RADIX_INPLACE_INSERTION_THRESHOLD 32
+
+// 插入排序暂存空间放在栈上的最大元素大小
+#define RADIX_STACK_TMP_SIZE 64
+
+/* ============================================================================
+ * 键的读取
+ * ============================================================================
+ */
+
+/**
+ * 读出记录中的键并编码为保序的无符号整数，32 位键零扩展为 64 位。
+ */
+static inline uint64_t load_key(const char *elem, size_t key_offset, radix_key_type_t type)
+{
+    if (key_width(type) == sizeof(uint32_t))
+    {
+        uint32_t bits;
+        memcpy(&bits, elem + key_offset, sizeof(bits));
+        return encode_u32(bits, type);
+    }
+    uint64_t bits;
+    memcpy(&bits, elem + key_offset, sizeof(bits));
+    return encode_u64(bits, type);
+}
+
+static inline int is_trivial_digit(const size_t *hist, size_t digit_of_any, size_t arr_len)
+{
+    return hist[digit_of_any] == arr_len;
+}
+
+static inline void exclusive_prefix_sum(const size_t *hist, size_t *offsets)
+{
+    size_t sum = 0;
+    for (size_t b = 0; b < RADIX_BUCKETS; b++)
+    {
+        offsets[b] = sum;
+        sum += hist[b];
+    }
+}
+
+/* ============================================================================
+ * LSD：纯键数组
+ * ============================================================================
+ */
+
+static size_t lsd_sort_u32(uint32_t *arr, size_t arr_len, uint32_t *buffer, radix_key_type_t type)
+{
+    size_t passes = 0;
+    size_t hist[sizeof(uint32_t)][RADIX_BUCKETS] = {{0}};
+    size_t offsets[RADIX_BUCKETS];
+
+    // 编码和所有数字位的直方图在同一次遍历中完成
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        uint32_t key = encode_u32(arr[i], type);
+        arr[i] = key;
+        hist[0][key & RADIX_MASK]++;
+        hist[1][(key >> 8) & RADIX_MASK]++;
+        hist[2][(key >> 16) & RADIX_MASK]++;
+        hist[3][key >> 24]++;
+    }
+
+    uint32_t *src = arr;
+    uint32_t *dst = buffer;
+    for (size_t d = 0; d < sizeof(uint32_t); d++)
+    {
+        unsigned shift = (unsigned)(d * RADIX_BITS);
+        if (is_trivial_digit(hist[d], (src[0] >> shift) & RADIX_MASK, arr_len))
+        {
+            continue;
+        }
+        exclusive_prefix_sum(hist[d], offsets);
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            uint32_t key = src[i];
+            dst[offsets[(key >> shift) & RADIX_MASK]++] = key;
+        }
+        uint32_t *t = src;
+        src = dst;
+        dst = t;
+        passes++;
+    }
+
+    // 解码，结果在辅助空间时顺带拷回
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        arr[i] = decode_u32(src[i], type);
+    }
+    return passes;
+}
+
+static size_t lsd_sort_u64(uint64_t *arr, size_t arr_len, uint64_t *buffer, radix_key_type_t type)
+{
+    size_t passes = 0;
+    size_t hist[sizeof(uint64_t)][RADIX_BUCKETS] = {{0}};
+    size_t offsets[RADIX_BUCKETS];
+
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        uint64_t key = encode_u64(arr[i], type);
+        arr[i] = key;
+        for (size_t d = 0; d < sizeof(uint64_t); d++)
+        {
+            hist[d][(key >> (d * RADIX_BITS)) & RADIX_MASK]++;
+        }
+    }
+
+    uint64_t *src = arr;
+    uint64_t *dst = buffer;
+    for (size_t d = 0; d < sizeof(uint64_t); d++)
+    {
+        unsigned shift = (unsigned)(d * RADIX_BITS);
+        if (is_trivial_digit(hist[d], (src[0] >> shift) & RADIX_MASK, arr_len))
+        {
+            continue;
+        }
+        exclusive_prefix_sum(hist[d], offsets);
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            uint64_t key = src[i];
+            dst[offsets[(key >> shift) & RADIX_MASK]++] = key;
+        }
+        uint64_t *t = src;
+        src = dst;
+        dst = t;
+        passes++;
+    }
+
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        arr[i] = decode_u64(src[i], type);
+    }
+    return passes;
+}
+
+/* ============================================================================
+ * LSD：带键的记录
+ * ============================================================================
+ */
+
+static size_t lsd_sort_records(
+    char *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t type,
+    char *buffer)
+{
+    size_t passes = 0;
+    size_t width = key_width(type);
+    size_t hist[sizeof(uint64_t)][RADIX_BUCKETS] = {{0}};
+    size_t offsets[RADIX_BUCKETS];
+
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        uint64_t key = load_key(INDEX_OF(arr, element_size, i), key_offset, type);
+        for (size_t d = 0; d < width; d++)
+        {
+            hist[d][(key >> (d * RADIX_BITS)) & RADIX_MASK]++;
+        }
+    }
+
+    char *src = arr;
+    char *dst = buffer;
+    for (size_t d = 0; d < width; d++)
+    {
+        unsigned shift = (unsigned)(d * RADIX_BITS);
+        if (is_trivial_digit(hist[d], (load_key(src, key_offset, type) >> shift) & RADIX_MASK, arr_len))
+        {
+            continue;
+        }
+        exclusive_prefix_sum(hist[d], offsets);
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            const char *elem = INDEX_OF(src, element_size, i);
+            size_t b = (load_key(elem, key_offset, type) >> shift) & RADIX_MASK;
+            memcpy(INDEX_OF(dst, element_size, offsets[b]++), elem, element_size);
+        }
+        char *t = src;
+        src = dst;
+        dst = t;
+        passes++;
+    }
+
+    if (src != arr)
+    {
+        memcpy(arr, src, arr_len * element_size);
+    }
+    return passes;
+}
+
+static inline sort_result_t check_args(
+    const void *arr,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type)
+{
+    if (NULL == arr)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    size_t width = key_width(key_type);
+    if (width == 0 || element_size < width || key_offset > element_size - width)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    return SORT_SUCCESS;
+}
+
+/**
+ * 按记录是否就是键本身选择实现，返回分发的轮数(不含跳过的数字位)
+ */
+static size_t lsd_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    void *buffer)
+{
+    if (element_size == key_width(key_type))
+    {
+        if (element_size == sizeof(uint32_t))
+        {
+            return lsd_sort_u32((uint32_t *)arr, arr_len, (uint32_t *)buffer, key_type);
+        }
+        return lsd_sort_u64((uint64_t *)arr, arr_len, (uint64_t *)buffer, key_type);
+    }
+    return lsd_sort_records((char *)arr, arr_len, element_size, key_offset, key_type, (char *)buffer);
+}
+
+sort_result_t generic_radix_sort_with_buffer(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    void *buffer)
+{
+    sort_result_t res = check_args(arr, element_size, key_offset, key_type);
+    if (res != SORT_SUCCESS)
+    {
+        return res;
+    }
+    if (NULL == buffer)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    lsd_sort(arr, arr_len, element_size, key_offset, key_type, buffer);
+    return SORT_SUCCESS;
+}
+
+sort_result_t generic_radix_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type)
+{
+    return generic_radix_sort_ex(arr, arr_len, element_size, key_offset, key_type, NULL);
+}
+
+sort_result_t generic_radix_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    sort_result_t res = check_args(arr, element_size, key_offset, key_type);
+    if (res != SORT_SUCCESS || arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return res;
+    }
+
+    void *buffer = scratch_alloc(arr_len * element_size);
+    if (NULL == buffer)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, arr_len * element_size);
+    size_t passes = lsd_sort(arr, arr_len, element_size, key_offset, key_type, buffer);
+    // 每轮分发写一遍全部元素，奇数轮后结果在辅助空间，需要再拷回一次
+    INCRE_MOVEMENTS_BY(stats, (passes + (passes & 1)) * arr_len);
+    (void)passes;
+    scratch_free(buffer);
+    DECRE_MEMORY_USED(stats, arr_len * element_size);
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
+
+sort_result_t radix_sort_uint32(uint32_t *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(uint32_t), 0, RADIX_KEY_UINT32);
+}
+
+sort_result_t radix_sort_int32(int32_t *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(int32_t), 0, RADIX_KEY_INT32);
+}
+
+sort_result_t radix_sort_float(float *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(float), 0, RADIX_KEY_FLOAT);
+}
+
+sort_result_t radix_sort_uint64(uint64_t *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(uint64_t), 0, RADIX_KEY_UINT64);
+}
+
+sort_result_t radix_sort_int64(int64_t *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(int64_t), 0, RADIX_KEY_INT64);
+}
+
+sort_result_t radix_sort_double(double *arr, size_t arr_len)
+{
+    return generic_radix_sort(arr, arr_len, sizeof(double), 0, RADIX_KEY_DOUBLE);
+}
+
+/* ============================================================================
+ * MSD：American flag 原地排序
+ * ============================================================================
+ */
+
+typedef struct
+{
+    size_t element_size;
+    size_t key_offset;
+    radix_key_type_t key_type;
+    sized_swap_func_t *swap;
+    void *tmp;
+    sort_stats_t *stats;
+} radix_inplace_ctx_t;
+
+static void insertion_sort_by_key(const radix_inplace_ctx_t *ctx, char *arr, size_t arr_len)
+{
+    size_t es = ctx->element_size;
+    for (size_t i = 1; i < arr_len; i++)
+    {
+        char *cur = INDEX_OF(arr, es, i);
+        uint64_t key = load_key(cur, ctx->key_offset, ctx->key_type);
+        if (load_key(cur - es, ctx->key_offset, ctx->key_type) <= key)
+        {
+            continue;
+        }
+        memcpy(ctx->tmp, cur, es);
+        size_t j = i - 1;
+        while (j > 0 && load_key(INDEX_OF(arr, es, j - 1), ctx->key_offset, ctx->key_type) > key)
+        {
+            j--;
+        }
+        memmove(INDEX_OF(arr, es, j + 1), INDEX_OF(arr, es, j), (i - j) * es);
+        memcpy(INDEX_OF(arr, es, j), ctx->tmp, es);
+        INCRE_MOVEMENTS_BY(ctx->stats, i - j + 1);
+    }
+}
+
+/**
+ * 小桶收尾：记录就是 int32/float 键本身时交给排序网络(与这里的保序编码
+ * 顺序一致)，其余按键做插入排序。
+ */
+static void small_sort_by_key(const radix_inplace_ctx_t *ctx, char *arr, size_t arr_len)
+{
+    if (ctx->element_size == sizeof(int32_t) && arr_len <= SORTING_NETWORK_MAX_32BIT)
+    {
+        if (ctx->key_type == RADIX_KEY_INT32)
+        {
+            network_sort_int32((int32_t *)arr, arr_len);
+            return;
+        }
+        if (ctx->key_type == RADIX_KEY_FLOAT)
+        {
+            network_sort_float((float *)arr, arr_len);
+            return;
+        }
+    }
+    insertion_sort_by_key(ctx, arr, arr_len);
+}
+
+static void american_flag_sort(const radix_inplace_ctx_t *ctx, char *arr, size_t arr_len, size_t digit)
+{
+    size_t es = ctx->element_size;
+    size_t count[RADIX_BUCKETS];
+    size_t next[RADIX_BUCKETS];
+    size_t end[RADIX_BUCKETS];
+
+    for (;;)
+    {
+        if (arr_len < RADIX_INPLACE_INSERTION_THRESHOLD)
+        {
+            small_sort_by_key(ctx, arr, arr_len);
+            return;
+        }
+
+        unsigned shift = (unsigned)(digit * RADIX_BITS);
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < arr_len; i++)
+        {
+            count[(load_key(INDEX_OF(arr, es, i), ctx->key_offset, ctx->key_type) >> shift) & RADIX_MASK]++;
+        }
+
+        // 所有元素在该位上相同，直接处理下一位
+        size_t first_digit = (load_key(arr, ctx->key_offset, ctx->key_type) >> shift) & RADIX_MASK;
+        if (count[first_digit] == arr_len)
+        {
+            if (digit == 0)
+            {
+                return;
+            }
+            digit--;
+            continue;
+        }
+
+        exclusive_prefix_sum(count, next);
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            end[b] = next[b] + count[b];
+        }
+
+        // 逐桶循环交换，每个元素最多被交换一次到位
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            while (next[b] < end[b])
+            {
+                char *elem = INDEX_OF(arr, es, next[b]);
+                size_t d = (load_key(elem, ctx->key_offset, ctx->key_type) >> shift) & RADIX_MASK;
+                if (d == b)
+                {
+                    next[b]++;
+                }
+                else
+                {
+                    ctx->swap(elem, INDEX_OF(arr, es, next[d]), es);
+                    INCRE_MOVEMENTS_BY(ctx->stats, 2);
+                    next[d]++;
+                }
+            }
+        }
+
+        if (digit == 0)
+        {
+            return;
+        }
+        size_t start = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            if (count[b] > 1)
+            {
+                american_flag_sort(ctx, INDEX_OF(arr, es, start), count[b], digit - 1);
+            }
+            start += count[b];
+        }
+        return;
+    }
+}
+
+sort_result_t generic_radix_sort_inplace(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type)
+{
+    return generic_radix_sort_inplace_ex(arr, arr_len, element_size, key_offset, key_type, NULL);
+}
+
+sort_result_t generic_radix_sort_inplace_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    size_t key_offset,
+    radix_key_type_t key_type,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    sort_result_t res = check_args(arr, element_size, key_offset, key_type);
+    if (res != SORT_SUCCESS || arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return res;
+    }
+
+    char stack_tmp[RADIX_STACK_TMP_SIZE];
+    void *tmp = stack_tmp;
+    if (element_size > RADIX_STACK_TMP_SIZE)
+    {
+        tmp = scratch_alloc(element_size);
+        if (NULL == tmp)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
+    }
+
+    radix_inplace_ctx_t ctx = {element_size, key_offset, key_type, select_swap_func(element_size), tmp, stats};
+    american_flag_sort(&ctx, (char *)arr, arr_len, key_width(key_type) - 1);
+
+    if (tmp != stack_tmp)
+    {
+        scratch_free(tmp);
+        DECRE_MEMORY_USED(stats, element_size);
+    }
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
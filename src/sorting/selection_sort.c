@@ -8,26 +8,7 @@ sort_result_t selection_sort(
     size_t element_size,
     compare_func_t cmp
 ) {
-    if (NULL == arr || NULL == cmp) {
-        return SORT_ERROR_NULL_POINTER;
-    }
-
-    if (arr_len == 0 || arr_len == 1) {
-        return SORT_SUCCESS;
-    }
-
-    for (size_t i = 0; i < arr_len - 1; i++) {
-        size_t min_index = i;
-        for (size_t j = i + 1; j < arr_len; j++) {
-            if (cmp(INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, min_index)) < 0) {
-                min_index = j;
-            }
-        }
-        if (min_index != i) {
-            GENERIC_SAMP_SIZE_SWAP(element_size, INDEX_OF(arr, element_size, i), INDEX_OF(arr, element_size, min_index));
-        }
-    }
-    return SORT_SUCCESS;
+    return generic_selection_sort_ex(arr, arr_len, element_size, cmp, NULL);
 }
 
 
@@ -37,23 +18,41 @@ sort_result_t generic_selection_sort(
     size_t element_size,
     compare_func_t cmp
 ) {
+    return generic_selection_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+
+sort_result_t generic_selection_sort_ex(
+    void* arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+) {
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
     if (NULL == arr || NULL == cmp) {
         return SORT_ERROR_NULL_POINTER;
     }
     if (arr_len == 0 || arr_len == 1) {
+        STOP_TIMMING(stats);
         return SORT_SUCCESS;
     }
     
+    sized_swap_func_t *swap = select_swap_func(element_size);
     for (size_t i = 0; i < arr_len - 1; i++) {
         size_t min_index = i;
         for (size_t j = i + 1; j < arr_len; j++) {
-            if (cmp(INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, min_index)) < 0) {
+            if (COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, min_index)) < 0) {
                 min_index = j;
             }
         }
         if (min_index != i) {
-            GENERIC_SAMP_SIZE_SWAP(element_size,INDEX_OF(arr, element_size, i), INDEX_OF(arr, element_size, min_index));
+            swap(INDEX_OF(arr, element_size, i), INDEX_OF(arr, element_size, min_index), element_size);
+            INCRE_MOVEMENTS_BY(stats, 2);
         }
     }
+    STOP_TIMMING(stats);
     return SORT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -1,4 +1,3 @@
-
 #include "sorting/shell_sort.h"
 
 
@@ -8,7 +7,21 @@ sort_result_t generic_shell_sort(
     size_t element_size,
     compare_func_t cmp
 ) {
+    return generic_shell_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_shell_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats
+) {
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
     if (arr_len <= 1) {
+        STOP_TIMMING(stats);
         return SORT_SUCCESS;
     }
     if (NULL == arr || NULL == cmp) {
@@ -18,6 +31,7 @@ sort_result_t generic_shell_sort(
     if (element_size == 0) {
         return SORT_ERROR_INVALID_ELEMENT_SIZE;
     }
+    sized_swap_func_t *swap = select_swap_func(element_size);
     size_t N = arr_len;
     size_t h = 1;
     while (h < N / 3) {
@@ -27,11 +41,13 @@ sort_result_t generic_shell_sort(
     while (h >= 1) {
         for (size_t i = h; i < N; i++) {
             // j = 4 , 1
-            for (size_t j = i; j >= h && cmp(INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, j - h)) < 0; j -= h) {
-                GENERIC_SAMP_SIZE_SWAP(element_size, INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, j - h));
+            for (size_t j = i; j >= h && COUNTED_CMP(stats, cmp, INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, j - h)) < 0; j -= h) {
+                swap(INDEX_OF(arr, element_size, j), INDEX_OF(arr, element_size, j - h), element_size);
+                INCRE_MOVEMENTS_BY(stats, 2);
             }
         }
         h /= 3;
     }
+    STOP_TIMMING(stats);
     return SORT_SUCCESS;
-}
\ No newline at end of file
+}
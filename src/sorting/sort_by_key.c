@@ -0,0 +1,437 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "sorting/sort_by_key.h"
+#include "sorting/parallel_sort.h"
+#include "util/scratch_arena.h"
+#include "radix_key.h"
+
+// 64 位键(或下标超过 32 位)时排序用的 (键, 下标) 对
+typedef struct
+{
+    uint64_t key;
+    uint64_t index;
+} key_pair_t;
+
+// 比较排序用的元组头，键紧跟在头后面。比较函数存在每个元组里，
+// 并行排序时不需要共享的上下文
+typedef struct
+{
+    compare_func_t *cmp;
+    size_t index;
+} key_tuple_t;
+
+#define TUPLE_KEY(tuple) ((char *)(tuple) + sizeof(key_tuple_t))
+
+/* ============================================================================
+ * 参数检查与值数组重排
+ * ============================================================================
+ */
+
+/** 检查值数组，并求出最大的元素大小 */
+static sort_result_t check_values(const sort_value_array_t *values, size_t num_values, size_t *max_value_size)
+{
+    if (num_values > 0 && NULL == values)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    size_t max_size = 0;
+    for (size_t v = 0; v < num_values; v++)
+    {
+        if (NULL == values[v].data)
+        {
+            return SORT_ERROR_NULL_POINTER;
+        }
+        if (0 == values[v].element_size)
+        {
+            return SORT_ERROR_INVALID_ELEMENT_SIZE;
+        }
+        max_size = values[v].element_size > max_size ? values[v].element_size : max_size;
+    }
+    *max_value_size = max_size;
+    return SORT_SUCCESS;
+}
+
+// 定长 memcpy 会被编译成一次加载和一次存储
+#define GATHER_LOOP(dst, src, perm, n, size)                                          \
+    for (size_t i = 0; i < (n); i++)                                                  \
+    {                                                                                 \
+        memcpy((dst) + i * (size), (src) + (perm)[i] * (size), (size));               \
+    }
+
+/** dst[i] = src[perm[i]] */
+static void gather(char *dst, const char *src, size_t element_size, const size_t *perm, size_t n)
+{
+    switch (element_size)
+    {
+    case 4:
+        GATHER_LOOP(dst, src, perm, n, 4);
+        break;
+    case 8:
+        GATHER_LOOP(dst, src, perm, n, 8);
+        break;
+    case 16:
+        GATHER_LOOP(dst, src, perm, n, 16);
+        break;
+    default:
+        GATHER_LOOP(dst, src, perm, n, element_size);
+        break;
+    }
+}
+
+/** 按 perm 重排每个值数组：gather 到 scratch 再整块拷回 */
+static void permute_values(
+    const sort_value_array_t *values,
+    size_t num_values,
+    const size_t *perm,
+    size_t n,
+    char *scratch,
+    sort_stats_t *stats)
+{
+    for (size_t v = 0; v < num_values; v++)
+    {
+        gather(scratch, values[v].data, values[v].element_size, perm, n);
+        memcpy(values[v].data, scratch, n * values[v].element_size);
+        INCRE_MOVEMENTS_BY(stats, 2 * n);
+    }
+    (void)stats;
+}
+
+/* ============================================================================
+ * 基数排序路径
+ * ============================================================================
+ */
+
+/**
+ * 32 位键：编码后的键放在高 32 位、下标放在低 32 位，一个 uint64_t 就是
+ * 一个 (键, 下标) 对。只分发键所在的 4 个字节，LSD 保证相等键的下标
+ * 保持升序，即稳定。排序后键写回 keys，下标原地压缩成 perm(写入 out)。
+ * @return 执行的分发轮数
+ */
+static size_t sort_items_32(void *keys, size_t n, radix_key_type_t type, uint64_t *items, uint64_t *buffer, size_t *out)
+{
+    uint32_t *k32 = keys;
+    size_t hist[4][RADIX_BUCKETS] = {{0}};
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t k = encode_u32(k32[i], type);
+        items[i] = ((uint64_t)k << 32) | (uint64_t)i;
+        hist[0][k & RADIX_MASK]++;
+        hist[1][(k >> 8) & RADIX_MASK]++;
+        hist[2][(k >> 16) & RADIX_MASK]++;
+        hist[3][k >> 24]++;
+    }
+
+    uint64_t *src = items;
+    uint64_t *dst = buffer;
+    size_t passes = 0;
+    for (size_t d = 0; d < 4; d++)
+    {
+        unsigned shift = 32 + (unsigned)d * RADIX_BITS;
+        // 所有键在这一位上相同时跳过
+        if (hist[d][(src[0] >> shift) & RADIX_MASK] == n)
+        {
+            continue;
+        }
+        size_t pos[RADIX_BUCKETS];
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            pos[b] = sum;
+            sum += hist[d][b];
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t item = src[i];
+            dst[pos[(item >> shift) & RADIX_MASK]++] = item;
+        }
+        uint64_t *t = src;
+        src = dst;
+        dst = t;
+        passes++;
+    }
+
+    // out 与 items 是同一块内存：第 i 个 size_t 不晚于第 i 项被读取后才写入
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t item = src[i];
+        k32[i] = decode_u32((uint32_t)(item >> 32), type);
+        out[i] = (size_t)(uint32_t)item;
+    }
+    return passes;
+}
+
+/** 64 位键：16 字节的 (键, 下标) 对，分发 8 个字节，其余同 sort_items_32 */
+static size_t sort_pairs_64(void *keys, size_t n, size_t width, radix_key_type_t type, key_pair_t *pairs, key_pair_t *buffer, size_t *out)
+{
+    size_t hist[8][RADIX_BUCKETS] = {{0}};
+    size_t digits = width;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t k = width == sizeof(uint64_t) ? encode_u64(((uint64_t *)keys)[i], type)
+                                               : encode_u32(((uint32_t *)keys)[i], type);
+        pairs[i].key = k;
+        pairs[i].index = i;
+        for (size_t d = 0; d < digits; d++)
+        {
+            hist[d][(k >> (d * RADIX_BITS)) & RADIX_MASK]++;
+        }
+    }
+
+    key_pair_t *src = pairs;
+    key_pair_t *dst = buffer;
+    size_t passes = 0;
+    for (size_t d = 0; d < digits; d++)
+    {
+        unsigned shift = (unsigned)d * RADIX_BITS;
+        if (hist[d][(src[0].key >> shift) & RADIX_MASK] == n)
+        {
+            continue;
+        }
+        size_t pos[RADIX_BUCKETS];
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            pos[b] = sum;
+            sum += hist[d][b];
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            dst[pos[(src[i].key >> shift) & RADIX_MASK]++] = src[i];
+        }
+        key_pair_t *t = src;
+        src = dst;
+        dst = t;
+        passes++;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t k = src[i].key;
+        size_t index = (size_t)src[i].index;
+        if (width == sizeof(uint64_t))
+        {
+            ((uint64_t *)keys)[i] = decode_u64(k, type);
+        }
+        else
+        {
+            ((uint32_t *)keys)[i] = decode_u32((uint32_t)k, type);
+        }
+        out[i] = index;
+    }
+    return passes;
+}
+
+sort_result_t radix_sort_by_key(
+    void *keys,
+    size_t arr_len,
+    radix_key_type_t key_type,
+    const sort_value_array_t *values,
+    size_t num_values)
+{
+    return radix_sort_by_key_ex(keys, arr_len, key_type, values, num_values, NULL);
+}
+
+sort_result_t radix_sort_by_key_ex(
+    void *keys,
+    size_t arr_len,
+    radix_key_type_t key_type,
+    const sort_value_array_t *values,
+    size_t num_values,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ARR_LEN(stats, arr_len);
+    size_t width = key_width(key_type);
+    RECORD_ELEMENT_SIZE(stats, width);
+    size_t max_value_size = 0;
+    sort_result_t res = SORT_SUCCESS;
+    if (NULL == keys)
+    {
+        res = SORT_ERROR_NULL_POINTER;
+    }
+    else if (0 == width)
+    {
+        res = SORT_ERROR_INVALID_ARGUMENT;
+    }
+    else
+    {
+        res = check_values(values, num_values, &max_value_size);
+    }
+    if (res != SORT_SUCCESS || arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return res;
+    }
+
+    // 前一半放 (键, 下标) 对，后一半是分发用的另一半，同时也是值数组 gather
+    // 的暂存空间，所以至少要放得下 n 个最大的值元素
+    int packed = width == sizeof(uint32_t) && (uint64_t)arr_len <= UINT32_MAX;
+    size_t item_size = packed ? sizeof(uint64_t) : sizeof(key_pair_t);
+    size_t buffer_size = arr_len * (item_size > max_value_size ? item_size : max_value_size);
+    size_t total = arr_len * item_size + buffer_size;
+    char *mem = scratch_alloc(total);
+    if (NULL == mem)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, total);
+
+    char *buffer = mem + arr_len * item_size;
+    size_t *perm = (size_t *)mem;
+    size_t passes = packed
+                        ? sort_items_32(keys, arr_len, key_type, (uint64_t *)mem, (uint64_t *)buffer, perm)
+                        : sort_pairs_64(keys, arr_len, width, key_type, (key_pair_t *)mem, (key_pair_t *)buffer, perm);
+    // 打包、每轮分发、写回各移动一遍
+    INCRE_MOVEMENTS_BY(stats, (passes + 2) * arr_len);
+    (void)passes;
+
+    permute_values(values, num_values, perm, arr_len, buffer, stats);
+
+    scratch_free(mem);
+    DECRE_MEMORY_USED(stats, total);
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
+
+/* ============================================================================
+ * 比较排序路径
+ * ============================================================================
+ */
+
+static int compare_tuples(const void *a, const void *b)
+{
+    const key_tuple_t *ta = a;
+    return ta->cmp(TUPLE_KEY(a), TUPLE_KEY(b));
+}
+
+sort_result_t generic_sort_by_key(
+    void *keys,
+    size_t arr_len,
+    size_t key_size,
+    compare_func_t cmp,
+    const sort_value_array_t *values,
+    size_t num_values,
+    int stable)
+{
+    return generic_sort_by_key_ex(keys, arr_len, key_size, cmp, values, num_values, stable, NULL);
+}
+
+sort_result_t generic_sort_by_key_ex(
+    void *keys,
+    size_t arr_len,
+    size_t key_size,
+    compare_func_t cmp,
+    const sort_value_array_t *values,
+    size_t num_values,
+    int stable,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, key_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    size_t max_value_size = 0;
+    sort_result_t res = SORT_SUCCESS;
+    if (NULL == keys || NULL == cmp)
+    {
+        res = SORT_ERROR_NULL_POINTER;
+    }
+    else if (0 == key_size)
+    {
+        res = SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    else
+    {
+        res = check_values(values, num_values, &max_value_size);
+    }
+    if (res != SORT_SUCCESS || arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return res;
+    }
+
+    // 元组大小按头的对齐取整，键在元组内与头同样对齐
+    size_t align = sizeof(size_t);
+    size_t tuple_size = sizeof(key_tuple_t) + (key_size + align - 1) / align * align;
+    size_t tuples_bytes = arr_len * tuple_size;
+    char *tuples = scratch_alloc(tuples_bytes);
+    if (NULL == tuples)
+    {
+        STOP_TIMMING(stats);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    INCRE_MEMORY_USED(stats, tuples_bytes);
+
+    // perm 只占元组区的前 arr_len 个 size_t，剩余部分够放时直接作为值数组的
+    // 暂存空间；不够时在排序前分配，避免键已排好而值数组分配失败
+    size_t scratch_bytes = num_values > 0 ? arr_len * max_value_size : 0;
+    char *scratch = tuples + arr_len * sizeof(size_t);
+    char *extra = NULL;
+    if (tuples_bytes - arr_len * sizeof(size_t) < scratch_bytes)
+    {
+        extra = scratch_alloc(scratch_bytes);
+        if (NULL == extra)
+        {
+            scratch_free(tuples);
+            DECRE_MEMORY_USED(stats, tuples_bytes);
+            STOP_TIMMING(stats);
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, scratch_bytes);
+        scratch = extra;
+    }
+
+    const char *k = keys;
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        key_tuple_t *t = (key_tuple_t *)(tuples + i * tuple_size);
+        t->cmp = cmp;
+        t->index = i;
+        memcpy(TUPLE_KEY(t), k + i * key_size, key_size);
+    }
+
+    // 内部的 _ex 会清零 stats，用局部统计再合并
+    sort_stats_t sort_stats = {0};
+    sort_stats_t *sub = NULL != stats ? &sort_stats : NULL;
+    res = stable ? generic_parallel_stable_sort_ex(tuples, arr_len, tuple_size, compare_tuples, sub)
+                 : generic_parallel_sort_ex(tuples, arr_len, tuple_size, compare_tuples, sub);
+    if (NULL != stats)
+    {
+        sort_stats_merge(stats, &sort_stats);
+    }
+    if (res != SORT_SUCCESS)
+    {
+        if (NULL != extra)
+        {
+            scratch_free(extra);
+            DECRE_MEMORY_USED(stats, scratch_bytes);
+        }
+        scratch_free(tuples);
+        DECRE_MEMORY_USED(stats, tuples_bytes);
+        STOP_TIMMING(stats);
+        return res;
+    }
+
+    // 键写回，下标原地压缩成 perm：第 i 个元组在第 i 个 size_t 写入前已读完
+    size_t *perm = (size_t *)tuples;
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        const key_tuple_t *t = (const key_tuple_t *)(tuples + i * tuple_size);
+        size_t index = t->index;
+        memcpy((char *)keys + i * key_size, TUPLE_KEY(t), key_size);
+        perm[i] = index;
+    }
+    INCRE_MOVEMENTS_BY(stats, 2 * arr_len);
+
+    permute_values(values, num_values, perm, arr_len, scratch, stats);
+    if (NULL != extra)
+    {
+        scratch_free(extra);
+        DECRE_MEMORY_USED(stats, scratch_bytes);
+    }
+
+    scratch_free(tuples);
+    DECRE_MEMORY_USED(stats, tuples_bytes);
+    STOP_TIMMING(stats);
+    return SORT_SUCCESS;
+}
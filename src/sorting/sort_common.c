@@ -1,7 +1,13 @@
 #include "sorting/sort_common.h"
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORT_COMMON_X86 1
+#include <immintrin.h>
+#endif
+
 int compare_integers(const void *const a, const void *const b)
 {
   const int *ap = (const int *)a;
@@ -15,7 +21,170 @@ int compare_strings(const void *const a, const void *const b)
 
 void swap_integers(void *const a, void *const b)
 {
-  GENERIC_SAMP_SIZE_SWAP(sizeof(int), a, b);
+  int t = *(int *)a;
+  *(int *)a = *(int *)b;
+  *(int *)b = t;
+}
+
+/* ============================================================================
+ * 按元素大小特化的交换函数
+ * ============================================================================
+ */
+
+#define DEFINE_FIXED_SWAP(bytes, type)                                \
+  static void swap_##bytes(void *const a, void *const b, size_t size) \
+  {                                                                   \
+    (void)size;                                                       \
+    type ta, tb;                                                      \
+    memcpy(&ta, a, sizeof(type));                                     \
+    memcpy(&tb, b, sizeof(type));                                     \
+    memcpy(a, &tb, sizeof(type));                                     \
+    memcpy(b, &ta, sizeof(type));                                     \
+  }
+
+DEFINE_FIXED_SWAP(1, uint8_t)
+DEFINE_FIXED_SWAP(2, uint16_t)
+DEFINE_FIXED_SWAP(4, uint32_t)
+DEFINE_FIXED_SWAP(8, uint64_t)
+
+/** 不足一个分块的尾部，按 8/4/1 字节交换 */
+static inline void swap_tail(char *a, char *b, size_t size)
+{
+  while (size >= 8)
+  {
+    swap_8(a, b, 8);
+    a += 8;
+    b += 8;
+    size -= 8;
+  }
+  while (size >= 4)
+  {
+    swap_4(a, b, 4);
+    a += 4;
+    b += 4;
+    size -= 4;
+  }
+  while (size > 0)
+  {
+    swap_1(a, b, 1);
+    a++;
+    b++;
+    size--;
+  }
+}
+
+#if defined(SORT_COMMON_X86)
+
+static void swap_16(void *const a, void *const b, size_t size)
+{
+  (void)size;
+  __m128i x = _mm_loadu_si128((const __m128i *)a);
+  __m128i y = _mm_loadu_si128((const __m128i *)b);
+  _mm_storeu_si128((__m128i *)a, y);
+  _mm_storeu_si128((__m128i *)b, x);
+}
+
+static void swap_sse2(void *const a, void *const b, size_t size)
+{
+  char *pa = (char *)a;
+  char *pb = (char *)b;
+  for (; size >= 16; size -= 16, pa += 16, pb += 16)
+  {
+    swap_16(pa, pb, 16);
+  }
+  swap_tail(pa, pb, size);
+}
+
+__attribute__((target("avx2"))) static void swap_avx2(void *const a, void *const b, size_t size)
+{
+  char *pa = (char *)a;
+  char *pb = (char *)b;
+  for (; size >= 32; size -= 32, pa += 32, pb += 32)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i *)pa);
+    __m256i y = _mm256_loadu_si256((const __m256i *)pb);
+    _mm256_storeu_si256((__m256i *)pa, y);
+    _mm256_storeu_si256((__m256i *)pb, x);
+  }
+  if (size >= 16)
+  {
+    swap_16(pa, pb, 16);
+    pa += 16;
+    pb += 16;
+    size -= 16;
+  }
+  swap_tail(pa, pb, size);
+}
+
+int sort_cpu_has_avx2(void)
+{
+  static int has_avx2 = -1;
+  if (has_avx2 < 0)
+  {
+    __builtin_cpu_init();
+    has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+  }
+  return has_avx2;
+}
+
+#else
+
+typedef struct
+{
+  uint64_t lo;
+  uint64_t hi;
+} swap_block16_t;
+
+DEFINE_FIXED_SWAP(16, swap_block16_t)
+
+/** 通用实现：按 64 字节栈缓冲区分块拷贝，编译器会把定长 memcpy 展开 */
+static void swap_chunked(void *const a, void *const b, size_t size)
+{
+  char *pa = (char *)a;
+  char *pb = (char *)b;
+  char tmp[64];
+  for (; size >= sizeof(tmp); size -= sizeof(tmp), pa += sizeof(tmp), pb += sizeof(tmp))
+  {
+    memcpy(tmp, pa, sizeof(tmp));
+    memcpy(pa, pb, sizeof(tmp));
+    memcpy(pb, tmp, sizeof(tmp));
+  }
+  swap_tail(pa, pb, size);
+}
+
+int sort_cpu_has_avx2(void)
+{
+  return 0;
+}
+
+#endif // SORT_COMMON_X86
+
+sized_swap_func_t *select_swap_func(size_t element_size)
+{
+  switch (element_size)
+  {
+  case 1:
+    return swap_1;
+  case 2:
+    return swap_2;
+  case 4:
+    return swap_4;
+  case 8:
+    return swap_8;
+  case 16:
+    return swap_16;
+  default:
+    break;
+  }
+#if defined(SORT_COMMON_X86)
+  if (element_size >= 32 && sort_cpu_has_avx2())
+  {
+    return swap_avx2;
+  }
+  return swap_sse2;
+#else
+  return swap_chunked;
+#endif
 }
 
 void print_stats(const sort_stats_t *stats)
@@ -27,6 +196,7 @@ void print_stats(const sort_stats_t *stats)
   printf("element_size: %zu bytes\n"
          "array_length: %zu\n"
          "Comparisons: %zu\n"
+         "Comparisons Avoided: %zu\n"
          "Movements: %zu\n"
          "Time Spent: %.2f ms\n"
          "Additional Memory Used: %zu bytes\n"
@@ -34,8 +204,69 @@ void print_stats(const sort_stats_t *stats)
          stats->element_size,
          stats->array_length,
          stats->comparisons,
+         stats->comparisons_avoided,
          stats->movements,
          stats->time_elapsed_ms,
          stats->memory_used,
          stats->max_mamory_used);
-}
\ No newline at end of file
+  if (stats->io_bytes_read > 0 || stats->io_bytes_written > 0)
+  {
+    printf("I/O Read: %llu bytes\n"
+           "I/O Written: %llu bytes\n"
+           "Merge Passes: %zu\n",
+           (unsigned long long)stats->io_bytes_read,
+           (unsigned long long)stats->io_bytes_written,
+           stats->merge_passes);
+  }
+
+  const sort_hw_counters_t *hw = &stats->hw;
+  if (0 == hw->available_mask)
+  {
+    printf("Hardware Counters: unavailable\n");
+    return;
+  }
+  printf("Hardware Counters:\n");
+  for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+  {
+    if (hw->available_mask & (1u << i))
+    {
+      printf("  %s: %llu\n", sort_hw_counter_name((sort_hw_counter_t)i), (unsigned long long)hw->values[i]);
+    }
+    else
+    {
+      printf("  %s: unavailable\n", sort_hw_counter_name((sort_hw_counter_t)i));
+    }
+  }
+  const uint32_t ipc_mask = (1u << SORT_HW_CYCLES) | (1u << SORT_HW_INSTRUCTIONS);
+  if ((hw->available_mask & ipc_mask) == ipc_mask && hw->values[SORT_HW_CYCLES] > 0)
+  {
+    printf("  IPC: %.2f\n", (double)hw->values[SORT_HW_INSTRUCTIONS] / (double)hw->values[SORT_HW_CYCLES]);
+  }
+  if ((hw->available_mask & (1u << SORT_HW_INSTRUCTIONS)) && stats->array_length > 0)
+  {
+    printf("  Instructions/Element: %.1f\n",
+           (double)hw->values[SORT_HW_INSTRUCTIONS] / (double)stats->array_length);
+  }
+}
+
+uint64_t sort_monotonic_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void sort_stats_merge(sort_stats_t *dst, const sort_stats_t *src)
+{
+  if (NULL == dst || NULL == src)
+  {
+    return;
+  }
+  dst->comparisons += src->comparisons;
+  dst->comparisons_avoided += src->comparisons_avoided;
+  dst->movements += src->movements;
+  dst->memory_used += src->memory_used;
+  dst->max_mamory_used += src->max_mamory_used;
+  dst->io_bytes_read += src->io_bytes_read;
+  dst->io_bytes_written += src->io_bytes_written;
+}
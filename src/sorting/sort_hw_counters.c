@@ -0,0 +1,263 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "sorting/sort_common.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SORT_HW_PERF_EVENT 1
+#endif
+
+static atomic_int hw_enabled = 0;
+
+void sort_hw_counters_set_enabled(int enabled)
+{
+    atomic_store_explicit(&hw_enabled, enabled ? 1 : 0, memory_order_relaxed);
+}
+
+int sort_hw_counters_enabled(void)
+{
+    return atomic_load_explicit(&hw_enabled, memory_order_relaxed);
+}
+
+const char *sort_hw_counter_name(sort_hw_counter_t counter)
+{
+    switch (counter)
+    {
+    case SORT_HW_CYCLES:
+        return "Cycles";
+    case SORT_HW_INSTRUCTIONS:
+        return "Instructions";
+    case SORT_HW_L1D_MISSES:
+        return "L1D Misses";
+    case SORT_HW_LLC_MISSES:
+        return "LLC Misses";
+    case SORT_HW_BRANCH_MISSES:
+        return "Branch Misses";
+    default:
+        return "Unknown";
+    }
+}
+
+#if defined(SORT_HW_PERF_EVENT)
+
+/* ============================================================================
+ * 每线程的计数器组
+ * ============================================================================
+ */
+
+// 组读取格式(PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING):
+// nr, time_enabled, time_running, value[nr]
+#define HW_READ_HEADER 3
+
+typedef struct
+{
+    int state;                        // 0 未打开，1 可用，-1 打开失败(不再重试)
+    int leader_fd;
+    int fds[SORT_HW_COUNTER_COUNT];
+    int slot[SORT_HW_COUNTER_COUNT];  // 计数器在组读取结果中的下标，-1 表示没打开
+    int nr;
+    uint32_t mask;
+} hw_thread_state_t;
+
+static _Thread_local hw_thread_state_t tls_hw = {0};
+
+static pthread_key_t hw_cleanup_key;
+static pthread_once_t hw_cleanup_once = PTHREAD_ONCE_INIT;
+
+static void hw_close_thread_state(void *arg)
+{
+    hw_thread_state_t *st = (hw_thread_state_t *)arg;
+    for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+    {
+        if (st->fds[i] >= 0)
+        {
+            close(st->fds[i]);
+            st->fds[i] = -1;
+        }
+    }
+    st->leader_fd = -1;
+    st->state = 0;
+}
+
+static void hw_create_cleanup_key(void)
+{
+    pthread_key_create(&hw_cleanup_key, hw_close_thread_state);
+}
+
+static void hw_event_attr(sort_hw_counter_t counter, struct perf_event_attr *attr)
+{
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->exclude_kernel = 1; // perf_event_paranoid <= 2 时允许统计本进程的用户态
+    attr->exclude_hv = 1;
+    attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (counter)
+    {
+    case SORT_HW_CYCLES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case SORT_HW_INSTRUCTIONS:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case SORT_HW_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_L1D |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case SORT_HW_LLC_MISSES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case SORT_HW_BRANCH_MISSES:
+    default:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+}
+
+/**
+ * 打开调用线程的计数器组。第一个打开成功的事件做组长，
+ * 其余事件单独失败时只是缺少那一项，不影响其它计数。
+ */
+static int hw_open_thread_state(hw_thread_state_t *st)
+{
+    st->leader_fd = -1;
+    st->nr = 0;
+    st->mask = 0;
+    for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+    {
+        st->fds[i] = -1;
+        st->slot[i] = -1;
+    }
+
+    for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+    {
+        struct perf_event_attr attr;
+        hw_event_attr((sort_hw_counter_t)i, &attr);
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, st->leader_fd, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (st->leader_fd < 0)
+        {
+            st->leader_fd = fd;
+        }
+        st->fds[i] = fd;
+        st->slot[i] = st->nr++;
+        st->mask |= 1u << i;
+    }
+
+    if (st->leader_fd < 0)
+    {
+        st->state = -1;
+        return 0;
+    }
+    pthread_once(&hw_cleanup_once, hw_create_cleanup_key);
+    pthread_setspecific(hw_cleanup_key, st);
+    st->state = 1;
+    return 1;
+}
+
+/** 读取整组计数；成功时 out 依次为 time_enabled, time_running, value[0..nr) */
+static int hw_read_group(const hw_thread_state_t *st, uint64_t out[SORT_HW_COUNTER_COUNT + 2])
+{
+    uint64_t buf[HW_READ_HEADER + SORT_HW_COUNTER_COUNT];
+    ssize_t expected = (ssize_t)((HW_READ_HEADER + (size_t)st->nr) * sizeof(uint64_t));
+    if (read(st->leader_fd, buf, sizeof(buf)) != expected || buf[0] != (uint64_t)st->nr)
+    {
+        return 0;
+    }
+    memcpy(out, buf + 1, (2 + (size_t)st->nr) * sizeof(uint64_t));
+    return 1;
+}
+
+void sort_hw_counters_begin(sort_hw_counters_t *hw)
+{
+    if (NULL == hw)
+    {
+        return;
+    }
+    hw->available_mask = 0;
+    memset(hw->values, 0, sizeof(hw->values));
+    if (!sort_hw_counters_enabled())
+    {
+        return;
+    }
+
+    hw_thread_state_t *st = &tls_hw;
+    if (st->state == 0)
+    {
+        hw_open_thread_state(st);
+    }
+    if (st->state != 1 || !hw_read_group(st, hw->snapshot))
+    {
+        return;
+    }
+    hw->available_mask = st->mask;
+}
+
+void sort_hw_counters_end(sort_hw_counters_t *hw)
+{
+    if (NULL == hw || 0 == hw->available_mask)
+    {
+        return;
+    }
+
+    hw_thread_state_t *st = &tls_hw;
+    uint64_t now[SORT_HW_COUNTER_COUNT + 2];
+    // 开始和结束必须落在同一线程的同一组计数器上
+    if (st->state != 1 || st->mask != hw->available_mask || !hw_read_group(st, now))
+    {
+        hw->available_mask = 0;
+        return;
+    }
+
+    uint64_t enabled = now[0] - hw->snapshot[0];
+    uint64_t running = now[1] - hw->snapshot[1];
+    if (0 == running)
+    {
+        // 计数器组整段时间都没被调度到 PMU 上，读数没有意义
+        hw->available_mask = 0;
+        return;
+    }
+    double scale = (double)enabled / (double)running;
+    for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+    {
+        if (st->slot[i] < 0)
+        {
+            continue;
+        }
+        uint64_t delta = now[2 + st->slot[i]] - hw->snapshot[2 + st->slot[i]];
+        hw->values[i] = (uint64_t)((double)delta * scale + 0.5);
+    }
+}
+
+#else // !SORT_HW_PERF_EVENT
+
+void sort_hw_counters_begin(sort_hw_counters_t *hw)
+{
+    if (NULL != hw)
+    {
+        hw->available_mask = 0;
+        memset(hw->values, 0, sizeof(hw->values));
+    }
+}
+
+void sort_hw_counters_end(sort_hw_counters_t *hw)
+{
+    (void)hw;
+}
+
+#endif // SORT_HW_PERF_EVENT
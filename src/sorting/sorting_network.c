@@ -0,0 +1,483 @@
+#include "sorting/sorting_network.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORTING_NETWORK_X86 1
+#include <immintrin.h>
+#endif
+
+/* ============================================================================
+ * 网络表
+ * ============================================================================
+ */
+
+// 每项 {i, j} 表示比较 arr[i] 与 arr[j](i < j)，较小者放到 i。
+// 2~10、12、16 为已知最优网络；11 由 12 元网络、13~15 由 16 元网络
+// 裁剪一条输入线得到。全部用 0-1 原理穷举验证过。
+static const uint8_t network_2[1][2] = {
+    {0, 1},
+};
+static const uint8_t network_3[3][2] = {
+    {0, 2}, {0, 1}, {1, 2},
+};
+static const uint8_t network_4[5][2] = {
+    {0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2},
+};
+static const uint8_t network_5[9][2] = {
+    {0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4},
+    {2, 3},
+};
+static const uint8_t network_6[12][2] = {
+    {0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1},
+    {2, 3}, {4, 5}, {1, 2}, {3, 4},
+};
+static const uint8_t network_7[16][2] = {
+    {0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5},
+    {3, 4}, {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6},
+};
+static const uint8_t network_8[19][2] = {
+    {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+    {0, 1}, {2, 3}, {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6},
+    {1, 2}, {3, 4}, {5, 6},
+};
+static const uint8_t network_9[25][2] = {
+    {0, 3}, {1, 7}, {2, 5}, {4, 8}, {0, 7}, {2, 4}, {3, 8}, {5, 6},
+    {0, 2}, {1, 3}, {4, 5}, {7, 8}, {1, 4}, {3, 6}, {5, 7}, {0, 1},
+    {2, 4}, {3, 5}, {6, 8}, {2, 3}, {4, 5}, {6, 7}, {1, 2}, {3, 4},
+    {5, 6},
+};
+static const uint8_t network_10[29][2] = {
+    {0, 8}, {1, 9}, {2, 7}, {3, 5}, {4, 6}, {0, 2}, {1, 4}, {5, 8},
+    {7, 9}, {0, 3}, {2, 4}, {5, 7}, {6, 9}, {0, 1}, {3, 6}, {8, 9},
+    {1, 5}, {2, 3}, {4, 8}, {6, 7}, {1, 2}, {3, 5}, {4, 6}, {7, 8},
+    {2, 3}, {4, 5}, {6, 7}, {3, 4}, {5, 6},
+};
+static const uint8_t network_11[35][2] = {
+    {0, 6}, {1, 5}, {2, 10}, {3, 9}, {4, 8}, {1, 4}, {2, 3}, {5, 8},
+    {6, 7}, {9, 10}, {0, 5}, {4, 9}, {8, 10}, {0, 1}, {3, 5}, {4, 6},
+    {7, 10}, {8, 9}, {0, 3}, {2, 4}, {5, 7}, {6, 9}, {0, 2}, {1, 4},
+    {5, 8}, {7, 9}, {1, 2}, {3, 4}, {5, 6}, {7, 8}, {3, 5}, {4, 6},
+    {2, 3}, {4, 5}, {6, 7},
+};
+static const uint8_t network_12[39][2] = {
+    {0, 8}, {1, 7}, {2, 6}, {3, 11}, {4, 10}, {5, 9}, {0, 1}, {2, 5},
+    {3, 4}, {6, 9}, {7, 8}, {10, 11}, {0, 2}, {1, 6}, {5, 10}, {9, 11},
+    {0, 3}, {1, 2}, {4, 6}, {5, 7}, {8, 11}, {9, 10}, {1, 4}, {3, 5},
+    {6, 8}, {7, 10}, {1, 3}, {2, 5}, {6, 9}, {8, 10}, {2, 3}, {4, 5},
+    {6, 7}, {8, 9}, {4, 6}, {5, 7}, {3, 4}, {5, 6}, {7, 8},
+};
+static const uint8_t network_13[46][2] = {
+    {0, 11}, {1, 5}, {2, 3}, {4, 8}, {6, 7}, {0, 1}, {3, 10}, {5, 11},
+    {7, 12}, {8, 9}, {1, 2}, {3, 5}, {4, 6}, {7, 8}, {9, 10}, {11, 12},
+    {1, 7}, {2, 8}, {3, 4}, {5, 6}, {9, 11}, {10, 12}, {0, 9}, {1, 3},
+    {2, 4}, {5, 7}, {6, 8}, {10, 11}, {2, 5}, {4, 7}, {6, 10}, {8, 11},
+    {0, 3}, {6, 9}, {8, 10}, {0, 2}, {3, 5}, {4, 6}, {7, 9}, {0, 1},
+    {2, 3}, {4, 5}, {6, 7}, {8, 9}, {3, 4}, {5, 6},
+};
+static const uint8_t network_14[51][2] = {
+    {0, 13}, {1, 12}, {2, 6}, {3, 4}, {5, 9}, {7, 8}, {0, 7}, {1, 2},
+    {4, 11}, {6, 12}, {8, 13}, {9, 10}, {0, 1}, {2, 3}, {4, 6}, {5, 7},
+    {8, 9}, {10, 11}, {12, 13}, {2, 8}, {3, 9}, {4, 5}, {6, 7}, {10, 12},
+    {11, 13}, {1, 10}, {2, 4}, {3, 5}, {6, 8}, {7, 9}, {11, 12}, {0, 4},
+    {3, 6}, {5, 8}, {7, 11}, {9, 12}, {0, 2}, {1, 4}, {7, 10}, {9, 11},
+    {1, 3}, {4, 6}, {5, 7}, {8, 10}, {1, 2}, {3, 4}, {5, 6}, {7, 8},
+    {9, 10}, {4, 5}, {6, 7},
+};
+static const uint8_t network_15[56][2] = {
+    {0, 11}, {1, 14}, {2, 13}, {3, 7}, {4, 5}, {6, 10}, {8, 9}, {0, 6},
+    {1, 8}, {2, 3}, {5, 12}, {7, 13}, {9, 14}, {10, 11}, {1, 2}, {3, 4},
+    {5, 7}, {6, 8}, {9, 10}, {11, 12}, {13, 14}, {0, 2}, {3, 9}, {4, 10},
+    {5, 6}, {7, 8}, {11, 13}, {12, 14}, {0, 1}, {2, 11}, {3, 5}, {4, 6},
+    {7, 9}, {8, 10}, {12, 13}, {0, 3}, {1, 5}, {4, 7}, {6, 9}, {8, 12},
+    {10, 13}, {1, 3}, {2, 5}, {8, 11}, {10, 12}, {2, 4}, {5, 7}, {6, 8},
+    {9, 11}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {5, 6}, {7, 8},
+};
+static const uint8_t network_16[60][2] = {
+    {0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+    {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12},
+    {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13}, {14, 15},
+    {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14}, {13, 15},
+    {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14}, {1, 4},
+    {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14}, {2, 4}, {3, 6}, {9, 12},
+    {11, 13}, {3, 5}, {6, 8}, {7, 9}, {10, 12}, {3, 4}, {5, 6}, {7, 8},
+    {9, 10}, {11, 12}, {6, 7}, {8, 9},
+};
+
+typedef struct
+{
+    const uint8_t (*pairs)[2];
+    size_t count;
+} network_t;
+
+#define NETWORK_ENTRY(n) {network_##n, sizeof(network_##n) / sizeof(network_##n[0])}
+
+static const network_t networks[SORTING_NETWORK_MAX + 1] = {
+    {NULL, 0},
+    {NULL, 0},
+    NETWORK_ENTRY(2),
+    NETWORK_ENTRY(3),
+    NETWORK_ENTRY(4),
+    NETWORK_ENTRY(5),
+    NETWORK_ENTRY(6),
+    NETWORK_ENTRY(7),
+    NETWORK_ENTRY(8),
+    NETWORK_ENTRY(9),
+    NETWORK_ENTRY(10),
+    NETWORK_ENTRY(11),
+    NETWORK_ENTRY(12),
+    NETWORK_ENTRY(13),
+    NETWORK_ENTRY(14),
+    NETWORK_ENTRY(15),
+    NETWORK_ENTRY(16),
+};
+
+/* ============================================================================
+ * 通用版本
+ * ============================================================================
+ */
+
+// 比较结果转成全 0/全 1 掩码后用 XOR 交换，交换与否不产生分支
+#define DEFINE_MASKED_NETWORK(NAME, WORD, WORDS)                                             \
+    static void NAME(char *arr, const network_t *net, compare_func_t cmp, sort_stats_t *stats) \
+    {                                                                                        \
+        for (size_t i = 0; i < net->count; i++)                                              \
+        {                                                                                    \
+            char *pa = arr + (size_t)net->pairs[i][0] * (sizeof(WORD) * (WORDS));            \
+            char *pb = arr + (size_t)net->pairs[i][1] * (sizeof(WORD) * (WORDS));            \
+            int gt = COUNTED_CMP(stats, cmp, pa, pb) > 0;                                    \
+            WORD mask = (WORD)0 - (WORD)gt;                                                  \
+            for (size_t w = 0; w < (WORDS); w++)                                             \
+            {                                                                                \
+                WORD x, y;                                                                   \
+                memcpy(&x, pa + w * sizeof(WORD), sizeof(WORD));                             \
+                memcpy(&y, pb + w * sizeof(WORD), sizeof(WORD));                             \
+                WORD t = (x ^ y) & mask;                                                     \
+                x ^= t;                                                                      \
+                y ^= t;                                                                      \
+                memcpy(pa + w * sizeof(WORD), &x, sizeof(WORD));                             \
+                memcpy(pb + w * sizeof(WORD), &y, sizeof(WORD));                             \
+            }                                                                                \
+            INCRE_MOVEMENTS_BY(stats, 2 * (size_t)gt);                                       \
+        }                                                                                    \
+    }
+
+DEFINE_MASKED_NETWORK(network_run_4, uint32_t, 1)
+DEFINE_MASKED_NETWORK(network_run_8, uint64_t, 1)
+DEFINE_MASKED_NETWORK(network_run_16, uint64_t, 2)
+
+static void network_run_swap(char *arr, size_t es, const network_t *net, compare_func_t cmp, sort_stats_t *stats)
+{
+    sized_swap_func_t *swap = select_swap_func(es);
+    for (size_t i = 0; i < net->count; i++)
+    {
+        char *pa = arr + (size_t)net->pairs[i][0] * es;
+        char *pb = arr + (size_t)net->pairs[i][1] * es;
+        if (COUNTED_CMP(stats, cmp, pa, pb) > 0)
+        {
+            swap(pa, pb, es);
+            INCRE_MOVEMENTS_BY(stats, 2);
+        }
+    }
+}
+
+sort_result_t generic_network_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_network_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_network_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len > SORTING_NETWORK_MAX)
+    {
+        return SORT_ERROR_INVALID_LENGTH;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+
+    const network_t *net = &networks[arr_len];
+    switch (element_size)
+    {
+    case 4:
+        network_run_4((char *)arr, net, cmp, stats);
+        break;
+    case 8:
+        network_run_8((char *)arr, net, cmp, stats);
+        break;
+    case 16:
+        network_run_16((char *)arr, net, cmp, stats);
+        break;
+    default:
+        network_run_swap((char *)arr, element_size, net, cmp, stats);
+        break;
+    }
+    return SORT_SUCCESS;
+}
+
+/* ============================================================================
+ * int32 / float：标量版本
+ * ============================================================================
+ */
+
+static inline void minmax_int32(int32_t *a, int32_t *b)
+{
+    int32_t x = *a;
+    int32_t y = *b;
+    *a = x < y ? x : y;
+    *b = x < y ? y : x;
+}
+
+/**
+ * Batcher 归并交换网络(Knuth 5.2.2 算法 M)，适用于任意 n。
+ * 比较次数比最优网络多，只用于 17~32 个元素。
+ */
+static void merge_exchange_int32(int32_t *arr, size_t n)
+{
+    size_t t = 0;
+    while (((size_t)1 << t) < n)
+    {
+        t++;
+    }
+    for (size_t p = (size_t)1 << (t - 1); p > 0; p >>= 1)
+    {
+        size_t q = (size_t)1 << (t - 1);
+        size_t r = 0;
+        size_t d = p;
+        for (;;)
+        {
+            for (size_t i = 0; i + d < n; i++)
+            {
+                if ((i & p) == r)
+                {
+                    minmax_int32(&arr[i], &arr[i + d]);
+                }
+            }
+            if (q == p)
+            {
+                break;
+            }
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+}
+
+static void network_int32_scalar(int32_t *arr, size_t n)
+{
+    if (n > SORTING_NETWORK_MAX)
+    {
+        merge_exchange_int32(arr, n);
+        return;
+    }
+    const network_t *net = &networks[n];
+    for (size_t i = 0; i < net->count; i++)
+    {
+        minmax_int32(&arr[net->pairs[i][0]], &arr[net->pairs[i][1]]);
+    }
+}
+
+/* ============================================================================
+ * int32 / float：AVX2 寄存器内双调排序
+ * ============================================================================
+ */
+
+#if defined(SORTING_NETWORK_X86)
+
+#define NETWORK_AVX2 __attribute__((target("avx2")))
+
+/**
+ * 一层比较-交换：lane i 与 partner 中的对应 lane 比较，
+ * imm 中为 1 的 lane 取较大值，其余取较小值
+ */
+#define AVX2_LAYER(v, partner, imm)                                         \
+    do                                                                      \
+    {                                                                       \
+        __m256i p_ = (partner);                                             \
+        (v) = _mm256_blend_epi32(_mm256_min_epi32((v), p_), _mm256_max_epi32((v), p_), (imm)); \
+    } while (0)
+
+// 与相距 1/2/4 个 lane 的元素配对
+#define AVX2_PAIR1(v) _mm256_shuffle_epi32((v), _MM_SHUFFLE(2, 3, 0, 1))
+#define AVX2_PAIR2(v) _mm256_shuffle_epi32((v), _MM_SHUFFLE(1, 0, 3, 2))
+#define AVX2_PAIR4(v) _mm256_permute2x128_si256((v), (v), 1)
+
+/** 对双调序列做升序合并 */
+NETWORK_AVX2 static inline __m256i avx2_bitonic_merge8(__m256i v)
+{
+    AVX2_LAYER(v, AVX2_PAIR4(v), 0xF0);
+    AVX2_LAYER(v, AVX2_PAIR2(v), 0xCC);
+    AVX2_LAYER(v, AVX2_PAIR1(v), 0xAA);
+    return v;
+}
+
+/** 寄存器内 8 个元素的双调排序，共 6 层 */
+NETWORK_AVX2 static inline __m256i avx2_sort8(__m256i v)
+{
+    AVX2_LAYER(v, AVX2_PAIR1(v), 0x66);
+    AVX2_LAYER(v, AVX2_PAIR2(v), 0x3C);
+    AVX2_LAYER(v, AVX2_PAIR1(v), 0x5A);
+    return avx2_bitonic_merge8(v);
+}
+
+NETWORK_AVX2 static inline __m256i avx2_reverse8(__m256i v)
+{
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+/** 合并两个升序寄存器，*a 得到较小的 8 个，*b 得到较大的 8 个 */
+NETWORK_AVX2 static inline void avx2_merge16(__m256i *a, __m256i *b)
+{
+    __m256i rb = avx2_reverse8(*b);
+    __m256i lo = _mm256_min_epi32(*a, rb);
+    __m256i hi = _mm256_max_epi32(*a, rb);
+    *a = avx2_bitonic_merge8(lo);
+    *b = avx2_bitonic_merge8(hi);
+}
+
+/** 对 buf 的前 8/16/32 个元素排序，lanes 为其中之一 */
+NETWORK_AVX2 static void avx2_sort_int32(int32_t *buf, size_t lanes)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i *)buf);
+    a = avx2_sort8(a);
+    if (lanes == 8)
+    {
+        _mm256_storeu_si256((__m256i *)buf, a);
+        return;
+    }
+
+    __m256i b = _mm256_loadu_si256((const __m256i *)(buf + 8));
+    b = avx2_sort8(b);
+    avx2_merge16(&a, &b);
+    if (lanes == 16)
+    {
+        _mm256_storeu_si256((__m256i *)buf, a);
+        _mm256_storeu_si256((__m256i *)(buf + 8), b);
+        return;
+    }
+
+    __m256i c = _mm256_loadu_si256((const __m256i *)(buf + 16));
+    __m256i d = _mm256_loadu_si256((const __m256i *)(buf + 24));
+    c = avx2_sort8(c);
+    d = avx2_sort8(d);
+    avx2_merge16(&c, &d);
+
+    // [a, b] 与 [c, d] 各自升序：与逆序的 [d, c] 逐 lane 取 min/max，
+    // 得到较小 16 个和较大 16 个两个双调序列，再各自合并
+    __m256i rd = avx2_reverse8(d);
+    __m256i rc = avx2_reverse8(c);
+    __m256i l1 = _mm256_min_epi32(a, rd);
+    __m256i h1 = _mm256_max_epi32(a, rd);
+    __m256i l2 = _mm256_min_epi32(b, rc);
+    __m256i h2 = _mm256_max_epi32(b, rc);
+
+    a = avx2_bitonic_merge8(_mm256_min_epi32(l1, l2));
+    b = avx2_bitonic_merge8(_mm256_max_epi32(l1, l2));
+    c = avx2_bitonic_merge8(_mm256_min_epi32(h1, h2));
+    d = avx2_bitonic_merge8(_mm256_max_epi32(h1, h2));
+    _mm256_storeu_si256((__m256i *)buf, a);
+    _mm256_storeu_si256((__m256i *)(buf + 8), b);
+    _mm256_storeu_si256((__m256i *)(buf + 16), c);
+    _mm256_storeu_si256((__m256i *)(buf + 24), d);
+}
+
+#endif // SORTING_NETWORK_X86
+
+/**
+ * 排序 buf[0, n)，buf 至少有 SORTING_NETWORK_MAX_32BIT 个元素的空间。
+ * AVX2 路径把 n 补齐到 8/16/32，填充 INT32_MAX，排序后填充值都在末尾。
+ */
+static void sort_int32_buffer(int32_t *buf, size_t n)
+{
+#if defined(SORTING_NETWORK_X86)
+    if (sort_cpu_has_avx2())
+    {
+        size_t lanes = n <= 8 ? 8 : (n <= 16 ? 16 : 32);
+        for (size_t i = n; i < lanes; i++)
+        {
+            buf[i] = INT32_MAX;
+        }
+        avx2_sort_int32(buf, lanes);
+        return;
+    }
+#endif
+    network_int32_scalar(buf, n);
+}
+
+sort_result_t network_sort_int32(int32_t *arr, size_t arr_len)
+{
+    if (NULL == arr)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len > SORTING_NETWORK_MAX_32BIT)
+    {
+        return SORT_ERROR_INVALID_LENGTH;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+
+    int32_t buf[SORTING_NETWORK_MAX_32BIT];
+    memcpy(buf, arr, arr_len * sizeof(int32_t));
+    sort_int32_buffer(buf, arr_len);
+    memcpy(arr, buf, arr_len * sizeof(int32_t));
+    return SORT_SUCCESS;
+}
+
+/**
+ * float 位模式转为保序的 int32：负数翻转低 31 位，符号位不变，
+ * 按有符号整数比较即为全序。变换是自身的逆。
+ */
+static inline int32_t float_order_key(int32_t bits)
+{
+    return bits ^ (int32_t)((uint32_t)(bits >> 31) >> 1);
+}
+
+sort_result_t network_sort_float(float *arr, size_t arr_len)
+{
+    if (NULL == arr)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len > SORTING_NETWORK_MAX_32BIT)
+    {
+        return SORT_ERROR_INVALID_LENGTH;
+    }
+    if (arr_len <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+
+    int32_t buf[SORTING_NETWORK_MAX_32BIT];
+    memcpy(buf, arr, arr_len * sizeof(int32_t));
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        buf[i] = float_order_key(buf[i]);
+    }
+    sort_int32_buffer(buf, arr_len);
+    for (size_t i = 0; i < arr_len; i++)
+    {
+        buf[i] = float_order_key(buf[i]);
+    }
+    memcpy(arr, buf, arr_len * sizeof(int32_t));
+    return SORT_SUCCESS;
+}
@@ -0,0 +1,430 @@
+#include <stdlib.h>
+#include "sorting/string_sort.h"
+#include "util/scratch_arena.h"
+
+// 缓存键覆盖的字节数
+#define KEY_BYTES 8
+
+// MSD 基数排序的桶数：字符串结束 + 256 个字节值
+#define RADIX_BUCKETS 257
+
+typedef struct
+{
+    uint64_t key;             // 从当前深度开始的 KEY_BYTES 个字节，大端打包，不足补 0
+    const unsigned char *ptr;
+    size_t len;
+} str_entry_t;
+
+typedef struct
+{
+    str_entry_t *entries;
+    str_entry_t *tmp;
+    uint16_t *oracle;
+} radix_ctx_t;
+
+static inline uint64_t load_key(const unsigned char *p, size_t rem)
+{
+    if (rem >= KEY_BYTES)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        v = __builtin_bswap64(v);
+#elif !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        v = 0;
+        for (size_t i = 0; i < KEY_BYTES; i++)
+        {
+            v = (v << 8) | p[i];
+        }
+#endif
+        return v;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < rem; i++)
+    {
+        v = (v << 8) | p[i];
+    }
+    return rem == 0 ? 0 : v << (8 * (KEY_BYTES - rem));
+}
+
+static inline void load_keys(str_entry_t *e, size_t n, size_t depth)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        e[i].key = load_key(e[i].ptr + depth, e[i].len - depth);
+    }
+}
+
+/**
+ * 缓存键相同时区分剩余长度：0~8 表示字符串在缓存范围内结束(补的 0
+ * 与真实的 '\0' 由长度区分)，9 表示还有后续字节，需要进入下一个 8 字节。
+ */
+static inline size_t tail_class(const str_entry_t *e, size_t depth)
+{
+    size_t rem = e->len - depth;
+    return rem > KEY_BYTES ? KEY_BYTES + 1 : rem;
+}
+
+static inline int key_cmp(const str_entry_t *e, uint64_t key, size_t cls, size_t depth)
+{
+    if (e->key != key)
+    {
+        return e->key < key ? -1 : 1;
+    }
+    size_t c = tail_class(e, depth);
+    return (c > cls) - (c < cls);
+}
+
+/** 两个条目从 depth 开始的完整比较，depth 之前的字节已知相等 */
+static inline int entry_cmp(const str_entry_t *a, const str_entry_t *b, size_t depth)
+{
+    if (a->key != b->key)
+    {
+        return a->key < b->key ? -1 : 1;
+    }
+    size_t ra = a->len - depth;
+    size_t rb = b->len - depth;
+    if (ra > KEY_BYTES && rb > KEY_BYTES)
+    {
+        size_t m = (ra < rb ? ra : rb) - KEY_BYTES;
+        int c = memcmp(a->ptr + depth + KEY_BYTES, b->ptr + depth + KEY_BYTES, m);
+        if (c != 0)
+        {
+            return c;
+        }
+    }
+    // 缓存键相同且至少一方在缓存范围内结束：较短的是另一个的前缀
+    return (ra > rb) - (ra < rb);
+}
+
+static void insertion_sort_entries(str_entry_t *e, size_t n, size_t depth)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        str_entry_t cur = e[i];
+        size_t j = i;
+        while (j > 0 && entry_cmp(&cur, &e[j - 1], depth) < 0)
+        {
+            e[j] = e[j - 1];
+            j--;
+        }
+        e[j] = cur;
+    }
+}
+
+static inline void swap_entries(str_entry_t *a, str_entry_t *b)
+{
+    str_entry_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static inline str_entry_t *med3(str_entry_t *a, str_entry_t *b, str_entry_t *c, size_t depth)
+{
+    size_t cb = tail_class(b, depth);
+    int ab = key_cmp(a, b->key, cb, depth);
+    int cbc = key_cmp(c, b->key, cb, depth);
+    if ((ab <= 0 && cbc >= 0) || (ab >= 0 && cbc <= 0))
+    {
+        return b;
+    }
+    // b 是最大或最小值，中位数在 a 和 c 之间取
+    int ac = key_cmp(a, c->key, tail_class(c, depth), depth);
+    if (ab < 0)
+    {
+        return ac < 0 ? c : a;
+    }
+    return ac < 0 ? a : c;
+}
+
+/* ============================================================================
+ * 多键快速排序
+ * ============================================================================
+ */
+
+static void multikey_sort(str_entry_t *e, size_t n, size_t depth)
+{
+    for (;;)
+    {
+        if (n <= STRING_SORT_INSERTION_THRESHOLD)
+        {
+            insertion_sort_entries(e, n, depth);
+            return;
+        }
+
+        const str_entry_t *m = med3(e, e + n / 2, e + n - 1, depth);
+        uint64_t pivot_key = m->key;
+        size_t pivot_cls = tail_class(m, depth);
+
+        // 三路划分：[0, lt) 小于、[lt, gt) 等于、[gt, n) 大于枢轴
+        size_t lt = 0;
+        size_t i = 0;
+        size_t gt = n;
+        while (i < gt)
+        {
+            int c = key_cmp(&e[i], pivot_key, pivot_cls, depth);
+            if (c < 0)
+            {
+                swap_entries(&e[lt++], &e[i++]);
+            }
+            else if (c > 0)
+            {
+                swap_entries(&e[i], &e[--gt]);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        // 三段中最大的一段留在循环里处理，其余两段递归，递归深度为 O(log n)
+        str_entry_t *part[3] = {e, e + lt, e + gt};
+        size_t len[3] = {lt, gt - lt, n - gt};
+        size_t part_depth[3] = {depth, depth + KEY_BYTES, depth};
+        if (pivot_cls <= KEY_BYTES)
+        {
+            len[1] = 0; // 等于部分的字符串已经完全相同
+        }
+        else
+        {
+            load_keys(part[1], len[1], depth + KEY_BYTES);
+        }
+
+        size_t largest = 0;
+        for (size_t p = 1; p < 3; p++)
+        {
+            if (len[p] > len[largest])
+            {
+                largest = p;
+            }
+        }
+        for (size_t p = 0; p < 3; p++)
+        {
+            if (p != largest && len[p] > 1)
+            {
+                multikey_sort(part[p], len[p], part_depth[p]);
+            }
+        }
+        e = part[largest];
+        n = len[largest];
+        depth = part_depth[largest];
+    }
+}
+
+/* ============================================================================
+ * MSD 基数排序
+ * ============================================================================
+ */
+
+/** key_depth 为 e 中缓存键对应的深度，depth - key_depth 在 [0, KEY_BYTES] 内 */
+static void radix_sort_entries(const radix_ctx_t *ctx, str_entry_t *e, size_t n, size_t depth, size_t key_depth)
+{
+    for (;;)
+    {
+        if (n < STRING_SORT_RADIX_THRESHOLD)
+        {
+            if (key_depth != depth)
+            {
+                load_keys(e, n, depth);
+            }
+            multikey_sort(e, n, depth);
+            return;
+        }
+        if (depth - key_depth == KEY_BYTES)
+        {
+            load_keys(e, n, depth);
+            key_depth = depth;
+        }
+
+        size_t offset = (size_t)(e - ctx->entries);
+        uint16_t *oracle = ctx->oracle + offset;
+        unsigned shift = (unsigned)(8 * (KEY_BYTES - 1 - (depth - key_depth)));
+        size_t counts[RADIX_BUCKETS] = {0};
+        for (size_t i = 0; i < n; i++)
+        {
+            uint16_t b = e[i].len == depth ? 0 : (uint16_t)(((e[i].key >> shift) & 0xff) + 1);
+            oracle[i] = b;
+            counts[b]++;
+        }
+
+        // 所有字符串这一字节都相同：不分发，直接看下一个字节
+        if (counts[oracle[0]] == n)
+        {
+            if (oracle[0] == 0)
+            {
+                return;
+            }
+            depth++;
+            continue;
+        }
+
+        size_t starts[RADIX_BUCKETS];
+        size_t pos[RADIX_BUCKETS];
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            starts[b] = sum;
+            pos[b] = sum;
+            sum += counts[b];
+        }
+        str_entry_t *tmp = ctx->tmp + offset;
+        for (size_t i = 0; i < n; i++)
+        {
+            tmp[pos[oracle[i]]++] = e[i];
+        }
+        memcpy(e, tmp, n * sizeof(str_entry_t));
+
+        // 0 号桶的字符串已经结束，彼此相等
+        size_t largest = 1;
+        for (size_t b = 2; b < RADIX_BUCKETS; b++)
+        {
+            if (counts[b] > counts[largest])
+            {
+                largest = b;
+            }
+        }
+        for (size_t b = 1; b < RADIX_BUCKETS; b++)
+        {
+            if (b != largest && counts[b] > 1)
+            {
+                radix_sort_entries(ctx, e + starts[b], counts[b], depth + 1, key_depth);
+            }
+        }
+        if (counts[largest] <= 1)
+        {
+            return;
+        }
+        e += starts[largest];
+        n = counts[largest];
+        depth++;
+    }
+}
+
+/* ============================================================================
+ * 对外接口
+ * ============================================================================
+ */
+
+static sort_result_t sort_entries(str_entry_t *entries, size_t count, int radix)
+{
+    if (!radix)
+    {
+        multikey_sort(entries, count, 0);
+        return SORT_SUCCESS;
+    }
+    radix_ctx_t ctx;
+    ctx.entries = entries;
+    ctx.tmp = (str_entry_t *)scratch_alloc(count * sizeof(str_entry_t));
+    ctx.oracle = (uint16_t *)scratch_alloc(count * sizeof(uint16_t));
+    if (NULL == ctx.tmp || NULL == ctx.oracle)
+    {
+        scratch_free(ctx.tmp);
+        scratch_free(ctx.oracle);
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    radix_sort_entries(&ctx, entries, count, 0, 0);
+    scratch_free(ctx.tmp);
+    scratch_free(ctx.oracle);
+    return SORT_SUCCESS;
+}
+
+static sort_result_t sort_cstrings(char *strs[], size_t count, int radix)
+{
+    if (NULL == strs)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (count <= 1)
+    {
+        return (count == 1 && NULL == strs[0]) ? SORT_ERROR_NULL_POINTER : SORT_SUCCESS;
+    }
+    str_entry_t *entries = (str_entry_t *)scratch_alloc(count * sizeof(str_entry_t));
+    if (NULL == entries)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (NULL == strs[i])
+        {
+            scratch_free(entries);
+            return SORT_ERROR_NULL_POINTER;
+        }
+        entries[i].ptr = (const unsigned char *)strs[i];
+        entries[i].len = strlen(strs[i]);
+        entries[i].key = load_key(entries[i].ptr, entries[i].len);
+    }
+
+    sort_result_t ret = sort_entries(entries, count, radix);
+    if (SORT_SUCCESS == ret)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            strs[i] = (char *)entries[i].ptr;
+        }
+    }
+    scratch_free(entries);
+    return ret;
+}
+
+static sort_result_t sort_slices(string_slice_t slices[], size_t count, int radix)
+{
+    if (NULL == slices)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (NULL == slices[i].ptr && slices[i].len > 0)
+        {
+            return SORT_ERROR_NULL_POINTER;
+        }
+    }
+    if (count <= 1)
+    {
+        return SORT_SUCCESS;
+    }
+    str_entry_t *entries = (str_entry_t *)scratch_alloc(count * sizeof(str_entry_t));
+    if (NULL == entries)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i].ptr = (const unsigned char *)slices[i].ptr;
+        entries[i].len = slices[i].len;
+        entries[i].key = load_key(entries[i].ptr, entries[i].len);
+    }
+
+    sort_result_t ret = sort_entries(entries, count, radix);
+    if (SORT_SUCCESS == ret)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            slices[i].ptr = (const char *)entries[i].ptr;
+            slices[i].len = entries[i].len;
+        }
+    }
+    scratch_free(entries);
+    return ret;
+}
+
+sort_result_t string_multikey_sort(char *strs[], size_t count)
+{
+    return sort_cstrings(strs, count, 0);
+}
+
+sort_result_t string_radix_sort(char *strs[], size_t count)
+{
+    return sort_cstrings(strs, count, 1);
+}
+
+sort_result_t slice_multikey_sort(string_slice_t slices[], size_t count)
+{
+    return sort_slices(slices, count, 0);
+}
+
+sort_result_t slice_radix_sort(string_slice_t slices[], size_t count)
+{
+    return sort_slices(slices, count, 1);
+}
@@ -0,0 +1,723 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "sorting/tim_sort.h"
+#include "sorting/insertion_sort.h"
+#include "util/scratch_arena.h"
+
+#define TIM_SORT_STACK_TMP_SIZE 64
+// 栈不变式保证 run 长度至少按斐波那契数列增长，64 位下 85 层足够
+#define TIM_SORT_MAX_PENDING 85
+
+typedef struct
+{
+    char *arr;
+    size_t element_size;
+    compare_func_t *cmp;
+    sized_swap_func_t *swap;
+    void *tmp;
+    sort_stats_t *stats;
+
+    char *buf;        /**< 归并用辅助空间，按需增长 */
+    size_t buf_cap;   /**< 辅助空间容量(元素个数) */
+    size_t buf_limit; /**< 辅助空间容量上限，n / 2 */
+    size_t min_gallop;
+
+    size_t pending;
+    size_t run_base[TIM_SORT_MAX_PENDING];
+    size_t run_len[TIM_SORT_MAX_PENDING];
+} tim_sort_ctx_t;
+
+#define AT(ptr, i) ((ptr) + (i) * es)
+
+static size_t compute_min_run(size_t n)
+{
+    size_t r = 0;
+    while (n >= TIM_SORT_MIN_MERGE)
+    {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/**
+ * 返回从 lo 开始的 run 长度，严格降序的 run 原地翻转为升序
+ */
+static size_t count_run_and_make_ascending(tim_sort_ctx_t *ctx, size_t lo, size_t hi)
+{
+    const size_t es = ctx->element_size;
+    char *a = ctx->arr;
+    size_t run_hi = lo + 1;
+    if (run_hi == hi)
+    {
+        return 1;
+    }
+
+    if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(a, run_hi), AT(a, lo)) < 0)
+    {
+        run_hi++;
+        while (run_hi < hi && COUNTED_CMP(ctx->stats, ctx->cmp, AT(a, run_hi), AT(a, run_hi - 1)) < 0)
+        {
+            run_hi++;
+        }
+        for (size_t i = lo, j = run_hi - 1; i < j; i++, j--)
+        {
+            ctx->swap(AT(a, i), AT(a, j), es);
+            INCRE_MOVEMENTS_BY(ctx->stats, 2);
+        }
+    }
+    else
+    {
+        run_hi++;
+        while (run_hi < hi && COUNTED_CMP(ctx->stats, ctx->cmp, AT(a, run_hi), AT(a, run_hi - 1)) >= 0)
+        {
+            run_hi++;
+        }
+    }
+    return run_hi - lo;
+}
+
+/**
+ * 在有序的 base[0, n) 中查找 key 的最左插入位置 k：base[k-1] < key <= base[k]。
+ * 从 hint 出发做指数搜索，再在最后一段内二分。
+ */
+static size_t gallop_left(const tim_sort_ctx_t *ctx, const void *key, const char *base, size_t n, size_t hint)
+{
+    const size_t es = ctx->element_size;
+    ptrdiff_t last_ofs = 0;
+    ptrdiff_t ofs = 1;
+
+    if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(base, hint), key) < 0)
+    {
+        // base[hint] < key，向右搜索直到 base[hint + last_ofs] < key <= base[hint + ofs]
+        const ptrdiff_t max_ofs = (ptrdiff_t)(n - hint);
+        while (ofs < max_ofs && COUNTED_CMP(ctx->stats, ctx->cmp, AT(base, hint + ofs), key) < 0)
+        {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+            {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs)
+        {
+            ofs = max_ofs;
+        }
+        last_ofs += (ptrdiff_t)hint;
+        ofs += (ptrdiff_t)hint;
+    }
+    else
+    {
+        // key <= base[hint]，向左搜索直到 base[hint - ofs] < key <= base[hint - last_ofs]
+        const ptrdiff_t max_ofs = (ptrdiff_t)hint + 1;
+        while (ofs < max_ofs && COUNTED_CMP(ctx->stats, ctx->cmp, AT(base, hint - ofs), key) >= 0)
+        {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+            {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs)
+        {
+            ofs = max_ofs;
+        }
+        ptrdiff_t t = last_ofs;
+        last_ofs = (ptrdiff_t)hint - ofs;
+        ofs = (ptrdiff_t)hint - t;
+    }
+
+    // 此时 base[last_ofs] < key <= base[ofs]，last_ofs 可能为 -1
+    last_ofs++;
+    while (last_ofs < ofs)
+    {
+        ptrdiff_t m = last_ofs + ((ofs - last_ofs) >> 1);
+        if (COUNTED_CMP(ctx->stats, ctx->cmp, AT(base, m), key) < 0)
+        {
+            last_ofs = m + 1;
+        }
+        else
+        {
+            ofs = m;
+        }
+    }
+    return (size_t)ofs;
+}
+
+/**
+ * 同 gallop_left，但返回最右插入位置 k：base[k-1] <= key < base[k]。
+ */
+static size_t gallop_right(const tim_sort_ctx_t *ctx, const void *key, const char *base, size_t n, size_t hint)
+{
+    const size_t es = ctx->element_size;
+    ptrdiff_t last_ofs = 0;
+    ptrdiff_t ofs = 1;
+
+    if (COUNTED_CMP(ctx->stats, ctx->cmp, key, AT(base, hint)) < 0)
+    {
+        // key < base[hint]，向左搜索
+        const ptrdiff_t max_ofs = (ptrdiff_t)hint + 1;
+        while (ofs < max_ofs && COUNTED_CMP(ctx->stats, ctx->cmp, key, AT(base, hint - ofs)) < 0)
+        {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+            {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs)
+        {
+            ofs = max_ofs;
+        }
+        ptrdiff_t t = last_ofs;
+        last_ofs = (ptrdiff_t)hint - ofs;
+        ofs = (ptrdiff_t)hint - t;
+    }
+    else
+    {
+        // base[hint] <= key，向右搜索
+        const ptrdiff_t max_ofs = (ptrdiff_t)(n - hint);
+        while (ofs < max_ofs && COUNTED_CMP(ctx->stats, ctx->cmp, key, AT(base, hint + ofs)) >= 0)
+        {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+            {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs)
+        {
+            ofs = max_ofs;
+        }
+        last_ofs += (ptrdiff_t)hint;
+        ofs += (ptrdiff_t)hint;
+    }
+
+    // 此时 base[last_ofs] <= key < base[ofs]
+    last_ofs++;
+    while (last_ofs < ofs)
+    {
+        ptrdiff_t m = last_ofs + ((ofs - last_ofs) >> 1);
+        if (COUNTED_CMP(ctx->stats, ctx->cmp, key, AT(base, m)) < 0)
+        {
+            ofs = m;
+        }
+        else
+        {
+            last_ofs = m + 1;
+        }
+    }
+    return (size_t)ofs;
+}
+
+static sort_result_t ensure_buffer(tim_sort_ctx_t *ctx, size_t need)
+{
+    if (ctx->buf_cap >= need)
+    {
+        return SORT_SUCCESS;
+    }
+    size_t new_cap = ctx->buf_cap > 0 ? ctx->buf_cap : 256;
+    while (new_cap < need)
+    {
+        new_cap <<= 1;
+    }
+    if (new_cap > ctx->buf_limit)
+    {
+        new_cap = need > ctx->buf_limit ? need : ctx->buf_limit;
+    }
+    char *new_buf = (char *)scratch_alloc(new_cap * ctx->element_size);
+    if (NULL == new_buf)
+    {
+        return SORT_ERROR_ALLOCATION_FAILED;
+    }
+    // 旧内容不需要保留
+    scratch_free(ctx->buf);
+    DECRE_MEMORY_USED(ctx->stats, ctx->buf_cap * ctx->element_size);
+    ctx->buf = new_buf;
+    ctx->buf_cap = new_cap;
+    INCRE_MEMORY_USED(ctx->stats, new_cap * ctx->element_size);
+    return SORT_SUCCESS;
+}
+
+/**
+ * 归并相邻的 run1 = [base1, base1 + len1) 和 run2 = [base2, base2 + len2)，
+ * len1 <= len2。调用前已保证 run1 首元素大于 run2 首元素、run1 末元素
+ * 大于 run2 末元素。把 run1 复制到辅助空间，从左向右归并。
+ */
+static sort_result_t merge_lo(tim_sort_ctx_t *ctx, size_t base1, size_t len1, size_t base2, size_t len2)
+{
+    const size_t es = ctx->element_size;
+    sort_result_t res = ensure_buffer(ctx, len1);
+    if (res != SORT_SUCCESS)
+    {
+        return res;
+    }
+    memcpy(ctx->buf, AT(ctx->arr, base1), len1 * es);
+
+    char *cursor1 = ctx->buf;
+    char *cursor2 = AT(ctx->arr, base2);
+    char *dest = AT(ctx->arr, base1);
+
+    memcpy(dest, cursor2, es);
+    dest += es;
+    cursor2 += es;
+    if (--len2 == 0)
+    {
+        memcpy(dest, cursor1, len1 * es);
+        return SORT_SUCCESS;
+    }
+    if (len1 == 1)
+    {
+        memmove(dest, cursor2, len2 * es);
+        memcpy(AT(dest, len2), cursor1, es);
+        return SORT_SUCCESS;
+    }
+
+    size_t min_gallop = ctx->min_gallop;
+    for (;;)
+    {
+        size_t count1 = 0; // run1 连续胜出的次数
+        size_t count2 = 0; // run2 连续胜出的次数
+
+        // 逐个比较归并，直到某一侧连续胜出 min_gallop 次
+        do
+        {
+            if (COUNTED_CMP(ctx->stats, ctx->cmp, cursor2, cursor1) < 0)
+            {
+                memcpy(dest, cursor2, es);
+                dest += es;
+                cursor2 += es;
+                count2++;
+                count1 = 0;
+                if (--len2 == 0)
+                {
+                    goto done;
+                }
+            }
+            else
+            {
+                memcpy(dest, cursor1, es);
+                dest += es;
+                cursor1 += es;
+                count1++;
+                count2 = 0;
+                if (--len1 == 1)
+                {
+                    goto copy_b;
+                }
+            }
+        } while ((count1 | count2) < min_gallop);
+
+        // galloping 模式：用指数搜索找出可以整块移动的长度
+        do
+        {
+            count1 = gallop_right(ctx, cursor2, cursor1, len1, 0);
+            if (count1 != 0)
+            {
+                memcpy(dest, cursor1, count1 * es);
+                dest += count1 * es;
+                cursor1 += count1 * es;
+                len1 -= count1;
+                if (len1 == 1)
+                {
+                    goto copy_b;
+                }
+                if (len1 == 0)
+                {
+                    // 只有比较函数不满足全序时才会发生
+                    goto done;
+                }
+            }
+            memcpy(dest, cursor2, es);
+            dest += es;
+            cursor2 += es;
+            if (--len2 == 0)
+            {
+                goto done;
+            }
+
+            count2 = gallop_left(ctx, cursor1, cursor2, len2, 0);
+            if (count2 != 0)
+            {
+                memmove(dest, cursor2, count2 * es);
+                dest += count2 * es;
+                cursor2 += count2 * es;
+                len2 -= count2;
+                if (len2 == 0)
+                {
+                    goto done;
+                }
+            }
+            memcpy(dest, cursor1, es);
+            dest += es;
+            cursor1 += es;
+            if (--len1 == 1)
+            {
+                goto copy_b;
+            }
+            if (min_gallop > 1)
+            {
+                min_gallop--;
+            }
+        } while (count1 >= TIM_SORT_MIN_GALLOP || count2 >= TIM_SORT_MIN_GALLOP);
+        // 退出 galloping 后提高再次进入的门槛
+        min_gallop += 2;
+    }
+
+done:
+    ctx->min_gallop = min_gallop;
+    if (len1 != 0)
+    {
+        memcpy(dest, cursor1, len1 * es);
+    }
+    return SORT_SUCCESS;
+
+copy_b:
+    // run1 只剩最后一个元素，它大于 run2 剩余的所有元素
+    ctx->min_gallop = min_gallop;
+    memmove(dest, cursor2, len2 * es);
+    memcpy(AT(dest, len2), cursor1, es);
+    return SORT_SUCCESS;
+}
+
+/**
+ * 同 merge_lo，用于 len1 > len2：把 run2 复制到辅助空间，从右向左归并。
+ */
+static sort_result_t merge_hi(tim_sort_ctx_t *ctx, size_t base1, size_t len1, size_t base2, size_t len2)
+{
+    const size_t es = ctx->element_size;
+    sort_result_t res = ensure_buffer(ctx, len2);
+    if (res != SORT_SUCCESS)
+    {
+        return res;
+    }
+    memcpy(ctx->buf, AT(ctx->arr, base2), len2 * es);
+
+    char *const run1_base = AT(ctx->arr, base1);
+    char *cursor1 = AT(ctx->arr, base1 + len1 - 1);
+    char *cursor2 = AT(ctx->buf, len2 - 1);
+    char *dest = AT(ctx->arr, base2 + len2 - 1);
+
+    memcpy(dest, cursor1, es);
+    dest -= es;
+    cursor1 -= es;
+    if (--len1 == 0)
+    {
+        memcpy(dest - (len2 - 1) * es, ctx->buf, len2 * es);
+        return SORT_SUCCESS;
+    }
+    if (len2 == 1)
+    {
+        dest -= len1 * es;
+        cursor1 -= len1 * es;
+        memmove(dest + es, cursor1 + es, len1 * es);
+        memcpy(dest, cursor2, es);
+        return SORT_SUCCESS;
+    }
+
+    size_t min_gallop = ctx->min_gallop;
+    for (;;)
+    {
+        size_t count1 = 0;
+        size_t count2 = 0;
+
+        do
+        {
+            if (COUNTED_CMP(ctx->stats, ctx->cmp, cursor2, cursor1) < 0)
+            {
+                memcpy(dest, cursor1, es);
+                dest -= es;
+                cursor1 -= es;
+                count1++;
+                count2 = 0;
+                if (--len1 == 0)
+                {
+                    goto done;
+                }
+            }
+            else
+            {
+                memcpy(dest, cursor2, es);
+                dest -= es;
+                cursor2 -= es;
+                count2++;
+                count1 = 0;
+                if (--len2 == 1)
+                {
+                    goto copy_a;
+                }
+            }
+        } while ((count1 | count2) < min_gallop);
+
+        do
+        {
+            // run1 中大于 *cursor2 的元素整块右移
+            count1 = len1 - gallop_right(ctx, cursor2, run1_base, len1, len1 - 1);
+            if (count1 != 0)
+            {
+                dest -= count1 * es;
+                cursor1 -= count1 * es;
+                len1 -= count1;
+                memmove(dest + es, cursor1 + es, count1 * es);
+                if (len1 == 0)
+                {
+                    goto done;
+                }
+            }
+            memcpy(dest, cursor2, es);
+            dest -= es;
+            cursor2 -= es;
+            if (--len2 == 1)
+            {
+                goto copy_a;
+            }
+
+            // 辅助空间中不小于 *cursor1 的元素整块复制
+            count2 = len2 - gallop_left(ctx, cursor1, ctx->buf, len2, len2 - 1);
+            if (count2 != 0)
+            {
+                dest -= count2 * es;
+                cursor2 -= count2 * es;
+                len2 -= count2;
+                memcpy(dest + es, cursor2 + es, count2 * es);
+                if (len2 == 1)
+                {
+                    goto copy_a;
+                }
+                if (len2 == 0)
+                {
+                    // 只有比较函数不满足全序时才会发生
+                    goto done;
+                }
+            }
+            memcpy(dest, cursor1, es);
+            dest -= es;
+            cursor1 -= es;
+            if (--len1 == 0)
+            {
+                goto done;
+            }
+            if (min_gallop > 1)
+            {
+                min_gallop--;
+            }
+        } while (count1 >= TIM_SORT_MIN_GALLOP || count2 >= TIM_SORT_MIN_GALLOP);
+        min_gallop += 2;
+    }
+
+done:
+    ctx->min_gallop = min_gallop;
+    if (len2 != 0)
+    {
+        memcpy(dest - (len2 - 1) * es, ctx->buf, len2 * es);
+    }
+    return SORT_SUCCESS;
+
+copy_a:
+    // 辅助空间只剩第一个元素，它小于等于 run1 剩余的所有元素
+    ctx->min_gallop = min_gallop;
+    dest -= len1 * es;
+    cursor1 -= len1 * es;
+    memmove(dest + es, cursor1 + es, len1 * es);
+    memcpy(dest, cursor2, es);
+    return SORT_SUCCESS;
+}
+
+/** 归并栈上第 i 和 i + 1 个 run */
+static sort_result_t merge_at(tim_sort_ctx_t *ctx, size_t i)
+{
+    const size_t es = ctx->element_size;
+    size_t base1 = ctx->run_base[i];
+    size_t len1 = ctx->run_len[i];
+    size_t base2 = ctx->run_base[i + 1];
+    size_t len2 = ctx->run_len[i + 1];
+
+    ctx->run_len[i] = len1 + len2;
+    if (i + 3 == ctx->pending)
+    {
+        ctx->run_base[i + 1] = ctx->run_base[i + 2];
+        ctx->run_len[i + 1] = ctx->run_len[i + 2];
+    }
+    ctx->pending--;
+
+    // run1 中不大于 run2 首元素的前缀已经就位
+    size_t k = gallop_right(ctx, AT(ctx->arr, base2), AT(ctx->arr, base1), len1, 0);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0)
+    {
+        return SORT_SUCCESS;
+    }
+
+    // run2 中不小于 run1 末元素的后缀已经就位
+    len2 = gallop_left(ctx, AT(ctx->arr, base1 + len1 - 1), AT(ctx->arr, base2), len2, len2 - 1);
+    if (len2 == 0)
+    {
+        return SORT_SUCCESS;
+    }
+
+    // 较短的一段复制到辅助空间，区间内每个元素再写回一次
+    INCRE_MOVEMENTS_BY(ctx->stats, len1 + len2 + (len1 <= len2 ? len1 : len2));
+    return len1 <= len2 ? merge_lo(ctx, base1, len1, base2, len2)
+                        : merge_hi(ctx, base1, len1, base2, len2);
+}
+
+/**
+ * 恢复栈不变式。同时检查栈顶下方两层，避免原始 TimSort 只检查栈顶三个
+ * run 时不变式仍可能被破坏的问题。
+ */
+static sort_result_t merge_collapse(tim_sort_ctx_t *ctx)
+{
+    size_t *len = ctx->run_len;
+    while (ctx->pending > 1)
+    {
+        size_t n = ctx->pending - 2;
+        if ((n > 0 && len[n - 1] <= len[n] + len[n + 1]) ||
+            (n > 1 && len[n - 2] <= len[n - 1] + len[n]))
+        {
+            if (len[n - 1] < len[n + 1])
+            {
+                n--;
+            }
+        }
+        else if (len[n] > len[n + 1])
+        {
+            break;
+        }
+        sort_result_t res = merge_at(ctx, n);
+        if (res != SORT_SUCCESS)
+        {
+            return res;
+        }
+    }
+    return SORT_SUCCESS;
+}
+
+static sort_result_t merge_force_collapse(tim_sort_ctx_t *ctx)
+{
+    size_t *len = ctx->run_len;
+    while (ctx->pending > 1)
+    {
+        size_t n = ctx->pending - 2;
+        if (n > 0 && len[n - 1] < len[n + 1])
+        {
+            n--;
+        }
+        sort_result_t res = merge_at(ctx, n);
+        if (res != SORT_SUCCESS)
+        {
+            return res;
+        }
+    }
+    return SORT_SUCCESS;
+}
+
+static sort_result_t tim_sort_impl(tim_sort_ctx_t *ctx, size_t n)
+{
+    const size_t es = ctx->element_size;
+
+    if (n < TIM_SORT_MIN_MERGE)
+    {
+        size_t init_run = count_run_and_make_ascending(ctx, 0, n);
+        return generic_binary_insertion_sort_with_buffer_ex(ctx->arr, n, es, ctx->cmp, init_run, ctx->tmp, ctx->stats);
+    }
+
+    const size_t min_run = compute_min_run(n);
+    size_t lo = 0;
+    while (lo < n)
+    {
+        size_t run_len = count_run_and_make_ascending(ctx, lo, n);
+        if (run_len < min_run)
+        {
+            size_t force = n - lo < min_run ? n - lo : min_run;
+            generic_binary_insertion_sort_with_buffer_ex(AT(ctx->arr, lo), force, es, ctx->cmp, run_len, ctx->tmp, ctx->stats);
+            run_len = force;
+        }
+
+        ctx->run_base[ctx->pending] = lo;
+        ctx->run_len[ctx->pending] = run_len;
+        ctx->pending++;
+        sort_result_t res = merge_collapse(ctx);
+        if (res != SORT_SUCCESS)
+        {
+            return res;
+        }
+        lo += run_len;
+    }
+    return merge_force_collapse(ctx);
+}
+
+sort_result_t generic_tim_sort(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp)
+{
+    return generic_tim_sort_ex(arr, arr_len, element_size, cmp, NULL);
+}
+
+sort_result_t generic_tim_sort_ex(
+    void *arr,
+    size_t arr_len,
+    size_t element_size,
+    compare_func_t cmp,
+    sort_stats_t *stats)
+{
+    START_TIMMING(stats);
+    RECORD_ELEMENT_SIZE(stats, element_size);
+    RECORD_ARR_LEN(stats, arr_len);
+    if (NULL == arr || NULL == cmp)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (element_size == 0)
+    {
+        return SORT_ERROR_INVALID_ELEMENT_SIZE;
+    }
+    if (arr_len <= 1)
+    {
+        STOP_TIMMING(stats);
+        return SORT_SUCCESS;
+    }
+
+    char stack_tmp[TIM_SORT_STACK_TMP_SIZE];
+    void *tmp = stack_tmp;
+    if (element_size > TIM_SORT_STACK_TMP_SIZE)
+    {
+        tmp = scratch_alloc(element_size);
+        if (NULL == tmp)
+        {
+            return SORT_ERROR_ALLOCATION_FAILED;
+        }
+        INCRE_MEMORY_USED(stats, element_size);
+    }
+
+    tim_sort_ctx_t ctx;
+    ctx.arr = (char *)arr;
+    ctx.element_size = element_size;
+    ctx.cmp = cmp;
+    ctx.swap = select_swap_func(element_size);
+    ctx.tmp = tmp;
+    ctx.stats = stats;
+    ctx.buf = NULL;
+    ctx.buf_cap = 0;
+    ctx.buf_limit = arr_len / 2;
+    ctx.min_gallop = TIM_SORT_MIN_GALLOP;
+    ctx.pending = 0;
+
+    sort_result_t res = tim_sort_impl(&ctx, arr_len);
+
+    scratch_free(ctx.buf);
+    DECRE_MEMORY_USED(stats, ctx.buf_cap * element_size);
+    if (tmp != stack_tmp)
+    {
+        scratch_free(tmp);
+        DECRE_MEMORY_USED(stats, element_size);
+    }
+    STOP_TIMMING(stats);
+    return res;
+}
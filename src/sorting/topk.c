@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include "sorting/topk.h"
+#include "sorting/quick_sort.h"
+
+struct topk
+{
+    char *heap; // 按 cmp 的大顶堆，heap[0] 是门槛
+    size_t size;
+    size_t capacity;
+    size_t element_size;
+    compare_func_t *cmp;
+};
+
+/**
+ * 把 elem 放到以 hole 为根的子树里：较大的孩子逐层上移填洞，
+ * 最后把 elem 拷进洞里。elem 在堆外，不需要暂存空间。
+ */
+static void sift_down_from(topk_t *topk, size_t hole, const void *elem)
+{
+    size_t es = topk->element_size;
+    size_t n = topk->size;
+    for (;;)
+    {
+        size_t child = 2 * hole + 1;
+        if (child >= n)
+        {
+            break;
+        }
+        if (child + 1 < n && topk->cmp(INDEX_OF(topk->heap, es, child), INDEX_OF(topk->heap, es, child + 1)) < 0)
+        {
+            child++;
+        }
+        if (topk->cmp(elem, INDEX_OF(topk->heap, es, child)) >= 0)
+        {
+            break;
+        }
+        memcpy(INDEX_OF(topk->heap, es, hole), INDEX_OF(topk->heap, es, child), es);
+        hole = child;
+    }
+    memcpy(INDEX_OF(topk->heap, es, hole), elem, es);
+}
+
+/** 把 elem 追加到堆尾并上浮，调用前 size 已包含新位置 */
+static void sift_up_from(topk_t *topk, size_t hole, const void *elem)
+{
+    size_t es = topk->element_size;
+    while (hole > 0)
+    {
+        size_t parent = (hole - 1) / 2;
+        if (topk->cmp(INDEX_OF(topk->heap, es, parent), elem) >= 0)
+        {
+            break;
+        }
+        memcpy(INDEX_OF(topk->heap, es, hole), INDEX_OF(topk->heap, es, parent), es);
+        hole = parent;
+    }
+    memcpy(INDEX_OF(topk->heap, es, hole), elem, es);
+}
+
+/** 自底向上建堆，与堆排序相同，用交换下沉 */
+static void heapify(topk_t *topk)
+{
+    size_t es = topk->element_size;
+    size_t n = topk->size;
+    sized_swap_func_t *swap = select_swap_func(es);
+    for (size_t i = n / 2; i > 0; i--)
+    {
+        size_t root = i - 1;
+        for (;;)
+        {
+            size_t child = 2 * root + 1;
+            if (child >= n)
+            {
+                break;
+            }
+            if (child + 1 < n && topk->cmp(INDEX_OF(topk->heap, es, child), INDEX_OF(topk->heap, es, child + 1)) < 0)
+            {
+                child++;
+            }
+            if (topk->cmp(INDEX_OF(topk->heap, es, root), INDEX_OF(topk->heap, es, child)) >= 0)
+            {
+                break;
+            }
+            swap(INDEX_OF(topk->heap, es, root), INDEX_OF(topk->heap, es, child), es);
+            root = child;
+        }
+    }
+}
+
+static inline void offer(topk_t *topk, const void *elem)
+{
+    if (topk->cmp(elem, topk->heap) < 0)
+    {
+        sift_down_from(topk, 0, elem);
+    }
+}
+
+topk_t *topk_create(size_t k, size_t element_size, compare_func_t cmp)
+{
+    if (NULL == cmp || element_size == 0 || (k > 0 && element_size > SIZE_MAX / k))
+    {
+        return NULL;
+    }
+    topk_t *topk = (topk_t *)calloc(1, sizeof(topk_t));
+    if (NULL == topk)
+    {
+        return NULL;
+    }
+    if (k > 0)
+    {
+        topk->heap = (char *)malloc(k * element_size);
+        if (NULL == topk->heap)
+        {
+            free(topk);
+            return NULL;
+        }
+    }
+    topk->capacity = k;
+    topk->element_size = element_size;
+    topk->cmp = cmp;
+    return topk;
+}
+
+void topk_destroy(topk_t *topk)
+{
+    if (NULL == topk)
+    {
+        return;
+    }
+    free(topk->heap);
+    free(topk);
+}
+
+void topk_clear(topk_t *topk)
+{
+    if (NULL != topk)
+    {
+        topk->size = 0;
+    }
+}
+
+size_t topk_size(const topk_t *topk)
+{
+    return NULL == topk ? 0 : topk->size;
+}
+
+size_t topk_capacity(const topk_t *topk)
+{
+    return NULL == topk ? 0 : topk->capacity;
+}
+
+const void *topk_threshold(const topk_t *topk)
+{
+    if (NULL == topk || topk->capacity == 0 || topk->size < topk->capacity)
+    {
+        return NULL;
+    }
+    return topk->heap;
+}
+
+sort_result_t topk_push(topk_t *topk, const void *elem)
+{
+    if (NULL == topk || NULL == elem)
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (topk->size < topk->capacity)
+    {
+        topk->size++;
+        sift_up_from(topk, topk->size - 1, elem);
+    }
+    else if (topk->capacity > 0)
+    {
+        offer(topk, elem);
+    }
+    return SORT_SUCCESS;
+}
+
+sort_result_t topk_push_batch(topk_t *topk, const void *arr, size_t arr_len)
+{
+    if (NULL == topk || (NULL == arr && arr_len > 0))
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (arr_len == 0)
+    {
+        return SORT_SUCCESS;
+    }
+    size_t es = topk->element_size;
+    const char *cur = (const char *)arr;
+    const char *end = cur + arr_len * es;
+
+    size_t room = topk->capacity - topk->size;
+    if (room > 0)
+    {
+        size_t take = room < arr_len ? room : arr_len;
+        if (topk->size == 0)
+        {
+            // 空堆整段拷贝后 O(k) 建堆，比逐个上浮的 O(k log k) 少
+            memcpy(topk->heap, cur, take * es);
+            topk->size = take;
+            heapify(topk);
+        }
+        else
+        {
+            for (size_t i = 0; i < take; i++)
+            {
+                topk->size++;
+                sift_up_from(topk, topk->size - 1, cur + i * es);
+            }
+        }
+        cur += take * es;
+    }
+
+    if (topk->capacity == 0)
+    {
+        return SORT_SUCCESS;
+    }
+    for (; cur < end; cur += es)
+    {
+        offer(topk, cur);
+    }
+    return SORT_SUCCESS;
+}
+
+sort_result_t topk_result(const topk_t *topk, void *out, size_t *out_len)
+{
+    if (NULL == topk || (NULL == out && topk->size > 0))
+    {
+        return SORT_ERROR_NULL_POINTER;
+    }
+    if (NULL != out_len)
+    {
+        *out_len = topk->size;
+    }
+    if (topk->size == 0)
+    {
+        return SORT_SUCCESS;
+    }
+    memcpy(out, topk->heap, topk->size * topk->element_size);
+    return generic_quick_sort(out, topk->size, topk->element_size, topk->cmp);
+}
@@ -0,0 +1,503 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "util/scratch_arena.h"
+
+// AddressSanitizer 看不到 mmap 上自己管理的块，手动标记未分配的部分，
+// 越界和释放后使用仍能被发现
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) && !defined(__SANITIZE_ADDRESS__)
+#define __SANITIZE_ADDRESS__ 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/asan_interface.h>
+#define SCRATCH_POISON(addr, size) ASAN_POISON_MEMORY_REGION((addr), (size))
+#define SCRATCH_UNPOISON(addr, size) ASAN_UNPOISON_MEMORY_REGION((addr), (size))
+#else
+#define SCRATCH_POISON(addr, size) ((void)(addr), (void)(size))
+#define SCRATCH_UNPOISON(addr, size) ((void)(addr), (void)(size))
+#endif
+
+// 块头放在每个块的开头，返回给调用者的地址紧跟其后，保持 16 字节对齐
+#define SCRATCH_HEADER_SIZE 16
+// 最小的块(含块头)，空闲时块头之后存放链表指针
+#define SCRATCH_MIN_BLOCK 64
+// 每个 2 的幂分成 4 个大小级别，级别大小比申请大小最多多 25%
+#define SCRATCH_CLASSES_PER_DOUBLING 4
+#define SCRATCH_NUM_CLASSES (SCRATCH_CLASSES_PER_DOUBLING * 64)
+
+// 小块从这么大的 chunk 中顺序切出，正好是两个透明大页
+#define SCRATCH_CHUNK_SIZE ((size_t)4 << 20)
+// 超过该大小的块单独映射
+#define SCRATCH_SMALL_MAX (SCRATCH_CHUNK_SIZE / 8)
+#define SCRATCH_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+typedef struct
+{
+    scratch_arena_t *arena;
+    size_t size_class;
+} block_header_t;
+
+_Static_assert(sizeof(block_header_t) <= SCRATCH_HEADER_SIZE, "block header too large");
+
+/** chunk 的开头，chunk 之间用链表串起来以便销毁 */
+typedef struct chunk
+{
+    struct chunk *next;
+    size_t size;
+} chunk_t;
+
+#define CHUNK_HEADER_SIZE ((sizeof(chunk_t) + 15) & ~(size_t)15)
+
+struct scratch_arena
+{
+    // 各大小级别的空闲块，链表指针存放在块头之后
+    void *free_lists[SCRATCH_NUM_CLASSES];
+    // 当前 chunk 中还未切出的部分
+    char *bump;
+    char *bump_end;
+    chunk_t *chunks;
+    // 其他线程释放的块，无锁压栈，由使用 arena 的线程整体取走
+    void *remote;
+    size_t reserved;
+    size_t limit;
+    // 空闲链表中单独映射的大块合计字节数，受 cache_limit 约束
+    size_t cached_large;
+    scratch_arena_t *next_orphan;
+};
+
+// 线程自己的 arena(首次申请时创建) / scratch_arena_use 指定的 arena
+static _Thread_local scratch_arena_t *tls_arena = NULL;
+static _Thread_local scratch_arena_t *tls_user_arena = NULL;
+
+static size_t total_reserved = 0;
+static size_t global_limit = 0;
+static size_t cache_limit = SCRATCH_DEFAULT_CACHE_LIMIT;
+static int huge_pages = 0;
+
+// 已退出线程留下的 arena，新线程优先复用
+static pthread_mutex_t orphan_lock = PTHREAD_MUTEX_INITIALIZER;
+static scratch_arena_t *orphans = NULL;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_key;
+
+/* ============================================================================
+ * 大小级别
+ * ============================================================================
+ */
+
+static inline size_t floor_log2(size_t n)
+{
+    return sizeof(unsigned long long) * 8 - 1 - (size_t)__builtin_clzll((unsigned long long)n);
+}
+
+/** 能放下 size 字节(含块头)的最小级别 */
+static inline size_t class_of(size_t size)
+{
+    if (size <= SCRATCH_MIN_BLOCK)
+    {
+        return 0;
+    }
+    size_t lg = floor_log2(size - 1);
+    size_t sub = ((size - 1) >> (lg - 2)) & (SCRATCH_CLASSES_PER_DOUBLING - 1);
+    return (lg - 6) * SCRATCH_CLASSES_PER_DOUBLING + sub + 1;
+}
+
+static inline size_t class_size(size_t cls)
+{
+    if (0 == cls)
+    {
+        return SCRATCH_MIN_BLOCK;
+    }
+    size_t lg = (cls - 1) / SCRATCH_CLASSES_PER_DOUBLING + 6;
+    size_t sub = (cls - 1) % SCRATCH_CLASSES_PER_DOUBLING;
+    return ((size_t)1 << lg) + (sub + 1) * ((size_t)1 << (lg - 2));
+}
+
+static inline void **next_of(void *block)
+{
+    return (void **)((char *)block + SCRATCH_HEADER_SIZE);
+}
+
+/* ============================================================================
+ * 映射与上限
+ * ============================================================================
+ */
+
+static void *map_memory(scratch_arena_t *arena, size_t size)
+{
+    if (0 != arena->limit && arena->reserved + size > arena->limit)
+    {
+        return NULL;
+    }
+    size_t limit = __atomic_load_n(&global_limit, __ATOMIC_RELAXED);
+    size_t total = __atomic_add_fetch(&total_reserved, size, __ATOMIC_RELAXED);
+    if (0 != limit && total > limit)
+    {
+        __atomic_sub_fetch(&total_reserved, size, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == mem)
+    {
+        __atomic_sub_fetch(&total_reserved, size, __ATOMIC_RELAXED);
+        return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (size >= SCRATCH_HUGE_PAGE_SIZE && __atomic_load_n(&huge_pages, __ATOMIC_RELAXED))
+    {
+        madvise(mem, size, MADV_HUGEPAGE);
+    }
+#endif
+    __atomic_store_n(&arena->reserved, arena->reserved + size, __ATOMIC_RELAXED);
+    return mem;
+}
+
+static void unmap_memory(scratch_arena_t *arena, void *mem, size_t size)
+{
+    SCRATCH_UNPOISON(mem, size);
+    munmap(mem, size);
+    __atomic_sub_fetch(&total_reserved, size, __ATOMIC_RELAXED);
+    __atomic_store_n(&arena->reserved, arena->reserved - size, __ATOMIC_RELAXED);
+}
+
+/** 单独映射的大块 */
+static inline int is_large_class(size_t cls)
+{
+    return cls > class_of(SCRATCH_SMALL_MAX);
+}
+
+/** 从大到小归还缓存的大块，直到缓存的字节数不超过 keep */
+static void trim_cached(scratch_arena_t *arena, size_t keep)
+{
+    for (size_t cls = SCRATCH_NUM_CLASSES; cls-- > 0 && is_large_class(cls) && arena->cached_large > keep;)
+    {
+        while (NULL != arena->free_lists[cls] && arena->cached_large > keep)
+        {
+            void *block = arena->free_lists[cls];
+            arena->free_lists[cls] = *next_of(block);
+            arena->cached_large -= class_size(cls);
+            unmap_memory(arena, block, class_size(cls));
+        }
+    }
+}
+
+/**
+ * 把释放的块放回空闲链表。大块缓存的总量不超过 cache_limit：超出时先归还
+ * 其他缓存的大块，单块就超过上限时直接归还，否则每个线程的 arena 都会
+ * 一直留着它用过的最大的那些块
+ */
+static void cache_block(scratch_arena_t *arena, void *block, size_t cls)
+{
+    if (is_large_class(cls))
+    {
+        size_t size = class_size(cls);
+        size_t limit = __atomic_load_n(&cache_limit, __ATOMIC_RELAXED);
+        trim_cached(arena, size > limit ? limit : limit - size);
+        if (size > limit)
+        {
+            unmap_memory(arena, block, size);
+            return;
+        }
+        arena->cached_large += size;
+    }
+    *next_of(block) = arena->free_lists[cls];
+    arena->free_lists[cls] = block;
+}
+
+/** 取走其他线程释放的块，放回各自级别的空闲链表 */
+static void collect_remote(scratch_arena_t *arena)
+{
+    void *block = __atomic_exchange_n(&arena->remote, NULL, __ATOMIC_ACQUIRE);
+    while (NULL != block)
+    {
+        void *next = *next_of(block);
+        cache_block(arena, block, ((block_header_t *)block)->size_class);
+        block = next;
+    }
+}
+
+/** 归还缓存的单独映射的大块，用于接近上限时腾出空间 */
+static void release_cached(scratch_arena_t *arena)
+{
+    collect_remote(arena);
+    trim_cached(arena, 0);
+}
+
+/* ============================================================================
+ * 分配
+ * ============================================================================
+ */
+
+/** 把当前 chunk 剩下的部分切成尽量大的块放入空闲链表 */
+static void retire_bump(scratch_arena_t *arena)
+{
+    while ((size_t)(arena->bump_end - arena->bump) >= SCRATCH_MIN_BLOCK)
+    {
+        size_t remain = (size_t)(arena->bump_end - arena->bump);
+        size_t cls = class_of(remain);
+        if (class_size(cls) > remain)
+        {
+            cls--;
+        }
+        void *block = arena->bump;
+        arena->bump += class_size(cls);
+        ((block_header_t *)block)->size_class = cls;
+        *next_of(block) = arena->free_lists[cls];
+        arena->free_lists[cls] = block;
+    }
+}
+
+static void *new_block(scratch_arena_t *arena, size_t cls)
+{
+    size_t size = class_size(cls);
+    if (size > SCRATCH_SMALL_MAX)
+    {
+        return map_memory(arena, size);
+    }
+    if ((size_t)(arena->bump_end - arena->bump) < size)
+    {
+        chunk_t *chunk = (chunk_t *)map_memory(arena, SCRATCH_CHUNK_SIZE);
+        if (NULL == chunk)
+        {
+            return NULL;
+        }
+        retire_bump(arena);
+        chunk->next = arena->chunks;
+        chunk->size = SCRATCH_CHUNK_SIZE;
+        arena->chunks = chunk;
+        arena->bump = (char *)chunk + CHUNK_HEADER_SIZE;
+        arena->bump_end = (char *)chunk + SCRATCH_CHUNK_SIZE;
+    }
+    void *block = arena->bump;
+    arena->bump += size;
+    return block;
+}
+
+scratch_arena_t *scratch_arena_create(size_t limit)
+{
+    // arena 本身也放在映射出来的内存里，不经过 malloc
+    size_t size = (sizeof(scratch_arena_t) + 4095) & ~(size_t)4095;
+    scratch_arena_t *arena = (scratch_arena_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == arena)
+    {
+        return NULL;
+    }
+    memset(arena, 0, sizeof(*arena));
+    arena->limit = limit;
+    return arena;
+}
+
+void scratch_arena_destroy(scratch_arena_t *arena)
+{
+    if (NULL == arena)
+    {
+        return;
+    }
+    release_cached(arena);
+    chunk_t *chunk = arena->chunks;
+    while (NULL != chunk)
+    {
+        chunk_t *next = chunk->next;
+        unmap_memory(arena, chunk, chunk->size);
+        chunk = next;
+    }
+    munmap(arena, (sizeof(scratch_arena_t) + 4095) & ~(size_t)4095);
+}
+
+void *scratch_arena_alloc(scratch_arena_t *arena, size_t size)
+{
+    if (NULL == arena || size > SIZE_MAX / 2)
+    {
+        return NULL;
+    }
+    size_t cls = class_of(size + SCRATCH_HEADER_SIZE);
+    void *block = arena->free_lists[cls];
+    if (NULL == block && NULL != __atomic_load_n(&arena->remote, __ATOMIC_RELAXED))
+    {
+        collect_remote(arena);
+        block = arena->free_lists[cls];
+    }
+    if (NULL != block)
+    {
+        arena->free_lists[cls] = *next_of(block);
+        if (is_large_class(cls))
+        {
+            arena->cached_large -= class_size(cls);
+        }
+    }
+    else
+    {
+        block = new_block(arena, cls);
+        if (NULL == block)
+        {
+            release_cached(arena);
+            block = new_block(arena, cls);
+            if (NULL == block)
+            {
+                return NULL;
+            }
+        }
+    }
+    block_header_t *header = (block_header_t *)block;
+    header->arena = arena;
+    header->size_class = cls;
+    SCRATCH_UNPOISON((char *)block + SCRATCH_HEADER_SIZE, size);
+    SCRATCH_POISON((char *)block + SCRATCH_HEADER_SIZE + size, class_size(cls) - SCRATCH_HEADER_SIZE - size);
+    return (char *)block + SCRATCH_HEADER_SIZE;
+}
+
+size_t scratch_arena_reserved(const scratch_arena_t *arena)
+{
+    return NULL == arena ? 0 : __atomic_load_n(&arena->reserved, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ * 线程 arena
+ * ============================================================================
+ */
+
+/** 线程退出时把 arena 留给之后的线程，其中的块可能还在被其他线程释放 */
+static void orphan_arena(void *arg)
+{
+    scratch_arena_t *arena = (scratch_arena_t *)arg;
+    pthread_mutex_lock(&orphan_lock);
+    arena->next_orphan = orphans;
+    orphans = arena;
+    pthread_mutex_unlock(&orphan_lock);
+}
+
+static void create_thread_key(void)
+{
+    pthread_key_create(&thread_key, orphan_arena);
+}
+
+static scratch_arena_t *thread_arena(void)
+{
+    if (NULL != tls_user_arena)
+    {
+        return tls_user_arena;
+    }
+    if (NULL != tls_arena)
+    {
+        return tls_arena;
+    }
+    pthread_once(&thread_key_once, create_thread_key);
+    pthread_mutex_lock(&orphan_lock);
+    scratch_arena_t *arena = orphans;
+    if (NULL != arena)
+    {
+        orphans = arena->next_orphan;
+        arena->next_orphan = NULL;
+    }
+    pthread_mutex_unlock(&orphan_lock);
+    if (NULL == arena)
+    {
+        arena = scratch_arena_create(0);
+        if (NULL == arena)
+        {
+            return NULL;
+        }
+    }
+    pthread_setspecific(thread_key, arena);
+    tls_arena = arena;
+    return arena;
+}
+
+scratch_arena_t *scratch_arena_use(scratch_arena_t *arena)
+{
+    scratch_arena_t *previous = tls_user_arena;
+    tls_user_arena = arena;
+    return previous;
+}
+
+void *scratch_alloc(size_t size)
+{
+    return scratch_arena_alloc(thread_arena(), size);
+}
+
+void *scratch_calloc(size_t count, size_t size)
+{
+    if (0 != size && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    void *ptr = scratch_alloc(count * size);
+    if (NULL != ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void scratch_free(void *ptr)
+{
+    if (NULL == ptr)
+    {
+        return;
+    }
+    void *block = (char *)ptr - SCRATCH_HEADER_SIZE;
+    const block_header_t *header = (const block_header_t *)block;
+    scratch_arena_t *arena = header->arena;
+    // 块头之后的一个指针留给空闲链表，其余部分标记为不可访问
+    SCRATCH_UNPOISON(ptr, sizeof(void *));
+    SCRATCH_POISON((char *)ptr + sizeof(void *), class_size(header->size_class) - SCRATCH_HEADER_SIZE - sizeof(void *));
+    scratch_arena_t *current = NULL != tls_user_arena ? tls_user_arena : tls_arena;
+    if (arena == current)
+    {
+        cache_block(arena, block, header->size_class);
+        return;
+    }
+    // 不属于当前线程使用的 arena：压入所属 arena 的远程释放栈
+    void *head = __atomic_load_n(&arena->remote, __ATOMIC_RELAXED);
+    do
+    {
+        *next_of(block) = head;
+    } while (!__atomic_compare_exchange_n(&arena->remote, &head, block, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void scratch_set_limit(size_t limit)
+{
+    __atomic_store_n(&global_limit, limit, __ATOMIC_RELAXED);
+}
+
+void scratch_set_cache_limit(size_t bytes)
+{
+    __atomic_store_n(&cache_limit, bytes, __ATOMIC_RELAXED);
+}
+
+size_t scratch_total_reserved(void)
+{
+    return __atomic_load_n(&total_reserved, __ATOMIC_RELAXED);
+}
+
+void scratch_set_huge_pages(int enabled)
+{
+    __atomic_store_n(&huge_pages, enabled, __ATOMIC_RELAXED);
+}
+
+void scratch_release_all(void)
+{
+    if (NULL != tls_arena)
+    {
+        pthread_setspecific(thread_key, NULL);
+        scratch_arena_destroy(tls_arena);
+        tls_arena = NULL;
+    }
+    pthread_mutex_lock(&orphan_lock);
+    scratch_arena_t *arena = orphans;
+    orphans = NULL;
+    pthread_mutex_unlock(&orphan_lock);
+    while (NULL != arena)
+    {
+        scratch_arena_t *next = arena->next_orphan;
+        scratch_arena_destroy(arena);
+        arena = next;
+    }
+}
@@ -0,0 +1,411 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "util/thread_pool.h"
+
+#define TASK_DEQUE_INITIAL_CAPACITY 64
+
+typedef struct
+{
+    thread_pool_task_func_t *func;
+    void *arg;
+    thread_pool_group_t *group;
+} thread_pool_task_t;
+
+/** 互斥锁保护的环形双端队列，head 端被窃取，tail 端由所有者使用 */
+typedef struct
+{
+    pthread_mutex_t lock;
+    thread_pool_task_t *tasks;
+    size_t capacity;
+    size_t head;
+    size_t size;
+} task_deque_t;
+
+struct thread_pool
+{
+    size_t num_threads;
+    pthread_t *threads;
+    // deques[num_threads] 为非工作线程使用的注入队列
+    task_deque_t *deques;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake_cond;
+    size_t queued;
+    int shutdown;
+};
+
+typedef struct
+{
+    thread_pool_t *pool;
+    size_t index;
+} worker_arg_t;
+
+static _Thread_local thread_pool_t *tls_pool = NULL;
+static _Thread_local size_t tls_worker_index = 0;
+
+static thread_pool_t *global_pool = NULL;
+
+/* ============================================================================
+ * 任务队列
+ * ============================================================================
+ */
+
+static int deque_init(task_deque_t *deque)
+{
+    deque->tasks = (thread_pool_task_t *)malloc(TASK_DEQUE_INITIAL_CAPACITY * sizeof(thread_pool_task_t));
+    if (NULL == deque->tasks)
+    {
+        return -1;
+    }
+    deque->capacity = TASK_DEQUE_INITIAL_CAPACITY;
+    deque->head = 0;
+    deque->size = 0;
+    pthread_mutex_init(&deque->lock, NULL);
+    return 0;
+}
+
+static void deque_destroy(task_deque_t *deque)
+{
+    pthread_mutex_destroy(&deque->lock);
+    free(deque->tasks);
+}
+
+static int deque_push_tail(task_deque_t *deque, const thread_pool_task_t *task)
+{
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size == deque->capacity)
+    {
+        size_t new_capacity = deque->capacity * 2;
+        thread_pool_task_t *tasks = (thread_pool_task_t *)malloc(new_capacity * sizeof(thread_pool_task_t));
+        if (NULL == tasks)
+        {
+            pthread_mutex_unlock(&deque->lock);
+            return -1;
+        }
+        for (size_t i = 0; i < deque->size; i++)
+        {
+            tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->capacity = new_capacity;
+        deque->head = 0;
+    }
+    deque->tasks[(deque->head + deque->size) % deque->capacity] = *task;
+    // size 会在锁外被无锁地预读，写入使用原子操作
+    __atomic_store_n(&deque->size, deque->size + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&deque->lock);
+    return 0;
+}
+
+static int deque_pop_tail(task_deque_t *deque, thread_pool_task_t *task)
+{
+    if (__atomic_load_n(&deque->size, __ATOMIC_RELAXED) == 0)
+    {
+        return 0;
+    }
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size > 0)
+    {
+        __atomic_store_n(&deque->size, deque->size - 1, __ATOMIC_RELAXED);
+        *task = deque->tasks[(deque->head + deque->size) % deque->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static int deque_steal_head(task_deque_t *deque, thread_pool_task_t *task)
+{
+    if (__atomic_load_n(&deque->size, __ATOMIC_RELAXED) == 0)
+    {
+        return 0;
+    }
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size > 0)
+    {
+        *task = deque->tasks[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        __atomic_store_n(&deque->size, deque->size - 1, __ATOMIC_RELAXED);
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/* ============================================================================
+ * 调度
+ * ============================================================================
+ */
+
+static inline int is_worker_of(const thread_pool_t *pool)
+{
+    return tls_pool == pool;
+}
+
+/**
+ * 取一个任务：工作线程先取自己队列尾部，然后从注入队列和其他队列头部窃取。
+ */
+static int find_task(thread_pool_t *pool, thread_pool_task_t *task)
+{
+    size_t num_deques = pool->num_threads + 1;
+    size_t start = pool->num_threads;
+    if (is_worker_of(pool))
+    {
+        if (deque_pop_tail(&pool->deques[tls_worker_index], task))
+        {
+            return 1;
+        }
+        start = tls_worker_index + 1;
+    }
+    for (size_t k = 0; k < num_deques; k++)
+    {
+        if (deque_steal_head(&pool->deques[(start + k) % num_deques], task))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void run_task(thread_pool_t *pool, const thread_pool_task_t *task)
+{
+    __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_RELAXED);
+    task->func(task->arg);
+    __atomic_sub_fetch(&task->group->pending, 1, __ATOMIC_RELEASE);
+}
+
+static void *worker_main(void *arg)
+{
+    worker_arg_t *worker = (worker_arg_t *)arg;
+    thread_pool_t *pool = worker->pool;
+    tls_pool = pool;
+    tls_worker_index = worker->index;
+    free(worker);
+
+    thread_pool_task_t task;
+    for (;;)
+    {
+        if (find_task(pool, &task))
+        {
+            run_task(pool, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->sleep_lock);
+        while (__atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) == 0 && !pool->shutdown)
+        {
+            pthread_cond_wait(&pool->wake_cond, &pool->sleep_lock);
+        }
+        int shutdown = pool->shutdown;
+        pthread_mutex_unlock(&pool->sleep_lock);
+        if (shutdown)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int thread_pool_submit(thread_pool_t *pool,
+                       thread_pool_group_t *group,
+                       thread_pool_task_func_t *func,
+                       void *arg)
+{
+    if (NULL == pool || NULL == group || NULL == func)
+    {
+        return -1;
+    }
+    thread_pool_task_t task = {func, arg, group};
+    size_t index = is_worker_of(pool) ? tls_worker_index : pool->num_threads;
+
+    __atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pool->queued, 1, __ATOMIC_RELEASE);
+    if (deque_push_tail(&pool->deques[index], &task) != 0)
+    {
+        __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    pthread_mutex_lock(&pool->sleep_lock);
+    pthread_cond_signal(&pool->wake_cond);
+    pthread_mutex_unlock(&pool->sleep_lock);
+    return 0;
+}
+
+void thread_pool_wait(thread_pool_t *pool, thread_pool_group_t *group)
+{
+    if (NULL == pool || NULL == group)
+    {
+        return;
+    }
+    thread_pool_task_t task;
+    while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0)
+    {
+        if (find_task(pool, &task))
+        {
+            run_task(pool, &task);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
+
+/* ============================================================================
+ * 创建与销毁
+ * ============================================================================
+ */
+
+static size_t default_thread_count(void)
+{
+    const char *env = getenv("ALGORITHMS_NUM_THREADS");
+    if (NULL != env)
+    {
+        long n = strtol(env, NULL, 10);
+        if (n > 0)
+        {
+            return (size_t)n;
+        }
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t)cpus : 1;
+}
+
+thread_pool_t *thread_pool_create(size_t num_threads)
+{
+    if (num_threads == 0)
+    {
+        num_threads = default_thread_count();
+    }
+
+    thread_pool_t *pool = (thread_pool_t *)calloc(1, sizeof(thread_pool_t));
+    if (NULL == pool)
+    {
+        return NULL;
+    }
+    pool->num_threads = num_threads;
+    pool->threads = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
+    pool->deques = (task_deque_t *)calloc(num_threads + 1, sizeof(task_deque_t));
+    if (NULL == pool->threads || NULL == pool->deques)
+    {
+        free(pool->threads);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    size_t initialized = 0;
+    for (; initialized < num_threads + 1; initialized++)
+    {
+        if (deque_init(&pool->deques[initialized]) != 0)
+        {
+            break;
+        }
+    }
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->wake_cond, NULL);
+
+    size_t started = 0;
+    if (initialized == num_threads + 1)
+    {
+        for (; started < num_threads; started++)
+        {
+            worker_arg_t *arg = (worker_arg_t *)malloc(sizeof(worker_arg_t));
+            if (NULL == arg)
+            {
+                break;
+            }
+            arg->pool = pool;
+            arg->index = started;
+            if (pthread_create(&pool->threads[started], NULL, worker_main, arg) != 0)
+            {
+                free(arg);
+                break;
+            }
+        }
+    }
+
+    if (started != num_threads)
+    {
+        pool->num_threads = started;
+        pthread_mutex_lock(&pool->sleep_lock);
+        pool->shutdown = 1;
+        pthread_cond_broadcast(&pool->wake_cond);
+        pthread_mutex_unlock(&pool->sleep_lock);
+        for (size_t i = 0; i < started; i++)
+        {
+            pthread_join(pool->threads[i], NULL);
+        }
+        for (size_t i = 0; i < initialized; i++)
+        {
+            deque_destroy(&pool->deques[i]);
+        }
+        pthread_mutex_destroy(&pool->sleep_lock);
+        pthread_cond_destroy(&pool->wake_cond);
+        free(pool->threads);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t *pool)
+{
+    if (NULL == pool)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pool->sleep_lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake_cond);
+    pthread_mutex_unlock(&pool->sleep_lock);
+
+    for (size_t i = 0; i < pool->num_threads; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (size_t i = 0; i < pool->num_threads + 1; i++)
+    {
+        deque_destroy(&pool->deques[i]);
+    }
+    pthread_mutex_destroy(&pool->sleep_lock);
+    pthread_cond_destroy(&pool->wake_cond);
+    free(pool->threads);
+    free(pool->deques);
+    free(pool);
+}
+
+size_t thread_pool_size(const thread_pool_t *pool)
+{
+    return NULL == pool ? 0 : pool->num_threads;
+}
+
+int thread_pool_global_init(size_t num_threads)
+{
+    thread_pool_t *pool = thread_pool_create(num_threads);
+    if (NULL == pool)
+    {
+        return -1;
+    }
+    thread_pool_global_shutdown();
+    global_pool = pool;
+    return 0;
+}
+
+void thread_pool_global_shutdown(void)
+{
+    thread_pool_destroy(global_pool);
+    global_pool = NULL;
+}
+
+thread_pool_t *thread_pool_global(void)
+{
+    return global_pool;
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+#define TEST_DATA_SIZE 100000
+#define BENCHMARK_TEST_DATA_SIZE 100000
+
+#endif
\ No newline at end of file
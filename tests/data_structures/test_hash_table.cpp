@@ -0,0 +1,405 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include "data_structures/hash_table.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct HashTableDeleter
+    {
+        void operator()(hash_table_t *table) const { hash_table_destroy(table); }
+    };
+    using TablePtr = std::unique_ptr<hash_table_t, HashTableDeleter>;
+
+    TablePtr make_table(size_t key_size, size_t value_size, hash_func_t *hash = nullptr,
+                        hash_equal_func_t *equal = nullptr)
+    {
+        hash_table_t *table = nullptr;
+        EXPECT_EQ(hash_table_create(key_size, value_size, hash, equal, &table), SORT_SUCCESS);
+        return TablePtr(table);
+    }
+
+    // 所有键落到同一个起始组，探测序列跨越很多组，用来覆盖满组、墓碑和回绕
+    uint64_t constant_hash(const void *const, size_t)
+    {
+        return 0x8000000000000005ull;
+    }
+
+    // 恒等哈希：小整数键只有低位不同，表内不再混合时全部落到第 0 组
+    uint64_t identity_hash(const void *const key, size_t key_size)
+    {
+        uint64_t x = 0;
+        std::memcpy(&x, key, key_size);
+        return x;
+    }
+
+    size_t equal_calls = 0;
+
+    int counting_equal(const void *const a, const void *const b, size_t key_size)
+    {
+        equal_calls++;
+        return 0 == std::memcmp(a, b, key_size);
+    }
+
+    // 12 字节键：只比较前 8 个字节
+    struct Key12
+    {
+        uint64_t id;
+        uint32_t tag;
+    };
+
+    int equal_by_id(const void *const a, const void *const b, size_t)
+    {
+        return static_cast<const Key12 *>(a)->id == static_cast<const Key12 *>(b)->id;
+    }
+
+    uint64_t hash_by_id(const void *const key, size_t)
+    {
+        return hash_table_default_hash(&static_cast<const Key12 *>(key)->id, sizeof(uint64_t));
+    }
+}
+
+class HashTableTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    HashTableTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(HashTableTest, CreateAndNullArguments)
+{
+    hash_table_t *table = nullptr;
+    EXPECT_EQ(hash_table_create(8, 8, nullptr, nullptr, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(hash_table_create(0, 8, nullptr, nullptr, &table), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(table, nullptr);
+
+    TablePtr t = make_table(8, 8);
+    EXPECT_EQ(hash_table_size(t.get()), 0u);
+    EXPECT_EQ(hash_table_capacity(t.get()), 0u);
+    EXPECT_EQ(hash_table_find_int64(t.get(), 1), nullptr);
+    EXPECT_EQ(hash_table_erase_int64(t.get(), 1), 0);
+    EXPECT_EQ(hash_table_insert(nullptr, "", nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(hash_table_insert(t.get(), nullptr, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(hash_table_find(t.get(), nullptr), nullptr);
+    EXPECT_EQ(hash_table_size(nullptr), 0u);
+    hash_table_destroy(nullptr);
+
+    // 键长与类型不符
+    EXPECT_EQ(hash_table_insert_int32(t.get(), 1, nullptr), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(hash_table_find_int32(t.get(), 1), nullptr);
+}
+
+TEST_F(HashTableTest, InsertFindEraseInt64)
+{
+    TablePtr t = make_table(sizeof(int64_t), sizeof(int64_t));
+    std::vector<int> keys = get_shuffled_int_vector();
+    for (int k : keys)
+    {
+        int64_t value = -static_cast<int64_t>(k);
+        ASSERT_EQ(hash_table_insert_int64(t.get(), k, &value), SORT_SUCCESS);
+    }
+    EXPECT_EQ(hash_table_size(t.get()), keys.size());
+    EXPECT_LE(hash_table_size(t.get()), hash_table_capacity(t.get()) * HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR);
+    for (int k : keys)
+    {
+        auto *value = static_cast<int64_t *>(hash_table_find_int64(t.get(), k));
+        ASSERT_NE(value, nullptr) << k;
+        ASSERT_EQ(*value, -static_cast<int64_t>(k));
+        // 通用接口与整数快速路径共享同一张表
+        int64_t key = k;
+        ASSERT_EQ(hash_table_find(t.get(), &key), value);
+    }
+    EXPECT_EQ(hash_table_find_int64(t.get(), -1), nullptr);
+    EXPECT_EQ(hash_table_find_int64(t.get(), static_cast<int64_t>(keys.size())), nullptr);
+
+    // 覆盖已有的值，value 为 NULL 时不改变已有的值
+    int64_t value = 42;
+    ASSERT_EQ(hash_table_insert_int64(t.get(), 7, &value), SORT_SUCCESS);
+    ASSERT_EQ(hash_table_insert_int64(t.get(), 7, nullptr), SORT_SUCCESS);
+    EXPECT_EQ(*static_cast<int64_t *>(hash_table_find_int64(t.get(), 7)), 42);
+    EXPECT_EQ(hash_table_size(t.get()), keys.size());
+
+    // 删除一半，另一半仍在
+    for (size_t i = 0; i < keys.size(); i += 2)
+    {
+        ASSERT_EQ(hash_table_erase_int64(t.get(), keys[i]), 1);
+        ASSERT_EQ(hash_table_erase_int64(t.get(), keys[i]), 0);
+    }
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        ASSERT_EQ(hash_table_find_int64(t.get(), keys[i]) != nullptr, i % 2 == 1) << keys[i];
+    }
+    EXPECT_EQ(hash_table_size(t.get()), keys.size() / 2);
+
+    hash_table_clear(t.get());
+    EXPECT_EQ(hash_table_size(t.get()), 0u);
+    EXPECT_EQ(hash_table_find_int64(t.get(), keys[1]), nullptr);
+}
+
+TEST_F(HashTableTest, RandomOperationsMatchStd)
+{
+    // 键取值范围小，插入、删除反复命中同一批键，墓碑不断产生和复用
+    std::mt19937_64 rng(1);
+    TablePtr t = make_table(sizeof(uint64_t), sizeof(uint32_t));
+    std::unordered_map<uint64_t, uint32_t> expected;
+    size_t max_capacity = 0;
+    for (int i = 0; i < 400000; i++)
+    {
+        uint64_t key = rng() % 20000;
+        uint32_t value = static_cast<uint32_t>(rng());
+        switch (rng() % 3)
+        {
+        case 0:
+            ASSERT_EQ(hash_table_insert_uint64(t.get(), key, &value), SORT_SUCCESS);
+            expected[key] = value;
+            break;
+        case 1:
+            ASSERT_EQ(hash_table_erase_uint64(t.get(), key), static_cast<int>(expected.erase(key)));
+            break;
+        default:
+        {
+            auto *found = static_cast<uint32_t *>(hash_table_find_uint64(t.get(), key));
+            auto it = expected.find(key);
+            ASSERT_EQ(found != nullptr, it != expected.end()) << key;
+            if (found != nullptr)
+            {
+                ASSERT_EQ(*found, it->second);
+            }
+        }
+        }
+        ASSERT_EQ(hash_table_size(t.get()), expected.size());
+        max_capacity = std::max(max_capacity, hash_table_capacity(t.get()));
+    }
+    // 元素数稳定时墓碑靠原容量重建清除，容量不会持续增长
+    EXPECT_LE(max_capacity, 4 * 20000u);
+}
+
+TEST_F(HashTableTest, CollidingHashesAndCallbacks)
+{
+    // 全部冲突：探测序列跨过所有满组，删除留下墓碑
+    TablePtr t = make_table(sizeof(int32_t), 0, constant_hash);
+    std::vector<int> keys(sorted_int_vector.begin(), sorted_int_vector.begin() + 500);
+    for (int k : keys)
+    {
+        ASSERT_EQ(hash_table_insert_int32(t.get(), k, nullptr), SORT_SUCCESS);
+    }
+    for (size_t i = 0; i < keys.size(); i += 3)
+    {
+        ASSERT_EQ(hash_table_erase_int32(t.get(), keys[i]), 1);
+    }
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        ASSERT_EQ(hash_table_find_int32(t.get(), keys[i]) != nullptr, i % 3 != 0) << keys[i];
+    }
+    for (size_t i = 0; i < keys.size(); i += 3)
+    {
+        ASSERT_EQ(hash_table_insert_int32(t.get(), keys[i], nullptr), SORT_SUCCESS);
+    }
+    EXPECT_EQ(hash_table_size(t.get()), keys.size());
+
+    // 结构体键：只按 id 哈希和比较，tag 不同视为同一个键
+    TablePtr s = make_table(sizeof(Key12), sizeof(double), hash_by_id, equal_by_id);
+    for (uint64_t id = 0; id < 1000; id++)
+    {
+        Key12 key = {id, 1};
+        double value = static_cast<double>(id) / 2;
+        ASSERT_EQ(hash_table_insert(s.get(), &key, &value), SORT_SUCCESS);
+    }
+    Key12 probe = {123, 99};
+    auto *value = static_cast<double *>(hash_table_find(s.get(), &probe));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 61.5);
+    // 值按 8 字节对齐存放
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(value) % alignof(double), 0u);
+    EXPECT_EQ(hash_table_erase(s.get(), &probe), 1);
+    EXPECT_EQ(hash_table_find(s.get(), &probe), nullptr);
+}
+
+TEST_F(HashTableTest, EmplaceCounts)
+{
+    TablePtr t = make_table(sizeof(int32_t), sizeof(uint64_t));
+    std::mt19937 rng(3);
+    std::unordered_map<int32_t, uint64_t> expected;
+    for (int i = 0; i < 50000; i++)
+    {
+        int32_t key = static_cast<int32_t>(rng() % 1000) - 500;
+        void *value = nullptr;
+        int inserted = -1;
+        ASSERT_EQ(hash_table_emplace(t.get(), &key, &value, &inserted), SORT_SUCCESS);
+        ASSERT_EQ(inserted, expected.count(key) == 0 ? 1 : 0);
+        ++*static_cast<uint64_t *>(value);
+        ++expected[key];
+    }
+    size_t cursor = 0;
+    const void *key = nullptr;
+    void *value = nullptr;
+    size_t visited = 0;
+    while (hash_table_next(t.get(), &cursor, &key, &value))
+    {
+        int32_t k;
+        std::memcpy(&k, key, sizeof(k));
+        ASSERT_EQ(*static_cast<uint64_t *>(value), expected.at(k));
+        visited++;
+    }
+    EXPECT_EQ(visited, expected.size());
+    EXPECT_EQ(hash_table_next(t.get(), &cursor, &key, &value), 0);
+}
+
+TEST_F(HashTableTest, BatchInsertAndFind)
+{
+    std::mt19937_64 rng(4);
+    // 含重复键，用于去重
+    std::vector<int64_t> keys(TEST_DATA_SIZE);
+    for (auto &k : keys)
+    {
+        k = static_cast<int64_t>(rng() % (TEST_DATA_SIZE / 2));
+    }
+    std::vector<int64_t> values(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        values[i] = static_cast<int64_t>(i);
+    }
+    std::unordered_set<int64_t> distinct(keys.begin(), keys.end());
+
+    TablePtr typed = make_table(sizeof(int64_t), sizeof(int64_t));
+    TablePtr generic = make_table(sizeof(int64_t), sizeof(int64_t));
+    size_t inserted = 0;
+    ASSERT_EQ(hash_table_insert_batch_int64(typed.get(), keys.data(), values.data(), keys.size(), &inserted),
+              SORT_SUCCESS);
+    EXPECT_EQ(inserted, distinct.size());
+    ASSERT_EQ(hash_table_insert_batch(generic.get(), keys.data(), values.data(), keys.size(), &inserted),
+              SORT_SUCCESS);
+    EXPECT_EQ(inserted, distinct.size());
+    EXPECT_EQ(hash_table_size(typed.get()), distinct.size());
+
+    // 重复键保留最后一次写入的值
+    std::unordered_map<int64_t, int64_t> last;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        last[keys[i]] = values[i];
+    }
+
+    std::vector<int64_t> queries(keys.size() + 37);
+    for (auto &q : queries)
+    {
+        q = static_cast<int64_t>(rng() % TEST_DATA_SIZE);
+    }
+    std::vector<void *> out(queries.size());
+    std::vector<void *> out_generic(queries.size());
+    hash_table_find_batch_int64(typed.get(), queries.data(), queries.size(), out.data());
+    hash_table_find_batch(generic.get(), queries.data(), queries.size(), out_generic.data());
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        auto it = last.find(queries[i]);
+        ASSERT_EQ(out[i], hash_table_find_int64(typed.get(), queries[i]));
+        ASSERT_EQ(out[i] != nullptr, it != last.end()) << queries[i];
+        ASSERT_EQ(out_generic[i] != nullptr, it != last.end());
+        if (it != last.end())
+        {
+            ASSERT_EQ(*static_cast<int64_t *>(out[i]), it->second);
+            ASSERT_EQ(*static_cast<int64_t *>(out_generic[i]), it->second);
+        }
+    }
+
+    // 集合：values 为 NULL
+    TablePtr set = make_table(sizeof(int32_t), 0);
+    std::vector<int32_t> small(keys.begin(), keys.begin() + 1000);
+    ASSERT_EQ(hash_table_insert_batch_int32(set.get(), small.data(), nullptr, small.size(), nullptr), SORT_SUCCESS);
+    EXPECT_EQ(hash_table_size(set.get()), std::unordered_set<int32_t>(small.begin(), small.end()).size());
+    hash_table_find_batch_int32(set.get(), small.data(), small.size(), out.data());
+    EXPECT_TRUE(std::all_of(out.begin(), out.begin() + small.size(), [](void *p) { return p != nullptr; }));
+}
+
+// 小表(一两个组)的空槽上限不到一批，已有的键重复批量插入时不应每批都重建。
+// 重建先分配新表再释放旧表，值的地址不变说明没有重建
+TEST_F(HashTableTest, BatchOfExistingKeysDoesNotRebuild)
+{
+    TablePtr t = make_table(sizeof(int64_t), sizeof(int64_t));
+    std::vector<int64_t> keys(HASH_TABLE_BATCH_WIDTH);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        keys[i] = static_cast<int64_t>(i % 5);
+    }
+    ASSERT_EQ(hash_table_insert_batch_int64(t.get(), keys.data(), keys.data(), keys.size(), nullptr), SORT_SUCCESS);
+    ASSERT_EQ(hash_table_size(t.get()), 5u);
+    size_t capacity = hash_table_capacity(t.get());
+    void *value = hash_table_find_int64(t.get(), 0);
+    for (int round = 0; round < 10; round++)
+    {
+        size_t inserted = 1;
+        ASSERT_EQ(hash_table_insert_batch_int64(t.get(), keys.data(), keys.data(), keys.size(), &inserted),
+                  SORT_SUCCESS);
+        EXPECT_EQ(inserted, 0u);
+        EXPECT_EQ(hash_table_capacity(t.get()), capacity);
+        EXPECT_EQ(hash_table_find_int64(t.get(), 0), value);
+    }
+    EXPECT_EQ(hash_table_size(t.get()), 5u);
+}
+
+TEST_F(HashTableTest, LoadFactorAndReserve)
+{
+    TablePtr t = make_table(sizeof(int64_t), sizeof(int64_t));
+    EXPECT_EQ(hash_table_set_max_load_factor(t.get(), 0.0), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hash_table_set_max_load_factor(t.get(), 1.0), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hash_table_set_max_load_factor(nullptr, 0.5), SORT_ERROR_NULL_POINTER);
+
+    // 预留后插入不再扩容
+    ASSERT_EQ(hash_table_reserve(t.get(), TEST_DATA_SIZE), SORT_SUCCESS);
+    size_t capacity = hash_table_capacity(t.get());
+    EXPECT_GE(capacity * HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR, TEST_DATA_SIZE);
+    EXPECT_EQ(capacity % HASH_TABLE_GROUP_WIDTH, 0u);
+    for (int k : sorted_int_vector)
+    {
+        ASSERT_EQ(hash_table_insert_int64(t.get(), k, nullptr), SORT_SUCCESS);
+    }
+    EXPECT_EQ(hash_table_capacity(t.get()), capacity);
+    // 每个元素 16 字节，加上控制字节不超过原始数据的 1.3 倍
+    EXPECT_LT(hash_table_memory_bytes(t.get()), TEST_DATA_SIZE * 16 * 13 / 10);
+
+    // 调低负载因子立即扩容
+    ASSERT_EQ(hash_table_set_max_load_factor(t.get(), 0.5), SORT_SUCCESS);
+    EXPECT_GE(hash_table_capacity(t.get()), 2u * TEST_DATA_SIZE);
+    for (int k : sorted_int_vector)
+    {
+        ASSERT_NE(hash_table_find_int64(t.get(), k), nullptr);
+    }
+
+    // 负载因子接近 1 时仍然正确
+    TablePtr dense = make_table(sizeof(int32_t), 0);
+    ASSERT_EQ(hash_table_set_max_load_factor(dense.get(), 0.99), SORT_SUCCESS);
+    for (int k : sorted_int_vector)
+    {
+        ASSERT_EQ(hash_table_insert_int32(dense.get(), k, nullptr), SORT_SUCCESS);
+    }
+    for (int k : sorted_int_vector)
+    {
+        ASSERT_NE(hash_table_find_int32(dense.get(), k), nullptr);
+    }
+    EXPECT_EQ(hash_table_find_int32(dense.get(), -5), nullptr);
+}
+
+TEST_F(HashTableTest, IdentityHashSpreadsKeys)
+{
+    const int n = 100000;
+    TablePtr t = make_table(sizeof(int64_t), 0, identity_hash, counting_equal);
+    for (int64_t k = 0; k < n; k++)
+    {
+        ASSERT_EQ(hash_table_insert_int64(t.get(), k, nullptr), SORT_SUCCESS);
+    }
+    // 起始组均匀时每次命中的查找平均只比较一两次键；
+    // 全部挤在同一组时探测序列很长，h2 相同的槽位有 n / 128 量级
+    equal_calls = 0;
+    for (int64_t k = 0; k < n; k++)
+    {
+        ASSERT_NE(hash_table_find_int64(t.get(), k), nullptr);
+    }
+    EXPECT_LT(equal_calls, static_cast<size_t>(2 * n));
+    EXPECT_EQ(hash_table_find_int64(t.get(), n), nullptr);
+}
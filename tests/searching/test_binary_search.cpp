@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "searching/binary_search.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    int compare_int64(const void *const a, const void *const b)
+    {
+        int64_t x = *static_cast<const int64_t *>(a);
+        int64_t y = *static_cast<const int64_t *>(b);
+        return (x > y) - (x < y);
+    }
+
+    // 有大量重复值的有序数组，查询覆盖范围之外、重复值和空隙
+    std::vector<int> sorted_with_duplicates(size_t n, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<int> v(n);
+        for (auto &x : v)
+        {
+            x = static_cast<int>(rng() % (n / 2 + 1)) * 2;
+        }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+}
+
+class BinarySearchTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    BinarySearchTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(BinarySearchTest, EmptyAndNull)
+{
+    int key = 1;
+    EXPECT_EQ(generic_lower_bound(nullptr, 10, sizeof(int), &key, compare_integers), 0u);
+    EXPECT_EQ(generic_upper_bound(sorted_int_vector.data(), 0, sizeof(int), &key, compare_integers), 0u);
+    EXPECT_EQ(generic_binary_search(sorted_int_vector.data(), 0, sizeof(int), &key, compare_integers), SEARCH_NOT_FOUND);
+    EXPECT_EQ(lower_bound_int32(nullptr, 5, 1), 0u);
+    EXPECT_EQ(upper_bound_double(nullptr, 0, 1.0), 0u);
+}
+
+TEST_F(BinarySearchTest, MatchesStdBounds)
+{
+    for (size_t n : {1u, 2u, 3u, 7u, 8u, 9u, 100u, 1023u, 1024u, 1025u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, static_cast<unsigned>(n));
+        std::vector<int32_t> v32(v.begin(), v.end());
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<uint64_t> vu64(v.begin(), v.end());
+        std::vector<float> vf(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        for (int key = -3; key <= static_cast<int>(n) + 3; key++)
+        {
+            size_t lo = std::lower_bound(v.begin(), v.end(), key) - v.begin();
+            size_t hi = std::upper_bound(v.begin(), v.end(), key) - v.begin();
+            ASSERT_EQ(generic_lower_bound(v.data(), n, sizeof(int), &key, compare_integers), lo) << n << " " << key;
+            ASSERT_EQ(generic_upper_bound(v.data(), n, sizeof(int), &key, compare_integers), hi) << n << " " << key;
+            ASSERT_EQ(generic_binary_search(v.data(), n, sizeof(int), &key, compare_integers),
+                      lo < hi ? lo : SEARCH_NOT_FOUND);
+            ASSERT_EQ(lower_bound_int32(v32.data(), n, key), lo);
+            ASSERT_EQ(upper_bound_int32(v32.data(), n, key), hi);
+            ASSERT_EQ(lower_bound_int64(v64.data(), n, key), lo);
+            ASSERT_EQ(upper_bound_int64(v64.data(), n, key), hi);
+            if (key >= 0)
+            {
+                ASSERT_EQ(lower_bound_uint64(vu64.data(), n, static_cast<uint64_t>(key)), lo);
+                ASSERT_EQ(upper_bound_uint64(vu64.data(), n, static_cast<uint64_t>(key)), hi);
+            }
+            ASSERT_EQ(lower_bound_float(vf.data(), n, static_cast<float>(key)), lo);
+            ASSERT_EQ(upper_bound_float(vf.data(), n, static_cast<float>(key)), hi);
+            ASSERT_EQ(lower_bound_double(vd.data(), n, key + 0.0), lo);
+            ASSERT_EQ(upper_bound_double(vd.data(), n, key + 0.0), hi);
+        }
+        // 非整数查询落在空隙里
+        ASSERT_EQ(lower_bound_double(vd.data(), n, 0.5),
+                  static_cast<size_t>(std::lower_bound(vd.begin(), vd.end(), 0.5) - vd.begin()));
+    }
+}
+
+TEST_F(BinarySearchTest, BatchMatchesScalar)
+{
+    // 查询个数不是批宽度的整数倍，覆盖最后不满的一组
+    const size_t num_keys = SEARCH_BATCH_WIDTH * 100 + 7;
+    for (size_t n : {1u, 5u, 1000u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, 42);
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<int32_t> keys(num_keys);
+        for (auto &k : keys)
+        {
+            k = static_cast<int32_t>(rng() % (n + 10)) - 5;
+        }
+        std::vector<int64_t> keys64(keys.begin(), keys.end());
+        std::vector<float> keysf(keys.begin(), keys.end());
+        std::vector<double> keysd(keys.begin(), keys.end());
+        std::vector<float> vf(v.begin(), v.end());
+
+        std::vector<size_t> out(num_keys), out_generic(num_keys), out64(num_keys), outf(num_keys), outd(num_keys);
+        lower_bound_int32_batch(v.data(), n, keys.data(), num_keys, out.data());
+        generic_lower_bound_batch(v.data(), n, sizeof(int), keys.data(), num_keys, compare_integers, out_generic.data());
+        lower_bound_int64_batch(v64.data(), n, keys64.data(), num_keys, out64.data());
+        lower_bound_float_batch(vf.data(), n, keysf.data(), num_keys, outf.data());
+        lower_bound_double_batch(vd.data(), n, keysd.data(), num_keys, outd.data());
+        for (size_t i = 0; i < num_keys; i++)
+        {
+            size_t expected = std::lower_bound(v.begin(), v.end(), keys[i]) - v.begin();
+            ASSERT_EQ(out[i], expected) << i;
+            ASSERT_EQ(out_generic[i], expected) << i;
+            ASSERT_EQ(out64[i], expected) << i;
+            ASSERT_EQ(outf[i], expected) << i;
+            ASSERT_EQ(outd[i], expected) << i;
+        }
+    }
+}
+
+TEST_F(BinarySearchTest, GenericWideElements)
+{
+    std::vector<int64_t> v(TEST_DATA_SIZE);
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        v[i] = static_cast<int64_t>(i) * 3 - 1000;
+    }
+    for (int64_t key : {INT64_MIN, static_cast<int64_t>(-1000), static_cast<int64_t>(-999), static_cast<int64_t>(2),
+                        static_cast<int64_t>(299999 * 3 - 1000), INT64_MAX})
+    {
+        size_t expected = std::lower_bound(v.begin(), v.end(), key) - v.begin();
+        EXPECT_EQ(generic_lower_bound(v.data(), v.size(), sizeof(int64_t), &key, compare_int64), expected);
+        EXPECT_EQ(lower_bound_int64(v.data(), v.size(), key), expected);
+    }
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "searching/eytzinger.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    template <typename T>
+    struct Layout
+    {
+        std::vector<T> eyt;
+        std::vector<size_t> sorted_index;
+    };
+
+    template <typename T>
+    Layout<T> make_layout(const std::vector<T> &sorted)
+    {
+        Layout<T> layout{std::vector<T>(sorted.size()), std::vector<size_t>(sorted.size())};
+        EXPECT_EQ(generic_eytzinger_build(sorted.data(), sorted.size(), sizeof(T), layout.eyt.data(),
+                                          layout.sorted_index.data()),
+                  SORT_SUCCESS);
+        return layout;
+    }
+
+    // 把布局中的位置换回有序数组下标，不存在时为 n
+    size_t to_rank(const std::vector<size_t> &sorted_index, size_t slot)
+    {
+        return slot == sorted_index.size() ? sorted_index.size() : sorted_index[slot];
+    }
+
+    std::vector<int> sorted_with_duplicates(size_t n, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<int> v(n);
+        for (auto &x : v)
+        {
+            x = static_cast<int>(rng() % (n / 2 + 1)) * 2;
+        }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+}
+
+class EytzingerTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    EytzingerTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(EytzingerTest, BuildLayout)
+{
+    std::vector<int> sorted = {0, 1, 2, 3, 4, 5, 6};
+    auto layout = make_layout(sorted);
+    EXPECT_EQ(layout.eyt, (std::vector<int>{3, 1, 5, 0, 2, 4, 6}));
+    EXPECT_EQ(layout.sorted_index, (std::vector<size_t>{3, 1, 5, 0, 2, 4, 6}));
+
+    int out[1];
+    EXPECT_EQ(generic_eytzinger_build(nullptr, 1, sizeof(int), out, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_eytzinger_build(sorted.data(), 1, 0, out, nullptr), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(generic_eytzinger_build(sorted.data(), 0, sizeof(int), out, nullptr), SORT_SUCCESS);
+    EXPECT_EQ(eytzinger_lower_bound_int32(nullptr, 0, 1), 0u);
+}
+
+TEST_F(EytzingerTest, LowerBoundMatchesStd)
+{
+    for (size_t n : {1u, 2u, 3u, 6u, 7u, 8u, 15u, 16u, 17u, 1000u, 65535u, 65536u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, static_cast<unsigned>(n));
+        std::vector<int32_t> v32(v.begin(), v.end());
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<float> vf(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        auto l32 = make_layout(v32);
+        auto l64 = make_layout(v64);
+        auto lf = make_layout(vf);
+        auto ld = make_layout(vd);
+        for (int key = -3; key <= static_cast<int>(n) + 3; key += (n > 1000 ? 7 : 1))
+        {
+            size_t lo = std::lower_bound(v.begin(), v.end(), key) - v.begin();
+            // 有重复值时返回的是相等元素中的第一个
+            ASSERT_EQ(to_rank(l32.sorted_index, eytzinger_lower_bound_int32(l32.eyt.data(), n, key)), lo) << n << " " << key;
+            ASSERT_EQ(to_rank(l32.sorted_index,
+                              generic_eytzinger_lower_bound(l32.eyt.data(), n, sizeof(int32_t), &key, compare_integers)),
+                      lo);
+            ASSERT_EQ(to_rank(l64.sorted_index, eytzinger_lower_bound_int64(l64.eyt.data(), n, key)), lo);
+            ASSERT_EQ(to_rank(lf.sorted_index, eytzinger_lower_bound_float(lf.eyt.data(), n, static_cast<float>(key))), lo);
+            ASSERT_EQ(to_rank(ld.sorted_index, eytzinger_lower_bound_double(ld.eyt.data(), n, key + 0.0)), lo);
+        }
+    }
+}
+
+TEST_F(EytzingerTest, BatchMatchesScalar)
+{
+    const size_t num_keys = 1000;
+    for (size_t n : {1u, 2u, 31u, 32u, 33u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, 9);
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<float> vf(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        auto l32 = make_layout(v);
+        auto l64 = make_layout(v64);
+        auto lf = make_layout(vf);
+        auto ld = make_layout(vd);
+
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<int32_t> keys(num_keys);
+        for (auto &k : keys)
+        {
+            k = static_cast<int32_t>(rng() % (n + 10)) - 5;
+        }
+        std::vector<int64_t> keys64(keys.begin(), keys.end());
+        std::vector<float> keysf(keys.begin(), keys.end());
+        std::vector<double> keysd(keys.begin(), keys.end());
+
+        std::vector<size_t> out(num_keys), out_generic(num_keys), out64(num_keys), outf(num_keys), outd(num_keys);
+        eytzinger_lower_bound_int32_batch(l32.eyt.data(), n, keys.data(), num_keys, out.data());
+        generic_eytzinger_lower_bound_batch(l32.eyt.data(), n, sizeof(int), keys.data(), num_keys, compare_integers,
+                                            out_generic.data());
+        eytzinger_lower_bound_int64_batch(l64.eyt.data(), n, keys64.data(), num_keys, out64.data());
+        eytzinger_lower_bound_float_batch(lf.eyt.data(), n, keysf.data(), num_keys, outf.data());
+        eytzinger_lower_bound_double_batch(ld.eyt.data(), n, keysd.data(), num_keys, outd.data());
+        for (size_t i = 0; i < num_keys; i++)
+        {
+            size_t slot = eytzinger_lower_bound_int32(l32.eyt.data(), n, keys[i]);
+            ASSERT_EQ(out[i], slot) << n << " " << i;
+            ASSERT_EQ(out_generic[i], slot);
+            ASSERT_EQ(out64[i], slot);
+            ASSERT_EQ(outf[i], slot);
+            ASSERT_EQ(outd[i], slot);
+        }
+    }
+}
+
+TEST_F(EytzingerTest, AlignedAllocation)
+{
+    const size_t n = 100000;
+    auto v = sorted_with_duplicates(n, 13);
+    int *eyt = static_cast<int *>(eytzinger_alloc(n, sizeof(int)));
+    ASSERT_NE(eyt, nullptr);
+    // 1 号节点在下标 0，节点 16k 起的 16 个后代在下标 16k - 1，须从缓存行边界开始
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(eyt - 1) % 64, 0u);
+    std::vector<size_t> sorted_index(n);
+    ASSERT_EQ(generic_eytzinger_build(v.data(), n, sizeof(int), eyt, sorted_index.data()), SORT_SUCCESS);
+    auto layout = make_layout(v);
+    EXPECT_TRUE(std::equal(layout.eyt.begin(), layout.eyt.end(), eyt));
+    for (int key = -3; key < static_cast<int>(n) + 3; key += 7)
+    {
+        size_t lo = static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin());
+        ASSERT_EQ(to_rank(sorted_index, eytzinger_lower_bound_int32(eyt, n, key)), lo);
+        ASSERT_EQ(to_rank(sorted_index, generic_eytzinger_lower_bound(eyt, n, sizeof(int), &key, compare_integers)), lo);
+    }
+    eytzinger_free(eyt, sizeof(int));
+    EXPECT_EQ(eytzinger_alloc(SIZE_MAX, sizeof(int)), nullptr);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include "searching/interpolation_search.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class InterpolationSearchTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    InterpolationSearchTest() : TestDataUtil(TEST_DATA_SIZE) {}
+
+    template <typename T, typename Search>
+    static void expect_matches_std(const std::vector<T> &v, Search search, const std::vector<T> &keys)
+    {
+        for (T key : keys)
+        {
+            ASSERT_EQ(search(v.data(), v.size(), key),
+                      static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin()))
+                << key;
+        }
+    }
+};
+
+TEST_F(InterpolationSearchTest, EmptyAndSmall)
+{
+    EXPECT_EQ(interpolation_search_int32(nullptr, 10, 1), 0u);
+    std::vector<int32_t> v = {1, 3, 5};
+    EXPECT_EQ(interpolation_search_int32(v.data(), 0, 1), 0u);
+    EXPECT_EQ(interpolation_search_int32(v.data(), v.size(), 0), 0u);
+    EXPECT_EQ(interpolation_search_int32(v.data(), v.size(), 3), 1u);
+    EXPECT_EQ(interpolation_search_int32(v.data(), v.size(), 4), 2u);
+    EXPECT_EQ(interpolation_search_int32(v.data(), v.size(), 6), 3u);
+}
+
+TEST_F(InterpolationSearchTest, UniformKeys)
+{
+    std::mt19937_64 rng(1);
+    std::vector<int64_t> v(TEST_DATA_SIZE);
+    for (auto &x : v)
+    {
+        x = static_cast<int64_t>(rng() >> 2) - (INT64_MAX / 4);
+    }
+    std::sort(v.begin(), v.end());
+    std::vector<int64_t> keys = {INT64_MIN, INT64_MAX, v.front(), v.back()};
+    for (int i = 0; i < 5000; i++)
+    {
+        keys.push_back(v[rng() % v.size()]);
+        keys.push_back(static_cast<int64_t>(rng() >> 2) - (INT64_MAX / 4));
+    }
+    expect_matches_std(v, interpolation_search_int64, keys);
+
+    std::vector<int32_t> v32(sorted_int_vector.begin(), sorted_int_vector.end());
+    std::vector<int32_t> keys32 = {-1, 0, static_cast<int32_t>(v32.size()), INT32_MIN, INT32_MAX};
+    for (int i = 0; i < 5000; i++)
+    {
+        keys32.push_back(static_cast<int32_t>(rng() % (v32.size() + 10)));
+    }
+    expect_matches_std(v32, interpolation_search_int32, keys32);
+}
+
+TEST_F(InterpolationSearchTest, SkewedAndDuplicateKeys)
+{
+    // 指数分布会让插值估计严重偏离，区间没有减半时退回二分查找
+    std::mt19937_64 rng(2);
+    std::vector<double> v(TEST_DATA_SIZE);
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        v[i] = std::pow(1.0001, static_cast<double>(i % 50000)) + (i % 7 == 0 ? 0.0 : 1.0);
+    }
+    std::sort(v.begin(), v.end());
+    std::vector<double> keys = {0.0, 1e300, -1e300};
+    for (int i = 0; i < 5000; i++)
+    {
+        keys.push_back(v[rng() % v.size()]);
+        keys.push_back(v[rng() % v.size()] + 1e-9);
+    }
+    expect_matches_std(v, interpolation_search_double, keys);
+
+    std::vector<float> vf(1000, 5.0f);
+    vf.insert(vf.begin(), -std::numeric_limits<float>::infinity());
+    vf.push_back(std::numeric_limits<float>::infinity());
+    expect_matches_std(vf, interpolation_search_float, std::vector<float>{-1.0f, 5.0f, 6.0f, std::numeric_limits<float>::infinity()});
+}
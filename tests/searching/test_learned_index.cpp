@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include "searching/learned_index.h"
+#include "searching/binary_search.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    // 逐个核对数组中的键、相邻键之间的值以及范围之外的值
+    template <typename T, typename LowerBound>
+    void expect_matches_std(const std::vector<T> &v, LowerBound lower_bound, std::mt19937_64 &rng)
+    {
+        for (size_t i = 0; i < v.size(); i += 1 + v.size() / 5000)
+        {
+            T key = v[i];
+            ASSERT_EQ(lower_bound(key), static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin())) << i;
+            if (key > std::numeric_limits<T>::min())
+            {
+                key--;
+                ASSERT_EQ(lower_bound(key), static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin())) << i;
+            }
+        }
+        for (int i = 0; i < 2000; i++)
+        {
+            T key = static_cast<T>(rng());
+            ASSERT_EQ(lower_bound(key), static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin()));
+        }
+        for (T key : {std::numeric_limits<T>::min(), std::numeric_limits<T>::max()})
+        {
+            ASSERT_EQ(lower_bound(key), static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin()));
+        }
+    }
+}
+
+class LearnedIndexTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    LearnedIndexTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(LearnedIndexTest, InvalidAndEmpty)
+{
+    learned_index_t *index = nullptr;
+    EXPECT_EQ(learned_index_build_int64(nullptr, 10, 64, &index), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(learned_index_lower_bound_int64(nullptr, 1), 0u);
+    learned_index_destroy(nullptr);
+
+    ASSERT_EQ(learned_index_build_uint64(nullptr, 0, 64, &index), SORT_SUCCESS);
+    EXPECT_EQ(learned_index_segments(index), 0u);
+    EXPECT_EQ(learned_index_lower_bound_uint64(index, 5), 0u);
+    learned_index_destroy(index);
+}
+
+TEST_F(LearnedIndexTest, LinearDataFitsOneSegment)
+{
+    std::vector<uint64_t> v(TEST_DATA_SIZE);
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        v[i] = 1000 + i * 37;
+    }
+    learned_index_t *index;
+    ASSERT_EQ(learned_index_build_uint64(v.data(), v.size(), 0, &index), SORT_SUCCESS);
+    EXPECT_EQ(learned_index_segments(index), 1u);
+    EXPECT_EQ(learned_index_levels(index), 1u);
+    std::mt19937_64 rng(1);
+    expect_matches_std(v, [&](uint64_t k) { return learned_index_lower_bound_uint64(index, k); }, rng);
+    learned_index_destroy(index);
+}
+
+TEST_F(LearnedIndexTest, UniformKeys)
+{
+    std::mt19937_64 rng(2);
+    std::vector<uint64_t> v(TEST_DATA_SIZE);
+    for (auto &x : v)
+    {
+        x = rng();
+    }
+    std::sort(v.begin(), v.end());
+    for (size_t epsilon : {0u, 1u, 8u, 64u})
+    {
+        learned_index_t *index;
+        ASSERT_EQ(learned_index_build_uint64(v.data(), v.size(), epsilon, &index), SORT_SUCCESS);
+        expect_matches_std(v, [&](uint64_t k) { return learned_index_lower_bound_uint64(index, k); }, rng);
+        learned_index_destroy(index);
+    }
+}
+
+TEST_F(LearnedIndexTest, SkewedSignedKeysWithDuplicates)
+{
+    // 正负对称的对数正态分布，大量重复和很大的空隙
+    std::mt19937_64 rng(3);
+    std::lognormal_distribution<double> dist(0.0, 8.0);
+    std::vector<int64_t> v(TEST_DATA_SIZE);
+    for (auto &x : v)
+    {
+        double d = std::min(dist(rng), 9.0e18);
+        x = static_cast<int64_t>(d) * (rng() & 1 ? 1 : -1);
+    }
+    std::sort(v.begin(), v.end());
+    for (size_t epsilon : {4u, 64u})
+    {
+        learned_index_t *index;
+        ASSERT_EQ(learned_index_build_int64(v.data(), v.size(), epsilon, &index), SORT_SUCCESS);
+        EXPECT_GT(learned_index_levels(index), 1u);
+        expect_matches_std(v, [&](int64_t k) { return learned_index_lower_bound_int64(index, k); }, rng);
+        learned_index_destroy(index);
+    }
+}
+
+TEST_F(LearnedIndexTest, SmallArrays)
+{
+    std::mt19937_64 rng(4);
+    for (size_t n = 1; n <= 40; n++)
+    {
+        std::vector<int64_t> v(n);
+        for (auto &x : v)
+        {
+            x = static_cast<int64_t>(rng() % 20) - 10;
+        }
+        std::sort(v.begin(), v.end());
+        learned_index_t *index;
+        ASSERT_EQ(learned_index_build_int64(v.data(), n, 1, &index), SORT_SUCCESS);
+        for (int64_t key = -12; key <= 12; key++)
+        {
+            ASSERT_EQ(learned_index_lower_bound_int64(index, key),
+                      static_cast<size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin()))
+                << n << " " << key;
+        }
+        learned_index_destroy(index);
+    }
+}
+
+TEST_F(LearnedIndexTest, BatchMatchesScalar)
+{
+    std::mt19937_64 rng(5);
+    std::vector<int64_t> v(TEST_DATA_SIZE);
+    for (auto &x : v)
+    {
+        x = static_cast<int64_t>(rng() >> 20);
+    }
+    std::sort(v.begin(), v.end());
+    learned_index_t *index;
+    ASSERT_EQ(learned_index_build_int64(v.data(), v.size(), LEARNED_INDEX_DEFAULT_EPSILON, &index), SORT_SUCCESS);
+    const size_t num_keys = SEARCH_BATCH_WIDTH * 64 + 5;
+    std::vector<int64_t> keys(num_keys);
+    for (auto &k : keys)
+    {
+        k = static_cast<int64_t>(rng() >> 20);
+    }
+    std::vector<size_t> out(num_keys);
+    learned_index_lower_bound_int64_batch(index, keys.data(), num_keys, out.data());
+    for (size_t i = 0; i < num_keys; i++)
+    {
+        ASSERT_EQ(out[i], lower_bound_int64(v.data(), v.size(), keys[i])) << i;
+    }
+    learned_index_destroy(index);
+}
+
+TEST_F(LearnedIndexTest, ReportsBuildCost)
+{
+    std::vector<uint64_t> v(sorted_int_vector.begin(), sorted_int_vector.end());
+    learned_index_t *index;
+    sort_stats_t stats;
+    ASSERT_EQ(learned_index_build_uint64_ex(v.data(), v.size(), 16, &index, &stats), SORT_SUCCESS);
+    EXPECT_EQ(stats.array_length, v.size());
+    EXPECT_EQ(stats.max_mamory_used, learned_index_memory_bytes(index));
+    EXPECT_GE(stats.time_elapsed_ms, 0.0);
+    // 连续整数只需一段
+    EXPECT_LT(learned_index_memory_bytes(index), 4096u);
+    learned_index_destroy(index);
+}
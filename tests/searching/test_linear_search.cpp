@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "searching/linear_search.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    // 在每一级指令集下分别运行，超出 CPU 支持范围的级别会降级，结果应当相同
+    template <typename Fn>
+    void for_each_simd_level(Fn fn)
+    {
+        linear_search_simd_t original = linear_search_simd_level();
+        for (linear_search_simd_t level : {LINEAR_SEARCH_SCALAR, LINEAR_SEARCH_SSE, LINEAR_SEARCH_AVX2})
+        {
+            linear_search_set_simd_level(level);
+            fn(level);
+        }
+        linear_search_set_simd_level(original);
+    }
+
+    template <typename T>
+    size_t expected_find(const std::vector<T> &v, size_t n, T key)
+    {
+        auto it = std::find(v.begin(), v.begin() + n, key);
+        return it == v.begin() + n ? SEARCH_NOT_FOUND : static_cast<size_t>(it - v.begin());
+    }
+
+    template <typename T>
+    size_t expected_greater(const std::vector<T> &v, size_t n, T key)
+    {
+        return std::find_if(v.begin(), v.begin() + n, [key](T x) { return x > key; }) - v.begin();
+    }
+}
+
+class LinearSearchTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    LinearSearchTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(LinearSearchTest, NullArray)
+{
+    EXPECT_EQ(linear_find_int32(nullptr, 10, 1), SEARCH_NOT_FOUND);
+    EXPECT_EQ(linear_count_int64(nullptr, 10, 1), 0u);
+    EXPECT_EQ(linear_find_first_greater_float(nullptr, 10, 1.0f), 0u);
+    EXPECT_EQ(adaptive_upper_bound_int32(nullptr, 0, 1), 0u);
+}
+
+TEST_F(LinearSearchTest, UnsortedMatchesStd)
+{
+    std::mt19937 rng(1);
+    // 长度覆盖尾部 0 ~ 15 个元素的所有情况
+    std::vector<int32_t> v32(300);
+    for (auto &x : v32)
+    {
+        x = static_cast<int32_t>(rng() % 64) - 32;
+    }
+    std::vector<int64_t> v64(v32.begin(), v32.end());
+    v64[17] = INT64_MAX;
+    v64[40] = INT64_MIN;
+    std::vector<float> vf(v32.begin(), v32.end());
+
+    for_each_simd_level([&](linear_search_simd_t level) {
+        for (size_t n = 0; n <= v32.size(); n += (n < 40 ? 1 : 37))
+        {
+            for (int key = -34; key <= 34; key += 3)
+            {
+                ASSERT_EQ(linear_find_int32(v32.data(), n, key), expected_find(v32, n, key)) << level << " " << n;
+                ASSERT_EQ(linear_count_int32(v32.data(), n, key),
+                          static_cast<size_t>(std::count(v32.begin(), v32.begin() + n, key)));
+                ASSERT_EQ(linear_find_first_greater_int32(v32.data(), n, key), expected_greater(v32, n, key));
+
+                ASSERT_EQ(linear_find_int64(v64.data(), n, key), expected_find(v64, n, static_cast<int64_t>(key)));
+                ASSERT_EQ(linear_count_int64(v64.data(), n, key),
+                          static_cast<size_t>(std::count(v64.begin(), v64.begin() + n, key)));
+                ASSERT_EQ(linear_find_first_greater_int64(v64.data(), n, key),
+                          expected_greater(v64, n, static_cast<int64_t>(key)));
+
+                float fkey = static_cast<float>(key);
+                ASSERT_EQ(linear_find_float(vf.data(), n, fkey), expected_find(vf, n, fkey));
+                ASSERT_EQ(linear_count_float(vf.data(), n, fkey),
+                          static_cast<size_t>(std::count(vf.begin(), vf.begin() + n, fkey)));
+                ASSERT_EQ(linear_find_first_greater_float(vf.data(), n, fkey), expected_greater(vf, n, fkey));
+            }
+            ASSERT_EQ(linear_find_int64(v64.data(), n, INT64_MIN), expected_find(v64, n, INT64_MIN));
+            ASSERT_EQ(linear_find_first_greater_int64(v64.data(), n, INT64_MAX - 1),
+                      expected_greater(v64, n, INT64_MAX - 1));
+        }
+    });
+}
+
+TEST_F(LinearSearchTest, FloatNaN)
+{
+    std::vector<float> v(20, 1.0f);
+    v[5] = std::numeric_limits<float>::quiet_NaN();
+    for_each_simd_level([&](linear_search_simd_t) {
+        EXPECT_EQ(linear_find_float(v.data(), v.size(), std::numeric_limits<float>::quiet_NaN()), SEARCH_NOT_FOUND);
+        EXPECT_EQ(linear_count_float(v.data(), v.size(), 1.0f), 19u);
+        EXPECT_EQ(linear_find_first_greater_float(v.data(), v.size(), 0.0f), 0u);
+        EXPECT_EQ(linear_find_first_greater_float(v.data(), v.size(), 1.0f), v.size());
+    });
+}
+
+TEST_F(LinearSearchTest, AdaptiveUpperBound)
+{
+    size_t original = linear_search_crossover_bytes();
+    std::vector<int32_t> v(sorted_int_vector.begin(), sorted_int_vector.begin() + 1000);
+    std::vector<int64_t> v64(v.begin(), v.end());
+    std::vector<float> vf(v.begin(), v.end());
+    // 分界点为 0 时全部走二分查找，足够大时全部走顺序扫描
+    for (size_t crossover : {static_cast<size_t>(0), static_cast<size_t>(256), static_cast<size_t>(1) << 20})
+    {
+        linear_search_set_crossover_bytes(crossover);
+        for (size_t n : {0u, 1u, 7u, 64u, 65u, 1000u})
+        {
+            for (int key = -1; key <= static_cast<int>(n); key += 1 + static_cast<int>(n) / 50)
+            {
+                size_t expected = std::upper_bound(v.begin(), v.begin() + n, key) - v.begin();
+                ASSERT_EQ(adaptive_upper_bound_int32(v.data(), n, key), expected) << crossover << " " << n;
+                ASSERT_EQ(adaptive_upper_bound_int64(v64.data(), n, key), expected);
+                ASSERT_EQ(adaptive_upper_bound_float(vf.data(), n, static_cast<float>(key)), expected);
+            }
+        }
+    }
+    linear_search_set_crossover_bytes(original);
+}
+
+TEST_F(LinearSearchTest, CalibrateSetsCrossover)
+{
+    size_t original = linear_search_crossover_bytes();
+    size_t crossover = linear_search_calibrate();
+    EXPECT_EQ(linear_search_crossover_bytes(), crossover);
+    EXPECT_EQ(crossover % sizeof(int32_t), 0u);
+    linear_search_set_crossover_bytes(original);
+}
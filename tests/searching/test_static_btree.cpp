@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cstdint>
+#include "searching/static_btree.h"
+#include "searching/binary_search.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    std::vector<int> sorted_with_duplicates(size_t n, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<int> v(n);
+        for (auto &x : v)
+        {
+            x = static_cast<int>(rng() % (n / 2 + 1)) * 2;
+        }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+}
+
+class StaticBtreeTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    StaticBtreeTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(StaticBtreeTest, InvalidAndEmpty)
+{
+    stree_t *tree = nullptr;
+    EXPECT_EQ(stree_build_int32(nullptr, 10, &tree), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(stree_build_int32(sorted_int_vector.data(), 10, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(stree_lower_bound_int32(nullptr, 1), 0u);
+    stree_destroy(nullptr);
+
+    ASSERT_EQ(stree_build_int32(nullptr, 0, &tree), SORT_SUCCESS);
+    EXPECT_EQ(stree_size(tree), 0u);
+    EXPECT_EQ(stree_lower_bound_int32(tree, 5), 0u);
+    EXPECT_EQ(stree_lower_bound_int32(tree, INT32_MAX), 0u);
+    stree_destroy(tree);
+}
+
+TEST_F(StaticBtreeTest, LowerBoundMatchesStd)
+{
+    // 覆盖单层、两层、多层以及最后一个叶子/节点不满的情况
+    for (size_t n : {1u, 15u, 16u, 17u, 272u, 273u, 4913u, 5000u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, static_cast<unsigned>(n));
+        std::vector<int32_t> v32(v.begin(), v.end());
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<float> vf(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        stree_t *t32, *t64, *tf, *td;
+        ASSERT_EQ(stree_build_int32(v32.data(), n, &t32), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_int64(v64.data(), n, &t64), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_float(vf.data(), n, &tf), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_double(vd.data(), n, &td), SORT_SUCCESS);
+        EXPECT_EQ(stree_size(t32), n);
+        EXPECT_TRUE(std::equal(v32.begin(), v32.end(), stree_keys_int32(t32)));
+        for (int key = -3; key <= static_cast<int>(n) + 3; key += (n > 5000 ? 7 : 1))
+        {
+            size_t lo = std::lower_bound(v.begin(), v.end(), key) - v.begin();
+            ASSERT_EQ(stree_lower_bound_int32(t32, key), lo) << n << " " << key;
+            ASSERT_EQ(stree_lower_bound_int64(t64, key), lo) << n << " " << key;
+            ASSERT_EQ(stree_lower_bound_float(tf, static_cast<float>(key)), lo) << n << " " << key;
+            ASSERT_EQ(stree_lower_bound_double(td, key + 0.0), lo) << n << " " << key;
+        }
+        EXPECT_EQ(stree_lower_bound_int32(t32, INT32_MIN), 0u);
+        EXPECT_EQ(stree_lower_bound_int32(t32, INT32_MAX), n);
+        EXPECT_EQ(stree_lower_bound_int64(t64, INT64_MAX), n);
+        EXPECT_EQ(stree_lower_bound_double(td, std::numeric_limits<double>::infinity()), n);
+        stree_destroy(t32);
+        stree_destroy(t64);
+        stree_destroy(tf);
+        stree_destroy(td);
+    }
+}
+
+TEST_F(StaticBtreeTest, MaxValueKeys)
+{
+    // 数据里的最大值与补齐用的值相同
+    std::vector<int32_t> v = {1, 2, INT32_MAX, INT32_MAX};
+    stree_t *tree;
+    ASSERT_EQ(stree_build_int32(v.data(), v.size(), &tree), SORT_SUCCESS);
+    EXPECT_EQ(stree_lower_bound_int32(tree, 3), 2u);
+    EXPECT_EQ(stree_lower_bound_int32(tree, INT32_MAX), 2u);
+    stree_destroy(tree);
+}
+
+TEST_F(StaticBtreeTest, BatchMatchesScalar)
+{
+    const size_t num_keys = SEARCH_BATCH_WIDTH * 50 + 3;
+    for (size_t n : {1u, 100u, 100000u})
+    {
+        auto v = sorted_with_duplicates(n, 3);
+        std::vector<int64_t> v64(v.begin(), v.end());
+        std::vector<float> vf(v.begin(), v.end());
+        std::vector<double> vd(v.begin(), v.end());
+        stree_t *t32, *t64, *tf, *td;
+        ASSERT_EQ(stree_build_int32(v.data(), n, &t32), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_int64(v64.data(), n, &t64), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_float(vf.data(), n, &tf), SORT_SUCCESS);
+        ASSERT_EQ(stree_build_double(vd.data(), n, &td), SORT_SUCCESS);
+
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<int32_t> keys(num_keys);
+        for (auto &k : keys)
+        {
+            k = static_cast<int32_t>(rng() % (n + 10)) - 5;
+        }
+        std::vector<int64_t> keys64(keys.begin(), keys.end());
+        std::vector<float> keysf(keys.begin(), keys.end());
+        std::vector<double> keysd(keys.begin(), keys.end());
+
+        std::vector<size_t> out(num_keys), out64(num_keys), outf(num_keys), outd(num_keys);
+        stree_lower_bound_int32_batch(t32, keys.data(), num_keys, out.data());
+        stree_lower_bound_int64_batch(t64, keys64.data(), num_keys, out64.data());
+        stree_lower_bound_float_batch(tf, keysf.data(), num_keys, outf.data());
+        stree_lower_bound_double_batch(td, keysd.data(), num_keys, outd.data());
+        for (size_t i = 0; i < num_keys; i++)
+        {
+            size_t expected = std::lower_bound(v.begin(), v.end(), keys[i]) - v.begin();
+            ASSERT_EQ(out[i], expected) << n << " " << i;
+            ASSERT_EQ(out64[i], expected);
+            ASSERT_EQ(outf[i], expected);
+            ASSERT_EQ(outd[i], expected);
+        }
+        stree_destroy(t32);
+        stree_destroy(t64);
+        stree_destroy(tf);
+        stree_destroy(td);
+    }
+}
+
+TEST_F(StaticBtreeTest, RangeScan)
+{
+    std::vector<int32_t> v(sorted_int_vector.begin(), sorted_int_vector.end());
+    stree_t *tree;
+    ASSERT_EQ(stree_build_int32(v.data(), v.size(), &tree), SORT_SUCCESS);
+    const int32_t *keys = stree_keys_int32(tree);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 1000; i++)
+    {
+        int32_t lo = v[rng() % v.size()];
+        int32_t hi = v[rng() % v.size()];
+        size_t begin, end;
+        stree_range_int32(tree, lo, hi, &begin, &end);
+        auto first = std::lower_bound(v.begin(), v.end(), lo);
+        auto last = lo < hi ? std::lower_bound(v.begin(), v.end(), hi) : first;
+        ASSERT_EQ(begin, static_cast<size_t>(first - v.begin()));
+        ASSERT_EQ(end, static_cast<size_t>(last - v.begin()));
+        for (size_t j = begin; j < end; j++)
+        {
+            ASSERT_GE(keys[j], lo);
+            ASSERT_LT(keys[j], hi);
+        }
+    }
+    stree_destroy(tree);
+}
+
+TEST_F(StaticBtreeTest, ReportsBuildCost)
+{
+    std::vector<int32_t> v(sorted_int_vector.begin(), sorted_int_vector.end());
+    stree_t *tree;
+    sort_stats_t stats;
+    ASSERT_EQ(stree_build_int32_ex(v.data(), v.size(), &tree, &stats), SORT_SUCCESS);
+    EXPECT_EQ(stats.array_length, v.size());
+    EXPECT_EQ(stats.max_mamory_used, stree_memory_bytes(tree));
+    EXPECT_GE(stats.time_elapsed_ms, 0.0);
+    // 叶子层加上约 1/16 的内部节点
+    EXPECT_GE(stree_memory_bytes(tree), v.size() * sizeof(int32_t));
+    EXPECT_LE(stree_memory_bytes(tree), v.size() * sizeof(int32_t) * 9 / 8 + 64);
+    stree_destroy(tree);
+}
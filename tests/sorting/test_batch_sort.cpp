@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "algorithms.h"
+#include "sorting/batch_sort.h"
+#include "sorting/parallel_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Record
+    {
+        int key;
+        char payload[92];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Record *>(a)->key;
+        int kb = static_cast<const Record *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    // 随机生成段长度，混合各个长度级别
+    std::vector<size_t> random_offsets(size_t num_segments, size_t max_len, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<size_t> offsets(num_segments + 1, 0);
+        for (size_t i = 0; i < num_segments; i++)
+        {
+            offsets[i + 1] = offsets[i] + rng() % (max_len + 1);
+        }
+        return offsets;
+    }
+
+    void expect_segments_sorted(const std::vector<int> &original, const std::vector<int> &sorted,
+                                const std::vector<size_t> &offsets)
+    {
+        for (size_t i = 0; i + 1 < offsets.size(); i++)
+        {
+            std::vector<int> expected(original.begin() + offsets[i], original.begin() + offsets[i + 1]);
+            std::sort(expected.begin(), expected.end());
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), sorted.begin() + offsets[i])) << "segment " << i;
+        }
+    }
+}
+
+class BatchSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    BatchSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(BatchSortTest, InvalidArguments)
+{
+    int data[4] = {3, 2, 1, 0};
+    size_t offsets[] = {0, 2, 4};
+    size_t bad_offsets[] = {0, 3, 2};
+    EXPECT_EQ(generic_sort_batch(nullptr, offsets, 2, sizeof(int), compare_integers, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_batch(data, nullptr, 2, sizeof(int), compare_integers, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_batch(data, offsets, 2, sizeof(int), nullptr, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_batch(data, offsets, 2, 0, compare_integers, nullptr), SORT_ERROR_INVALID_ELEMENT_SIZE);
+
+    // offsets 不单调时不修改数据
+    EXPECT_EQ(generic_sort_batch(data, bad_offsets, 2, sizeof(int), compare_integers, nullptr),
+              SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(data[0], 3);
+    EXPECT_EQ(data[1], 2);
+
+    EXPECT_EQ(generic_sort_batch(data, offsets, 0, sizeof(int), compare_integers, nullptr), SORT_SUCCESS);
+}
+
+TEST_F(BatchSortTest, SegmentsSortedIndependently)
+{
+    auto offsets = random_offsets(5000, 300, 1);
+    auto values = get_random_int_vecotor<TEST_DATA_SIZE * 10, 0, 2000>();
+    ASSERT_GE(values.size(), offsets.back());
+    values.resize(offsets.back());
+    auto original = values;
+
+    std::vector<sort_result_t> results(offsets.size() - 1, SORT_ERROR_IO);
+    EXPECT_EQ(generic_sort_batch(values.data(), offsets.data(), offsets.size() - 1, sizeof(int), compare_integers,
+                                 results.data()),
+              SORT_SUCCESS);
+    expect_segments_sorted(original, values, offsets);
+    for (sort_result_t res : results)
+    {
+        EXPECT_EQ(res, SORT_SUCCESS);
+    }
+}
+
+TEST_F(BatchSortTest, TinySegmentsAndNonZeroBase)
+{
+    // 全部是排序网络处理的长度，且 offsets 不从 0 开始
+    auto offsets = random_offsets(20000, SORTING_NETWORK_MAX, 2);
+    for (auto &off : offsets)
+    {
+        off += 7;
+    }
+    auto values = get_random_int_vecotor<TEST_DATA_SIZE * 2, 0, 50>();
+    ASSERT_GE(values.size(), offsets.back());
+    auto original = values;
+    EXPECT_EQ(generic_sort_batch(values.data(), offsets.data(), offsets.size() - 1, sizeof(int), compare_integers,
+                                 nullptr),
+              SORT_SUCCESS);
+    expect_segments_sorted(original, values, offsets);
+    EXPECT_TRUE(std::equal(original.begin(), original.begin() + 7, values.begin()));
+    EXPECT_TRUE(std::equal(original.begin() + offsets.back(), original.end(), values.begin() + offsets.back()));
+}
+
+TEST_F(BatchSortTest, LargeElements)
+{
+    auto offsets = random_offsets(500, 100, 3);
+    std::mt19937 rng(3);
+    std::vector<Record> records(offsets.back());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        records[i].key = (int)(rng() % 1000);
+        records[i].payload[0] = (char)records[i].key;
+    }
+    EXPECT_EQ(generic_sort_batch(records.data(), offsets.data(), offsets.size() - 1, sizeof(Record), compare_records,
+                                 nullptr),
+              SORT_SUCCESS);
+    for (size_t s = 0; s + 1 < offsets.size(); s++)
+    {
+        for (size_t i = offsets[s]; i < offsets[s + 1]; i++)
+        {
+            ASSERT_EQ(records[i].payload[0], (char)records[i].key);
+            if (i > offsets[s])
+            {
+                ASSERT_LE(records[i - 1].key, records[i].key);
+            }
+        }
+    }
+}
+
+TEST_F(BatchSortTest, ParallelWithLargeSegment)
+{
+    ASSERT_EQ(algorithms_set_thread_count(4), 0);
+    parallel_sort_set_cutoff(1024);
+
+    // 许多小段中夹着一个超过顺序阈值、单独并行排序的大段
+    auto offsets = random_offsets(3000, 200, 4);
+    size_t big = 1500;
+    size_t shift = 50000;
+    for (size_t i = big + 1; i < offsets.size(); i++)
+    {
+        offsets[i] += shift;
+    }
+    auto values = get_random_int_vecotor<TEST_DATA_SIZE * 10, 0, 200000>();
+    ASSERT_GE(values.size(), offsets.back());
+    values.resize(offsets.back());
+    auto original = values;
+
+    sort_stats_t stats;
+    std::vector<sort_result_t> results(offsets.size() - 1, SORT_ERROR_IO);
+    EXPECT_EQ(generic_sort_batch_ex(values.data(), offsets.data(), offsets.size() - 1, sizeof(int), compare_integers,
+                                    results.data(), &stats),
+              SORT_SUCCESS);
+    expect_segments_sorted(original, values, offsets);
+    EXPECT_TRUE(std::all_of(results.begin(), results.end(), [](sort_result_t r) { return r == SORT_SUCCESS; }));
+    EXPECT_EQ(stats.array_length, offsets.back());
+
+    parallel_sort_set_cutoff(0);
+    algorithms_cleanup();
+}
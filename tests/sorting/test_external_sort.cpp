@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "sorting/external_sort.h"
+#include "util/thread_pool.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Record
+    {
+        int key;
+        int seq;
+        char payload[24];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Record *>(a)->key;
+        int kb = static_cast<const Record *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    template <typename T>
+    void write_file(const std::string &path, const std::vector<T> &data)
+    {
+        FILE *fp = fopen(path.c_str(), "wb");
+        ASSERT_NE(fp, nullptr);
+        if (!data.empty())
+        {
+            ASSERT_EQ(fwrite(data.data(), sizeof(T), data.size(), fp), data.size());
+        }
+        fclose(fp);
+    }
+
+    template <typename T>
+    std::vector<T> read_file(const std::string &path)
+    {
+        std::vector<T> data;
+        FILE *fp = fopen(path.c_str(), "rb");
+        EXPECT_NE(fp, nullptr);
+        if (nullptr == fp)
+        {
+            return data;
+        }
+        T value;
+        while (fread(&value, sizeof(T), 1, fp) == 1)
+        {
+            data.push_back(value);
+        }
+        fclose(fp);
+        return data;
+    }
+}
+
+class ExternalSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    ExternalSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+
+    void SetUp() override
+    {
+        char dir[] = "/tmp/external_sort_test_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        temp_dir = dir;
+        input_path = temp_dir + "/input.bin";
+        output_path = temp_dir + "/output.bin";
+    }
+
+    void TearDown() override
+    {
+        unlink(input_path.c_str());
+        unlink(output_path.c_str());
+        // 临时 run 文件创建后立即 unlink，目录此时应为空
+        EXPECT_EQ(rmdir(temp_dir.c_str()), 0);
+    }
+
+    external_sort_options_t options(size_t budget, int stable = 0) const
+    {
+        external_sort_options_t opt;
+        opt.memory_budget = budget;
+        opt.temp_dir = temp_dir.c_str();
+        opt.stable = stable;
+        return opt;
+    }
+
+    std::string temp_dir;
+    std::string input_path;
+    std::string output_path;
+};
+
+TEST_F(ExternalSortTest, InvalidArguments)
+{
+    auto opt = options(1 << 20);
+    EXPECT_EQ(generic_external_sort(nullptr, output_path.c_str(), sizeof(int), compare_integers, &opt, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, nullptr), SORT_ERROR_IO);
+
+    write_file(input_path, std::vector<char>(10, 'x'));
+    EXPECT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, nullptr), SORT_ERROR_INVALID_LENGTH);
+    auto tiny = options(2 * sizeof(int));
+    EXPECT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &tiny, nullptr), SORT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(ExternalSortTest, EmptyFile)
+{
+    write_file(input_path, std::vector<int>());
+    auto opt = options(1 << 20);
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, nullptr), SORT_SUCCESS);
+    EXPECT_TRUE(read_file<int>(output_path).empty());
+}
+
+TEST_F(ExternalSortTest, FitsInMemory)
+{
+    write_file(input_path, get_shuffled_int_vector());
+    auto opt = options(TEST_DATA_SIZE * sizeof(int) * 4);
+    sort_stats_t stats;
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, &stats), SORT_SUCCESS);
+    EXPECT_EQ(read_file<int>(output_path), sorted_int_vector);
+    EXPECT_EQ(stats.merge_passes, 0u);
+    EXPECT_EQ(stats.array_length, sorted_int_vector.size());
+    EXPECT_EQ(stats.io_bytes_read, sorted_int_vector.size() * sizeof(int));
+    EXPECT_EQ(stats.io_bytes_written, sorted_int_vector.size() * sizeof(int));
+}
+
+TEST_F(ExternalSortTest, SinglePassMerge)
+{
+    write_file(input_path, get_shuffled_int_vector());
+    // 7 个 run，预算足够一趟归并
+    auto opt = options(64 << 10);
+    sort_stats_t stats;
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, &stats), SORT_SUCCESS);
+    EXPECT_EQ(read_file<int>(output_path), sorted_int_vector);
+    EXPECT_EQ(stats.merge_passes, 1u);
+    size_t bytes = sorted_int_vector.size() * sizeof(int);
+    EXPECT_EQ(stats.io_bytes_read, 2 * bytes);
+    EXPECT_EQ(stats.io_bytes_written, 2 * bytes);
+}
+
+TEST_F(ExternalSortTest, MultiPassMergeInPlace)
+{
+    write_file(input_path, get_shuffled_int_vector());
+    // 预算只够 3 路归并，几百个 run 需要多趟；输出覆盖输入文件
+    auto opt = options(256);
+    sort_stats_t stats;
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), input_path.c_str(), sizeof(int), compare_integers, &opt, &stats), SORT_SUCCESS);
+    EXPECT_EQ(read_file<int>(input_path), sorted_int_vector);
+    EXPECT_GE(stats.merge_passes, 3u);
+    EXPECT_EQ(stats.io_bytes_read, (stats.merge_passes + 1) * sorted_int_vector.size() * sizeof(int));
+}
+
+// 各 run 依次排序并复用同一块辅助空间，峰值是 run 缓冲加一个 run 的辅助空间，
+// 不随 run 的个数增长
+TEST_F(ExternalSortTest, PeakMemoryWithinBudgetAcrossRuns)
+{
+    ASSERT_EQ(thread_pool_global_init(4), 0);
+    std::mt19937 rng(7);
+    std::vector<int> data(1 << 20);
+    for (auto &v : data)
+    {
+        v = static_cast<int>(rng() % 1000000);
+    }
+    write_file(input_path, data);
+    const size_t budget = 1 << 20;
+    auto opt = options(budget);
+    sort_stats_t stats;
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(int), compare_integers, &opt, &stats), SORT_SUCCESS);
+    thread_pool_global_shutdown();
+    std::sort(data.begin(), data.end());
+    EXPECT_EQ(read_file<int>(output_path), data);
+    EXPECT_GE(stats.merge_passes, 1u);
+#if defined(PRINT_SORTING_INFO)
+    EXPECT_GT(stats.max_mamory_used, 0u);
+    EXPECT_LE(stats.max_mamory_used, budget);
+#endif
+}
+
+TEST_F(ExternalSortTest, StableRecords)
+{
+    std::mt19937 rng(99);
+    std::vector<Record> records(20000);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        records[i].key = static_cast<int>(rng() % 50);
+        records[i].seq = static_cast<int>(i);
+        std::fill(std::begin(records[i].payload), std::end(records[i].payload), static_cast<char>(i));
+    }
+    write_file(input_path, records);
+
+    auto opt = options(8 << 10, 1);
+    ASSERT_EQ(generic_external_sort(input_path.c_str(), output_path.c_str(), sizeof(Record), compare_records, &opt, nullptr), SORT_SUCCESS);
+    auto sorted = read_file<Record>(output_path);
+    ASSERT_EQ(sorted.size(), records.size());
+    for (size_t i = 1; i < sorted.size(); i++)
+    {
+        ASSERT_LE(sorted[i - 1].key, sorted[i].key);
+        if (sorted[i - 1].key == sorted[i].key)
+        {
+            ASSERT_LT(sorted[i - 1].seq, sorted[i].seq);
+        }
+    }
+    for (const auto &r : sorted)
+    {
+        ASSERT_EQ(r.payload[23], static_cast<char>(r.seq));
+    }
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include "sorting/heap_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class HeapSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    HeapSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(HeapSortTest, NullPointerHandling)
+{
+    EXPECT_EQ(generic_heap_sort(nullptr, 10, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(HeapSortTest, EmptyArrayHandling)
+{
+    int arr[1] = {0};
+    EXPECT_EQ(generic_heap_sort(arr, 0, sizeof(int), compare_integers), SORT_SUCCESS);
+}
+
+TEST_F(HeapSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_heap_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
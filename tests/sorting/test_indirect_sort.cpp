@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include "sorting/indirect_sort.h"
+#include "sorting/merge_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    // 模拟较大的元素，key 之外的 payload 用来检查元素是否被完整移动
+    struct BigRecord
+    {
+        int key;
+        int id;
+        char payload[248];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const BigRecord *>(a)->key;
+        int kb = static_cast<const BigRecord *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+}
+
+class IndirectSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    IndirectSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(IndirectSortTest, NullPointerHandling)
+{
+    int arr[1] = {0};
+    size_t indices[1];
+    EXPECT_EQ(generic_argsort(nullptr, 10, sizeof(int), compare_integers, nullptr, indices), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_argsort(arr, 1, sizeof(int), compare_integers, nullptr, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_pointers(nullptr, 10, compare_integers, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(apply_permutation(nullptr, 10, sizeof(int), indices), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(IndirectSortTest, ArgsortLeavesInputUntouched)
+{
+    auto shuffled = get_shuffled_int_vector();
+    auto original = shuffled;
+    std::vector<size_t> indices(shuffled.size());
+    EXPECT_EQ(generic_argsort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, nullptr, indices.data()), SORT_SUCCESS);
+    EXPECT_EQ(shuffled, original);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        EXPECT_EQ(shuffled[indices[i]], sorted_int_vector[i]);
+    }
+}
+
+TEST_F(IndirectSortTest, ArgsortStableWithMergeSort)
+{
+    // 只有 10 种 key，大量重复
+    std::vector<int> keys(TEST_DATA_SIZE);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        keys[i] = static_cast<int>((i * 7919) % 10);
+    }
+    std::vector<size_t> indices(keys.size());
+    EXPECT_EQ(generic_argsort(keys.data(), keys.size(), sizeof(int), compare_integers, generic_merge_sort, indices.data()), SORT_SUCCESS);
+    for (size_t i = 1; i < indices.size(); i++)
+    {
+        ASSERT_LE(keys[indices[i - 1]], keys[indices[i]]);
+        if (keys[indices[i - 1]] == keys[indices[i]])
+        {
+            ASSERT_LT(indices[i - 1], indices[i]);
+        }
+    }
+}
+
+TEST_F(IndirectSortTest, SortPointers)
+{
+    auto shuffled = get_shuffled_int_vector();
+    auto original = shuffled;
+    std::vector<void *> ptrs(shuffled.size());
+    for (size_t i = 0; i < shuffled.size(); i++)
+    {
+        ptrs[i] = &shuffled[i];
+    }
+    EXPECT_EQ(generic_sort_pointers(ptrs.data(), ptrs.size(), compare_integers, nullptr), SORT_SUCCESS);
+    EXPECT_EQ(shuffled, original);
+    for (size_t i = 0; i < ptrs.size(); i++)
+    {
+        EXPECT_EQ(*static_cast<int *>(ptrs[i]), sorted_int_vector[i]);
+    }
+}
+
+TEST_F(IndirectSortTest, ArgsortThenApplyPermutationOnLargeRecords)
+{
+    const size_t n = 5000;
+    std::vector<BigRecord> records(n);
+    auto keys = get_shuffled_int_vector();
+    for (size_t i = 0; i < n; i++)
+    {
+        records[i].key = keys[i] % 100;
+        records[i].id = static_cast<int>(i);
+        std::fill(std::begin(records[i].payload), std::end(records[i].payload), static_cast<char>(i));
+    }
+    auto expected = records;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const BigRecord &a, const BigRecord &b) { return a.key < b.key; });
+
+    std::vector<size_t> indices(n);
+    EXPECT_EQ(generic_argsort(records.data(), n, sizeof(BigRecord), compare_records, generic_merge_sort, indices.data()), SORT_SUCCESS);
+    EXPECT_EQ(apply_permutation(records.data(), n, sizeof(BigRecord), indices.data()), SORT_SUCCESS);
+    for (size_t i = 0; i < n; i++)
+    {
+        ASSERT_EQ(records[i].id, expected[i].id);
+        ASSERT_EQ(records[i].payload[247], static_cast<char>(expected[i].id));
+    }
+}
+
+TEST_F(IndirectSortTest, ApplyPermutationRejectsInvalidPerm)
+{
+    int arr[4] = {10, 20, 30, 40};
+    size_t duplicate[4] = {0, 1, 1, 3};
+    size_t out_of_range[4] = {0, 1, 2, 4};
+    EXPECT_EQ(apply_permutation(arr, 4, sizeof(int), duplicate), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(apply_permutation(arr, 4, sizeof(int), out_of_range), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(arr[0], 10);
+    EXPECT_EQ(arr[3], 40);
+
+    size_t rotate[4] = {3, 0, 1, 2};
+    EXPECT_EQ(apply_permutation(arr, 4, sizeof(int), rotate), SORT_SUCCESS);
+    EXPECT_EQ(arr[0], 40);
+    EXPECT_EQ(arr[1], 10);
+    EXPECT_EQ(arr[2], 20);
+    EXPECT_EQ(arr[3], 30);
+}
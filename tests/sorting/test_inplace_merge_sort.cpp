@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include "sorting/inplace_merge_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    // key 相同的元素靠 index 检查稳定性；padding 让元素超过定长交换的大小
+    struct Tagged
+    {
+        int key;
+        int index;
+        char padding[40];
+    };
+
+    int compare_tagged(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Tagged *>(a)->key;
+        int kb = static_cast<const Tagged *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    std::vector<Tagged> make_tagged(size_t n, int distinct, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<Tagged> v(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            v[i].key = static_cast<int>(rng() % distinct);
+            v[i].index = static_cast<int>(i);
+            v[i].padding[39] = static_cast<char>(i);
+        }
+        return v;
+    }
+
+    void expect_stable_sorted(const std::vector<Tagged> &v)
+    {
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            ASSERT_EQ(v[i].padding[39], static_cast<char>(v[i].index));
+            if (i > 0)
+            {
+                ASSERT_LE(v[i - 1].key, v[i].key) << "at " << i;
+                if (v[i - 1].key == v[i].key)
+                {
+                    ASSERT_LT(v[i - 1].index, v[i].index) << "at " << i;
+                }
+            }
+        }
+    }
+}
+
+class InplaceMergeSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    InplaceMergeSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(InplaceMergeSortTest, InvalidArguments)
+{
+    int data[3] = {3, 1, 2};
+    int buffer[1];
+    EXPECT_EQ(generic_inplace_merge_sort(nullptr, 3, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_inplace_merge_sort(data, 3, sizeof(int), nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_inplace_merge_sort(data, 3, 0, compare_integers), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(generic_inplace_merge_sort_with_buffer(data, 3, sizeof(int), compare_integers, nullptr, 1),
+              SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_inplace_merge_sort_with_buffer(data, 3, sizeof(int), compare_integers, buffer, 0),
+              SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(generic_inplace_merge_sort(data, 1, sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_EQ(data[0], 3);
+}
+
+TEST_F(InplaceMergeSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_inplace_merge_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+
+    // 已经有序、逆序的输入
+    EXPECT_EQ(generic_inplace_merge_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    std::reverse(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(generic_inplace_merge_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(InplaceMergeSortTest, StableWithDuplicates)
+{
+    for (size_t n : {2u, 17u, 33u, 100u, 1000u, 12345u})
+    {
+        for (int distinct : {1, 3, 100, 1000000})
+        {
+            auto v = make_tagged(n, distinct, static_cast<unsigned>(n + distinct));
+            ASSERT_EQ(generic_inplace_merge_sort(v.data(), v.size(), sizeof(Tagged), compare_tagged), SORT_SUCCESS);
+            expect_stable_sorted(v);
+        }
+    }
+}
+
+TEST_F(InplaceMergeSortTest, TinyBufferUsesRotations)
+{
+    // 只有一个元素的辅助空间：几乎所有归并都走 SymMerge 和三次反转
+    auto v = make_tagged(TEST_DATA_SIZE, 50, 7);
+    Tagged buffer[1];
+    ASSERT_EQ(generic_inplace_merge_sort_with_buffer(v.data(), v.size(), sizeof(Tagged), compare_tagged, buffer, 1),
+              SORT_SUCCESS);
+    expect_stable_sorted(v);
+
+    auto ints = get_random_int_vecotor<TEST_DATA_SIZE, 0, 1000>();
+    auto expected = ints;
+    std::stable_sort(expected.begin(), expected.end());
+    int ibuf[3];
+    ASSERT_EQ(generic_inplace_merge_sort_with_buffer(ints.data(), ints.size(), sizeof(int), compare_integers, ibuf, 3),
+              SORT_SUCCESS);
+    EXPECT_EQ(ints, expected);
+}
+
+#if defined(PRINT_SORTING_INFO)
+TEST_F(InplaceMergeSortTest, ComparisonsAreNLogN)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    ASSERT_EQ(generic_inplace_merge_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, &stats),
+              SORT_SUCCESS);
+    double n = static_cast<double>(shuffled.size());
+    EXPECT_LT(static_cast<double>(stats.comparisons), 2.0 * n * std::log2(n));
+}
+#endif
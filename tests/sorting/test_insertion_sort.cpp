@@ -73,6 +73,19 @@ TEST_F(InsertionSortTest, SingleElementArray)
     EXPECT_EQ(result, SORT_SUCCESS);
 }
 
+// 指针数组版本的插入排序以前从不和第 0 个元素比较，最小值最后出现时排不到最前面
+TEST_F(InsertionSortTest, PointerInsertionSortReachesFront)
+{
+    std::vector<int> values = {5, 3, 4, 1};
+    std::vector<void *> ptrs;
+    for (auto &v : values)
+    {
+        ptrs.push_back(&v);
+    }
+    ASSERT_EQ(generic_insertion_sort(ptrs.data(), ptrs.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_EQ(values, (std::vector<int>{1, 3, 4, 5}));
+}
+
 // TEST_F(InsertionSortTest, BinaryInsertionSort)
 // {
 //     auto shuffled_vector = get_shuffled_int_vector();
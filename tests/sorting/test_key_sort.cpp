@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include "sorting/key_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Name
+    {
+        char text[32];
+        int id;
+    };
+
+    int compare_names(const void *const a, const void *const b)
+    {
+        return strcmp(static_cast<const Name *>(a)->text, static_cast<const Name *>(b)->text);
+    }
+
+    // 前 8 字节按大端拼成整数，与 strcmp 的顺序一致
+    uint64_t name_prefix_key(const void *const elem)
+    {
+        const unsigned char *s = reinterpret_cast<const unsigned char *>(static_cast<const Name *>(elem)->text);
+        uint64_t key = 0;
+        size_t i = 0;
+        for (; i < 8 && s[i] != '\0'; i++)
+        {
+            key = (key << 8) | s[i];
+        }
+        return key << (8 * (8 - i));
+    }
+
+    uint64_t int_key(const void *const elem)
+    {
+        return static_cast<uint64_t>(*static_cast<const int *>(elem)) ^ (1ULL << 63);
+    }
+
+    uint64_t int_key_div_16(const void *const elem)
+    {
+        return static_cast<uint64_t>(static_cast<int64_t>(*static_cast<const int *>(elem)) >> 4) ^ (1ULL << 63);
+    }
+}
+
+class KeySortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    KeySortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(KeySortTest, NullPointerHandling)
+{
+    int arr[1] = {0};
+    EXPECT_EQ(generic_key_sort(nullptr, 10, sizeof(int), int_key, compare_integers, nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_key_sort(arr, 1, sizeof(int), nullptr, compare_integers, nullptr), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(KeySortTest, EmptyArrayHandling)
+{
+    int arr[1] = {0};
+    EXPECT_EQ(generic_key_sort(arr, 0, sizeof(int), int_key, compare_integers, nullptr), SORT_SUCCESS);
+}
+
+TEST_F(KeySortTest, DistinctKeysNeedNoComparisons)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    EXPECT_EQ(generic_key_sort(shuffled.data(), shuffled.size(), sizeof(int), int_key, compare_integers, &stats), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    EXPECT_EQ(stats.comparisons, 0u);
+    EXPECT_GT(stats.comparisons_avoided, 0u);
+    EXPECT_EQ(stats.array_length, shuffled.size());
+}
+
+TEST_F(KeySortTest, CoarseKeysFallBackToComparator)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    EXPECT_EQ(generic_key_sort(shuffled.data(), shuffled.size(), sizeof(int), int_key_div_16, compare_integers, &stats), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    EXPECT_GT(stats.comparisons, 0u);
+}
+
+TEST_F(KeySortTest, StringPrefixKeysAreStable)
+{
+    const char *words[] = {"alphabet", "alphabetical", "alpha", "beta", "alphabetic", "gamma", "alphabet", "beta"};
+    const size_t word_count = sizeof(words) / sizeof(words[0]);
+    std::vector<Name> names;
+    for (int i = 0; i < 2000; i++)
+    {
+        Name n{};
+        strcpy(n.text, words[(i * 7) % word_count]);
+        n.id = i;
+        names.push_back(n);
+    }
+    auto expected = names;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const Name &a, const Name &b) { return strcmp(a.text, b.text) < 0; });
+
+    EXPECT_EQ(generic_key_sort(names.data(), names.size(), sizeof(Name), name_prefix_key, compare_names, nullptr), SORT_SUCCESS);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        ASSERT_STREQ(names[i].text, expected[i].text);
+        ASSERT_EQ(names[i].id, expected[i].id);
+    }
+}
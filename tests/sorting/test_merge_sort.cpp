@@ -46,3 +46,35 @@ TEST_F(MergeSortTest, IntegerBenchmakrTest)
     auto vec = get_random_int_vecotor<TEST_DATA_SIZE, 0, 1000000>();
     generic_merge_sort(vec.data(), vec.size(), sizeof(int), compare_integers);
 }
+
+TEST_F(MergeSortTest, WithBufferSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    std::vector<int> buffer(shuffled.size());
+    EXPECT_EQ(generic_merge_sort_with_buffer(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, nullptr),
+              SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_merge_sort_with_buffer(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, buffer.data()),
+              SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(MergeSortTest, StabilityTest)
+{
+    // first 为排序键，second 记录原始位置
+    std::vector<std::pair<int, int>> records;
+    auto keys = get_random_int_vecotor<TEST_DATA_SIZE, 0, 100>();
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        records.emplace_back(keys[i], static_cast<int>(i));
+    }
+    // compare_integers 只比较 pair 的第一个成员
+    generic_merge_sort(records.data(), records.size(), sizeof(records[0]), compare_integers);
+    for (size_t i = 1; i < records.size(); i++)
+    {
+        ASSERT_LE(records[i - 1].first, records[i].first);
+        if (records[i - 1].first == records[i].first)
+        {
+            ASSERT_LT(records[i - 1].second, records[i].second);
+        }
+    }
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "sorting/nth_element.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Record
+    {
+        int key;
+        char payload[60];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Record *>(a)->key;
+        int kb = static_cast<const Record *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    size_t g_comparisons = 0;
+
+    int counting_compare(const void *const a, const void *const b)
+    {
+        g_comparisons++;
+        return compare_integers(a, b);
+    }
+
+    // McIlroy 的快速排序对手(antiqsort)：元素是下标，值在比较时才确定。
+    // 两个未定值(gas)的元素比较时，把刚参与过比较的那个(多半是枢轴候选)定为
+    // 当前最小的值，枢轴因此总落在很靠前的位置，每次划分只切下几个元素。
+    // 跑完后把各下标的值作为输入，同一算法会重走完全相同的比较序列。
+    std::vector<int> g_adversary_values;
+    int g_adversary_solid = 0;
+    int g_adversary_candidate = 0;
+    int g_adversary_gas = 0;
+
+    int adversary_compare(const void *const a, const void *const b)
+    {
+        int x = *static_cast<const int *>(a);
+        int y = *static_cast<const int *>(b);
+        std::vector<int> &val = g_adversary_values;
+        if (val[x] == g_adversary_gas && val[y] == g_adversary_gas)
+        {
+            val[x == g_adversary_candidate ? x : y] = g_adversary_solid++;
+        }
+        if (val[x] == g_adversary_gas)
+        {
+            g_adversary_candidate = x;
+        }
+        else if (val[y] == g_adversary_gas)
+        {
+            g_adversary_candidate = y;
+        }
+        return (val[x] > val[y]) - (val[x] < val[y]);
+    }
+
+    std::vector<int> make_killer_input(size_t n, size_t nth)
+    {
+        g_adversary_gas = static_cast<int>(n);
+        g_adversary_values.assign(n, g_adversary_gas);
+        g_adversary_solid = 0;
+        g_adversary_candidate = 0;
+        std::vector<int> ids(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            ids[i] = static_cast<int>(i);
+        }
+        EXPECT_EQ(generic_nth_element(ids.data(), n, sizeof(int), adversary_compare, nth), SORT_SUCCESS);
+        // 从未与另一个未定值比较过的元素都大于已定值，互相之间取不同的值即可
+        for (auto &v : g_adversary_values)
+        {
+            if (v == g_adversary_gas)
+            {
+                v = g_adversary_solid++;
+            }
+        }
+        return g_adversary_values;
+    }
+
+    // arr[nth] 等于排序后的值，且左侧都不大于、右侧都不小于它
+    void expect_nth_partitioned(const std::vector<int> &data, size_t nth, const std::vector<int> &sorted)
+    {
+        ASSERT_EQ(data[nth], sorted[nth]);
+        for (size_t i = 0; i < nth; i++)
+        {
+            ASSERT_LE(data[i], data[nth]);
+        }
+        for (size_t i = nth + 1; i < data.size(); i++)
+        {
+            ASSERT_GE(data[i], data[nth]);
+        }
+    }
+}
+
+class NthElementTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    NthElementTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(NthElementTest, NullPointerHandling)
+{
+    EXPECT_EQ(generic_nth_element(nullptr, 10, sizeof(int), compare_integers, 0), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_partial_sort(nullptr, 10, sizeof(int), compare_integers, 1), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(NthElementTest, OutOfRangeIndex)
+{
+    int arr[3] = {3, 1, 2};
+    EXPECT_EQ(generic_nth_element(arr, 3, sizeof(int), compare_integers, 3), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(generic_nth_element(arr, 0, sizeof(int), compare_integers, 0), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(generic_partial_sort(arr, 3, sizeof(int), compare_integers, 4), SORT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(generic_partial_sort(arr, 3, sizeof(int), compare_integers, 0), SORT_SUCCESS);
+}
+
+TEST_F(NthElementTest, MedianAndPercentiles)
+{
+    auto shuffled = get_shuffled_int_vector();
+    size_t n = shuffled.size();
+    for (size_t nth : {size_t(0), n / 100, n / 2, n * 99 / 100, n - 1})
+    {
+        auto data = shuffled;
+        ASSERT_EQ(generic_nth_element(data.data(), n, sizeof(int), compare_integers, nth), SORT_SUCCESS);
+        expect_nth_partitioned(data, nth, sorted_int_vector);
+    }
+}
+
+TEST_F(NthElementTest, ComparisonsAreLinear)
+{
+    auto shuffled = get_shuffled_int_vector();
+    g_comparisons = 0;
+    ASSERT_EQ(generic_nth_element(shuffled.data(), shuffled.size(), sizeof(int), counting_compare, shuffled.size() / 2), SORT_SUCCESS);
+    EXPECT_LT(g_comparisons, 6 * shuffled.size());
+}
+
+// 对手输入让取中选出的枢轴总是很小，划分次数耗尽 2·log2(n) 的预算后
+// 必须转入 median-of-medians，比较次数才能保持线性
+TEST_F(NthElementTest, MedianOfThreeKillerFallsBack)
+{
+    const size_t n = 1 << 15;
+    const size_t nth = n / 2;
+    std::vector<int> data = make_killer_input(n, nth);
+    std::vector<int> sorted(data);
+    std::sort(sorted.begin(), sorted.end());
+    g_comparisons = 0;
+    ASSERT_EQ(generic_nth_element(data.data(), n, sizeof(int), counting_compare, nth), SORT_SUCCESS);
+    expect_nth_partitioned(data, nth, sorted);
+    EXPECT_LT(g_comparisons, 40 * n);
+}
+
+TEST_F(NthElementTest, RandomSizesAndDuplicates)
+{
+    std::mt19937 rng(42);
+    for (int round = 0; round < 300; round++)
+    {
+        size_t n = 1 + rng() % 3000;
+        int range = (round % 3 == 0) ? 4 : 1000000;
+        std::vector<int> data(n);
+        for (auto &v : data)
+        {
+            v = static_cast<int>(rng() % range);
+        }
+        if (round % 5 == 1)
+        {
+            std::sort(data.begin(), data.end());
+        }
+        else if (round % 5 == 2)
+        {
+            std::sort(data.rbegin(), data.rend());
+        }
+        std::vector<int> sorted(data);
+        std::sort(sorted.begin(), sorted.end());
+        size_t nth = rng() % n;
+        ASSERT_EQ(generic_nth_element(data.data(), n, sizeof(int), compare_integers, nth), SORT_SUCCESS);
+        expect_nth_partitioned(data, nth, sorted);
+    }
+}
+
+TEST_F(NthElementTest, AllEqualElements)
+{
+    std::vector<int> data(TEST_DATA_SIZE, 7);
+    g_comparisons = 0;
+    ASSERT_EQ(generic_nth_element(data.data(), data.size(), sizeof(int), counting_compare, data.size() / 3), SORT_SUCCESS);
+    EXPECT_EQ(data[data.size() / 3], 7);
+    EXPECT_LT(g_comparisons, 6 * data.size());
+}
+
+TEST_F(NthElementTest, PartialSortSmallestK)
+{
+    auto shuffled = get_shuffled_int_vector();
+    for (size_t k : {size_t(1), size_t(100), shuffled.size() / 2, shuffled.size()})
+    {
+        auto data = shuffled;
+        ASSERT_EQ(generic_partial_sort(data.data(), data.size(), sizeof(int), compare_integers, k), SORT_SUCCESS);
+        EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.begin() + k, data.begin()));
+        std::sort(data.begin() + k, data.end());
+        EXPECT_TRUE(std::equal(sorted_int_vector.begin() + k, sorted_int_vector.end(), data.begin() + k));
+    }
+}
+
+TEST_F(NthElementTest, PartialSortLargeRecords)
+{
+    std::mt19937 rng(7);
+    std::vector<Record> records(5000);
+    for (auto &r : records)
+    {
+        r.key = static_cast<int>(rng() % 1000);
+        std::fill(std::begin(r.payload), std::end(r.payload), static_cast<char>(r.key));
+    }
+    std::vector<int> keys;
+    for (const auto &r : records)
+    {
+        keys.push_back(r.key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    const size_t k = 50;
+    ASSERT_EQ(generic_partial_sort(records.data(), records.size(), sizeof(Record), compare_records, k), SORT_SUCCESS);
+    for (size_t i = 0; i < k; i++)
+    {
+        EXPECT_EQ(records[i].key, keys[i]);
+        EXPECT_EQ(records[i].payload[59], static_cast<char>(records[i].key));
+    }
+}
+
+TEST_F(NthElementTest, ExRecordsStats)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    g_comparisons = 0;
+    ASSERT_EQ(generic_partial_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), counting_compare, 10, &stats), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.begin() + 10, shuffled.begin()));
+    EXPECT_EQ(stats.array_length, shuffled.size());
+    EXPECT_GE(stats.end_time, stats.start_time);
+#if defined(PRINT_SORTING_INFO)
+    EXPECT_EQ(stats.comparisons, g_comparisons);
+#endif
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "algorithms.h"
+#include "sorting/parallel_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class ParallelSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    ParallelSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+
+    static void SetUpTestSuite()
+    {
+        ASSERT_EQ(algorithms_set_thread_count(4), 0);
+        // 让测试数据量也走并行路径
+        parallel_sort_set_cutoff(1024);
+    }
+
+    static void TearDownTestSuite()
+    {
+        parallel_sort_set_cutoff(0);
+        algorithms_cleanup();
+    }
+};
+
+TEST_F(ParallelSortTest, NullPointerHandling)
+{
+    EXPECT_EQ(generic_parallel_sort(nullptr, 10, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_parallel_stable_sort(nullptr, 10, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(ParallelSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_parallel_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+
+    shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_parallel_stable_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(ParallelSortTest, ManyDuplicates)
+{
+    auto values = get_random_int_vecotor<TEST_DATA_SIZE, 0, 3>();
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(generic_parallel_sort(values.data(), values.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_EQ(values, expected);
+}
+
+TEST_F(ParallelSortTest, StableSortKeepsOrderOfEqualKeys)
+{
+    auto keys = get_random_int_vecotor<TEST_DATA_SIZE, 0, 100>();
+    std::vector<std::pair<int, int>> records;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        records.emplace_back(keys[i], static_cast<int>(i));
+    }
+    // compare_integers 只比较 pair 的第一个成员
+    EXPECT_EQ(generic_parallel_stable_sort(records.data(), records.size(), sizeof(records[0]), compare_integers),
+              SORT_SUCCESS);
+    for (size_t i = 1; i < records.size(); i++)
+    {
+        ASSERT_LE(records[i - 1].first, records[i].first);
+        if (records[i - 1].first == records[i].first)
+        {
+            ASSERT_LT(records[i - 1].second, records[i].second);
+        }
+    }
+}
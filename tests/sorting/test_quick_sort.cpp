@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "sorting/quick_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class QuickSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    QuickSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+struct Record
+{
+    int key;
+    char payload[92];
+};
+
+static int compare_record(const void *const a, const void *const b)
+{
+    int ka = static_cast<const Record *>(a)->key;
+    int kb = static_cast<const Record *>(b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+TEST_F(QuickSortTest, NullPointerHandling)
+{
+    EXPECT_EQ(generic_quick_sort(nullptr, 10, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+    int arr[2] = {2, 1};
+    EXPECT_EQ(generic_quick_sort(arr, 2, sizeof(int), nullptr), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(QuickSortTest, EmptyArrayHandling)
+{
+    int arr[1] = {0};
+    EXPECT_EQ(generic_quick_sort(arr, 0, sizeof(int), compare_integers), SORT_SUCCESS);
+    int pair[2] = {2, 1};
+    EXPECT_EQ(generic_quick_sort(pair, 2, 0, compare_integers), SORT_ERROR_INVALID_ELEMENT_SIZE);
+}
+
+TEST_F(QuickSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_quick_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(QuickSortTest, PatternInputs)
+{
+    const int n = TEST_DATA_SIZE;
+    std::vector<std::vector<int>> inputs;
+    inputs.push_back(sorted_int_vector);
+    inputs.emplace_back(sorted_int_vector.rbegin(), sorted_int_vector.rend());
+    inputs.emplace_back(n, 7);
+    std::vector<int> organ_pipe(n);
+    for (int i = 0; i < n; i++)
+    {
+        organ_pipe[i] = i < n / 2 ? i : n - i;
+    }
+    inputs.push_back(organ_pipe);
+    std::vector<int> few_unique(n);
+    for (int i = 0; i < n; i++)
+    {
+        few_unique[i] = (i * 7919) % 5;
+    }
+    inputs.push_back(few_unique);
+
+    for (auto &input : inputs)
+    {
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(generic_quick_sort(input.data(), input.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+        EXPECT_EQ(input, expected);
+    }
+}
+
+TEST_F(QuickSortTest, LargeElementSortTest)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, 1000);
+    std::vector<Record> records(5000);
+    for (auto &record : records)
+    {
+        record.key = dis(gen);
+        std::fill(std::begin(record.payload), std::end(record.payload), static_cast<char>(record.key));
+    }
+    EXPECT_EQ(generic_quick_sort(records.data(), records.size(), sizeof(Record), compare_record), SORT_SUCCESS);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (i > 0)
+        {
+            ASSERT_LE(records[i - 1].key, records[i].key);
+        }
+        ASSERT_EQ(records[i].payload[91], static_cast<char>(records[i].key));
+    }
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <limits>
+#include "sorting/radix_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class RadixSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    RadixSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+
+    template <typename T, typename Dist>
+    static std::vector<T> random_vector(size_t n, Dist dist)
+    {
+        static std::mt19937_64 gen(20250626);
+        std::vector<T> vec(n);
+        for (auto &v : vec)
+        {
+            v = static_cast<T>(dist(gen));
+        }
+        return vec;
+    }
+};
+
+struct KeyedRecord
+{
+    char tag[6];
+    int64_t key;
+    uint32_t seq;
+};
+
+TEST_F(RadixSortTest, InvalidArguments)
+{
+    EXPECT_EQ(radix_sort_uint32(nullptr, 10), SORT_ERROR_NULL_POINTER);
+    KeyedRecord records[2] = {};
+    EXPECT_EQ(generic_radix_sort(records, 2, sizeof(KeyedRecord), sizeof(KeyedRecord) - 4, RADIX_KEY_INT64),
+              SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(generic_radix_sort_inplace(records, 2, 2, 0, RADIX_KEY_UINT32), SORT_ERROR_INVALID_ELEMENT_SIZE);
+}
+
+TEST_F(RadixSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    std::vector<int32_t> values(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(radix_sort_int32(values.data(), values.size()), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), values.begin()));
+}
+
+TEST_F(RadixSortTest, TypedKeys)
+{
+    auto u32 = random_vector<uint32_t>(TEST_DATA_SIZE, std::uniform_int_distribution<uint32_t>());
+    auto i32 = random_vector<int32_t>(TEST_DATA_SIZE, std::uniform_int_distribution<int32_t>(
+                                                          std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+    auto u64 = random_vector<uint64_t>(TEST_DATA_SIZE, std::uniform_int_distribution<uint64_t>());
+    auto i64 = random_vector<int64_t>(TEST_DATA_SIZE, std::uniform_int_distribution<int64_t>(-1000, 1000));
+    auto f32 = random_vector<float>(TEST_DATA_SIZE, std::normal_distribution<float>(0.0f, 1e6f));
+    auto f64 = random_vector<double>(TEST_DATA_SIZE, std::normal_distribution<double>(0.0, 1e-3));
+    f64[0] = -std::numeric_limits<double>::infinity();
+    f64[1] = std::numeric_limits<double>::infinity();
+
+    auto expect_sorted = [](auto vec, auto sorter) {
+        auto expected = vec;
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(sorter(vec.data(), vec.size()), SORT_SUCCESS);
+        EXPECT_EQ(vec, expected);
+    };
+    expect_sorted(u32, radix_sort_uint32);
+    expect_sorted(i32, radix_sort_int32);
+    expect_sorted(u64, radix_sort_uint64);
+    expect_sorted(i64, radix_sort_int64);
+    expect_sorted(f32, radix_sort_float);
+    expect_sorted(f64, radix_sort_double);
+}
+
+TEST_F(RadixSortTest, RecordsAreSortedStably)
+{
+    auto keys = random_vector<int64_t>(TEST_DATA_SIZE, std::uniform_int_distribution<int64_t>(-50, 50));
+    std::vector<KeyedRecord> records(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        records[i] = KeyedRecord{{'r'}, keys[i], static_cast<uint32_t>(i)};
+    }
+    EXPECT_EQ(generic_radix_sort(records.data(), records.size(), sizeof(KeyedRecord),
+                                 offsetof(KeyedRecord, key), RADIX_KEY_INT64),
+              SORT_SUCCESS);
+    for (size_t i = 1; i < records.size(); i++)
+    {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key)
+        {
+            ASSERT_LT(records[i - 1].seq, records[i].seq);
+        }
+        ASSERT_EQ(records[i].tag[0], 'r');
+    }
+}
+
+TEST_F(RadixSortTest, InplaceSort)
+{
+    auto keys = random_vector<int64_t>(TEST_DATA_SIZE, std::uniform_int_distribution<int64_t>(
+                                                           std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()));
+    std::vector<KeyedRecord> records(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        records[i] = KeyedRecord{{'r'}, keys[i], static_cast<uint32_t>(i)};
+    }
+    EXPECT_EQ(generic_radix_sort_inplace(records.data(), records.size(), sizeof(KeyedRecord),
+                                         offsetof(KeyedRecord, key), RADIX_KEY_INT64),
+              SORT_SUCCESS);
+    for (size_t i = 1; i < records.size(); i++)
+    {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        ASSERT_EQ(keys[records[i].seq], records[i].key);
+    }
+
+    auto floats = random_vector<float>(TEST_DATA_SIZE, std::uniform_real_distribution<float>(-100.0f, 100.0f));
+    auto expected = floats;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(generic_radix_sort_inplace(floats.data(), floats.size(), sizeof(float), 0, RADIX_KEY_FLOAT), SORT_SUCCESS);
+    EXPECT_EQ(floats, expected);
+}
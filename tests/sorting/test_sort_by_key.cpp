@@ -0,0 +1,302 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include "algorithms.h"
+#include "sorting/sort_by_key.h"
+#include "sorting/parallel_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Wide
+    {
+        uint64_t lo;
+        uint64_t hi;
+        uint64_t tag;
+    };
+
+    int compare_doubles(const void *const a, const void *const b)
+    {
+        double x = *static_cast<const double *>(a);
+        double y = *static_cast<const double *>(b);
+        return (x > y) - (x < y);
+    }
+
+    // 3 字节的键，按字典序比较
+    int compare_bytes3(const void *const a, const void *const b)
+    {
+        return std::memcmp(a, b, 3);
+    }
+
+    // 对每种键类型：值数组保存原下标，排序后检查键有序、下标对应且相等键的下标递增
+    template <typename K>
+    void check_by_key(const std::vector<K> &original, const std::vector<K> &keys, const std::vector<size_t> &index,
+                      bool stable)
+    {
+        ASSERT_EQ(keys.size(), index.size());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            ASSERT_EQ(std::memcmp(&keys[i], &original[index[i]], sizeof(K)), 0) << "at " << i;
+            if (i > 0)
+            {
+                ASSERT_LE(keys[i - 1], keys[i]) << "at " << i;
+                if (stable && keys[i - 1] == keys[i])
+                {
+                    ASSERT_LT(index[i - 1], index[i]) << "at " << i;
+                }
+            }
+        }
+        std::vector<size_t> seen(index);
+        std::sort(seen.begin(), seen.end());
+        for (size_t i = 0; i < seen.size(); i++)
+        {
+            ASSERT_EQ(seen[i], i);
+        }
+    }
+
+    std::vector<size_t> iota_index(size_t n)
+    {
+        std::vector<size_t> index(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            index[i] = i;
+        }
+        return index;
+    }
+
+    template <typename K>
+    void radix_roundtrip(std::vector<K> keys, radix_key_type_t type)
+    {
+        auto original = keys;
+        auto index = iota_index(keys.size());
+        sort_value_array_t values[] = {{index.data(), sizeof(size_t)}};
+        ASSERT_EQ(radix_sort_by_key(keys.data(), keys.size(), type, values, 1), SORT_SUCCESS);
+        check_by_key(original, keys, index, true);
+    }
+}
+
+class SortByKeyTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    SortByKeyTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(SortByKeyTest, InvalidArguments)
+{
+    uint32_t keys[3] = {3, 1, 2};
+    uint32_t vals[3] = {0, 1, 2};
+    sort_value_array_t values[] = {{vals, sizeof(uint32_t)}};
+    sort_value_array_t null_data[] = {{nullptr, sizeof(uint32_t)}};
+    sort_value_array_t zero_size[] = {{vals, 0}};
+
+    EXPECT_EQ(radix_sort_by_key(nullptr, 3, RADIX_KEY_UINT32, values, 1), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(radix_sort_by_key(keys, 3, RADIX_KEY_UINT32, nullptr, 1), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(radix_sort_by_key(keys, 3, RADIX_KEY_UINT32, null_data, 1), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(radix_sort_by_key(keys, 3, RADIX_KEY_UINT32, zero_size, 1), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(radix_sort_by_key(keys, 3, (radix_key_type_t)100, values, 1), SORT_ERROR_INVALID_ARGUMENT);
+
+    EXPECT_EQ(generic_sort_by_key(nullptr, 3, 4, compare_integers, values, 1, 0), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_by_key(keys, 3, 4, nullptr, values, 1, 0), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_sort_by_key(keys, 3, 0, compare_integers, values, 1, 0), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(generic_sort_by_key(keys, 3, 4, compare_integers, zero_size, 1, 1), SORT_ERROR_INVALID_ELEMENT_SIZE);
+
+    // 参数错误时不修改数据
+    EXPECT_EQ(keys[0], 3u);
+    EXPECT_EQ(vals[0], 0u);
+
+    // 没有值数组时只排序键
+    EXPECT_EQ(radix_sort_by_key(keys, 3, RADIX_KEY_UINT32, nullptr, 0), SORT_SUCCESS);
+    EXPECT_EQ(keys[0], 1u);
+    EXPECT_EQ(keys[2], 3u);
+}
+
+TEST_F(SortByKeyTest, RadixAllKeyTypesStable)
+{
+    std::mt19937_64 rng(1);
+    const size_t n = TEST_DATA_SIZE;
+
+    // 取值范围较小，保证有大量相等的键
+    std::vector<uint32_t> u32(n);
+    std::vector<int32_t> i32(n);
+    std::vector<uint64_t> u64(n);
+    std::vector<int64_t> i64(n);
+    std::vector<float> f32(n);
+    std::vector<double> f64(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t r = rng();
+        u32[i] = (uint32_t)(r % 1000) * 4000000u;
+        i32[i] = (int32_t)(r % 2001) - 1000;
+        u64[i] = (r % 1000) << 40;
+        i64[i] = (int64_t)(r % 2001) * 1000000007LL - 1000000007000LL;
+        f32[i] = (float)((int)(r % 2001) - 1000) * 0.25f;
+        f64[i] = (double)((int)(r % 2001) - 1000) * 1e-3;
+    }
+    radix_roundtrip(u32, RADIX_KEY_UINT32);
+    radix_roundtrip(i32, RADIX_KEY_INT32);
+    radix_roundtrip(u64, RADIX_KEY_UINT64);
+    radix_roundtrip(i64, RADIX_KEY_INT64);
+    radix_roundtrip(f32, RADIX_KEY_FLOAT);
+    radix_roundtrip(f64, RADIX_KEY_DOUBLE);
+}
+
+TEST_F(SortByKeyTest, RadixFloatSignedZeroAndNaN)
+{
+    std::vector<float> keys = {1.0f, -0.0f, NAN, 0.0f, -2.5f, -NAN, 0.0f, -0.0f};
+    auto original = keys;
+    auto index = iota_index(keys.size());
+    sort_value_array_t values[] = {{index.data(), sizeof(size_t)}};
+    ASSERT_EQ(radix_sort_by_key(keys.data(), keys.size(), RADIX_KEY_FLOAT, values, 1), SORT_SUCCESS);
+
+    // 与 radix_sort_float 相同的全序：负 NaN 最前，-0.0 在 +0.0 之前，正 NaN 最后
+    EXPECT_TRUE(std::isnan(keys.front()) && std::signbit(keys.front()));
+    EXPECT_TRUE(std::isnan(keys.back()) && !std::signbit(keys.back()));
+    EXPECT_EQ(index, (std::vector<size_t>{5, 4, 1, 7, 3, 6, 0, 2}));
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        EXPECT_EQ(std::memcmp(&keys[i], &original[index[i]], sizeof(float)), 0);
+    }
+}
+
+TEST_F(SortByKeyTest, MultipleValueArrays)
+{
+    auto ints = get_random_int_vecotor<TEST_DATA_SIZE, 0, 5000>();
+    const size_t n = ints.size();
+    std::vector<uint32_t> keys(ints.begin(), ints.end());
+    auto original = keys;
+
+    // 1/4/8/16/24 字节的值数组，都由原下标推出，方便逐项核对
+    std::vector<uint8_t> v1(n);
+    std::vector<uint32_t> v4(n);
+    std::vector<double> v8(n);
+    std::vector<std::pair<uint64_t, uint64_t>> v16(n);
+    std::vector<Wide> v24(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        v1[i] = (uint8_t)i;
+        v4[i] = (uint32_t)i;
+        v8[i] = (double)i + 0.5;
+        v16[i] = {i, ~(uint64_t)i};
+        v24[i] = {i, i * 3, i * 7};
+    }
+    sort_value_array_t values[] = {
+        {v1.data(), sizeof(uint8_t)},
+        {v4.data(), sizeof(uint32_t)},
+        {v8.data(), sizeof(double)},
+        {v16.data(), sizeof(v16[0])},
+        {v24.data(), sizeof(Wide)},
+    };
+    sort_stats_t stats;
+    ASSERT_EQ(radix_sort_by_key_ex(keys.data(), n, RADIX_KEY_UINT32, values, 5, &stats), SORT_SUCCESS);
+    EXPECT_EQ(stats.array_length, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t src = v4[i];
+        ASSERT_EQ(keys[i], original[src]);
+        if (i > 0)
+        {
+            ASSERT_LE(keys[i - 1], keys[i]);
+            if (keys[i - 1] == keys[i])
+            {
+                ASSERT_LT(v4[i - 1], v4[i]);
+            }
+        }
+        ASSERT_EQ(v1[i], (uint8_t)src);
+        ASSERT_EQ(v8[i], (double)src + 0.5);
+        ASSERT_EQ(v16[i].first, src);
+        ASSERT_EQ(v16[i].second, ~(uint64_t)src);
+        ASSERT_EQ(v24[i].hi, src * 3);
+        ASSERT_EQ(v24[i].tag, src * 7);
+    }
+}
+
+TEST_F(SortByKeyTest, ComparisonStableAndUnstable)
+{
+    std::mt19937 rng(2);
+    const size_t n = TEST_DATA_SIZE;
+    std::vector<double> keys(n);
+    for (auto &k : keys)
+    {
+        k = (double)(rng() % 300) - 150.0;
+    }
+
+    for (int stable = 0; stable <= 1; stable++)
+    {
+        auto sorted = keys;
+        auto index = iota_index(n);
+        sort_value_array_t values[] = {{index.data(), sizeof(size_t)}};
+        ASSERT_EQ(generic_sort_by_key(sorted.data(), n, sizeof(double), compare_doubles, values, 1, stable),
+                  SORT_SUCCESS);
+        check_by_key(keys, sorted, index, stable != 0);
+    }
+}
+
+TEST_F(SortByKeyTest, ComparisonOddKeySizeAndLargeValues)
+{
+    // 3 字节的键(元组内按 8 字节对齐取整)，值元素比元组还大，需要额外的暂存空间
+    struct Big
+    {
+        uint64_t index;
+        char pad[120];
+    };
+    std::mt19937 rng(3);
+    const size_t n = 5000;
+    std::vector<uint8_t> keys(n * 3);
+    std::vector<Big> big(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        keys[i * 3] = (uint8_t)(rng() % 4);
+        keys[i * 3 + 1] = (uint8_t)(rng() % 4);
+        keys[i * 3 + 2] = (uint8_t)(rng() % 4);
+        big[i].index = i;
+        big[i].pad[119] = (char)i;
+    }
+    auto original = keys;
+    sort_value_array_t values[] = {{big.data(), sizeof(Big)}};
+    ASSERT_EQ(generic_sort_by_key(keys.data(), n, 3, compare_bytes3, values, 1, 1), SORT_SUCCESS);
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t src = big[i].index;
+        ASSERT_EQ(std::memcmp(&keys[i * 3], &original[src * 3], 3), 0);
+        ASSERT_EQ(big[i].pad[119], (char)src);
+        if (i > 0)
+        {
+            int c = std::memcmp(&keys[(i - 1) * 3], &keys[i * 3], 3);
+            ASSERT_LE(c, 0);
+            if (c == 0)
+            {
+                ASSERT_LT(big[i - 1].index, src);
+            }
+        }
+    }
+}
+
+TEST_F(SortByKeyTest, ParallelComparison)
+{
+    ASSERT_EQ(algorithms_set_thread_count(4), 0);
+    parallel_sort_set_cutoff(1024);
+
+    auto ints = get_random_int_vecotor<TEST_DATA_SIZE * 4, 0, 1000>();
+    std::vector<int> keys(ints.begin(), ints.end());
+    for (int stable = 0; stable <= 1; stable++)
+    {
+        auto sorted = keys;
+        auto index = iota_index(keys.size());
+        sort_value_array_t values[] = {{index.data(), sizeof(size_t)}};
+        sort_stats_t stats;
+        ASSERT_EQ(generic_sort_by_key_ex(sorted.data(), sorted.size(), sizeof(int), compare_integers, values, 1,
+                                         stable, &stats),
+                  SORT_SUCCESS);
+        check_by_key(keys, sorted, index, stable != 0);
+        EXPECT_EQ(stats.array_length, keys.size());
+    }
+
+    parallel_sort_set_cutoff(0);
+    algorithms_cleanup();
+}
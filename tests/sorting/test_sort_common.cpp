@@ -26,4 +26,21 @@ TEST(SortCommonTest, GenericSwap) {
     
     
 
-}
\ No newline at end of file
+}
+TEST(SortCommonTest, SelectSwapFunc) {
+    const size_t sizes[] = {1, 2, 3, 4, 8, 12, 16, 24, 32, 48, 64, 100, 128, 255, 512};
+    for (size_t size : sizes) {
+        std::vector<unsigned char> a(size), b(size);
+        for (size_t i = 0; i < size; i++) {
+            a[i] = static_cast<unsigned char>(i);
+            b[i] = static_cast<unsigned char>(255 - i);
+        }
+        auto expected_a = b;
+        auto expected_b = a;
+        sized_swap_func_t *swap = select_swap_func(size);
+        ASSERT_NE(swap, nullptr);
+        swap(a.data(), b.data(), size);
+        EXPECT_EQ(a, expected_a) << "size " << size;
+        EXPECT_EQ(b, expected_b) << "size " << size;
+    }
+}
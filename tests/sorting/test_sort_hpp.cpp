@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "sorting/sort.hpp"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+class SortHppTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    SortHppTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+struct Item
+{
+    std::int64_t key;
+    std::int32_t seq;
+    std::int32_t pad;
+};
+
+TEST_F(SortHppTest, SortInt64)
+{
+    auto shuffled = get_shuffled_long_vector();
+    std::vector<std::int64_t> values(shuffled.begin(), shuffled.end());
+    algo::sort(values.data(), values.size());
+    EXPECT_TRUE(std::equal(sorted_long_vector.begin(), sorted_long_vector.end(), values.begin()));
+}
+
+TEST_F(SortHppTest, SortPatternInputsWithComparator)
+{
+    std::vector<int> reversed = sorted_int_vector;
+    algo::sort(reversed, [](int a, int b) { return a > b; });
+    EXPECT_TRUE(std::equal(sorted_int_vector.rbegin(), sorted_int_vector.rend(), reversed.begin()));
+
+    std::vector<int> few_unique(TEST_DATA_SIZE);
+    for (size_t i = 0; i < few_unique.size(); i++)
+    {
+        few_unique[i] = static_cast<int>((i * 7919) % 3);
+    }
+    std::vector<int> expected = few_unique;
+    std::sort(expected.begin(), expected.end());
+    algo::sort(few_unique);
+    EXPECT_EQ(few_unique, expected);
+}
+
+TEST_F(SortHppTest, StableSortKeepsOrderOfEqualKeys)
+{
+    auto keys = get_random_int_vecotor<TEST_DATA_SIZE, 0, 100>();
+    std::vector<Item> items(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        items[i] = Item{keys[i], static_cast<std::int32_t>(i), 0};
+    }
+    algo::stable_sort(items, [](const Item &a, const Item &b) { return a.key < b.key; });
+    for (size_t i = 1; i < items.size(); i++)
+    {
+        ASSERT_LE(items[i - 1].key, items[i].key);
+        if (items[i - 1].key == items[i].key)
+        {
+            ASSERT_LT(items[i - 1].seq, items[i].seq);
+        }
+    }
+}
+
+TEST_F(SortHppTest, StableSortWithBuffer)
+{
+    auto shuffled = get_shuffled_int_vector();
+    std::vector<int> buffer(shuffled.size());
+    algo::stable_sort(shuffled.data(), shuffled.size(), buffer.data());
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(SortHppTest, ShellHeapAndSmallSorts)
+{
+    auto shuffled = get_shuffled_int_vector();
+    algo::shell_sort(shuffled.data(), shuffled.size());
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+
+    shuffled = get_shuffled_int_vector();
+    algo::heap_sort(shuffled.data(), shuffled.size());
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+
+    std::vector<std::string> words = {"pear", "apple", "fig", "banana", "cherry"};
+    algo::insertion_sort(words.data(), words.size());
+    EXPECT_TRUE(std::is_sorted(words.begin(), words.end()));
+
+    std::vector<double> small = {3.5, -1.0, 2.25, 0.0, 9.0};
+    algo::selection_sort(small.data(), small.size());
+    EXPECT_TRUE(std::is_sorted(small.begin(), small.end()));
+}
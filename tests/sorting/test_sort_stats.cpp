@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include "sorting/heap_sort.h"
+#include "sorting/quick_sort.h"
+#include "sorting/merge_sort.h"
+#include "sorting/inplace_merge_sort.h"
+#include "sorting/tim_sort.h"
+#include "sorting/shell_sort.h"
+#include "sorting/radix_sort.h"
+#include "sorting/parallel_sort.h"
+#include "algorithms.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    std::atomic<size_t> g_comparisons{0};
+
+    int counting_compare(const void *const a, const void *const b)
+    {
+        g_comparisons.fetch_add(1, std::memory_order_relaxed);
+        return compare_integers(a, b);
+    }
+
+    typedef sort_result_t sort_ex_func_t(void *, size_t, size_t, compare_func_t, sort_stats_t *);
+
+    // 用计数比较函数对照 _ex 记录的比较次数
+    void check_ex_sort(sort_ex_func_t *sort, std::vector<int> data, const std::vector<int> &expected)
+    {
+        sort_stats_t stats;
+        g_comparisons = 0;
+        ASSERT_EQ(sort(data.data(), data.size(), sizeof(int), counting_compare, &stats), SORT_SUCCESS);
+        EXPECT_EQ(data, expected);
+        EXPECT_EQ(stats.array_length, data.size());
+        EXPECT_EQ(stats.element_size, sizeof(int));
+        EXPECT_GE(stats.time_elapsed_ms, 0.0);
+        EXPECT_GE(stats.end_time, stats.start_time);
+#if defined(PRINT_SORTING_INFO)
+        EXPECT_EQ(stats.comparisons, g_comparisons.load());
+        EXPECT_GT(stats.movements, 0u);
+#else
+        EXPECT_EQ(stats.comparisons, 0u);
+#endif
+    }
+}
+
+class SortStatsTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    SortStatsTest() : TestDataUtil(TEST_DATA_SIZE) {}
+
+    static void SetUpTestSuite()
+    {
+        algorithms_set_thread_count(4);
+        parallel_sort_set_cutoff(1024);
+    }
+
+    static void TearDownTestSuite()
+    {
+        parallel_sort_set_cutoff(0);
+    }
+};
+
+TEST_F(SortStatsTest, NullStatsIsAccepted)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_quick_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, nullptr), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(SortStatsTest, SequentialSortsCountComparisons)
+{
+    auto shuffled = get_shuffled_int_vector();
+    check_ex_sort(generic_quick_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_heap_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_merge_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_inplace_merge_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_tim_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_shell_sort_ex, shuffled, sorted_int_vector);
+}
+
+TEST_F(SortStatsTest, ParallelSortsSumTaskStats)
+{
+    auto shuffled = get_shuffled_int_vector();
+    check_ex_sort(generic_parallel_sort_ex, shuffled, sorted_int_vector);
+    check_ex_sort(generic_parallel_stable_sort_ex, shuffled, sorted_int_vector);
+}
+
+TEST_F(SortStatsTest, RadixSortRecordsMovesOnly)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    EXPECT_EQ(generic_radix_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), 0, RADIX_KEY_INT32, &stats), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    EXPECT_EQ(stats.comparisons, 0u);
+#if defined(PRINT_SORTING_INFO)
+    EXPECT_GT(stats.movements, 0u);
+    EXPECT_GE(stats.max_mamory_used, shuffled.size() * sizeof(int));
+#endif
+}
+
+TEST_F(SortStatsTest, MergeSortReportsPeakScratch)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    EXPECT_EQ(generic_merge_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, &stats), SORT_SUCCESS);
+    EXPECT_EQ(stats.memory_used, 0u);
+#if defined(PRINT_SORTING_INFO)
+    EXPECT_EQ(stats.max_mamory_used, shuffled.size() * sizeof(int));
+#endif
+}
+
+TEST_F(SortStatsTest, InplaceMergeSortReportsSqrtScratch)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    EXPECT_EQ(generic_inplace_merge_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, &stats),
+              SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    EXPECT_EQ(stats.memory_used, 0u);
+#if defined(PRINT_SORTING_INFO)
+    size_t root = 1;
+    while (root * root < shuffled.size())
+    {
+        root++;
+    }
+    EXPECT_EQ(stats.max_mamory_used, root * sizeof(int));
+#endif
+}
+
+TEST_F(SortStatsTest, HardwareCountersDisabledByDefault)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    memset(&stats, 0xff, sizeof(stats));
+    ASSERT_EQ(sort_hw_counters_enabled(), 0);
+    EXPECT_EQ(generic_quick_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, &stats), SORT_SUCCESS);
+    EXPECT_EQ(stats.hw.available_mask, 0u);
+}
+
+// 内核可能禁止 perf_event_open(容器、perf_event_paranoid)，此时只要求干净地降级为不可用
+TEST_F(SortStatsTest, HardwareCountersDegradeGracefully)
+{
+    auto shuffled = get_shuffled_int_vector();
+    sort_stats_t stats;
+    sort_hw_counters_set_enabled(1);
+    EXPECT_EQ(generic_heap_sort_ex(shuffled.data(), shuffled.size(), sizeof(int), compare_integers, &stats), SORT_SUCCESS);
+    sort_hw_counters_set_enabled(0);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+    EXPECT_EQ(stats.hw.available_mask & ~((1u << SORT_HW_COUNTER_COUNT) - 1), 0u);
+    if (stats.hw.available_mask & (1u << SORT_HW_INSTRUCTIONS))
+    {
+        // 堆排序每个元素至少要执行若干条指令
+        EXPECT_GT(stats.hw.values[SORT_HW_INSTRUCTIONS], shuffled.size());
+    }
+    for (int i = 0; i < SORT_HW_COUNTER_COUNT; i++)
+    {
+        if (!(stats.hw.available_mask & (1u << i)))
+        {
+            EXPECT_EQ(stats.hw.values[i], 0u);
+        }
+    }
+}
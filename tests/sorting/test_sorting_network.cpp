@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include "sorting/sorting_network.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Record
+    {
+        int key;
+        char payload[28];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Record *>(a)->key;
+        int kb = static_cast<const Record *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    struct Pair64
+    {
+        int64_t key;
+        int64_t tag;
+    };
+
+    int compare_pair64(const void *const a, const void *const b)
+    {
+        int64_t ka = static_cast<const Pair64 *>(a)->key;
+        int64_t kb = static_cast<const Pair64 *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    int compare_int64(const void *const a, const void *const b)
+    {
+        int64_t ka = *static_cast<const int64_t *>(a);
+        int64_t kb = *static_cast<const int64_t *>(b);
+        return (ka > kb) - (ka < kb);
+    }
+}
+
+class SortingNetworkTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    SortingNetworkTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(SortingNetworkTest, InvalidArguments)
+{
+    int data[SORTING_NETWORK_MAX + 1] = {0};
+    EXPECT_EQ(generic_network_sort(nullptr, 4, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_network_sort(data, 4, sizeof(int), nullptr), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(generic_network_sort(data, 4, 0, compare_integers), SORT_ERROR_INVALID_ELEMENT_SIZE);
+    EXPECT_EQ(generic_network_sort(data, SORTING_NETWORK_MAX + 1, sizeof(int), compare_integers),
+              SORT_ERROR_INVALID_LENGTH);
+
+    int32_t keys[SORTING_NETWORK_MAX_32BIT + 1] = {0};
+    EXPECT_EQ(network_sort_int32(nullptr, 4), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(network_sort_int32(keys, SORTING_NETWORK_MAX_32BIT + 1), SORT_ERROR_INVALID_LENGTH);
+    EXPECT_EQ(network_sort_float(nullptr, 4), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(network_sort_int32(keys, 0), SORT_SUCCESS);
+    EXPECT_EQ(network_sort_int32(keys, 1), SORT_SUCCESS);
+}
+
+// 0-1 原理：网络能排好所有 0/1 输入，就能排好任意输入
+TEST_F(SortingNetworkTest, ZeroOnePrincipleAllSizes)
+{
+    for (size_t n = 2; n <= SORTING_NETWORK_MAX; n++)
+    {
+        for (uint32_t mask = 0; mask < (1u << n); mask++)
+        {
+            int data[SORTING_NETWORK_MAX];
+            for (size_t i = 0; i < n; i++)
+            {
+                data[i] = (mask >> i) & 1;
+            }
+            ASSERT_EQ(generic_network_sort(data, n, sizeof(int), compare_integers), SORT_SUCCESS);
+            ASSERT_TRUE(std::is_sorted(data, data + n)) << "n = " << n << ", mask = " << mask;
+        }
+    }
+}
+
+TEST_F(SortingNetworkTest, ZeroOnePrincipleInt32)
+{
+    // 32 个元素穷举不现实，17~20 穷举，其余用随机 0/1 输入
+    std::mt19937 rng(7);
+    for (size_t n = 2; n <= SORTING_NETWORK_MAX_32BIT; n++)
+    {
+        size_t rounds = n <= 20 ? (size_t)1 << n : 20000;
+        for (size_t r = 0; r < rounds; r++)
+        {
+            uint32_t bits = n <= 20 ? (uint32_t)r : (uint32_t)rng();
+            int32_t data[SORTING_NETWORK_MAX_32BIT];
+            for (size_t i = 0; i < n; i++)
+            {
+                data[i] = (int32_t)((bits >> (i % 32)) & 1);
+            }
+            ASSERT_EQ(network_sort_int32(data, n), SORT_SUCCESS);
+            ASSERT_TRUE(std::is_sorted(data, data + n)) << "n = " << n;
+        }
+    }
+}
+
+TEST_F(SortingNetworkTest, GenericElementSizes)
+{
+    std::mt19937 rng(42);
+    for (size_t n = 1; n <= SORTING_NETWORK_MAX; n++)
+    {
+        for (int round = 0; round < 200; round++)
+        {
+            std::vector<int> ints(n);
+            std::vector<int64_t> longs(n);
+            std::vector<Pair64> pairs(n);
+            std::vector<Record> records(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                int v = (int)(rng() % 10) - 5; // 大量重复值
+                ints[i] = v;
+                longs[i] = (int64_t)v * ((int64_t)1 << 40);
+                pairs[i] = {v, (int64_t)i};
+                records[i].key = v;
+                std::memset(records[i].payload, (int)i, sizeof(records[i].payload));
+            }
+            std::vector<int> expected = ints;
+            std::sort(expected.begin(), expected.end());
+
+            ASSERT_EQ(generic_network_sort(ints.data(), n, sizeof(int), compare_integers), SORT_SUCCESS);
+            ASSERT_EQ(generic_network_sort(longs.data(), n, sizeof(int64_t), compare_int64), SORT_SUCCESS);
+            ASSERT_EQ(generic_network_sort(pairs.data(), n, sizeof(Pair64), compare_pair64), SORT_SUCCESS);
+            ASSERT_EQ(generic_network_sort(records.data(), n, sizeof(Record), compare_records), SORT_SUCCESS);
+            ASSERT_EQ(ints, expected);
+            for (size_t i = 0; i < n; i++)
+            {
+                ASSERT_EQ(longs[i], (int64_t)expected[i] * ((int64_t)1 << 40));
+                ASSERT_EQ(pairs[i].key, expected[i]);
+                ASSERT_EQ(records[i].key, expected[i]);
+                // 整条记录一起移动
+                ASSERT_EQ(records[i].payload[0], records[i].payload[sizeof(records[i].payload) - 1]);
+            }
+        }
+    }
+}
+
+TEST_F(SortingNetworkTest, Int32MatchesStdSort)
+{
+    std::mt19937 rng(1);
+    for (size_t n = 1; n <= SORTING_NETWORK_MAX_32BIT; n++)
+    {
+        for (int round = 0; round < 500; round++)
+        {
+            std::vector<int32_t> data(n);
+            for (auto &v : data)
+            {
+                // 包含极值，AVX2 路径用 INT32_MAX 填充时不能混入结果
+                switch (rng() % 8)
+                {
+                case 0:
+                    v = std::numeric_limits<int32_t>::max();
+                    break;
+                case 1:
+                    v = std::numeric_limits<int32_t>::min();
+                    break;
+                default:
+                    v = (int32_t)rng();
+                    break;
+                }
+            }
+            std::vector<int32_t> expected = data;
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(network_sort_int32(data.data(), n), SORT_SUCCESS);
+            ASSERT_EQ(data, expected) << "n = " << n;
+        }
+    }
+}
+
+TEST_F(SortingNetworkTest, FloatTotalOrder)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    for (size_t n = 1; n <= SORTING_NETWORK_MAX_32BIT; n++)
+    {
+        for (int round = 0; round < 500; round++)
+        {
+            std::vector<float> data(n);
+            for (auto &v : data)
+            {
+                v = dist(rng);
+            }
+            std::vector<float> expected = data;
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(network_sort_float(data.data(), n), SORT_SUCCESS);
+            ASSERT_EQ(data, expected) << "n = " << n;
+        }
+    }
+
+    float special[] = {std::numeric_limits<float>::quiet_NaN(), 1.0f, 0.0f, -std::numeric_limits<float>::infinity(),
+                       -0.0f, std::numeric_limits<float>::infinity(), -1.0f, -std::numeric_limits<float>::quiet_NaN()};
+    ASSERT_EQ(network_sort_float(special, 8), SORT_SUCCESS);
+    EXPECT_TRUE(std::isnan(special[0]) && std::signbit(special[0]));
+    EXPECT_EQ(special[1], -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(special[2], -1.0f);
+    EXPECT_TRUE(special[3] == 0.0f && std::signbit(special[3]));
+    EXPECT_TRUE(special[4] == 0.0f && !std::signbit(special[4]));
+    EXPECT_EQ(special[5], 1.0f);
+    EXPECT_EQ(special[6], std::numeric_limits<float>::infinity());
+    EXPECT_TRUE(std::isnan(special[7]) && !std::signbit(special[7]));
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include "sorting/string_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    typedef sort_result_t cstring_sort_func_t(char *[], size_t);
+    typedef sort_result_t slice_sort_func_t(string_slice_t[], size_t);
+
+    // 模拟 URL：少量主机名和路径段组合，公共前缀很长，并包含重复
+    std::vector<std::string> make_urls(size_t count, unsigned seed)
+    {
+        static const char *hosts[] = {"https://www.example.com/", "https://api.example.com/v1/", "http://cdn.example.org/static/"};
+        static const char *segments[] = {"users", "items", "a", "ab", "abc", "search?q=", "images/", "2024/", "index.html", ""};
+        std::mt19937 rng(seed);
+        std::vector<std::string> urls;
+        for (size_t i = 0; i < count; i++)
+        {
+            std::string url = hosts[rng() % 3];
+            size_t parts = rng() % 6;
+            for (size_t p = 0; p < parts; p++)
+            {
+                url += segments[rng() % 10];
+                if (rng() % 3 == 0)
+                {
+                    url += std::to_string(rng() % 50);
+                }
+            }
+            urls.push_back(url);
+        }
+        return urls;
+    }
+
+    void check_cstring_sort(cstring_sort_func_t *sort, std::vector<std::string> data)
+    {
+        std::vector<char *> ptrs;
+        for (auto &s : data)
+        {
+            ptrs.push_back(&s[0]);
+        }
+        ASSERT_EQ(sort(ptrs.data(), ptrs.size()), SORT_SUCCESS);
+        std::vector<std::string> expected(data);
+        std::sort(expected.begin(), expected.end());
+        for (size_t i = 0; i < ptrs.size(); i++)
+        {
+            ASSERT_EQ(std::string(ptrs[i]), expected[i]) << "at " << i;
+        }
+    }
+
+    void check_slice_sort(slice_sort_func_t *sort, const std::vector<std::string> &data)
+    {
+        std::vector<string_slice_t> slices;
+        for (const auto &s : data)
+        {
+            slices.push_back({s.data(), s.size()});
+        }
+        ASSERT_EQ(sort(slices.data(), slices.size()), SORT_SUCCESS);
+        std::vector<std::string> expected(data);
+        std::sort(expected.begin(), expected.end());
+        for (size_t i = 0; i < slices.size(); i++)
+        {
+            ASSERT_EQ(std::string(slices[i].ptr, slices[i].len), expected[i]) << "at " << i;
+        }
+    }
+}
+
+class StringSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    StringSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(StringSortTest, NullPointerHandling)
+{
+    EXPECT_EQ(string_multikey_sort(nullptr, 3), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(slice_radix_sort(nullptr, 3), SORT_ERROR_NULL_POINTER);
+    char a[] = "a";
+    char *strs[] = {a, nullptr};
+    EXPECT_EQ(string_radix_sort(strs, 2), SORT_ERROR_NULL_POINTER);
+    string_slice_t slices[] = {{nullptr, 0}, {nullptr, 2}};
+    EXPECT_EQ(slice_multikey_sort(slices, 1), SORT_SUCCESS);
+    EXPECT_EQ(slice_multikey_sort(slices, 2), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(StringSortTest, UrlCorpus)
+{
+    auto urls = make_urls(TEST_DATA_SIZE / 4, 1);
+    check_cstring_sort(string_multikey_sort, urls);
+    check_cstring_sort(string_radix_sort, urls);
+    check_slice_sort(slice_multikey_sort, urls);
+    check_slice_sort(slice_radix_sort, urls);
+}
+
+TEST_F(StringSortTest, NumericStrings)
+{
+    auto shuffled = get_shuffled_int_vector();
+    std::vector<std::string> data;
+    for (int v : shuffled)
+    {
+        data.push_back(std::to_string(v));
+    }
+    check_cstring_sort(string_multikey_sort, data);
+    check_cstring_sort(string_radix_sort, data);
+}
+
+TEST_F(StringSortTest, PrefixesAndEmptyStrings)
+{
+    std::vector<std::string> data;
+    for (size_t len = 0; len < 40; len++)
+    {
+        data.push_back(std::string(len, 'a'));
+        data.push_back(std::string(len, 'a') + "b");
+        data.push_back(std::string(len, 'a'));
+    }
+    data.push_back("\xff\xfe");
+    data.push_back("\x7f");
+    std::shuffle(data.begin(), data.end(), std::mt19937(5));
+    check_cstring_sort(string_multikey_sort, data);
+    check_cstring_sort(string_radix_sort, data);
+    check_slice_sort(slice_multikey_sort, data);
+    check_slice_sort(slice_radix_sort, data);
+}
+
+TEST_F(StringSortTest, SlicesWithEmbeddedZeros)
+{
+    std::mt19937 rng(11);
+    std::vector<std::string> data;
+    for (int i = 0; i < 5000; i++)
+    {
+        std::string s(rng() % 20, '\0');
+        for (auto &c : s)
+        {
+            c = static_cast<char>(rng() % 3); // 大量 '\0'，长度不同但缓存键相同
+        }
+        data.push_back(s);
+    }
+    check_slice_sort(slice_multikey_sort, data);
+    check_slice_sort(slice_radix_sort, data);
+}
+
+TEST_F(StringSortTest, LongCommonPrefix)
+{
+    std::string prefix(3000, 'x');
+    std::mt19937 rng(3);
+    std::vector<std::string> data;
+    for (int i = 0; i < 2000; i++)
+    {
+        data.push_back(prefix + std::to_string(rng() % 500));
+    }
+    check_cstring_sort(string_multikey_sort, data);
+    check_cstring_sort(string_radix_sort, data);
+}
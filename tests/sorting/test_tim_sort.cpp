@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "sorting/tim_sort.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    struct Record
+    {
+        int key;
+        int id;
+        char payload[120];
+    };
+
+    int compare_records(const void *const a, const void *const b)
+    {
+        int ka = static_cast<const Record *>(a)->key;
+        int kb = static_cast<const Record *>(b)->key;
+        return (ka > kb) - (ka < kb);
+    }
+
+    size_t g_comparisons = 0;
+
+    int counting_compare(const void *const a, const void *const b)
+    {
+        g_comparisons++;
+        return compare_integers(a, b);
+    }
+
+    // 检查按 key 排序且 key 相同时 id 递增(稳定)
+    void expect_sorted_stable(const std::vector<Record> &records)
+    {
+        for (size_t i = 1; i < records.size(); i++)
+        {
+            ASSERT_LE(records[i - 1].key, records[i].key);
+            if (records[i - 1].key == records[i].key)
+            {
+                ASSERT_LT(records[i - 1].id, records[i].id);
+            }
+        }
+    }
+}
+
+class TimSortTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    TimSortTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(TimSortTest, NullPointerHandling)
+{
+    EXPECT_EQ(generic_tim_sort(nullptr, 10, sizeof(int), compare_integers), SORT_ERROR_NULL_POINTER);
+}
+
+TEST_F(TimSortTest, EmptyArrayHandling)
+{
+    int arr[1] = {0};
+    EXPECT_EQ(generic_tim_sort(arr, 0, sizeof(int), compare_integers), SORT_SUCCESS);
+}
+
+TEST_F(TimSortTest, IntegerArrSortTest)
+{
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(generic_tim_sort(shuffled.data(), shuffled.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), shuffled.begin()));
+}
+
+TEST_F(TimSortTest, ReversedArrSortTest)
+{
+    std::vector<int> reversed(sorted_int_vector.rbegin(), sorted_int_vector.rend());
+    EXPECT_EQ(generic_tim_sort(reversed.data(), reversed.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), reversed.begin()));
+}
+
+TEST_F(TimSortTest, SortedInputIsLinear)
+{
+    std::vector<int> sorted(sorted_int_vector);
+    g_comparisons = 0;
+    EXPECT_EQ(generic_tim_sort(sorted.data(), sorted.size(), sizeof(int), counting_compare), SORT_SUCCESS);
+    EXPECT_EQ(g_comparisons, sorted.size() - 1);
+}
+
+TEST_F(TimSortTest, NearlySortedArrSortTest)
+{
+    // 追加的时间序列：整体有序，每隔一段有一个小的乱序窗口
+    std::vector<int> data(sorted_int_vector);
+    std::mt19937 rng(42);
+    for (size_t i = 0; i + 8 < data.size(); i += 1000)
+    {
+        std::shuffle(data.begin() + i, data.begin() + i + 8, rng);
+    }
+    g_comparisons = 0;
+    EXPECT_EQ(generic_tim_sort(data.data(), data.size(), sizeof(int), counting_compare), SORT_SUCCESS);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.end(), data.begin()));
+    EXPECT_LT(g_comparisons, 4 * data.size());
+}
+
+TEST_F(TimSortTest, StabilityTest)
+{
+    std::mt19937 rng(7);
+    for (size_t n : {10u, 63u, 64u, 65u, 1000u, 4097u, 50000u})
+    {
+        for (int key_range : {2, 16, 1000})
+        {
+            std::vector<Record> records(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                records[i].key = static_cast<int>(rng() % key_range);
+                records[i].id = static_cast<int>(i);
+            }
+            // 制造一些长 run，触发 galloping
+            std::sort(records.begin(), records.begin() + n / 3,
+                      [](const Record &a, const Record &b) { return a.key < b.key || (a.key == b.key && a.id < b.id); });
+            EXPECT_EQ(generic_tim_sort(records.data(), n, sizeof(Record), compare_records), SORT_SUCCESS);
+            expect_sorted_stable(records);
+        }
+    }
+}
+
+TEST_F(TimSortTest, MixedRunsMatchStableSort)
+{
+    std::mt19937 rng(1234);
+    std::vector<int> data;
+    // 交替拼接升序、降序和随机段，长度各不相同
+    while (data.size() < TEST_DATA_SIZE)
+    {
+        size_t len = 1 + rng() % 3000;
+        int start = static_cast<int>(rng() % 100000);
+        switch (rng() % 3)
+        {
+        case 0:
+            for (size_t i = 0; i < len; i++)
+                data.push_back(start + static_cast<int>(i));
+            break;
+        case 1:
+            for (size_t i = 0; i < len; i++)
+                data.push_back(start - static_cast<int>(i));
+            break;
+        default:
+            for (size_t i = 0; i < len; i++)
+                data.push_back(static_cast<int>(rng() % 100000));
+            break;
+        }
+    }
+    auto expected = data;
+    std::stable_sort(expected.begin(), expected.end());
+    EXPECT_EQ(generic_tim_sort(data.data(), data.size(), sizeof(int), compare_integers), SORT_SUCCESS);
+    EXPECT_EQ(data, expected);
+}
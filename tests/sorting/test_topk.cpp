@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "sorting/topk.h"
+#include "util/test_data_util.h"
+#include "test_config.h" // 包含测试配置文件
+
+namespace
+{
+    int compare_integers_desc(const void *const a, const void *const b)
+    {
+        int x = *static_cast<const int *>(a);
+        int y = *static_cast<const int *>(b);
+        return (y > x) - (y < x);
+    }
+
+    std::vector<int> collect(const topk_t *topk)
+    {
+        std::vector<int> out(topk_size(topk));
+        size_t len = 0;
+        EXPECT_EQ(topk_result(topk, out.data(), &len), SORT_SUCCESS);
+        EXPECT_EQ(len, out.size());
+        return out;
+    }
+}
+
+class TopkTest : public ::testing::Test, public TestDataUtil
+{
+protected:
+    TopkTest() : TestDataUtil(TEST_DATA_SIZE) {}
+};
+
+TEST_F(TopkTest, InvalidArguments)
+{
+    EXPECT_EQ(topk_create(10, sizeof(int), nullptr), nullptr);
+    EXPECT_EQ(topk_create(10, 0, compare_integers), nullptr);
+    EXPECT_EQ(topk_create(SIZE_MAX, 16, compare_integers), nullptr);
+    EXPECT_EQ(topk_push(nullptr, nullptr), SORT_ERROR_NULL_POINTER);
+
+    topk_t *topk = topk_create(3, sizeof(int), compare_integers);
+    ASSERT_NE(topk, nullptr);
+    EXPECT_EQ(topk_push_batch(topk, nullptr, 5), SORT_ERROR_NULL_POINTER);
+    EXPECT_EQ(topk_push_batch(topk, nullptr, 0), SORT_SUCCESS);
+    EXPECT_EQ(topk_result(topk, nullptr, nullptr), SORT_SUCCESS);
+    topk_destroy(topk);
+}
+
+TEST_F(TopkTest, SmallestKFromBatches)
+{
+    auto shuffled = get_shuffled_int_vector();
+    const size_t k = 100;
+    topk_t *topk = topk_create(k, sizeof(int), compare_integers);
+    ASSERT_NE(topk, nullptr);
+
+    // 批大小不一，第一批小于 k，覆盖未满时的逐个上浮
+    size_t pos = 0;
+    size_t batch = 37;
+    while (pos < shuffled.size())
+    {
+        size_t len = std::min(batch, shuffled.size() - pos);
+        ASSERT_EQ(topk_push_batch(topk, shuffled.data() + pos, len), SORT_SUCCESS);
+        pos += len;
+        batch = batch * 3 + 1;
+    }
+    EXPECT_EQ(topk_size(topk), k);
+    ASSERT_NE(topk_threshold(topk), nullptr);
+    EXPECT_EQ(*static_cast<const int *>(topk_threshold(topk)), sorted_int_vector[k - 1]);
+
+    auto result = collect(topk);
+    EXPECT_TRUE(std::equal(sorted_int_vector.begin(), sorted_int_vector.begin() + k, result.begin()));
+    topk_destroy(topk);
+}
+
+TEST_F(TopkTest, LargestKWithReversedComparator)
+{
+    auto shuffled = get_shuffled_int_vector();
+    const size_t k = 10;
+    topk_t *topk = topk_create(k, sizeof(int), compare_integers_desc);
+    ASSERT_NE(topk, nullptr);
+    for (int v : shuffled)
+    {
+        ASSERT_EQ(topk_push(topk, &v), SORT_SUCCESS);
+    }
+    auto result = collect(topk);
+    ASSERT_EQ(result.size(), k);
+    EXPECT_TRUE(std::equal(sorted_int_vector.rbegin(), sorted_int_vector.rbegin() + k, result.begin()));
+    topk_destroy(topk);
+}
+
+TEST_F(TopkTest, FewerElementsThanK)
+{
+    topk_t *topk = topk_create(50, sizeof(int), compare_integers);
+    ASSERT_NE(topk, nullptr);
+    std::vector<int> data = {5, 3, 9, 1, 3};
+    ASSERT_EQ(topk_push_batch(topk, data.data(), data.size()), SORT_SUCCESS);
+    EXPECT_EQ(topk_threshold(topk), nullptr);
+    auto result = collect(topk);
+    std::sort(data.begin(), data.end());
+    EXPECT_EQ(result, data);
+
+    topk_clear(topk);
+    EXPECT_EQ(topk_size(topk), 0u);
+    EXPECT_EQ(topk_capacity(topk), 50u);
+    topk_destroy(topk);
+}
+
+TEST_F(TopkTest, ZeroCapacityKeepsNothing)
+{
+    topk_t *topk = topk_create(0, sizeof(int), compare_integers);
+    ASSERT_NE(topk, nullptr);
+    auto shuffled = get_shuffled_int_vector();
+    EXPECT_EQ(topk_push_batch(topk, shuffled.data(), shuffled.size()), SORT_SUCCESS);
+    EXPECT_EQ(topk_push(topk, shuffled.data()), SORT_SUCCESS);
+    EXPECT_EQ(topk_size(topk), 0u);
+    topk_destroy(topk);
+}
+
+TEST_F(TopkTest, MatchesSortWithDuplicates)
+{
+    std::mt19937 rng(1234);
+    for (int round = 0; round < 50; round++)
+    {
+        size_t k = 1 + rng() % 200;
+        std::vector<int> data(1 + rng() % 5000);
+        for (auto &v : data)
+        {
+            v = static_cast<int>(rng() % 100);
+        }
+        topk_t *topk = topk_create(k, sizeof(int), compare_integers);
+        ASSERT_NE(topk, nullptr);
+        size_t half = data.size() / 2;
+        ASSERT_EQ(topk_push_batch(topk, data.data(), half), SORT_SUCCESS);
+        for (size_t i = half; i < data.size(); i++)
+        {
+            ASSERT_EQ(topk_push(topk, &data[i]), SORT_SUCCESS);
+        }
+        auto result = collect(topk);
+        std::sort(data.begin(), data.end());
+        data.resize(std::min(k, data.size()));
+        EXPECT_EQ(result, data);
+        topk_destroy(topk);
+    }
+}
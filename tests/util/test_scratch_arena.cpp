@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "util/scratch_arena.h"
+
+TEST(ScratchArenaTest, AlignedAndReusedBySizeClass)
+{
+    scratch_arena_t *arena = scratch_arena_create(0);
+    ASSERT_NE(arena, nullptr);
+    scratch_arena_t *previous = scratch_arena_use(arena);
+
+    std::vector<void *> blocks;
+    for (size_t size : std::vector<size_t>{0, 1, 15, 16, 48, 100, 1000, 4096, 100000, 1u << 20, 5u << 20})
+    {
+        void *p = scratch_alloc(size);
+        ASSERT_NE(p, nullptr) << size;
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0u) << size;
+        std::memset(p, 0xAB, size);
+        blocks.push_back(p);
+    }
+    size_t reserved = scratch_arena_reserved(arena);
+    EXPECT_GT(reserved, 0u);
+    for (void *p : blocks)
+    {
+        scratch_free(p);
+    }
+
+    // 同样的申请序列全部命中空闲链表，不再映射新的内存
+    for (int round = 0; round < 10; round++)
+    {
+        void *a = scratch_alloc(100000);
+        void *b = scratch_alloc(5u << 20);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+        scratch_free(b);
+        scratch_free(a);
+    }
+    EXPECT_EQ(scratch_arena_reserved(arena), reserved);
+
+    EXPECT_EQ(scratch_arena_use(previous), arena);
+    scratch_arena_destroy(arena);
+}
+
+TEST(ScratchArenaTest, CallocZeroesAndChecksOverflow)
+{
+    void *p = scratch_alloc(4096);
+    ASSERT_NE(p, nullptr);
+    std::memset(p, 0xFF, 4096);
+    scratch_free(p);
+
+    auto *z = static_cast<unsigned char *>(scratch_calloc(1024, 4));
+    ASSERT_NE(z, nullptr);
+    for (size_t i = 0; i < 4096; i++)
+    {
+        ASSERT_EQ(z[i], 0);
+    }
+    scratch_free(z);
+
+    EXPECT_EQ(scratch_calloc(SIZE_MAX / 2, 4), nullptr);
+    scratch_free(nullptr);
+}
+
+TEST(ScratchArenaTest, ArenaLimit)
+{
+    scratch_arena_t *arena = scratch_arena_create(8u << 20);
+    ASSERT_NE(arena, nullptr);
+
+    void *a = scratch_arena_alloc(arena, 6u << 20);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(scratch_arena_alloc(arena, 6u << 20), nullptr);
+    EXPECT_LE(scratch_arena_reserved(arena), 8u << 20);
+
+    // 缓存的大块在接近上限时被归还，换成另一个级别的申请也能成功
+    scratch_free(a);
+    void *b = scratch_arena_alloc(arena, 7u << 20);
+    EXPECT_NE(b, nullptr);
+    scratch_free(b);
+    scratch_arena_destroy(arena);
+}
+
+TEST(ScratchArenaTest, LargeBlockCacheIsBounded)
+{
+    scratch_arena_t *arena = scratch_arena_create(0);
+    ASSERT_NE(arena, nullptr);
+    scratch_arena_t *previous = scratch_arena_use(arena);
+
+    // 每次申请都比上次大，落在不同的级别，释放后缓存的大块合计不超过上限
+    for (size_t mib = 1; mib <= 251; mib += 10)
+    {
+        void *p = scratch_alloc(mib << 20);
+        ASSERT_NE(p, nullptr) << mib;
+        static_cast<char *>(p)[0] = 1;
+        scratch_free(p);
+        ASSERT_LE(scratch_arena_reserved(arena), SCRATCH_DEFAULT_CACHE_LIMIT) << mib;
+    }
+
+    // 上限内的块仍然复用
+    void *a = scratch_alloc(5u << 20);
+    ASSERT_NE(a, nullptr);
+    scratch_free(a);
+    size_t reserved = scratch_arena_reserved(arena);
+    a = scratch_alloc(5u << 20);
+    EXPECT_EQ(scratch_arena_reserved(arena), reserved);
+    scratch_free(a);
+
+    // 上限为 0 时大块释放即归还
+    scratch_set_cache_limit(0);
+    void *b = scratch_alloc(3u << 20);
+    ASSERT_NE(b, nullptr);
+    scratch_free(b);
+    a = scratch_alloc(1u << 20);
+    scratch_free(a);
+    EXPECT_EQ(scratch_arena_reserved(arena), 0u);
+    scratch_set_cache_limit(SCRATCH_DEFAULT_CACHE_LIMIT);
+
+    EXPECT_EQ(scratch_arena_use(previous), arena);
+    scratch_arena_destroy(arena);
+}
+
+TEST(ScratchArenaTest, GlobalLimit)
+{
+    scratch_arena_t *arena = scratch_arena_create(0);
+    ASSERT_NE(arena, nullptr);
+    size_t base = scratch_total_reserved();
+    scratch_set_limit(base + (16u << 20));
+
+    void *a = scratch_arena_alloc(arena, 12u << 20);
+    EXPECT_NE(a, nullptr);
+    EXPECT_EQ(scratch_arena_alloc(arena, 12u << 20), nullptr);
+
+    scratch_set_limit(0);
+    void *b = scratch_arena_alloc(arena, 12u << 20);
+    EXPECT_NE(b, nullptr);
+    scratch_free(a);
+    scratch_free(b);
+    scratch_arena_destroy(arena);
+    EXPECT_EQ(scratch_total_reserved(), base);
+}
+
+TEST(ScratchArenaTest, CrossThreadFree)
+{
+    scratch_arena_t *arena = scratch_arena_create(0);
+    ASSERT_NE(arena, nullptr);
+    scratch_arena_use(arena);
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 1000; i++)
+    {
+        blocks.push_back(scratch_alloc(64 + i % 200));
+    }
+    size_t reserved = scratch_arena_reserved(arena);
+
+    // 在其他线程释放的块回到所属 arena，之后由本线程复用
+    std::thread other([&blocks]() {
+        for (void *p : blocks)
+        {
+            scratch_free(p);
+        }
+        void *own = scratch_alloc(128);
+        EXPECT_NE(own, nullptr);
+        scratch_free(own);
+    });
+    other.join();
+
+    for (int round = 0; round < 3; round++)
+    {
+        std::vector<void *> again;
+        for (int i = 0; i < 1000; i++)
+        {
+            again.push_back(scratch_alloc(64 + i % 200));
+        }
+        for (void *p : again)
+        {
+            scratch_free(p);
+        }
+    }
+    EXPECT_EQ(scratch_arena_reserved(arena), reserved);
+
+    scratch_arena_use(nullptr);
+    scratch_arena_destroy(arena);
+    scratch_release_all();
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "util/thread_pool.h"
+
+namespace
+{
+    struct FibTask
+    {
+        thread_pool_t *pool;
+        int n;
+        long result;
+    };
+
+    // 递归提交子任务并等待，验证 fork-join 不会死锁
+    void fib_task(void *arg)
+    {
+        auto *task = static_cast<FibTask *>(arg);
+        if (task->n < 2)
+        {
+            task->result = task->n;
+            return;
+        }
+        FibTask left{task->pool, task->n - 1, 0};
+        FibTask right{task->pool, task->n - 2, 0};
+        thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+        thread_pool_submit(task->pool, &group, fib_task, &left);
+        fib_task(&right);
+        thread_pool_wait(task->pool, &group);
+        task->result = left.result + right.result;
+    }
+
+    void increment_task(void *arg)
+    {
+        static_cast<std::atomic<int> *>(arg)->fetch_add(1);
+    }
+} // namespace
+
+TEST(ThreadPoolTest, RunsAllSubmittedTasks)
+{
+    thread_pool_t *pool = thread_pool_create(4);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(thread_pool_size(pool), 4u);
+
+    std::atomic<int> counter{0};
+    thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(thread_pool_submit(pool, &group, increment_task, &counter), 0);
+    }
+    thread_pool_wait(pool, &group);
+    EXPECT_EQ(counter.load(), 1000);
+    thread_pool_destroy(pool);
+}
+
+TEST(ThreadPoolTest, NestedForkJoin)
+{
+    thread_pool_t *pool = thread_pool_create(3);
+    ASSERT_NE(pool, nullptr);
+    FibTask root{pool, 20, 0};
+    thread_pool_group_t group = THREAD_POOL_GROUP_INIT;
+    thread_pool_submit(pool, &group, fib_task, &root);
+    thread_pool_wait(pool, &group);
+    EXPECT_EQ(root.result, 6765);
+    thread_pool_destroy(pool);
+}
+
+TEST(ThreadPoolTest, GlobalPool)
+{
+    EXPECT_EQ(thread_pool_global_init(2), 0);
+    EXPECT_EQ(thread_pool_size(thread_pool_global()), 2u);
+    thread_pool_global_shutdown();
+    EXPECT_EQ(thread_pool_global(), nullptr);
+}